@@ -0,0 +1,136 @@
+#include "signal_aggregator.hpp"
+#include <benchmark/benchmark.h>
+#include <memory>
+#include <string>
+#include <vector>
+
+using namespace wq::aggregator;
+
+namespace {
+
+constexpr size_t NUM_SYMBOLS = 3000;
+constexpr size_t SIGNALS_PER_SYMBOL = 100;
+
+AlphaSignal makeSignal(size_t symbol, size_t alpha, int64_t timestampNs) {
+    AlphaSignal signal;
+    signal.setSymbol("SYM" + std::to_string(symbol));
+    signal.setAlphaId("Alpha_" + std::to_string(alpha));
+    signal.signal = static_cast<double>((symbol * 31 + alpha * 17) % 200) / 100.0 - 1.0;
+    signal.confidence = 0.2 + static_cast<double>((symbol + alpha) % 8) / 10.0;
+    signal.timestampNs = timestampNs;
+    return signal;
+}
+
+// A 3,000-symbol book with SIGNALS_PER_SYMBOL signals each, already published once
+std::unique_ptr<SignalAggregator> makeAggregator(SignalStorageMode mode = SignalStorageMode::HISTORY) {
+    auto aggregator = std::make_unique<SignalAggregator>(std::make_unique<WeightedAverageAggregation>(), mode);
+    for (size_t a = 0; a < SIGNALS_PER_SYMBOL; ++a) {
+        for (size_t s = 0; s < NUM_SYMBOLS; ++s) {
+            aggregator->addSignal(makeSignal(s, a, static_cast<int64_t>(a)));
+        }
+    }
+    aggregator->generatePortfolioDelta();
+    return aggregator;
+}
+
+// Whole portfolio from the cached aggregates
+void BM_PortfolioSnapshot(benchmark::State& state) {
+    auto aggregator = makeAggregator();
+    for (auto _ : state) {
+        auto portfolio = aggregator->generateTargetPortfolio();
+        benchmark::DoNotOptimize(portfolio.data());
+    }
+    state.SetItemsProcessed(state.iterations() * NUM_SYMBOLS);
+}
+BENCHMARK(BM_PortfolioSnapshot);
+
+// state.range(0) new signals on distinct symbols, then a delta refresh
+void BM_PortfolioDelta(benchmark::State& state) {
+    auto aggregator = makeAggregator();
+    size_t changed = static_cast<size_t>(state.range(0));
+    std::vector<AlphaSignal> updates;
+    for (size_t i = 0; i < NUM_SYMBOLS; ++i) {
+        updates.push_back(makeSignal(i, SIGNALS_PER_SYMBOL + i % 7, 1000));
+    }
+    size_t next = 0;
+    for (auto _ : state) {
+        state.PauseTiming();
+        for (size_t i = 0; i < changed; ++i) {
+            AlphaSignal signal = updates[next];
+            aggregator->addSignal(std::move(signal));
+            next = (next + 1) % NUM_SYMBOLS;
+        }
+        state.ResumeTiming();
+        auto delta = aggregator->generatePortfolioDelta();
+        benchmark::DoNotOptimize(delta.data());
+    }
+    state.SetItemsProcessed(state.iterations() * changed);
+}
+BENCHMARK(BM_PortfolioDelta)->Arg(10)->Arg(100)->Arg(3000);
+
+// Steady-state insert: 100 alphas repeating themselves on a few symbols.
+// History keeps (and shifts) up to MAX_SIGNALS_PER_SYMBOL per symbol; latest
+// mode overwrites one slot per alpha.
+template<SignalStorageMode Mode>
+void BM_AddSignal(benchmark::State& state) {
+    SignalAggregator aggregator(std::make_unique<WeightedAverageAggregation>(), Mode);
+    std::vector<AlphaSignal> signals;
+    for (size_t i = 0; i < 4096; ++i) {
+        signals.push_back(makeSignal(i % 8, i % SIGNALS_PER_SYMBOL, static_cast<int64_t>(i)));
+    }
+    for (size_t i = 0; i < 16384; ++i) {
+        AlphaSignal signal = signals[i % signals.size()];
+        aggregator.addSignal(std::move(signal));
+    }
+    size_t i = 0;
+    int64_t now = 16384;
+    for (auto _ : state) {
+        AlphaSignal signal = signals[i];
+        signal.timestampNs = now++;
+        aggregator.addSignal(std::move(signal));
+        i = (i + 1) & (signals.size() - 1);
+    }
+    state.SetItemsProcessed(state.iterations());
+}
+BENCHMARK_TEMPLATE(BM_AddSignal, SignalStorageMode::HISTORY);
+BENCHMARK_TEMPLATE(BM_AddSignal, SignalStorageMode::LATEST_PER_ALPHA);
+
+// One symbol's state.range(0) signals reduced by each strategy
+template<typename Strategy>
+void BM_Aggregate(benchmark::State& state) {
+    Strategy strategy;
+    std::vector<AlphaSignal> signals;
+    for (int64_t a = 0; a < state.range(0); ++a) {
+        signals.push_back(makeSignal(7, static_cast<size_t>(a), a));
+    }
+    for (auto _ : state) {
+        benchmark::DoNotOptimize(strategy.aggregate(signals));
+    }
+    state.SetItemsProcessed(state.iterations() * state.range(0));
+}
+BENCHMARK_TEMPLATE(BM_Aggregate, WeightedAverageAggregation)->Arg(10)->Arg(100)->Arg(1000);
+BENCHMARK_TEMPLATE(BM_Aggregate, MedianAggregation)->Arg(10)->Arg(100)->Arg(1000);
+BENCHMARK_TEMPLATE(BM_Aggregate, TrimmedMeanAggregation)->Arg(10)->Arg(100)->Arg(1000);
+
+// Replace one of SIGNALS_PER_SYMBOL values and read the median back
+void BM_StreamingMedianUpdate(benchmark::State& state) {
+    StreamingMedian median;
+    std::vector<double> values;
+    for (size_t a = 0; a < SIGNALS_PER_SYMBOL; ++a) {
+        values.push_back(makeSignal(7, a, 0).signal);
+        median.insert(values.back());
+    }
+    size_t i = 0;
+    for (auto _ : state) {
+        double replacement = -values[i];
+        median.erase(values[i]);
+        median.insert(replacement);
+        values[i] = replacement;
+        benchmark::DoNotOptimize(median.median());
+        i = (i + 1) % SIGNALS_PER_SYMBOL;
+    }
+    state.SetItemsProcessed(state.iterations());
+}
+BENCHMARK(BM_StreamingMedianUpdate);
+
+} // namespace
@@ -0,0 +1,124 @@
+#include "alpha_engine.hpp"
+#include "alpha_strategy.hpp"
+#include "allocation_counter.hpp"
+#include <benchmark/benchmark.h>
+#include <cmath>
+#include <memory>
+#include <string>
+#include <vector>
+
+// Counting operator new for the whole wq_bench binary
+WQ_COUNT_ALLOCATIONS()
+
+using namespace wq::alpha;
+
+namespace {
+
+constexpr size_t NUM_TICKS = 4096;
+
+// One symbol with a noisy price path, so every tick slides a full window
+std::vector<MarketData> makeTicks() {
+    std::vector<MarketData> ticks(NUM_TICKS);
+    for (size_t i = 0; i < NUM_TICKS; ++i) {
+        ticks[i].setSymbol("AAPL");
+        ticks[i].price = 100.0 + std::sin(static_cast<double>(i) * 0.1) + static_cast<double>(i % 7) * 0.01;
+        ticks[i].timestampNs = static_cast<int64_t>(i);
+    }
+    return ticks;
+}
+
+// Per-tick cost of a strategy once its window is full; state.range(0) is the window
+template<typename TAlpha>
+void BM_AlphaTick(benchmark::State& state) {
+    auto ticks = makeTicks();
+    TAlpha alpha("bench", static_cast<int>(state.range(0)));
+    alpha.initialize();
+    for (size_t i = 0; i < static_cast<size_t>(state.range(0)) + 1; ++i) {
+        alpha.onMarketData(ticks[i % NUM_TICKS]);
+    }
+    size_t i = 0;
+    for (auto _ : state) {
+        auto signal = alpha.onMarketData(ticks[i]);
+        benchmark::DoNotOptimize(signal);
+        i = (i + 1) & (NUM_TICKS - 1);
+    }
+    state.SetItemsProcessed(state.iterations());
+}
+
+BENCHMARK_TEMPLATE(BM_AlphaTick, MeanReversionAlpha)->Arg(20)->Arg(200)->Arg(500);
+BENCHMARK_TEMPLATE(BM_AlphaTick, MomentumAlpha)->Arg(10)->Arg(200)->Arg(500);
+
+// One tick through a family of `state.range(0)` alphas with window 20:
+// separate objects versus one batch
+constexpr int FAMILY_WINDOW = 20;
+
+void BM_FamilySeparate(benchmark::State& state) {
+    auto ticks = makeTicks();
+    std::vector<std::unique_ptr<IAlphaStrategy>> family;
+    for (int64_t i = 0; i < state.range(0); ++i) {
+        family.push_back(AlphaFactory::create("MeanReversion", "bench_" + std::to_string(i), FAMILY_WINDOW));
+        family.back()->initialize();
+    }
+    size_t i = 0;
+    for (auto _ : state) {
+        for (auto& alpha : family) {
+            auto signal = alpha->onMarketData(ticks[i]);
+            benchmark::DoNotOptimize(signal);
+        }
+        i = (i + 1) & (NUM_TICKS - 1);
+    }
+    state.SetItemsProcessed(state.iterations() * state.range(0));
+}
+BENCHMARK(BM_FamilySeparate)->Arg(100)->Arg(1000);
+
+void BM_FamilyBatch(benchmark::State& state) {
+    auto ticks = makeTicks();
+    auto batch = AlphaFactory::createBatch("MeanReversion", "bench_",
+                                           std::vector<int>(state.range(0), FAMILY_WINDOW));
+    batch->initialize();
+    std::vector<AlphaSignal> signals(batch->size());
+    size_t i = 0;
+    for (auto _ : state) {
+        benchmark::DoNotOptimize(batch->onMarketData(ticks[i], signals.data()));
+        i = (i + 1) & (NUM_TICKS - 1);
+    }
+    state.SetItemsProcessed(state.iterations() * state.range(0));
+    state.SetLabel(alphaBatchKernelName());
+}
+BENCHMARK(BM_FamilyBatch)->Arg(100)->Arg(1000);
+
+// Ticks through the pool in batches of 64 under each scheduling mode, with
+// the heap allocations per tick (all threads) once warmed up
+template<SchedulingMode Mode>
+void BM_PoolDispatch(benchmark::State& state) {
+    constexpr size_t BATCH = 64;
+    auto ticks = makeTicks();
+    AlphaEnginePool pool(2, Mode);
+    pool.addAlphaBatch(AlphaFactory::createBatch("MeanReversion", "bench_", std::vector<int>(100, FAMILY_WINDOW)));
+    for (int i = 0; i < 8; ++i) {
+        pool.addAlpha(AlphaFactory::create("Momentum", "bench_momentum_" + std::to_string(i), 10));
+    }
+    pool.registerSignalCallback([](AlphaSignal&& signal) { benchmark::DoNotOptimize(signal); });
+    pool.start();
+    for (size_t i = 0; i < NUM_TICKS; i += BATCH) {
+        pool.processMarketDataBatch(ticks.data() + i, BATCH);
+    }
+    pool.waitIdle();
+
+    wq::common::AllocationCounter allocations;
+    size_t i = 0;
+    for (auto _ : state) {
+        pool.processMarketDataBatch(ticks.data() + i, BATCH);
+        pool.waitIdle();
+        i = (i + BATCH) & (NUM_TICKS - 1);
+    }
+    state.SetItemsProcessed(state.iterations() * BATCH);
+    state.counters["allocs_per_tick"] = static_cast<double>(allocations.allThreads()) /
+                                        static_cast<double>(state.iterations() * BATCH);
+    pool.stop();
+}
+BENCHMARK_TEMPLATE(BM_PoolDispatch, SchedulingMode::WORK_STEALING)->UseRealTime();
+BENCHMARK_TEMPLATE(BM_PoolDispatch, SchedulingMode::SHARDED)->UseRealTime();
+BENCHMARK_TEMPLATE(BM_PoolDispatch, SchedulingMode::SYMBOL_SHARDED)->UseRealTime();
+
+} // namespace
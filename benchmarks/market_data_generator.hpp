@@ -0,0 +1,91 @@
+#pragma once
+
+#include "data_types.hpp"
+#include "wire_format.hpp"
+#include <algorithm>
+#include <array>
+#include <cstdint>
+#include <cstring>
+#include <random>
+#include <string>
+#include <utility>
+#include <vector>
+
+namespace wq::bench {
+
+// C++ port of scripts/market_data_generator.py: random-walk prices, a 0.1%
+// spread, and NYSE-layout packets with a trailing sequence number. Seeded,
+// so every run replays the same feed.
+class MarketDataGenerator {
+public:
+    using Packet = std::array<uint8_t, datafeed::WireFormat::SEQUENCED_PACKET_SIZE>;
+
+    // The script's five symbols, then SYMnnn up to numSymbols
+    explicit MarketDataGenerator(size_t numSymbols = 5, uint64_t seed = 42) : rng_(seed) {
+        static const Symbol defaults[] = {
+            {"AAPL", 150.0, 0.015}, {"GOOGL", 2800.0, 0.020}, {"MSFT", 300.0, 0.012},
+            {"AMZN", 3200.0, 0.018}, {"TSLA", 700.0, 0.030}};
+        for (size_t i = 0; i < numSymbols; ++i) {
+            if (i < std::size(defaults)) {
+                symbols_.push_back(defaults[i]);
+            } else {
+                symbols_.push_back({"SYM" + std::to_string(i), 20.0 + static_cast<double>(i % 500), 0.01});
+            }
+        }
+    }
+
+    // One tick of a random symbol after a random-walk step
+    void generateTick(Packet& packet, int64_t timestampNs) {
+        Symbol& symbol = symbols_[std::uniform_int_distribution<size_t>(0, symbols_.size() - 1)(rng_)];
+        double step = std::normal_distribution<double>(0.0, symbol.volatility * symbol.price)(rng_);
+        symbol.price = std::max(0.01, symbol.price + step);
+        double halfSpread = symbol.basePrice * 0.001 / 2;
+        double bid = symbol.price - halfSpread;
+        double ask = symbol.price + halfSpread;
+        int64_t bidSize = std::uniform_int_distribution<int64_t>(100, 10000)(rng_);
+        int64_t askSize = std::uniform_int_distribution<int64_t>(100, 10000)(rng_);
+        int64_t volume = std::uniform_int_distribution<int64_t>(10000, 1000000)(rng_);
+
+        using Layout = datafeed::NYSEWireLayout;
+        packet.fill(0);
+        std::memcpy(packet.data() + Layout::BID_PRICE, &bid, sizeof(bid));
+        std::memcpy(packet.data() + Layout::ASK_PRICE, &ask, sizeof(ask));
+        std::memcpy(packet.data() + Layout::LAST_PRICE, &symbol.price, sizeof(symbol.price));
+        std::memcpy(packet.data() + Layout::BID_SIZE, &bidSize, sizeof(bidSize));
+        std::memcpy(packet.data() + Layout::ASK_SIZE, &askSize, sizeof(askSize));
+        std::memcpy(packet.data() + Layout::VOLUME, &volume, sizeof(volume));
+        std::memcpy(packet.data() + Layout::TIMESTAMP, &timestampNs, sizeof(timestampNs));
+        std::memcpy(packet.data() + Layout::SYMBOL, symbol.name.data(), symbol.name.size());
+        std::memcpy(packet.data() + datafeed::WireFormat::SEQUENCE_OFFSET, &sequence_, sizeof(sequence_));
+        ++sequence_;
+    }
+
+    // count consecutive ticks, timestamps one microsecond apart
+    std::vector<Packet> generate(size_t count) {
+        std::vector<Packet> packets(count);
+        for (size_t i = 0; i < count; ++i) {
+            generateTick(packets[i], 1700000000000000000LL + static_cast<int64_t>(sequence_) * 1000);
+        }
+        return packets;
+    }
+
+    size_t numSymbols() const { return symbols_.size(); }
+    const std::string& symbolName(size_t index) const { return symbols_[index].name; }
+
+private:
+    struct Symbol {
+        std::string name;
+        double basePrice;
+        double volatility;
+        double price;
+
+        Symbol(std::string name, double basePrice, double volatility)
+            : name(std::move(name)), basePrice(basePrice), volatility(volatility), price(basePrice) {}
+    };
+
+    std::vector<Symbol> symbols_;
+    std::mt19937_64 rng_;
+    uint64_t sequence_{0};
+};
+
+} // namespace wq::bench
@@ -0,0 +1,151 @@
+#include "data_feed_handler.hpp"
+#include "market_data_block.hpp"
+#include "wire_format.hpp"
+#include <benchmark/benchmark.h>
+#include <array>
+#include <cstring>
+#include <limits>
+#include <memory>
+#include <string>
+#include <vector>
+
+using namespace wq::datafeed;
+
+namespace {
+
+constexpr size_t NUM_PACKETS = 1024;
+constexpr size_t PACKET_SIZE = WireFormat::SEQUENCED_PACKET_SIZE;
+
+// Realistic NYSE-layout packets over a rotating set of symbols
+std::vector<std::array<uint8_t, PACKET_SIZE>> makeNysePackets() {
+    std::vector<std::array<uint8_t, PACKET_SIZE>> packets(NUM_PACKETS);
+    for (size_t i = 0; i < NUM_PACKETS; ++i) {
+        auto& packet = packets[i];
+        packet.fill(0);
+        double bid = 100.0 + static_cast<double>(i % 97) * 0.01;
+        double ask = bid + 0.02;
+        double last = bid + 0.01;
+        int64_t bidSize = 100 + static_cast<int64_t>(i);
+        int64_t askSize = 200 + static_cast<int64_t>(i);
+        int64_t volume = 10000 + static_cast<int64_t>(i) * 10;
+        int64_t timestamp = 1700000000000000000LL + static_cast<int64_t>(i);
+        std::memcpy(packet.data() + NYSEWireLayout::BID_PRICE, &bid, sizeof(bid));
+        std::memcpy(packet.data() + NYSEWireLayout::ASK_PRICE, &ask, sizeof(ask));
+        std::memcpy(packet.data() + NYSEWireLayout::LAST_PRICE, &last, sizeof(last));
+        std::memcpy(packet.data() + NYSEWireLayout::BID_SIZE, &bidSize, sizeof(bidSize));
+        std::memcpy(packet.data() + NYSEWireLayout::ASK_SIZE, &askSize, sizeof(askSize));
+        std::memcpy(packet.data() + NYSEWireLayout::VOLUME, &volume, sizeof(volume));
+        std::memcpy(packet.data() + NYSEWireLayout::TIMESTAMP, &timestamp, sizeof(timestamp));
+        std::string symbol = "SYM" + std::to_string(i % 256);
+        std::memcpy(packet.data() + NYSEWireLayout::SYMBOL, symbol.data(), symbol.size());
+    }
+    return packets;
+}
+
+// Baseline: weak_ptr lock + virtual normalize/validate + std::optional
+void BM_VirtualNormalize(benchmark::State& state) {
+    auto packets = makeNysePackets();
+    auto normalizer = std::make_shared<NYSENormalizer>();
+    std::weak_ptr<DataNormalizer> weak = normalizer;
+    size_t i = 0;
+    for (auto _ : state) {
+        if (auto locked = weak.lock()) {
+            auto result = locked->normalize(packets[i].data(), PACKET_SIZE);
+            benchmark::DoNotOptimize(result);
+        }
+        i = (i + 1) & (NUM_PACKETS - 1);
+    }
+    state.SetItemsProcessed(state.iterations());
+}
+BENCHMARK(BM_VirtualNormalize);
+
+// Fully inlined compile-time decoder
+void BM_StaticDecode(benchmark::State& state) {
+    auto packets = makeNysePackets();
+    MarketData out;
+    size_t i = 0;
+    for (auto _ : state) {
+        bool ok = decodePacket<NYSEWireLayout>(packets[i].data(), PACKET_SIZE, out);
+        benchmark::DoNotOptimize(ok);
+        benchmark::DoNotOptimize(out);
+        i = (i + 1) & (NUM_PACKETS - 1);
+    }
+    state.SetItemsProcessed(state.iterations());
+}
+BENCHMARK(BM_StaticDecode);
+
+// Decoder selected through the Exchange-indexed dispatch table
+void BM_StaticDispatch(benchmark::State& state) {
+    auto packets = makeNysePackets();
+    MarketData out;
+    Exchange exchange = Exchange::NYSE;
+    benchmark::DoNotOptimize(exchange);
+    size_t i = 0;
+    for (auto _ : state) {
+        bool ok = staticDecoder(exchange)(packets[i].data(), PACKET_SIZE, out);
+        benchmark::DoNotOptimize(ok);
+        benchmark::DoNotOptimize(out);
+        i = (i + 1) & (NUM_PACKETS - 1);
+    }
+    state.SetItemsProcessed(state.iterations());
+}
+BENCHMARK(BM_StaticDispatch);
+
+// Whole-batch decode into SoA columns with the runtime-selected kernel
+void BM_BlockDecode(benchmark::State& state) {
+    auto packets = makeNysePackets();
+    std::vector<const uint8_t*> pointers(NUM_PACKETS);
+    std::vector<size_t> lengths(NUM_PACKETS, PACKET_SIZE);
+    for (size_t i = 0; i < NUM_PACKETS; ++i) {
+        pointers[i] = packets[i].data();
+    }
+    auto block = std::make_unique<MarketDataBlock>();
+    for (auto _ : state) {
+        size_t valid = decodeBlock<NYSEWireLayout>(pointers.data(), lengths.data(), NUM_PACKETS, *block);
+        benchmark::DoNotOptimize(valid);
+    }
+    state.SetItemsProcessed(state.iterations() * NUM_PACKETS);
+    state.SetLabel(validateBlockKernelName());
+}
+BENCHMARK(BM_BlockDecode);
+
+// Validation kernels alone over an already-decoded block. A few rows are
+// malformed, including an infinite quote whose spread is NaN, and every
+// kernel must flag exactly the rows the scalar one does.
+template<void (*Kernel)(MarketDataBlock&, bool)>
+void BM_BlockValidate(benchmark::State& state) {
+    auto packets = makeNysePackets();
+    auto block = std::make_unique<MarketDataBlock>();
+    block->clear();
+    block->count = NUM_PACKETS;
+    for (size_t i = 0; i < NUM_PACKETS; ++i) {
+        MarketData data;
+        decodePacket<NYSEWireLayout>(packets[i].data(), PACKET_SIZE, data);
+        block->store(i, data);
+    }
+    const double inf = std::numeric_limits<double>::infinity();
+    for (size_t i = 0; i + 64 <= NUM_PACKETS; i += 64) {
+        block->bidPrice[i + 5] = block->askPrice[i + 5] = inf;                    // NaN spread
+        block->bidPrice[i + 18] = std::numeric_limits<double>::quiet_NaN();
+        block->askPrice[i + 31] = block->bidPrice[i + 31] - 0.01;                 // Crossed
+        block->askPrice[i + 44] = block->bidPrice[i + 44] * 2.0;                  // Too wide
+    }
+    block->validMask.fill(~uint64_t{0});
+    validateBlockScalar(*block, true);
+    const auto expected = block->validMask;
+
+    for (auto _ : state) {
+        block->validMask.fill(~uint64_t{0});
+        Kernel(*block, true);
+        benchmark::DoNotOptimize(block->validMask);
+    }
+    state.SetItemsProcessed(state.iterations() * NUM_PACKETS);
+    if (block->validMask != expected) {
+        state.SkipWithError("kernel disagrees with the scalar validation");
+    }
+}
+BENCHMARK_TEMPLATE(BM_BlockValidate, validateBlockScalar);
+BENCHMARK_TEMPLATE(BM_BlockValidate, validateBlockAvx2);
+BENCHMARK_TEMPLATE(BM_BlockValidate, validateBlockAvx512);
+
+} // namespace
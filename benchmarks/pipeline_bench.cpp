@@ -0,0 +1,120 @@
+#include "allocation_counter.hpp"
+#include "alpha_engine.hpp"
+#include "alpha_strategy.hpp"
+#include "data_feed_handler.hpp"
+#include "market_data_generator.hpp"
+#include "risk_guardian.hpp"
+#include "signal_aggregator.hpp"
+#include "wire_format.hpp"
+#include <benchmark/benchmark.h>
+#include <atomic>
+#include <memory>
+#include <string>
+#include <vector>
+
+using namespace wq;
+
+namespace {
+
+constexpr size_t TICKS_PER_BATCH = 1024;
+constexpr size_t NUM_BATCHES = 64;
+constexpr size_t FAMILY_SIZE = 100;
+
+// Every stage of one trading cycle in process, with the gRPC hops replaced
+// by the co-located record conversions: decode, alphas on the pool,
+// aggregation into a portfolio delta, and risk over the resulting orders
+struct Pipeline {
+    aggregator::SignalAggregator aggregator{std::make_unique<aggregator::WeightedAverageAggregation>(),
+                                            aggregator::SignalStorageMode::LATEST_PER_ALPHA};
+    std::unique_ptr<risk::RiskGuardian> guardian;
+    alpha::AlphaEnginePool pool;
+    std::atomic<uint64_t> signals{0};
+    std::vector<double> lastPrices = std::vector<double>(common::InternConfig::MAX_SYMBOLS, 0.0);
+
+    explicit Pipeline(size_t threads) : pool(threads) {
+        guardian = risk::RiskGuardianBuilder()
+            .withFatFingerCheck()
+            .withDrawdownCheck()
+            .withConcentrationCheck()
+            .build();
+        pool.addAlphaBatch(alpha::AlphaFactory::createBatch("MeanReversion", "MeanReversion_",
+                                                            std::vector<int>(FAMILY_SIZE, 20)));
+        pool.addAlphaBatch(alpha::AlphaFactory::createBatch("Momentum", "Momentum_",
+                                                            std::vector<int>(FAMILY_SIZE, 10)));
+        pool.registerSignalCallback([this](alpha::AlphaSignal&& signal) {
+            aggregator.addSignal(aggregator::fromSignalRecord(alpha::toSignalRecord(signal)));
+            signals.fetch_add(1, std::memory_order_relaxed);
+        });
+        pool.start();
+    }
+
+    ~Pipeline() { pool.stop(); }
+};
+
+// Generated ticks through all four stages; state.range(0) symbols on the
+// feed, state.range(1) pool workers. Items are ticks in.
+void BM_Pipeline(benchmark::State& state) {
+    bench::MarketDataGenerator generator(static_cast<size_t>(state.range(0)));
+    auto packets = generator.generate(TICKS_PER_BATCH * NUM_BATCHES);
+    Pipeline pipeline(static_cast<size_t>(state.range(1)));
+    for (size_t i = 0; i < generator.numSymbols(); ++i) {
+        pipeline.guardian->setADV(generator.symbolName(i), 10000000.0);
+    }
+
+    std::vector<alpha::MarketData> ticks(TICKS_PER_BATCH);
+    std::vector<risk::Order> orders;
+    std::vector<risk::RiskVerdict> verdicts;
+    uint64_t numOrders = 0;
+    uint64_t numApproved = 0;
+    size_t batch = 0;
+    common::AllocationCounter allocations;
+    for (auto _ : state) {
+        // Feed handler: decode and hand over as tick records
+        size_t count = 0;
+        for (size_t i = 0; i < TICKS_PER_BATCH; ++i) {
+            const auto& packet = packets[batch * TICKS_PER_BATCH + i];
+            datafeed::MarketData data;
+            if (datafeed::decodePacket<datafeed::NYSEWireLayout>(packet.data(), packet.size(), data)) {
+                ticks[count] = alpha::fromTickRecord(datafeed::toTickRecord(data));
+                pipeline.lastPrices[ticks[count].symbolId] = ticks[count].price;
+                ++count;
+            }
+        }
+        batch = (batch + 1) % NUM_BATCHES;
+
+        // Alpha engine: every signal goes straight into the aggregator
+        pipeline.pool.processMarketDataBatch(ticks.data(), count);
+        pipeline.pool.waitIdle();
+
+        // Aggregator and risk: one order per changed target
+        auto delta = pipeline.aggregator.generatePortfolioDelta();
+        orders.resize(delta.size());
+        verdicts.resize(delta.size());
+        for (size_t i = 0; i < delta.size(); ++i) {
+            double quantity = delta[i].targetQuantity - delta[i].currentQuantity;
+            orders[i].setSymbol(delta[i].symbol.view());
+            orders[i].quantity = quantity < 0 ? -quantity : quantity;
+            orders[i].side = quantity < 0 ? risk::OrderSide::SELL : risk::OrderSide::BUY;
+            orders[i].price = pipeline.lastPrices[orders[i].symbolId];
+        }
+        auto result = pipeline.guardian->validateBasket(orders.data(), orders.size(), verdicts.data());
+        numOrders += orders.size();
+        numApproved += result.approved;
+    }
+    state.SetItemsProcessed(state.iterations() * TICKS_PER_BATCH);
+    state.counters["signals"] = benchmark::Counter(static_cast<double>(pipeline.signals.load()), benchmark::Counter::kIsRate);
+    state.counters["orders"] = benchmark::Counter(static_cast<double>(numOrders), benchmark::Counter::kIsRate);
+    state.counters["allocs_per_tick"] = static_cast<double>(allocations.allThreads()) /
+                                        static_cast<double>(state.iterations() * TICKS_PER_BATCH);
+    state.counters["approved"] = benchmark::Counter(
+        numOrders == 0 ? 0.0 : static_cast<double>(numApproved) / static_cast<double>(numOrders));
+}
+BENCHMARK(BM_Pipeline)
+    ->ArgNames({"symbols", "threads"})
+    ->Args({5, 2})
+    ->Args({500, 2})
+    ->Args({500, 4})
+    ->UseRealTime()
+    ->Unit(benchmark::kMicrosecond);
+
+} // namespace
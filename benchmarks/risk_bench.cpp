@@ -0,0 +1,234 @@
+#include "allocation_counter.hpp"
+#include "risk_guardian.hpp"
+#include <benchmark/benchmark.h>
+#include <atomic>
+#include <memory>
+#include <string>
+#include <thread>
+#include <vector>
+
+using namespace wq::risk;
+
+namespace {
+
+// All three checks with data for the symbol, so none of them short-circuits
+RiskCheckAggregator<Order> makeChecks() {
+    RiskCheckAggregator<Order> checks;
+    checks.addCheck(std::make_unique<FatFingerCheck>(RiskLimits::DEFAULT_MAX_ADV_PERCENTAGE));
+    checks.addCheck(std::make_unique<DrawdownCheck>(RiskLimits::DEFAULT_MAX_DRAWDOWN));
+    checks.addCheck(std::make_unique<ConcentrationCheck>(RiskLimits::DEFAULT_MAX_CONCENTRATION));
+    return checks;
+}
+
+std::unique_ptr<RiskState> makeState() {
+    auto state = std::make_unique<RiskState>();
+    RiskState::WriteScope write(*state);
+    state->setADV(wq::common::internSymbol("AAPL"), 1000000.0);
+    state->setPositionValue(wq::common::internSymbol("AAPL"), 50000.0);
+    state->setStartOfDayNAV(RiskLimits::DEFAULT_INITIAL_NAV);
+    state->setPnL(-60000.0);  // 6% down: buys are blocked
+    state->setNAV(RiskLimits::DEFAULT_INITIAL_NAV - 60000.0);
+    return state;
+}
+
+Order makeOrder(OrderSide side) {
+    Order order;
+    order.setSymbol("AAPL");
+    order.quantity = 100;
+    order.side = side;
+    order.price = 150.0;
+    return order;
+}
+
+// Mask only: no message is formatted even for the rejected buy
+void BM_CheckAll(benchmark::State& state) {
+    auto checks = makeChecks();
+    auto riskState = makeState();
+    Order order = makeOrder(state.range(0) ? OrderSide::BUY : OrderSide::SELL);
+    for (auto _ : state) {
+        benchmark::DoNotOptimize(checks.checkAll(order, *riskState));
+    }
+}
+BENCHMARK(BM_CheckAll)->ArgName("rejected")->Arg(0)->Arg(1);
+
+// Full result, reasons built for the rejected buy
+void BM_ValidateAll(benchmark::State& state) {
+    auto checks = makeChecks();
+    auto riskState = makeState();
+    Order order = makeOrder(state.range(0) ? OrderSide::BUY : OrderSide::SELL);
+    for (auto _ : state) {
+        auto result = checks.validateAll(order, *riskState);
+        benchmark::DoNotOptimize(result.approved);
+    }
+}
+BENCHMARK(BM_ValidateAll)->ArgName("rejected")->Arg(0)->Arg(1);
+
+// Guardian fast path, including its counters and budget timing
+void BM_CheckOrder(benchmark::State& state) {
+    auto guardian = RiskGuardianBuilder()
+        .withFatFingerCheck()
+        .withDrawdownCheck()
+        .withConcentrationCheck()
+        .build();
+    Order order = makeOrder(OrderSide::BUY);
+    for (auto _ : state) {
+        benchmark::DoNotOptimize(guardian->checkOrder(order));
+    }
+}
+BENCHMARK(BM_CheckOrder)->ThreadRange(1, 4);
+
+// Full result with the reason formatted, for an order the fat-finger check
+// rejects; one guardian shared by all threads, so they contend on its counters
+void BM_ValidateOrder(benchmark::State& state) {
+    static std::unique_ptr<RiskGuardian> guardian;
+    if (state.thread_index() == 0) {
+        guardian = RiskGuardianBuilder()
+            .withFatFingerCheck()
+            .withDrawdownCheck()
+            .withConcentrationCheck()
+            .build();
+        guardian->setADV("AAPL", 1000000.0);
+    }
+    Order order = makeOrder(OrderSide::BUY);
+    order.quantity = 60000;  // 6% of ADV
+    for (auto _ : state) {
+        auto result = guardian->validateOrder(order);
+        benchmark::DoNotOptimize(result.approved);
+    }
+}
+BENCHMARK(BM_ValidateOrder)->ThreadRange(1, 4);
+
+// Fast path while another thread re-marks the book as fast as it can
+void BM_CheckOrderDuringPriceUpdates(benchmark::State& state) {
+    auto guardian = RiskGuardianBuilder()
+        .withFatFingerCheck()
+        .withDrawdownCheck()
+        .withConcentrationCheck()
+        .build();
+    guardian->setADV("AAPL", 1000000.0);
+    guardian->updatePosition("AAPL", 100, 150.0);
+    std::atomic<bool> running{true};
+    std::thread writer([&] {
+        for (size_t i = 0; running.load(std::memory_order_relaxed); ++i) {
+            guardian->updateMarketPrice("AAPL", 150.0 + static_cast<double>(i % 100) / 100.0);
+        }
+    });
+    Order order = makeOrder(OrderSide::BUY);
+    for (auto _ : state) {
+        benchmark::DoNotOptimize(guardian->checkOrder(order));
+    }
+    running.store(false, std::memory_order_relaxed);
+    writer.join();
+}
+BENCHMARK(BM_CheckOrderDuringPriceUpdates)->UseRealTime();
+
+// A rebalance basket of count orders over 500 symbols
+std::vector<Order> makeBasket(RiskGuardian& guardian, size_t count) {
+    constexpr size_t NUM_SYMBOLS = 500;
+    std::vector<Order> basket(count);
+    for (size_t i = 0; i < count; ++i) {
+        std::string symbol = "BSK" + std::to_string(i % NUM_SYMBOLS);
+        if (i < NUM_SYMBOLS) {
+            guardian.setADV(symbol, 1000000.0);
+        }
+        basket[i].setSymbol(symbol);
+        basket[i].quantity = static_cast<double>(10 + i % 90);
+        basket[i].side = (i & 1) ? OrderSide::SELL : OrderSide::BUY;
+        basket[i].price = 20.0 + static_cast<double>(i % 50);
+    }
+    return basket;
+}
+
+// Order by order, each against its own read of the state
+void BM_CheckBasketPerOrder(benchmark::State& state) {
+    auto guardian = RiskGuardianBuilder()
+        .withFatFingerCheck()
+        .withDrawdownCheck()
+        .withConcentrationCheck()
+        .build();
+    auto basket = makeBasket(*guardian, static_cast<size_t>(state.range(0)));
+    std::vector<RiskVerdict> verdicts(basket.size());
+    for (auto _ : state) {
+        for (size_t i = 0; i < basket.size(); ++i) {
+            verdicts[i] = guardian->checkOrder(basket[i]);
+        }
+        benchmark::DoNotOptimize(verdicts.data());
+    }
+    state.SetItemsProcessed(state.iterations() * state.range(0));
+}
+BENCHMARK(BM_CheckBasketPerOrder)->Arg(100)->Arg(3000);
+
+// One gather and one pass per check, with cumulative per-symbol limits;
+// state.range(1) threads. Split baskets must match the single-threaded
+// verdicts, and warmed-up calls must not allocate.
+void BM_ValidateBasket(benchmark::State& state) {
+    auto guardian = RiskGuardianBuilder()
+        .withFatFingerCheck()
+        .withDrawdownCheck()
+        .withConcentrationCheck()
+        .build();
+    auto basket = makeBasket(*guardian, static_cast<size_t>(state.range(0)));
+    size_t threads = static_cast<size_t>(state.range(1));
+    std::vector<RiskVerdict> expected(basket.size());
+    std::vector<RiskVerdict> verdicts(basket.size());
+    guardian->validateBasket(basket.data(), basket.size(), expected.data());
+    guardian->validateBasket(basket.data(), basket.size(), verdicts.data(), threads);  // Warm up
+    wq::common::AllocationCounter allocations;
+    for (auto _ : state) {
+        auto result = guardian->validateBasket(basket.data(), basket.size(), verdicts.data(), threads);
+        benchmark::DoNotOptimize(result.approved);
+    }
+    state.SetItemsProcessed(state.iterations() * state.range(0));
+    state.counters["allocs_per_basket"] = static_cast<double>(allocations.allThreads()) /
+                                          static_cast<double>(state.iterations());
+    for (size_t i = 0; i < basket.size(); ++i) {
+        if (verdicts[i].violations != expected[i].violations) {
+            state.SkipWithError("split basket disagrees with the single-threaded verdicts");
+            break;
+        }
+    }
+}
+BENCHMARK(BM_ValidateBasket)
+    ->ArgNames({"orders", "threads"})
+    ->Args({100, 1})
+    ->Args({3000, 1})
+    ->Args({16384, 1})
+    ->Args({16384, 4});
+
+// Fills on a 3,000-symbol book: one lock and a constant-time total update
+void BM_PositionFill(benchmark::State& state) {
+    constexpr size_t NUM_SYMBOLS = 3000;
+    PositionManager positions;
+    std::vector<SymbolId> ids;
+    for (size_t i = 0; i < NUM_SYMBOLS; ++i) {
+        ids.push_back(wq::common::internSymbol("SYM" + std::to_string(i)));
+        positions.updatePosition(ids.back(), 100, 50.0);
+    }
+    size_t i = 0;
+    for (auto _ : state) {
+        positions.updatePosition(ids[i], (i & 1) ? 10.0 : -10.0, 50.0 + static_cast<double>(i % 7));
+        i = (i + 1) % NUM_SYMBOLS;
+    }
+    state.SetItemsProcessed(state.iterations());
+}
+BENCHMARK(BM_PositionFill);
+
+// Mark-to-market from a price tick
+void BM_MarketPriceUpdate(benchmark::State& state) {
+    constexpr size_t NUM_SYMBOLS = 3000;
+    PositionManager positions;
+    std::vector<SymbolId> ids;
+    for (size_t i = 0; i < NUM_SYMBOLS; ++i) {
+        ids.push_back(wq::common::internSymbol("SYM" + std::to_string(i)));
+        positions.updatePosition(ids.back(), 100, 50.0);
+    }
+    size_t i = 0;
+    for (auto _ : state) {
+        positions.updateMarketPrice(ids[i], 50.0 + static_cast<double>(i % 13) / 10.0);
+        i = (i + 1) % NUM_SYMBOLS;
+    }
+    state.SetItemsProcessed(state.iterations());
+}
+BENCHMARK(BM_MarketPriceUpdate);
+
+} // namespace
@@ -0,0 +1,83 @@
+#include "checkpoint.hpp"
+#include "signal_aggregator.hpp"
+#include <benchmark/benchmark.h>
+#include <cstdio>
+#include <memory>
+#include <string>
+#include <vector>
+
+using namespace wq::aggregator;
+
+// Listed last in the benchmark sources, so registered and run last: these
+// fill the process-wide intern tables, which no later benchmark could use.
+
+namespace {
+
+AlphaSignal makeSignal(std::string_view alphaId, int64_t timestampNs) {
+    AlphaSignal signal;
+    signal.setSymbol("SATURATED");
+    signal.alphaId = AlphaIdString(alphaId);  // Interned by the aggregator
+    signal.signal = 0.5;
+    signal.confidence = 1.0;
+    signal.timestampNs = timestampNs;
+    return signal;
+}
+
+// Latest-mode inserts once every alpha index is taken: each signal with a
+// new alpha id is rejected and counted, the table is left untouched
+void BM_AddSignalAlphaTableFull(benchmark::State& state) {
+    wq::common::internAlphaId("Known");
+    for (size_t i = wq::common::alphaIdTable().size(); i < wq::common::InternConfig::MAX_ALPHA_IDS; ++i) {
+        wq::common::internAlphaId("Filler_" + std::to_string(i));
+    }
+    SignalAggregator aggregator(std::make_unique<WeightedAverageAggregation>(),
+                                SignalStorageMode::LATEST_PER_ALPHA);
+    aggregator.addSignal(makeSignal("Known", 0));
+    if (aggregator.getRejectedSignalCount() != 0) {
+        state.SkipWithError("signal with a known alpha id was rejected");
+        return;
+    }
+
+    std::vector<AlphaSignal> signals;
+    for (size_t i = 0; i < 512; ++i) {  // Under MAX_SIGNALS_PER_SYMBOL, so history keeps all
+        signals.push_back(makeSignal("Overflow_" + std::to_string(i), static_cast<int64_t>(i) + 1));
+    }
+    size_t i = 0;
+    for (auto _ : state) {
+        AlphaSignal signal = signals[i];
+        aggregator.addSignal(std::move(signal));
+        i = (i + 1) & (signals.size() - 1);
+    }
+    state.SetItemsProcessed(state.iterations());
+
+    auto value = aggregator.getAggregatedSignal("SATURATED");
+    if (aggregator.getRejectedSignalCount() != static_cast<uint64_t>(state.iterations()) || !value || *value != 0.5) {
+        state.SkipWithError("signals past a full alpha table reached the latest-signal table");
+        return;
+    }
+
+    // History mode keeps signals without an alpha index; restoring them in
+    // latest mode goes through the same rejection
+    SignalAggregator history(std::make_unique<WeightedAverageAggregation>(), SignalStorageMode::HISTORY);
+    for (const auto& signal : signals) {
+        AlphaSignal copy = signal;
+        history.addSignal(std::move(copy));
+    }
+    const std::string path = "/tmp/wq_saturation_bench.ckpt";
+    wq::common::CheckpointWriter writer;
+    history.checkpoint(writer);
+    std::unique_ptr<wq::common::CheckpointReader> reader;
+    if (writer.commit(path, 0)) {
+        reader = wq::common::CheckpointReader::open(path);
+        std::remove(path.c_str());
+    }
+    SignalAggregator restored(std::make_unique<WeightedAverageAggregation>(),
+                              SignalStorageMode::LATEST_PER_ALPHA);
+    if (!reader || restored.restoreCheckpoint(*reader) != 0 ||
+        restored.getRejectedSignalCount() != signals.size()) {
+        state.SkipWithError("restored signals past a full alpha table were not rejected");
+    }
+}
+BENCHMARK(BM_AddSignalAlphaTableFull);
+
+} // namespace
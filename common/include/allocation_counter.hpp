@@ -0,0 +1,74 @@
+#pragma once
+
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <cstdlib>
+#include <new>
+
+namespace wq::common {
+
+// Heap allocation counts, maintained by the global operator new installed
+// with WQ_COUNT_ALLOCATIONS(). Without it the counts stay at zero.
+namespace allocation_detail {
+    inline std::atomic<uint64_t> total{0};
+    inline thread_local uint64_t thisThread = 0;
+
+    inline void note() {
+        ++thisThread;
+        total.fetch_add(1, std::memory_order_relaxed);
+    }
+
+    inline void* allocate(size_t size, size_t alignment) {
+        note();
+        void* pointer = alignment <= alignof(std::max_align_t)
+            ? std::malloc(size == 0 ? 1 : size)
+            : std::aligned_alloc(alignment, (size + alignment - 1) / alignment * alignment);
+        if (pointer == nullptr) {
+            throw std::bad_alloc();
+        }
+        return pointer;
+    }
+}
+
+inline uint64_t totalAllocations() { return allocation_detail::total.load(std::memory_order_relaxed); }
+inline uint64_t threadAllocations() { return allocation_detail::thisThread; }
+
+// Allocations between construction and the call, on this thread or on all
+class AllocationCounter {
+public:
+    AllocationCounter() : threadStart_(threadAllocations()), totalStart_(totalAllocations()) {}
+
+    uint64_t thisThread() const { return threadAllocations() - threadStart_; }
+    uint64_t allThreads() const { return totalAllocations() - totalStart_; }
+
+private:
+    uint64_t threadStart_;
+    uint64_t totalStart_;
+};
+
+} // namespace wq::common
+
+// Replace the global operator new/delete with counting versions. Expand
+// once, at namespace scope, in one translation unit of the executable.
+#define WQ_COUNT_ALLOCATIONS()                                                                     \
+    void* operator new(std::size_t size) {                                                         \
+        return wq::common::allocation_detail::allocate(size, alignof(std::max_align_t));           \
+    }                                                                                              \
+    void* operator new[](std::size_t size) {                                                       \
+        return wq::common::allocation_detail::allocate(size, alignof(std::max_align_t));           \
+    }                                                                                              \
+    void* operator new(std::size_t size, std::align_val_t alignment) {                             \
+        return wq::common::allocation_detail::allocate(size, static_cast<std::size_t>(alignment)); \
+    }                                                                                              \
+    void* operator new[](std::size_t size, std::align_val_t alignment) {                           \
+        return wq::common::allocation_detail::allocate(size, static_cast<std::size_t>(alignment)); \
+    }                                                                                              \
+    void operator delete(void* pointer) noexcept { std::free(pointer); }                           \
+    void operator delete[](void* pointer) noexcept { std::free(pointer); }                         \
+    void operator delete(void* pointer, std::size_t) noexcept { std::free(pointer); }              \
+    void operator delete[](void* pointer, std::size_t) noexcept { std::free(pointer); }            \
+    void operator delete(void* pointer, std::align_val_t) noexcept { std::free(pointer); }         \
+    void operator delete[](void* pointer, std::align_val_t) noexcept { std::free(pointer); }       \
+    void operator delete(void* pointer, std::size_t, std::align_val_t) noexcept { std::free(pointer); } \
+    void operator delete[](void* pointer, std::size_t, std::align_val_t) noexcept { std::free(pointer); }
@@ -0,0 +1,75 @@
+#pragma once
+
+#include <cstddef>
+#include <memory>
+#include <memory_resource>
+
+namespace wq::common {
+
+namespace ArenaConfig {
+    constexpr size_t THREAD_ARENA_BYTES = 1 << 20;  // Per-thread scratch before falling back upstream
+}
+
+// Bump allocator over one preallocated buffer, released all at once. Any
+// std::pmr container can draw from resource(); deallocation is a no-op and
+// reset() rewinds to the start of the buffer, so a tick or batch worth of
+// scratch costs no heap traffic once the buffer exists. Requests past the
+// buffer go to the upstream resource, std::pmr::get_default_resource() at
+// construction unless given, and are returned on reset(). Single thread.
+class MonotonicArena {
+public:
+    explicit MonotonicArena(size_t bytes = ArenaConfig::THREAD_ARENA_BYTES,
+                            std::pmr::memory_resource* upstream = std::pmr::get_default_resource())
+        : buffer_(new std::byte[bytes])
+        , bytes_(bytes)
+        , resource_(buffer_.get(), bytes, upstream) {}
+
+    MonotonicArena(const MonotonicArena&) = delete;
+    MonotonicArena& operator=(const MonotonicArena&) = delete;
+
+    std::pmr::memory_resource* resource() { return &resource_; }
+
+    // Everything allocated since the last reset() is invalidated
+    void reset() { resource_.release(); }
+
+    size_t capacity() const { return bytes_; }
+
+private:
+    std::unique_ptr<std::byte[]> buffer_;
+    size_t bytes_;
+    std::pmr::monotonic_buffer_resource resource_;
+};
+
+// The calling thread's arena, created on first use
+inline MonotonicArena& threadArena() {
+    thread_local MonotonicArena arena;
+    return arena;
+}
+
+// Resets the thread's arena when the outermost scope on that thread ends,
+// so helpers can open their own scope without freeing a caller's data
+class ArenaScope {
+public:
+    ArenaScope() : arena_(threadArena()) { ++depth(); }
+
+    ~ArenaScope() {
+        if (--depth() == 0) {
+            arena_.reset();
+        }
+    }
+
+    ArenaScope(const ArenaScope&) = delete;
+    ArenaScope& operator=(const ArenaScope&) = delete;
+
+    std::pmr::memory_resource* resource() { return arena_.resource(); }
+
+private:
+    MonotonicArena& arena_;
+
+    static size_t& depth() {
+        thread_local size_t depth = 0;
+        return depth;
+    }
+};
+
+} // namespace wq::common
@@ -0,0 +1,572 @@
+#pragma once
+
+#include "last_value_cache.hpp"
+#include "topology.hpp"
+#include <google/protobuf/arena.h>
+#include <google/protobuf/repeated_field.h>
+#include <grpcpp/grpcpp.h>
+#include <grpcpp/support/async_stream.h>
+#include <grpcpp/support/async_unary_call.h>
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <cstddef>
+#include <functional>
+#include <iostream>
+#include <memory>
+#include <mutex>
+#include <optional>
+#include <string>
+#include <string_view>
+#include <thread>
+#include <unordered_set>
+#include <vector>
+
+namespace wq::common {
+
+namespace ServerConfig {
+    // Listening addresses, one per proto service
+    constexpr const char* MARKET_DATA_ADDRESS = "0.0.0.0:50051";
+    constexpr const char* ALPHA_SIGNAL_ADDRESS = "0.0.0.0:50052";
+    constexpr const char* PORTFOLIO_ADDRESS = "0.0.0.0:50053";
+    constexpr const char* RISK_ADDRESS = "0.0.0.0:50054";
+
+    constexpr size_t ARENA_BLOCK_SIZE = 8192;     // First arena block, held inline by each call
+    constexpr size_t MAX_PENDING_ITEMS = 4096;    // Queued for a lagging subscriber before conflating
+    constexpr int64_t SHUTDOWN_GRACE_MS = 1000;   // In-flight calls get this long to finish
+}
+
+// Completion queue tag: the polling thread calls proceed() with the event's ok flag
+class AsyncTag {
+public:
+    virtual ~AsyncTag() = default;
+    virtual void proceed(bool ok) = 0;
+};
+
+// Tag forwarding to a member of its owner, so one object can have several
+// operations in flight
+template<typename Owner, void (Owner::*Method)(bool)>
+class MemberTag : public AsyncTag {
+public:
+    explicit MemberTag(Owner* owner) : owner_(owner) {}
+    void proceed(bool ok) override { (owner_->*Method)(ok); }
+
+private:
+    Owner* owner_;
+};
+
+// Protobuf arena whose first block lives inside the owner. Messages of a
+// call are created here and freed together by reset(), which keeps the
+// first block, so small calls allocate nothing once the owner exists.
+class CallArena {
+public:
+    CallArena() : arena_(options(block_)) {}
+
+    CallArena(const CallArena&) = delete;
+    CallArena& operator=(const CallArena&) = delete;
+
+    template<typename Message>
+    Message* create() { return google::protobuf::Arena::CreateMessage<Message>(&arena_); }
+
+    // Invalidates every message created since the last reset
+    void reset() { arena_.Reset(); }
+
+private:
+    alignas(8) char block_[ServerConfig::ARENA_BLOCK_SIZE];
+    google::protobuf::Arena arena_;
+
+    static google::protobuf::ArenaOptions options(char* block) {
+        google::protobuf::ArenaOptions options;
+        options.initial_block = block;
+        options.initial_block_size = ServerConfig::ARENA_BLOCK_SIZE;
+        return options;
+    }
+};
+
+// gRPC server on the async completion-queue API: one queue per core, each
+// polled by its own thread. Methods post a request on every queue at start()
+// and post the next one as each call arrives, so calls and streams are
+// plain state machines and no thread is tied to a stream.
+class AsyncServer {
+public:
+    using QueueHook = std::function<void(grpc::ServerCompletionQueue* cq)>;
+
+    // numQueues 0: one per hardware thread
+    explicit AsyncServer(std::string address, size_t numQueues = 0)
+        : address_(std::move(address))
+        , numQueues_(numQueues > 0 ? numQueues : std::max(1u, std::thread::hardware_concurrency()))
+        , fixedQueues_(numQueues > 0) {}
+
+    ~AsyncServer() { shutdown(); }
+
+    AsyncServer(const AsyncServer&) = delete;
+    AsyncServer& operator=(const AsyncServer&) = delete;
+
+    // Before start(). The service must outlive the server.
+    void addService(grpc::Service* service) { services_.push_back(service); }
+
+    // Before start(): run once per queue at start(), to post first requests
+    void addQueueHook(QueueHook hook) { queueHooks_.push_back(std::move(hook)); }
+
+    // Before start(): the topology stage of the poll threads. Without an
+    // explicit queue count the server then runs one queue per stage core.
+    void setStage(std::string_view stage) {
+        stage_ = stage;
+        if (!fixedQueues_ && topology().numCores(stage) > 0) {
+            numQueues_ = topology().numCores(stage);
+        }
+    }
+
+    // Run when shutdown begins, before the server stops accepting calls
+    void addShutdownHook(std::function<void()> hook) { shutdownHooks_.push_back(std::move(hook)); }
+
+    // False if the address cannot be bound
+    bool start() {
+        if (server_) {
+            return true;
+        }
+        grpc::ServerBuilder builder;
+        builder.AddListeningPort(address_, grpc::InsecureServerCredentials(), &port_);
+        for (grpc::Service* service : services_) {
+            builder.RegisterService(service);
+        }
+        for (size_t i = 0; i < numQueues_; ++i) {
+            queues_.push_back(builder.AddCompletionQueue());
+        }
+        server_ = builder.BuildAndStart();
+        if (!server_ || port_ == 0) {
+            std::cerr << "Failed to start gRPC server on " << address_ << std::endl;
+            server_.reset();
+            queues_.clear();
+            return false;
+        }
+        stopping_.store(false, std::memory_order_relaxed);
+        for (auto& queue : queues_) {
+            for (const auto& hook : queueHooks_) {
+                hook(queue.get());
+            }
+        }
+        for (auto& queue : queues_) {
+            threads_.push_back(topology().startThread(stage_, threads_.size(),
+                                                      [cq = queue.get()]() { poll(cq); }));
+        }
+        return true;
+    }
+
+    void shutdown() {
+        if (!server_) {
+            return;
+        }
+        stopping_.store(true, std::memory_order_relaxed);
+        for (const auto& hook : shutdownHooks_) {
+            hook();
+        }
+        server_->Shutdown(std::chrono::system_clock::now() +
+                          std::chrono::milliseconds(ServerConfig::SHUTDOWN_GRACE_MS));
+        for (auto& queue : queues_) {
+            queue->Shutdown();  // Pollers drain what is left, then return
+        }
+        for (auto& thread : threads_) {
+            thread.join();
+        }
+        threads_.clear();
+        queues_.clear();
+        server_.reset();
+    }
+
+    // Calls stop posting new requests once this is set
+    bool isShuttingDown() const { return stopping_.load(std::memory_order_relaxed); }
+
+    bool isRunning() const { return server_ != nullptr; }
+    const std::string& getAddress() const { return address_; }
+    int getPort() const { return port_; }
+    size_t getQueueCount() const { return numQueues_; }
+
+private:
+    std::string address_;
+    size_t numQueues_;
+    bool fixedQueues_;
+    std::string stage_;
+    int port_{0};
+    std::vector<grpc::Service*> services_;
+    std::vector<QueueHook> queueHooks_;
+    std::vector<std::function<void()>> shutdownHooks_;
+    std::unique_ptr<grpc::Server> server_;
+    std::vector<std::unique_ptr<grpc::ServerCompletionQueue>> queues_;
+    std::vector<std::thread> threads_;
+    std::atomic<bool> stopping_{false};
+
+    static void poll(grpc::ServerCompletionQueue* cq) {
+        void* tag = nullptr;
+        bool ok = false;
+        while (cq->Next(&tag, &ok)) {
+            static_cast<AsyncTag*>(tag)->proceed(ok);
+        }
+    }
+};
+
+// Unary RPC served on every queue. A call object waits on each queue; when
+// a request arrives another one is posted at once, then the request is
+// handled on the polling thread. Finished calls are kept for reuse, arena
+// and all, so steady traffic allocates no call state. The handler fills
+// the response in place and must not block.
+template<typename Service, typename Request, typename Response>
+class UnaryMethod {
+public:
+    using RequestFn = void (Service::*)(grpc::ServerContext*, Request*, grpc::ServerAsyncResponseWriter<Response>*,
+                                        grpc::CompletionQueue*, grpc::ServerCompletionQueue*, void*);
+    using Handler = std::function<grpc::Status(const Request& request, Response& response)>;
+
+    UnaryMethod(AsyncServer& server, Service& service, RequestFn request, Handler handler)
+        : server_(server), service_(service), request_(request), handler_(std::move(handler)) {
+        server_.addQueueHook([this](grpc::ServerCompletionQueue* cq) { post(cq); });
+    }
+
+    ~UnaryMethod() {
+        for (Call* call : idle_) {
+            delete call;
+        }
+    }
+
+    UnaryMethod(const UnaryMethod&) = delete;
+    UnaryMethod& operator=(const UnaryMethod&) = delete;
+
+    uint64_t getCallCount() const { return calls_.load(std::memory_order_relaxed); }
+
+private:
+    // Waiting, in flight or idle; deleted by the method or at shutdown
+    class Call {
+    public:
+        explicit Call(UnaryMethod& method) : method_(method) {}
+
+        void post(grpc::ServerCompletionQueue* cq) {
+            cq_ = cq;
+            responder_.reset();
+            context_.reset();
+            arena_.reset();
+            request_ = arena_.create<Request>();
+            response_ = arena_.create<Response>();
+            context_.emplace();  // A context serves one call, so it is rebuilt in place
+            responder_.emplace(&*context_);
+            (method_.service_.*method_.request_)(&*context_, request_, &*responder_, cq_, cq_, &requestTag_);
+        }
+
+    private:
+        UnaryMethod& method_;
+        grpc::ServerCompletionQueue* cq_{nullptr};
+        std::optional<grpc::ServerContext> context_;
+        std::optional<grpc::ServerAsyncResponseWriter<Response>> responder_;
+        CallArena arena_;
+        Request* request_{nullptr};
+        Response* response_{nullptr};
+
+        void onRequest(bool ok) {
+            if (!ok) {
+                delete this;  // Server shutting down
+                return;
+            }
+            if (!method_.server_.isShuttingDown()) {
+                method_.post(cq_);  // Next request on this queue
+            }
+            method_.calls_.fetch_add(1, std::memory_order_relaxed);
+            grpc::Status status = method_.handler_(*request_, *response_);
+            responder_->Finish(*response_, status, &finishTag_);
+        }
+
+        void onFinish(bool /*ok*/) {
+            if (method_.server_.isShuttingDown()) {
+                delete this;
+                return;
+            }
+            method_.release(this);
+        }
+
+        MemberTag<Call, &Call::onRequest> requestTag_{this};
+        MemberTag<Call, &Call::onFinish> finishTag_{this};
+    };
+
+    AsyncServer& server_;
+    Service& service_;
+    RequestFn request_;
+    Handler handler_;
+    std::mutex idleMutex_;
+    std::vector<Call*> idle_;
+    std::atomic<uint64_t> calls_{0};
+
+    void post(grpc::ServerCompletionQueue* cq) {
+        Call* call = nullptr;
+        {
+            std::lock_guard<std::mutex> lock(idleMutex_);
+            if (!idle_.empty()) {
+                call = idle_.back();
+                idle_.pop_back();
+            }
+        }
+        if (!call) {
+            call = new Call(*this);
+        }
+        call->post(cq);
+    }
+
+    void release(Call* call) {
+        std::lock_guard<std::mutex> lock(idleMutex_);
+        idle_.push_back(call);
+    }
+};
+
+// Server-streaming RPC fanned out to every subscriber, one message per
+// batch of items. publish() appends items to each matching subscriber's
+// pending batch. A subscriber has at most one write in flight, and whatever
+// arrives meanwhile goes out together in its next message, so a slow link
+// gets fewer, larger messages - the per-subscriber flow control. If a
+// subscriber lags until MAX_PENDING_ITEMS are pending, the batch is
+// conflated to the newest item per key: the client gets current values
+// instead of a growing backlog. A CONFLATED subscriber has every message
+// conflated that way. A disconnected subscriber is dropped at its next
+// write.
+template<typename Service, typename Request, typename Batch, typename Item>
+class StreamPublisher {
+public:
+    using RequestFn = void (Service::*)(grpc::ServerContext*, Request*, grpc::ServerAsyncWriter<Batch>*,
+                                        grpc::CompletionQueue*, grpc::ServerCompletionQueue*, void*);
+    using ItemsFn = google::protobuf::RepeatedPtrField<Item>* (Batch::*)();  // e.g. &Batch::mutable_ticks
+    using KeyFn = std::string (*)(const Item& item);                           // Conflation key
+    using FilterFn = std::function<bool(const Request& request, const Item& item)>;
+    using SnapshotFn = std::function<void(const Request& request, Batch& batch)>;
+    using PrepareFn = std::function<void(Batch& batch, bool first)>;
+    using PolicyFn = std::function<DeliveryPolicy(const Request& request)>;
+
+    StreamPublisher(AsyncServer& server, Service& service, RequestFn request, ItemsFn items, KeyFn key)
+        : server_(server), service_(service), request_(request), items_(items), key_(key) {
+        server_.addQueueHook([this](grpc::ServerCompletionQueue* cq) { new Subscriber(*this, cq); });
+        server_.addShutdownHook([this] { close(); });
+    }
+
+    // Before the server starts. Filter: items a subscriber asked for (all
+    // by default). Snapshot: seeds a new subscriber's first message.
+    // Prepare: sets batch-level fields just before each message is written.
+    // Policy: how a subscriber wants its items (FULL by default).
+    void setFilter(FilterFn filter) { filter_ = std::move(filter); }
+    void setSnapshot(SnapshotFn snapshot) { snapshot_ = std::move(snapshot); }
+    void setPrepare(PrepareFn prepare) { prepare_ = std::move(prepare); }
+    void setPolicy(PolicyFn policy) { policy_ = std::move(policy); }
+
+    // Queue items for every subscriber; never blocks on the network
+    void publish(const google::protobuf::RepeatedPtrField<Item>& items) {
+        std::lock_guard<std::mutex> lock(mutex_);
+        for (Subscriber* subscriber : subscribers_) {
+            subscriber->enqueue(items);
+        }
+    }
+
+    size_t getSubscriberCount() const {
+        std::lock_guard<std::mutex> lock(mutex_);
+        return subscribers_.size();
+    }
+    uint64_t getMessagesSent() const { return messagesSent_.load(std::memory_order_relaxed); }
+    uint64_t getConflatedCount() const { return conflated_.load(std::memory_order_relaxed); }  // Items replaced by newer ones
+
+private:
+    // One open stream. Owns its lifetime: deleted once its Finish completes.
+    class Subscriber {
+    public:
+        Subscriber(StreamPublisher& owner, grpc::ServerCompletionQueue* cq)
+            : owner_(owner), cq_(cq), writer_(&context_), pending_(arena_.create<Batch>()) {
+            (owner_.service_.*owner_.request_)(&context_, &request_, &writer_, cq_, cq_, &acceptTag_);
+        }
+
+        // Publisher holds its lock; the publisher's lock is always taken first
+        void enqueue(const google::protobuf::RepeatedPtrField<Item>& items) {
+            std::lock_guard<std::mutex> lock(mutex_);
+            if (finishing_) {
+                return;
+            }
+            auto* pending = (pending_->*owner_.items_)();
+            for (const Item& item : items) {
+                if (!owner_.filter_ || owner_.filter_(request_, item)) {
+                    pending->Add()->CopyFrom(item);
+                }
+            }
+            if (static_cast<size_t>(pending->size()) >= conflateAt_) {
+                conflateLocked();
+            }
+            if (!writing_) {
+                writeLocked();
+            }
+        }
+
+        // Shutdown: finish now, or after the write in flight
+        void close() {
+            bool finishNow = false;
+            {
+                std::lock_guard<std::mutex> lock(mutex_);
+                closing_ = true;
+                finishNow = !writing_ && !finishing_;
+                finishing_ = finishing_ || finishNow;
+            }
+            if (finishNow) {
+                writer_.Finish(grpc::Status::OK, &finishTag_);
+            }
+        }
+
+        const Request& request() const { return request_; }
+
+    private:
+        StreamPublisher& owner_;
+        grpc::ServerCompletionQueue* cq_;
+        grpc::ServerContext context_;
+        grpc::ServerAsyncWriter<Batch> writer_;
+        Request request_;
+        CallArena arena_;
+        Batch* pending_;                    // Next message, in arena_
+        std::mutex mutex_;
+        bool writing_{false};               // A write is in flight
+        bool finishing_{false};             // Finish issued or about to be
+        bool closing_{false};               // Publisher closed: already off its list
+        bool first_{true};
+        DeliveryPolicy policy_{DeliveryPolicy::FULL};
+        size_t conflateAt_{ServerConfig::MAX_PENDING_ITEMS};
+        std::unordered_set<std::string> seenKeys_;  // Conflation scratch
+        std::vector<uint8_t> keep_;
+
+        void onAccept(bool ok) {
+            if (!ok) {
+                delete this;  // Server shutting down
+                return;
+            }
+            if (!owner_.server_.isShuttingDown()) {
+                new Subscriber(owner_, cq_);  // Wait for the next subscriber on this queue
+            }
+            owner_.subscribe(this);
+        }
+
+        // The message is serialized by Write(), so the arena is free right after
+        void writeLocked() {
+            if ((pending_->*owner_.items_)()->empty() && !first_) {
+                return;
+            }
+            if (policy_ == DeliveryPolicy::CONFLATED && (pending_->*owner_.items_)()->size() > 1) {
+                conflateLocked();
+            }
+            if (owner_.prepare_) {
+                owner_.prepare_(*pending_, first_);
+            }
+            first_ = false;
+            writing_ = true;
+            writer_.Write(*pending_, &writeTag_);
+            owner_.messagesSent_.fetch_add(1, std::memory_order_relaxed);
+            arena_.reset();
+            pending_ = arena_.create<Batch>();
+            conflateAt_ = ServerConfig::MAX_PENDING_ITEMS;
+        }
+
+        void onWrite(bool ok) {
+            bool finish = false;
+            bool unlist = false;
+            {
+                std::lock_guard<std::mutex> lock(mutex_);
+                writing_ = false;
+                if (!ok || closing_) {
+                    finish = !finishing_;
+                    finishing_ = true;
+                    unlist = !closing_;
+                } else if (!(pending_->*owner_.items_)()->empty()) {
+                    writeLocked();
+                }
+            }
+            if (unlist) {
+                owner_.unsubscribe(this);  // Client gone
+            }
+            if (finish) {
+                writer_.Finish(ok ? grpc::Status::OK : grpc::Status::CANCELLED, &finishTag_);
+            }
+        }
+
+        void onFinish(bool /*ok*/) {
+            delete this;
+        }
+
+        // Keep the newest item per key, in their original order
+        void conflateLocked() {
+            auto* items = (pending_->*owner_.items_)();
+            int count = items->size();
+            seenKeys_.clear();
+            keep_.assign(static_cast<size_t>(count), 0);
+            for (int i = count - 1; i >= 0; --i) {
+                keep_[i] = seenKeys_.insert(owner_.key_(items->Get(i))).second;
+            }
+            int kept = 0;
+            for (int i = 0; i < count; ++i) {
+                if (keep_[i]) {
+                    if (kept != i) {
+                        items->SwapElements(kept, i);
+                    }
+                    ++kept;
+                }
+            }
+            items->DeleteSubrange(kept, count - kept);
+            owner_.conflated_.fetch_add(static_cast<uint64_t>(count - kept), std::memory_order_relaxed);
+            // All distinct: wait for as many again before the next pass
+            conflateAt_ = std::max(ServerConfig::MAX_PENDING_ITEMS, 2 * static_cast<size_t>(kept));
+        }
+
+        MemberTag<Subscriber, &Subscriber::onAccept> acceptTag_{this};
+        MemberTag<Subscriber, &Subscriber::onWrite> writeTag_{this};
+        MemberTag<Subscriber, &Subscriber::onFinish> finishTag_{this};
+
+        friend class StreamPublisher;
+    };
+
+    AsyncServer& server_;
+    Service& service_;
+    RequestFn request_;
+    ItemsFn items_;
+    KeyFn key_;
+    FilterFn filter_;
+    SnapshotFn snapshot_;
+    PrepareFn prepare_;
+    PolicyFn policy_;
+    mutable std::mutex mutex_;              // Guards subscribers_; taken before any subscriber's
+    std::vector<Subscriber*> subscribers_;
+    bool closed_{false};
+    std::atomic<uint64_t> messagesSent_{0};
+    std::atomic<uint64_t> conflated_{0};
+
+    // The snapshot is taken with the subscriber listed and locked, so no
+    // publish() lands between the snapshot and the first live item
+    void subscribe(Subscriber* subscriber) {
+        std::lock_guard<std::mutex> lock(mutex_);
+        if (closed_) {
+            subscriber->close();
+            return;
+        }
+        subscribers_.push_back(subscriber);
+        std::lock_guard<std::mutex> subscriberLock(subscriber->mutex_);
+        if (policy_) {
+            subscriber->policy_ = policy_(subscriber->request());
+        }
+        if (snapshot_) {
+            snapshot_(subscriber->request(), *subscriber->pending_);
+        }
+        subscriber->writeLocked();  // First message: the snapshot, possibly empty
+    }
+
+    void unsubscribe(Subscriber* subscriber) {
+        std::lock_guard<std::mutex> lock(mutex_);
+        subscribers_.erase(std::remove(subscribers_.begin(), subscribers_.end(), subscriber),
+                           subscribers_.end());
+    }
+
+    // Under the lock, so a subscriber whose client just left cannot
+    // finish and be deleted while it is being closed
+    void close() {
+        std::lock_guard<std::mutex> lock(mutex_);
+        closed_ = true;
+        for (Subscriber* subscriber : subscribers_) {
+            subscriber->close();
+        }
+        subscribers_.clear();
+    }
+};
+
+} // namespace wq::common
@@ -0,0 +1,312 @@
+#pragma once
+
+#include "fixed_string.hpp"
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <fcntl.h>
+#include <unistd.h>
+#include <algorithm>
+#include <cerrno>
+#include <cstddef>
+#include <cstdint>
+#include <cstdio>
+#include <cstring>
+#include <iostream>
+#include <memory>
+#include <string>
+#include <string_view>
+#include <type_traits>
+#include <vector>
+
+namespace wq::common {
+
+namespace CheckpointConfig {
+    constexpr uint32_t MAGIC = 0x4B435157;        // "WQCK"
+    constexpr uint32_t VERSION = 1;
+    constexpr size_t NAME_BYTES = 32;
+    constexpr size_t ALIGNMENT = 8;               // Section payloads start on this boundary
+    constexpr int64_t INTERVAL_NS = 10LL * 1000000000LL;  // Between periodic snapshots
+}
+
+// Checkpoint file: a header, a table of named sections, then the section
+// payloads, each a flat run of trivially copyable values (no pointers, no
+// interned ids, which differ between runs). Names may repeat: a service
+// with several instances of one component writes a section per instance.
+//
+// The watermark is the timestamp of the newest tick reflected in the state,
+// so a restart restores the file and replays the tick store from just past
+// it. Bump VERSION when changing any layout below.
+struct CheckpointHeader {
+    uint32_t magic;
+    uint32_t version;
+    uint32_t numSections;
+    uint32_t reserved;
+    int64_t createdNs;
+    int64_t watermarkNs;
+    uint64_t fileBytes;
+};
+
+struct CheckpointSectionEntry {
+    FixedString<CheckpointConfig::NAME_BYTES> name;
+    uint64_t offset;                    // From the start of the file
+    uint64_t bytes;
+};
+
+namespace CheckpointConfig {
+    constexpr size_t align(size_t bytes) { return (bytes + ALIGNMENT - 1) / ALIGNMENT * ALIGNMENT; }
+}
+
+// Builds a checkpoint in memory, then commits it in one write. Components
+// that snapshot in parallel each fill their own writer, and append() merges
+// them, so the only work done where the state lives is copying it out.
+class CheckpointWriter {
+public:
+    void beginSection(std::string_view name) {
+        endSection();
+        payload_.resize(CheckpointConfig::align(payload_.size()));
+        sections_.push_back({FixedString<CheckpointConfig::NAME_BYTES>(name), payload_.size(), 0});
+        open_ = true;
+    }
+
+    template<typename T>
+    void write(const T& value) {
+        writeArray(&value, 1);
+    }
+
+    template<typename T>
+    void writeArray(const T* values, size_t count) {
+        static_assert(std::is_trivially_copyable_v<T>, "checkpoint values are copied as bytes");
+        size_t bytes = sizeof(T) * count;
+        size_t at = payload_.size();
+        payload_.resize(at + bytes);
+        if (bytes > 0) {
+            std::memcpy(payload_.data() + at, values, bytes);
+        }
+    }
+
+    void endSection() {
+        if (open_) {
+            sections_.back().bytes = payload_.size() - sections_.back().offset;
+            open_ = false;
+        }
+    }
+
+    // Drop the open section and everything written to it
+    void abandonSection() {
+        if (open_) {
+            payload_.resize(sections_.back().offset);
+            sections_.pop_back();
+            open_ = false;
+        }
+    }
+
+    // Sections of other after those of this writer; the newer watermark wins
+    void append(CheckpointWriter& other) {
+        other.endSection();
+        endSection();
+        size_t base = CheckpointConfig::align(payload_.size());
+        payload_.resize(base);
+        payload_.insert(payload_.end(), other.payload_.begin(), other.payload_.end());
+        for (auto section : other.sections_) {
+            section.offset += base;
+            sections_.push_back(section);
+        }
+        advanceWatermark(other.watermarkNs_);
+    }
+
+    // The watermark only moves forward
+    void advanceWatermark(int64_t timestampNs) { watermarkNs_ = std::max(watermarkNs_, timestampNs); }
+    int64_t watermarkNs() const { return watermarkNs_; }
+
+    size_t numSections() const { return sections_.size(); }
+    size_t payloadBytes() const { return payload_.size(); }
+
+    // Write path.tmp, sync it and rename it over path, so readers see the
+    // previous checkpoint or this one, never a torn file. createdNs is
+    // recorded as given.
+    bool commit(const std::string& path, int64_t createdNs) {
+        endSection();
+        size_t tableBytes = sizeof(CheckpointSectionEntry) * sections_.size();
+        size_t base = CheckpointConfig::align(sizeof(CheckpointHeader) + tableBytes);
+
+        CheckpointHeader header{};
+        header.magic = CheckpointConfig::MAGIC;
+        header.version = CheckpointConfig::VERSION;
+        header.numSections = static_cast<uint32_t>(sections_.size());
+        header.createdNs = createdNs;
+        header.watermarkNs = watermarkNs_;
+        header.fileBytes = base + payload_.size();
+        std::vector<CheckpointSectionEntry> table(sections_);
+        for (auto& section : table) {
+            section.offset += base;
+        }
+
+        std::string tmpPath = path + ".tmp";
+        int fd = ::open(tmpPath.c_str(), O_WRONLY | O_CREAT | O_TRUNC, 0644);
+        if (fd < 0) {
+            std::cerr << "Failed to create checkpoint " << tmpPath << ": " << std::strerror(errno) << std::endl;
+            return false;
+        }
+        static const char padding[CheckpointConfig::ALIGNMENT] = {};
+        bool written = writeAll(fd, &header, sizeof(header))
+            && writeAll(fd, table.data(), tableBytes)
+            && writeAll(fd, padding, base - sizeof(header) - tableBytes)
+            && writeAll(fd, payload_.data(), payload_.size())
+            && fsync(fd) == 0;
+        written = close(fd) == 0 && written;
+        if (!written || std::rename(tmpPath.c_str(), path.c_str()) != 0) {
+            std::cerr << "Failed to write checkpoint " << path << ": " << std::strerror(errno) << std::endl;
+            ::unlink(tmpPath.c_str());
+            return false;
+        }
+        return true;
+    }
+
+private:
+    std::vector<char> payload_;
+    std::vector<CheckpointSectionEntry> sections_;  // Offsets into payload_
+    int64_t watermarkNs_{0};
+    bool open_{false};
+
+    static bool writeAll(int fd, const void* data, size_t bytes) {
+        const char* cursor = static_cast<const char*>(data);
+        while (bytes > 0) {
+            ssize_t written = ::write(fd, cursor, bytes);
+            if (written < 0) {
+                if (errno == EINTR) {
+                    continue;
+                }
+                return false;
+            }
+            cursor += written;
+            bytes -= static_cast<size_t>(written);
+        }
+        return true;
+    }
+};
+
+// Bounds-checked cursor over one section's payload in the mapping. Reads
+// past the end fail rather than return garbage, so a restore can reject a
+// section written by a differently configured component. Sections are
+// cheap to copy, and each copy reads from where the original stood.
+class CheckpointSection {
+public:
+    CheckpointSection() = default;
+    CheckpointSection(const char* data, size_t bytes) : data_(data), bytes_(bytes) {}
+
+    template<typename T>
+    bool read(T& value) {
+        return readArray(&value, 1);
+    }
+
+    template<typename T>
+    bool readArray(T* values, size_t count) {
+        static_assert(std::is_trivially_copyable_v<T>, "checkpoint values are copied as bytes");
+        size_t bytes = sizeof(T) * count;
+        if (count > remaining() / std::max<size_t>(sizeof(T), 1)) {
+            return false;
+        }
+        if (bytes > 0) {
+            std::memcpy(values, data_ + position_, bytes);
+        }
+        position_ += bytes;
+        return true;
+    }
+
+    // Skip count values of T without copying them
+    template<typename T>
+    bool skip(size_t count) {
+        if (count > remaining() / sizeof(T)) {
+            return false;
+        }
+        position_ += sizeof(T) * count;
+        return true;
+    }
+
+    size_t remaining() const { return bytes_ - position_; }
+    size_t size() const { return bytes_; }
+
+private:
+    const char* data_{nullptr};
+    size_t bytes_{0};
+    size_t position_{0};
+};
+
+// Read-only mapping of a checkpoint file. Opening maps the file and checks
+// the header and section table; the sections are read in place, so a
+// restore costs the page faults of the state it copies out, nothing more.
+class CheckpointReader {
+public:
+    // nullptr if the file is missing, damaged or not a checkpoint of this build
+    static std::unique_ptr<CheckpointReader> open(const std::string& path) {
+        int fd = ::open(path.c_str(), O_RDONLY);
+        if (fd < 0) {
+            std::cerr << "Failed to open checkpoint " << path << std::endl;
+            return nullptr;
+        }
+        struct stat info;
+        if (fstat(fd, &info) != 0 || static_cast<size_t>(info.st_size) < sizeof(CheckpointHeader)) {
+            close(fd);
+            std::cerr << "Checkpoint " << path << " is truncated" << std::endl;
+            return nullptr;
+        }
+        size_t size = static_cast<size_t>(info.st_size);
+        void* mapping = mmap(nullptr, size, PROT_READ, MAP_PRIVATE, fd, 0);
+        close(fd);
+        if (mapping == MAP_FAILED) {
+            std::cerr << "Failed to map checkpoint " << path << std::endl;
+            return nullptr;
+        }
+
+        const auto* header = static_cast<const CheckpointHeader*>(mapping);
+        bool valid = header->magic == CheckpointConfig::MAGIC
+            && header->version == CheckpointConfig::VERSION
+            && header->fileBytes == size
+            && header->numSections <= (size - sizeof(CheckpointHeader)) / sizeof(CheckpointSectionEntry);
+        const auto* table = reinterpret_cast<const CheckpointSectionEntry*>(header + 1);
+        for (uint32_t i = 0; valid && i < header->numSections; ++i) {
+            valid = table[i].offset <= size && table[i].bytes <= size - table[i].offset;
+        }
+        if (!valid) {
+            munmap(mapping, size);
+            std::cerr << "Checkpoint " << path << " is damaged or has an unsupported layout" << std::endl;
+            return nullptr;
+        }
+        return std::unique_ptr<CheckpointReader>(new CheckpointReader(mapping, size));
+    }
+
+    ~CheckpointReader() { munmap(mapping_, mappingSize_); }
+
+    // Deleted copy/move - sections point into the mapping
+    CheckpointReader(const CheckpointReader&) = delete;
+    CheckpointReader& operator=(const CheckpointReader&) = delete;
+
+    int64_t createdNs() const { return header()->createdNs; }
+    int64_t watermarkNs() const { return header()->watermarkNs; }
+    size_t numSections() const { return header()->numSections; }
+
+    // Every section with this name, in the order they were written
+    std::vector<CheckpointSection> sections(std::string_view name) const {
+        FixedString<CheckpointConfig::NAME_BYTES> key(name);
+        std::vector<CheckpointSection> found;
+        const auto* table = reinterpret_cast<const CheckpointSectionEntry*>(header() + 1);
+        for (size_t i = 0; i < numSections(); ++i) {
+            if (table[i].name == key) {
+                found.emplace_back(static_cast<const char*>(mapping_) + table[i].offset, table[i].bytes);
+            }
+        }
+        return found;
+    }
+
+private:
+    CheckpointReader(void* mapping, size_t mappingSize)
+        : mapping_(mapping)
+        , mappingSize_(mappingSize) {}
+
+    const CheckpointHeader* header() const { return static_cast<const CheckpointHeader*>(mapping_); }
+
+    void* mapping_;
+    size_t mappingSize_;
+};
+
+} // namespace wq::common
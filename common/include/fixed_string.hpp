@@ -0,0 +1,101 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+#include <ostream>
+#include <string>
+#include <string_view>
+
+namespace wq::common {
+
+// Fixed-capacity, NUL-padded string stored inline (no heap allocation).
+// Trivially copyable, so structs holding it can be memcpy'd, queued and
+// written to shared memory as-is. Input longer than N bytes is truncated.
+template<size_t N>
+class FixedString {
+public:
+    static constexpr size_t CAPACITY = N;
+
+    constexpr FixedString() noexcept : data_{} {}
+
+    constexpr FixedString(std::string_view str) noexcept : data_{} {
+        assign(str);
+    }
+
+    constexpr FixedString(const char* str) noexcept : FixedString(std::string_view(str)) {}
+
+    FixedString(const std::string& str) noexcept : FixedString(std::string_view(str)) {}
+
+    // Copy a NUL-terminated (or NUL-padded) field out of a wire buffer
+    static FixedString fromBuffer(const void* buffer, size_t maxLength) noexcept {
+        FixedString result;
+        size_t limit = maxLength < N ? maxLength : N;
+        const void* terminator = std::memchr(buffer, '\0', limit);
+        size_t length = terminator
+            ? static_cast<size_t>(static_cast<const char*>(terminator) - static_cast<const char*>(buffer))
+            : limit;
+        std::memcpy(result.data_, buffer, length);
+        return result;
+    }
+
+    size_t size() const noexcept {
+        const void* terminator = std::memchr(data_, '\0', N);
+        return terminator ? static_cast<size_t>(static_cast<const char*>(terminator) - data_) : N;
+    }
+
+    bool empty() const noexcept { return data_[0] == '\0'; }
+
+    std::string_view view() const noexcept { return std::string_view(data_, size()); }
+    std::string str() const { return std::string(view()); }
+    const char* data() const noexcept { return data_; }
+
+    // Padding is always zero, so whole-buffer comparison is exact
+    bool operator==(const FixedString& other) const noexcept {
+        return std::memcmp(data_, other.data_, N) == 0;
+    }
+    bool operator!=(const FixedString& other) const noexcept { return !(*this == other); }
+
+    // Word-at-a-time multiply-xorshift over the padded buffer
+    uint64_t hash() const noexcept {
+        uint64_t h = 0x9E3779B97F4A7C15ULL ^ N;
+        size_t i = 0;
+        for (; i + sizeof(uint64_t) <= N; i += sizeof(uint64_t)) {
+            uint64_t word;
+            std::memcpy(&word, data_ + i, sizeof(word));
+            h = (h ^ word) * 0xFF51AFD7ED558CCDULL;
+            h ^= h >> 32;
+        }
+        for (; i < N; ++i) {
+            h = (h ^ static_cast<uint8_t>(data_[i])) * 0x100000001B3ULL;
+        }
+        return h ^ (h >> 29);
+    }
+
+    friend std::ostream& operator<<(std::ostream& os, const FixedString& str) {
+        return os << str.view();
+    }
+
+private:
+    char data_[N];
+
+    constexpr void assign(std::string_view str) noexcept {
+        size_t length = str.size() < N ? str.size() : N;
+        for (size_t i = 0; i < length; ++i) {
+            data_[i] = str[i];
+        }
+    }
+};
+
+// Shared widths for identifiers carried through the hot path
+namespace StringWidth {
+    constexpr size_t SYMBOL = 16;
+    constexpr size_t ALPHA_ID = 32;
+    constexpr size_t ORDER_ID = 32;
+}
+
+using SymbolString = FixedString<StringWidth::SYMBOL>;
+using AlphaIdString = FixedString<StringWidth::ALPHA_ID>;
+using OrderIdString = FixedString<StringWidth::ORDER_ID>;
+
+} // namespace wq::common
@@ -0,0 +1,100 @@
+#pragma once
+
+#include <cstddef>
+#include <new>
+#include <type_traits>
+#include <utility>
+
+namespace wq::common {
+
+// Move-only void() callable that keeps its closure in place when it fits in
+// Capacity bytes, so queuing a task never allocates. std::function moves
+// anything beyond two pointers to the heap; a per-tick closure capturing a
+// tick and a snapshot is several times that. Larger closures still work,
+// through one heap allocation, and fitsInline<Fn> lets callers check.
+template<size_t Capacity>
+class InlineTask {
+    static_assert(Capacity >= sizeof(void*), "the heap fallback keeps a pointer in place");
+
+public:
+    template<typename Fn>
+    static constexpr bool fitsInline = sizeof(Fn) <= Capacity &&
+                                       alignof(Fn) <= alignof(std::max_align_t) &&
+                                       std::is_nothrow_move_constructible_v<Fn>;
+
+    InlineTask() noexcept = default;
+
+    template<typename Fn, typename = std::enable_if_t<!std::is_same_v<std::decay_t<Fn>, InlineTask>>>
+    InlineTask(Fn&& fn) {  // Implicit, like std::function
+        using Stored = std::decay_t<Fn>;
+        if constexpr (fitsInline<Stored>) {
+            new (storage_) Stored(std::forward<Fn>(fn));
+            ops_ = &INLINE_OPS<Stored>;
+        } else {
+            *reinterpret_cast<Stored**>(storage_) = new Stored(std::forward<Fn>(fn));
+            ops_ = &HEAP_OPS<Stored>;
+        }
+    }
+
+    InlineTask(InlineTask&& other) noexcept { moveFrom(other); }
+
+    InlineTask& operator=(InlineTask&& other) noexcept {
+        if (this != &other) {
+            reset();
+            moveFrom(other);
+        }
+        return *this;
+    }
+
+    InlineTask(const InlineTask&) = delete;
+    InlineTask& operator=(const InlineTask&) = delete;
+
+    ~InlineTask() { reset(); }
+
+    void operator()() { ops_->invoke(storage_); }
+
+    explicit operator bool() const noexcept { return ops_ != nullptr; }
+
+    void reset() noexcept {
+        if (ops_) {
+            ops_->destroy(storage_);
+            ops_ = nullptr;
+        }
+    }
+
+private:
+    struct Ops {
+        void (*invoke)(void* storage);
+        void (*move)(void* to, void* from) noexcept;  // Leaves from destroyed
+        void (*destroy)(void* storage) noexcept;
+    };
+
+    template<typename Fn>
+    static constexpr Ops INLINE_OPS = {
+        [](void* storage) { (*std::launder(reinterpret_cast<Fn*>(storage)))(); },
+        [](void* to, void* from) noexcept {
+            Fn* source = std::launder(reinterpret_cast<Fn*>(from));
+            new (to) Fn(std::move(*source));
+            source->~Fn();
+        },
+        [](void* storage) noexcept { std::launder(reinterpret_cast<Fn*>(storage))->~Fn(); }};
+
+    template<typename Fn>
+    static constexpr Ops HEAP_OPS = {
+        [](void* storage) { (**reinterpret_cast<Fn**>(storage))(); },
+        [](void* to, void* from) noexcept { *reinterpret_cast<Fn**>(to) = *reinterpret_cast<Fn**>(from); },
+        [](void* storage) noexcept { delete *reinterpret_cast<Fn**>(storage); }};
+
+    alignas(std::max_align_t) unsigned char storage_[Capacity];
+    const Ops* ops_{nullptr};
+
+    void moveFrom(InlineTask& other) noexcept {
+        if (other.ops_) {
+            other.ops_->move(storage_, other.storage_);
+            ops_ = other.ops_;
+            other.ops_ = nullptr;
+        }
+    }
+};
+
+} // namespace wq::common
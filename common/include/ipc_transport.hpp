@@ -0,0 +1,146 @@
+#pragma once
+
+#include "fixed_string.hpp"
+#include "shm_ring.hpp"
+#include "topology.hpp"
+#include <unistd.h>
+#include <cstdint>
+#include <cstdlib>
+#include <memory>
+#include <string_view>
+
+namespace wq::common {
+
+// Fixed-layout records exchanged between co-located services. They mirror
+// the proto messages field for field, but as plain bytes: no serialization,
+// no allocation. Bump ShmConfig::VERSION when changing any of them.
+
+// MarketTick
+struct TickRecord {
+    SymbolString symbol;
+    double bidPrice;
+    double askPrice;
+    double lastPrice;
+    int64_t bidSize;
+    int64_t askSize;
+    int64_t volume;
+    int64_t timestampNs;
+    uint8_t exchange;      // datafeed::Exchange
+    uint8_t assetType;     // datafeed::AssetType
+};
+
+// AlphaSignal
+struct SignalRecord {
+    AlphaIdString alphaId;
+    SymbolString symbol;
+    double signal;
+    double confidence;
+    int64_t timestampNs;
+};
+
+// TargetPosition
+struct TargetRecord {
+    SymbolString symbol;
+    double targetQuantity;
+    double currentQuantity;
+    int64_t timestampNs;
+};
+
+// OrderRequest
+struct OrderRecord {
+    OrderIdString orderId;
+    SymbolString symbol;
+    double quantity;
+    double price;
+    int64_t timestampNs;
+    uint8_t side;          // risk::OrderSide
+};
+
+// RiskCheckResult, matched to its request by orderId
+struct OrderVerdictRecord {
+    OrderIdString orderId;
+    uint32_t violationMask;  // Bit n set for risk::ViolationType n
+    bool approved;
+};
+
+namespace IpcConfig {
+    // Segment names, one per proto stream
+    constexpr std::string_view MARKET_DATA_SEGMENT = "/wq.market_data";
+    constexpr std::string_view SIGNAL_SEGMENT = "/wq.alpha_signals";
+    constexpr std::string_view TARGET_SEGMENT = "/wq.target_portfolio";
+    constexpr std::string_view ORDER_SEGMENT = "/wq.orders";
+    constexpr std::string_view VERDICT_SEGMENT = "/wq.order_verdicts";
+
+    constexpr size_t TICK_CAPACITY = 65536;
+    constexpr size_t SIGNAL_CAPACITY = 65536;
+    constexpr size_t TARGET_CAPACITY = 4096;
+    constexpr size_t ORDER_CAPACITY = 4096;
+
+    // Environment overrides: WQ_TRANSPORT=grpc disables shared memory,
+    // WQ_PEER_HOST names the upstream host (default: this one)
+    constexpr const char* TRANSPORT_ENV = "WQ_TRANSPORT";
+    constexpr const char* PEER_HOST_ENV = "WQ_PEER_HOST";
+}
+
+using TickShmRing = ShmRing<TickRecord, IpcConfig::TICK_CAPACITY>;
+using SignalShmRing = ShmRing<SignalRecord, IpcConfig::SIGNAL_CAPACITY>;
+using TargetShmRing = ShmRing<TargetRecord, IpcConfig::TARGET_CAPACITY>;
+using OrderShmRing = ShmRing<OrderRecord, IpcConfig::ORDER_CAPACITY>;
+using VerdictShmRing = ShmRing<OrderVerdictRecord, IpcConfig::ORDER_CAPACITY>;
+
+enum class TransportKind : uint8_t {
+    SHARED_MEMORY,  // Co-located peer, mmap'd ring
+    GRPC            // Cross-host peer, proto services
+};
+
+constexpr std::string_view transportKindToString(TransportKind kind) {
+    return kind == TransportKind::SHARED_MEMORY ? "shared-memory" : "gRPC";
+}
+
+// True if host names this machine
+inline bool isLocalHost(std::string_view host) {
+    if (host.empty() || host == "localhost" || host == "::1" || host.substr(0, 4) == "127.") {
+        return true;
+    }
+    char name[256] = {};
+    return gethostname(name, sizeof(name) - 1) == 0 && host == name;
+}
+
+inline bool sharedMemoryDisabled() {
+    const char* forced = std::getenv(IpcConfig::TRANSPORT_ENV);
+    return forced && std::string_view(forced) == "grpc";
+}
+
+// Consumer side: attach to the stream's ring if its producer runs on this
+// host (WQ_PEER_HOST, default local) and is alive. nullptr means the stream
+// must come over gRPC. WQ_TRANSPORT=grpc always returns nullptr.
+template<typename Ring>
+std::unique_ptr<Ring> attachColocated(std::string_view segment) {
+    if (sharedMemoryDisabled()) {
+        return nullptr;
+    }
+    const char* peer = std::getenv(IpcConfig::PEER_HOST_ENV);
+    if (!isLocalHost(peer ? peer : "")) {
+        return nullptr;
+    }
+    return Ring::open(segment);
+}
+
+// Producer side: publish the stream into shared memory for co-located
+// consumers alongside gRPC; nullptr if disabled or the segment cannot be
+// created. The segment is placed on the node of consumerStage when the
+// process topology names it.
+template<typename Ring>
+std::unique_ptr<Ring> publishColocated(std::string_view segment, std::string_view consumerStage = {}) {
+    if (sharedMemoryDisabled()) {
+        return nullptr;
+    }
+    int node = consumerStage.empty() ? -1 : topology().nodeOf(consumerStage);
+    auto ring = Ring::create(segment, node);
+    if (ring && node >= 0) {
+        topology().notePlacement(segment, Ring::mappingSize(), node, consumerStage);
+    }
+    return ring;
+}
+
+} // namespace wq::common
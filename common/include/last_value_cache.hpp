@@ -0,0 +1,214 @@
+#pragma once
+
+#include "symbol_table.hpp"
+#include <atomic>
+#include <cstdint>
+#include <cstring>
+#include <memory>
+#include <type_traits>
+
+namespace wq::common {
+
+// How a subscriber wants a stream of per-key updates
+enum class DeliveryPolicy : uint8_t {
+    FULL,       // Every update, in order
+    CONFLATED   // Only the newest update per key when the subscriber gets to it
+};
+
+// Newest value per key (usually an interned SymbolId), readable from any
+// thread while one writer keeps updating it. Each slot is its own seqlock,
+// so a reader retries only when it races a write of that same key. Values
+// are stored as atomic words, so reads never tear or race.
+template<typename Value>
+class LastValueCache {
+    static_assert(std::is_trivially_copyable_v<Value>, "cached values are copied word by word");
+
+public:
+    explicit LastValueCache(size_t capacity = InternConfig::MAX_SYMBOLS)
+        : capacity_(capacity)
+        , slots_(new Slot[capacity]())
+        , keys_(new std::atomic<uint32_t>[capacity]()) {}
+
+    LastValueCache(const LastValueCache&) = delete;
+    LastValueCache& operator=(const LastValueCache&) = delete;
+
+    // Store the newest value for key; returns its version, which starts at
+    // 1 and grows with every update. Keys past capacity are ignored (0).
+    // Writers must be serialized by the caller.
+    uint64_t update(size_t key, const Value& value) {
+        if (key >= capacity_) {
+            return 0;
+        }
+        Slot& slot = slots_[key];
+        uint64_t sequence = slot.sequence.load(std::memory_order_relaxed);
+        slot.sequence.store(sequence + 1, std::memory_order_relaxed);
+        std::atomic_thread_fence(std::memory_order_release);
+        uint64_t words[WORDS] = {};
+        std::memcpy(words, &value, sizeof(Value));
+        for (size_t i = 0; i < WORDS; ++i) {
+            slot.words[i].store(words[i], std::memory_order_relaxed);
+        }
+        slot.sequence.store(sequence + 2, std::memory_order_release);
+        if (sequence == 0) {
+            // First value for this key: list it for forEach()
+            size_t count = numKeys_.load(std::memory_order_relaxed);
+            keys_[count].store(static_cast<uint32_t>(key), std::memory_order_relaxed);
+            numKeys_.store(count + 1, std::memory_order_release);
+        }
+        return sequence / 2 + 1;
+    }
+
+    // Copy the newest value for key into out; returns its version, or 0
+    // (out untouched) if the key was never written
+    uint64_t read(size_t key, Value& out) const {
+        if (key >= capacity_) {
+            return 0;
+        }
+        const Slot& slot = slots_[key];
+        uint64_t words[WORDS];
+        while (true) {
+            uint64_t before = slot.sequence.load(std::memory_order_acquire);
+            if (before & 1) {
+                continue;  // Write in progress
+            }
+            if (before == 0) {
+                return 0;
+            }
+            for (size_t i = 0; i < WORDS; ++i) {
+                words[i] = slot.words[i].load(std::memory_order_relaxed);
+            }
+            std::atomic_thread_fence(std::memory_order_acquire);
+            if (slot.sequence.load(std::memory_order_relaxed) == before) {
+                std::memcpy(&out, words, sizeof(Value));
+                return before / 2;
+            }
+        }
+    }
+
+    // Version of the newest value for key, 0 if never written
+    uint64_t version(size_t key) const {
+        return key < capacity_ ? slots_[key].sequence.load(std::memory_order_acquire) / 2 : 0;
+    }
+
+    // Call fn(key, value) with the newest value of every key written so
+    // far, in the order the keys were first written
+    template<typename Fn>
+    void forEach(Fn&& fn) const {
+        size_t count = numKeys_.load(std::memory_order_acquire);
+        Value value;
+        for (size_t i = 0; i < count; ++i) {
+            size_t key = keys_[i].load(std::memory_order_relaxed);
+            if (read(key, value) != 0) {
+                fn(key, value);
+            }
+        }
+    }
+
+    size_t size() const { return numKeys_.load(std::memory_order_acquire); }  // Keys written so far
+    size_t capacity() const { return capacity_; }
+
+private:
+    static constexpr size_t WORDS = (sizeof(Value) + sizeof(uint64_t) - 1) / sizeof(uint64_t);
+
+    struct Slot {
+        std::atomic<uint64_t> sequence{0};  // Odd while a write is in progress
+        std::atomic<uint64_t> words[WORDS];
+    };
+
+    size_t capacity_;
+    std::unique_ptr<Slot[]> slots_;
+    std::unique_ptr<std::atomic<uint32_t>[]> keys_;  // Written keys, in first-write order
+    std::atomic<size_t> numKeys_{0};
+};
+
+// Keys with an update one conflated subscriber has not taken yet. The
+// producer updates a LastValueCache, then marks the key; the subscriber
+// drains the marked keys and reads their newest values. A key is queued at
+// most once however often it changes, so the queue never holds more than
+// capacity entries and a hot key cannot build a backlog. One producer
+// thread and one consumer thread.
+class ConflationQueue {
+public:
+    explicit ConflationQueue(size_t capacity = InternConfig::MAX_SYMBOLS)
+        : capacity_(capacity)
+        , mask_(roundUpPow2(capacity) - 1)
+        , ring_(new std::atomic<uint32_t>[mask_ + 1]())
+        , pending_(new std::atomic<uint8_t>[capacity]())
+        , delivered_(new uint64_t[capacity]()) {}
+
+    ConflationQueue(const ConflationQueue&) = delete;
+    ConflationQueue& operator=(const ConflationQueue&) = delete;
+
+    // Producer, after updating the cache. False if the key was already
+    // queued, i.e. its previous update will never be delivered.
+    bool mark(size_t key) {
+        if (key >= capacity_) {
+            return false;
+        }
+        if (pending_[key].exchange(1, std::memory_order_acq_rel)) {
+            conflated_.fetch_add(1, std::memory_order_relaxed);
+            return false;
+        }
+        size_t tail = tail_.load(std::memory_order_relaxed);
+        ring_[tail & mask_].store(static_cast<uint32_t>(key), std::memory_order_relaxed);
+        tail_.store(tail + 1, std::memory_order_release);
+        return true;
+    }
+
+    // Consumer: copy up to max newest values of marked keys into out, in
+    // the order the keys were marked. A key marked again while being
+    // drained comes back on a later call, unless its value was already
+    // delivered.
+    template<typename Value>
+    size_t drain(const LastValueCache<Value>& cache, Value* out, size_t max) {
+        size_t count = 0;
+        size_t head = head_.load(std::memory_order_relaxed);
+        size_t tail = tail_.load(std::memory_order_acquire);
+        while (count < max && head != tail) {
+            uint32_t key = ring_[head & mask_].load(std::memory_order_relaxed);
+            ++head;
+            // Cleared before the read, so a later update marks the key again;
+            // acquiring the mark makes the update that set it visible
+            pending_[key].exchange(0, std::memory_order_acq_rel);
+            uint64_t version = cache.read(key, out[count]);
+            if (version != 0 && version != delivered_[key]) {
+                delivered_[key] = version;
+                ++count;
+            }
+            if (head == tail) {
+                tail = tail_.load(std::memory_order_acquire);
+            }
+        }
+        head_.store(head, std::memory_order_release);
+        deliveredCount_.fetch_add(count, std::memory_order_relaxed);
+        return count;
+    }
+
+    bool empty() const {
+        return head_.load(std::memory_order_acquire) == tail_.load(std::memory_order_acquire);
+    }
+
+    uint64_t getConflatedCount() const { return conflated_.load(std::memory_order_relaxed); }   // Updates superseded before delivery
+    uint64_t getDeliveredCount() const { return deliveredCount_.load(std::memory_order_relaxed); }
+
+private:
+    size_t capacity_;
+    size_t mask_;
+    std::unique_ptr<std::atomic<uint32_t>[]> ring_;  // Marked keys not yet drained, each once
+    std::unique_ptr<std::atomic<uint8_t>[]> pending_;
+    std::unique_ptr<uint64_t[]> delivered_;         // Consumer only: last version delivered per key
+    alignas(64) std::atomic<size_t> head_{0};
+    alignas(64) std::atomic<size_t> tail_{0};
+    std::atomic<uint64_t> conflated_{0};
+    std::atomic<uint64_t> deliveredCount_{0};
+
+    static size_t roundUpPow2(size_t value) {
+        size_t result = 1;
+        while (result < value) {
+            result <<= 1;
+        }
+        return result;
+    }
+};
+
+} // namespace wq::common
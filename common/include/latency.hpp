@@ -0,0 +1,355 @@
+#pragma once
+
+#include <algorithm>
+#include <array>
+#include <atomic>
+#include <chrono>
+#include <cstdint>
+#include <functional>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <string_view>
+#include <thread>
+#include <vector>
+#if defined(__x86_64__) || defined(__i386__)
+#include <x86intrin.h>
+#endif
+
+namespace wq::common {
+
+namespace LatencyConfig {
+    constexpr int SUB_BUCKET_BITS = 7;             // 64 steps per power of two: under 1.6% error
+    constexpr int MAX_MAGNITUDE = 40;              // Values clamp at 2^40 ns (about 18 minutes)
+    constexpr size_t MAX_PROBES = 64;              // Named probes per process
+    constexpr int CALIBRATION_MS = 10;             // TSC calibration against steady_clock
+}
+
+// Cycle counter read in a few nanoseconds. Converted to nanoseconds with a
+// scale measured once against steady_clock, when the first probe is
+// created. Intervals measured across threads rely on the invariant,
+// synchronized TSC of current x86 parts; a negative interval reads as 0.
+// Other architectures fall back to steady_clock.
+class TscClock {
+public:
+    static uint64_t now() noexcept {
+#if defined(__x86_64__) || defined(__i386__)
+        return __rdtsc();
+#else
+        return static_cast<uint64_t>(std::chrono::steady_clock::now().time_since_epoch().count());
+#endif
+    }
+
+    static double nsPerTick() {
+        static const double scale = calibrate();
+        return scale;
+    }
+
+    static uint64_t toNs(uint64_t ticks) { return static_cast<uint64_t>(static_cast<double>(ticks) * nsPerTick()); }
+
+    // Nanoseconds since a now() reading
+    static uint64_t elapsedNs(uint64_t since) {
+        uint64_t ticks = now();
+        return ticks > since ? toNs(ticks - since) : 0;
+    }
+
+private:
+    static double calibrate() {
+#if defined(__x86_64__) || defined(__i386__)
+        auto wallStart = std::chrono::steady_clock::now();
+        uint64_t start = now();
+        std::this_thread::sleep_for(std::chrono::milliseconds(LatencyConfig::CALIBRATION_MS));
+        uint64_t ticks = now() - start;
+        auto wallNs = std::chrono::duration_cast<std::chrono::nanoseconds>(
+            std::chrono::steady_clock::now() - wallStart).count();
+        return ticks > 0 ? static_cast<double>(wallNs) / static_cast<double>(ticks) : 1.0;
+#else
+        using Period = std::chrono::steady_clock::period;
+        return 1e9 * static_cast<double>(Period::num) / static_cast<double>(Period::den);
+#endif
+    }
+};
+
+// HDR-style log-linear buckets: exact below 2^SUB_BUCKET_BITS ns, then
+// 2^(SUB_BUCKET_BITS - 1) buckets per power of two
+namespace latency_detail {
+    constexpr uint64_t SUB_BUCKETS = uint64_t{1} << LatencyConfig::SUB_BUCKET_BITS;
+    constexpr uint64_t HALF_BUCKETS = SUB_BUCKETS / 2;
+    constexpr uint64_t MAX_VALUE = (uint64_t{1} << LatencyConfig::MAX_MAGNITUDE) - 1;
+    constexpr size_t NUM_BUCKETS =
+        (LatencyConfig::MAX_MAGNITUDE - LatencyConfig::SUB_BUCKET_BITS + 1) * HALF_BUCKETS + HALF_BUCKETS;
+
+    constexpr size_t bucketIndex(uint64_t value) {
+        value = value < MAX_VALUE ? value : MAX_VALUE;
+        if (value < SUB_BUCKETS) {
+            return static_cast<size_t>(value);
+        }
+        int magnitude = 63 - __builtin_clzll(value);
+        int shift = magnitude - LatencyConfig::SUB_BUCKET_BITS + 1;
+        return static_cast<size_t>(shift * HALF_BUCKETS + (value >> shift));
+    }
+
+    // Largest value that lands in the bucket
+    constexpr uint64_t bucketUpperBound(size_t index) {
+        if (index < SUB_BUCKETS) {
+            return index;
+        }
+        uint64_t shift = index / HALF_BUCKETS - 1;
+        uint64_t sub = index - shift * HALF_BUCKETS;
+        return ((sub + 1) << shift) - 1;
+    }
+}
+
+// One thread's latencies for one probe. Only the owning thread records,
+// so a record is a few relaxed loads and stores, with no atomic
+// read-modify-write and no lock. Any thread may read it at any time.
+class LatencyHistogram {
+public:
+    void record(uint64_t ns) noexcept {
+        bump(counts_[latency_detail::bucketIndex(ns)], 1);
+        bump(count_, 1);
+        bump(sumNs_, ns);
+        if (ns > maxNs_.load(std::memory_order_relaxed)) {
+            maxNs_.store(ns, std::memory_order_relaxed);
+        }
+        if (ns < minNs_.load(std::memory_order_relaxed)) {
+            minNs_.store(ns, std::memory_order_relaxed);
+        }
+    }
+
+private:
+    std::array<std::atomic<uint64_t>, latency_detail::NUM_BUCKETS> counts_{};
+    std::atomic<uint64_t> count_{0};
+    std::atomic<uint64_t> sumNs_{0};
+    std::atomic<uint64_t> minNs_{UINT64_MAX};
+    std::atomic<uint64_t> maxNs_{0};
+
+    static void bump(std::atomic<uint64_t>& counter, uint64_t amount) {
+        counter.store(counter.load(std::memory_order_relaxed) + amount, std::memory_order_relaxed);
+    }
+
+    friend struct LatencyStats;
+};
+
+// Sum of a probe's per-thread histograms at one point in time
+struct LatencyStats {
+    std::vector<uint64_t> counts = std::vector<uint64_t>(latency_detail::NUM_BUCKETS, 0);
+    uint64_t count{0};
+    uint64_t sumNs{0};
+    uint64_t minNs{0};
+    uint64_t maxNs{0};
+
+    void add(const LatencyHistogram& histogram) {
+        uint64_t added = 0;
+        for (size_t i = 0; i < counts.size(); ++i) {
+            uint64_t value = histogram.counts_[i].load(std::memory_order_relaxed);
+            counts[i] += value;
+            added += value;
+        }
+        if (added == 0) {
+            return;
+        }
+        minNs = count == 0 ? histogram.minNs_.load(std::memory_order_relaxed)
+                           : std::min(minNs, histogram.minNs_.load(std::memory_order_relaxed));
+        maxNs = std::max(maxNs, histogram.maxNs_.load(std::memory_order_relaxed));
+        count += added;
+        sumNs += histogram.sumNs_.load(std::memory_order_relaxed);
+    }
+
+    // Smallest bucket bound at or above the given fraction of samples
+    uint64_t percentileNs(double fraction) const {
+        if (count == 0) {
+            return 0;
+        }
+        uint64_t rank = static_cast<uint64_t>(fraction * static_cast<double>(count));
+        rank = std::clamp<uint64_t>(rank, 1, count);
+        uint64_t seen = 0;
+        for (size_t i = 0; i < counts.size(); ++i) {
+            seen += counts[i];
+            if (seen >= rank) {
+                return std::min(latency_detail::bucketUpperBound(i), maxNs);
+            }
+        }
+        return maxNs;
+    }
+
+    double meanNs() const { return count > 0 ? static_cast<double>(sumNs) / static_cast<double>(count) : 0.0; }
+};
+
+// A named measurement point. Each thread that records gets its own
+// histogram on first use; reads merge them all.
+class LatencyProbe {
+public:
+    LatencyProbe(std::string name, size_t id) : name_(std::move(name)), id_(id) {}
+
+    LatencyProbe(const LatencyProbe&) = delete;
+    LatencyProbe& operator=(const LatencyProbe&) = delete;
+
+    void record(uint64_t ns) { threadHistogram().record(ns); }
+
+    // Record the time since a TscClock::now() reading
+    void recordSince(uint64_t startTicks) { record(TscClock::elapsedNs(startTicks)); }
+
+    LatencyStats collect() const {
+        LatencyStats stats;
+        std::lock_guard<std::mutex> lock(mutex_);
+        for (const auto& histogram : histograms_) {
+            stats.add(*histogram);
+        }
+        return stats;
+    }
+
+    const std::string& name() const { return name_; }
+
+private:
+    std::string name_;
+    size_t id_;
+    mutable std::mutex mutex_;  // Guards histograms_; taken once per thread, and by readers
+    std::vector<std::unique_ptr<LatencyHistogram>> histograms_;  // Kept after their thread exits
+
+    LatencyHistogram& threadHistogram() {
+        thread_local std::array<LatencyHistogram*, LatencyConfig::MAX_PROBES> slots{};
+        LatencyHistogram*& slot = slots[id_];
+        if (!slot) {
+            std::lock_guard<std::mutex> lock(mutex_);
+            histograms_.push_back(std::make_unique<LatencyHistogram>());
+            slot = histograms_.back().get();
+        }
+        return *slot;
+    }
+};
+
+// Percentiles of one probe, as exported
+struct LatencySummary {
+    std::string name;
+    uint64_t count{0};
+    uint64_t sumNs{0};
+    double meanNs{0};
+    uint64_t minNs{0};
+    uint64_t p50Ns{0};
+    uint64_t p90Ns{0};
+    uint64_t p99Ns{0};
+    uint64_t p999Ns{0};
+    uint64_t maxNs{0};
+};
+
+// Process-wide probes and exported counters, reached through metrics().
+// Probes live as long as the process, so call sites can hold on to the
+// reference.
+class MetricsRegistry {
+public:
+    using CounterFn = std::function<double()>;
+
+    MetricsRegistry(const MetricsRegistry&) = delete;
+    MetricsRegistry& operator=(const MetricsRegistry&) = delete;
+
+    // The probe with this name, created on first use. Beyond MAX_PROBES
+    // names, further names share one overflow probe.
+    LatencyProbe& probe(std::string_view name) {
+        std::lock_guard<std::mutex> lock(mutex_);
+        for (const auto& probe : probes_) {
+            if (probe->name() == name) {
+                return *probe;
+            }
+        }
+        if (probes_.size() + 1 >= LatencyConfig::MAX_PROBES) {
+            name = "overflow";
+            for (const auto& probe : probes_) {
+                if (probe->name() == name) {
+                    return *probe;
+                }
+            }
+        }
+        probes_.push_back(std::make_unique<LatencyProbe>(std::string(name), probes_.size()));
+        return *probes_.back();
+    }
+
+    // Export a value read when metrics are collected, e.g. an existing
+    // atomic counter. counter must stay callable until the process exits
+    // or the name is replaced, and must not call back into the registry.
+    void setCounter(std::string_view name, CounterFn counter) {
+        std::lock_guard<std::mutex> lock(mutex_);
+        for (auto& entry : counters_) {
+            if (entry.first == name) {
+                entry.second = std::move(counter);
+                return;
+            }
+        }
+        counters_.emplace_back(std::string(name), std::move(counter));
+    }
+
+    std::vector<LatencySummary> summarize() const {
+        std::vector<LatencyProbe*> probes;
+        {
+            std::lock_guard<std::mutex> lock(mutex_);
+            for (const auto& probe : probes_) {
+                probes.push_back(probe.get());
+            }
+        }
+        std::vector<LatencySummary> summaries;
+        summaries.reserve(probes.size());
+        for (LatencyProbe* probe : probes) {
+            LatencyStats stats = probe->collect();
+            LatencySummary summary;
+            summary.name = probe->name();
+            summary.count = stats.count;
+            summary.sumNs = stats.sumNs;
+            summary.meanNs = stats.meanNs();
+            summary.minNs = stats.minNs;
+            summary.p50Ns = stats.percentileNs(0.50);
+            summary.p90Ns = stats.percentileNs(0.90);
+            summary.p99Ns = stats.percentileNs(0.99);
+            summary.p999Ns = stats.percentileNs(0.999);
+            summary.maxNs = stats.maxNs;
+            summaries.push_back(std::move(summary));
+        }
+        return summaries;
+    }
+
+    std::vector<std::pair<std::string, double>> readCounters() const {
+        std::lock_guard<std::mutex> lock(mutex_);
+        std::vector<std::pair<std::string, double>> values;
+        values.reserve(counters_.size());
+        for (const auto& entry : counters_) {
+            values.emplace_back(entry.first, entry.second());
+        }
+        return values;
+    }
+
+private:
+    // One instance, as probe ids index every thread's histogram slots
+    MetricsRegistry() { TscClock::nsPerTick(); }  // Calibrate before the first record
+    friend MetricsRegistry& metrics();
+
+    mutable std::mutex mutex_;
+    std::vector<std::unique_ptr<LatencyProbe>> probes_;
+    std::vector<std::pair<std::string, CounterFn>> counters_;
+};
+
+MetricsRegistry& metrics();
+
+// Global registry shared by every stage of the process
+inline MetricsRegistry& metrics() {
+    static MetricsRegistry registry;
+    return registry;
+}
+
+inline LatencyProbe& latencyProbe(std::string_view name) {
+    return metrics().probe(name);
+}
+
+// Records the lifetime of the scope into a probe
+class ScopedLatency {
+public:
+    explicit ScopedLatency(LatencyProbe& probe) : probe_(probe), start_(TscClock::now()) {}
+    ~ScopedLatency() { probe_.recordSince(start_); }
+
+    ScopedLatency(const ScopedLatency&) = delete;
+    ScopedLatency& operator=(const ScopedLatency&) = delete;
+
+private:
+    LatencyProbe& probe_;
+    uint64_t start_;
+};
+
+} // namespace wq::common
@@ -0,0 +1,184 @@
+#pragma once
+
+#include "latency.hpp"
+#include <arpa/inet.h>
+#include <netinet/in.h>
+#include <poll.h>
+#include <sys/socket.h>
+#include <unistd.h>
+#include <atomic>
+#include <cerrno>
+#include <chrono>
+#include <cstdint>
+#include <cstring>
+#include <iostream>
+#include <mutex>
+#include <sstream>
+#include <string>
+#include <thread>
+
+namespace wq::common {
+
+namespace MetricsConfig {
+    constexpr uint16_t DATA_FEED_PORT = 9101;
+    constexpr uint16_t ALPHA_ENGINE_PORT = 9102;
+    constexpr uint16_t SIGNAL_AGGREGATOR_PORT = 9103;
+    constexpr uint16_t RISK_GUARDIAN_PORT = 9104;
+    constexpr int REFRESH_INTERVAL_MS = 1000;   // Percentiles are recomputed this often
+    constexpr int POLL_TIMEOUT_MS = 100;        // Bounds how long stop() waits
+    constexpr size_t MAX_REQUEST_BYTES = 4096;
+}
+
+// Probe percentiles and counters in the Prometheus text format, e.g.
+//   wq_latency_ns{probe="risk.check",quantile="0.99"} 412
+inline std::string formatMetrics(const MetricsRegistry& registry) {
+    std::ostringstream out;
+    out << "# TYPE wq_latency_ns summary\n";
+    for (const LatencySummary& summary : registry.summarize()) {
+        const std::string label = "probe=\"" + summary.name + "\"";
+        const std::pair<const char*, uint64_t> quantiles[] = {
+            {"0.5", summary.p50Ns}, {"0.9", summary.p90Ns}, {"0.99", summary.p99Ns},
+            {"0.999", summary.p999Ns}, {"1", summary.maxNs}};
+        for (const auto& [quantile, value] : quantiles) {
+            out << "wq_latency_ns{" << label << ",quantile=\"" << quantile << "\"} " << value << "\n";
+        }
+        out << "wq_latency_ns_sum{" << label << "} " << summary.sumNs << "\n";
+        out << "wq_latency_ns_count{" << label << "} " << summary.count << "\n";
+    }
+    for (const auto& [name, value] : registry.readCounters()) {
+        std::string metric = "wq_" + name;
+        for (char& c : metric) {
+            if (c == '.' || c == '-') {
+                c = '_';
+            }
+        }
+        out << "# TYPE " << metric << " gauge\n" << metric << " " << value << "\n";
+    }
+    return out.str();
+}
+
+// Plain HTTP endpoint answering every request with formatMetrics(), from
+// one background thread. The text is refreshed every REFRESH_INTERVAL_MS,
+// so scrapes do not each merge the histograms, and getReport() gives the
+// same text for logging.
+class MetricsServer {
+public:
+    explicit MetricsServer(uint16_t port, MetricsRegistry& registry = metrics())
+        : port_(port), registry_(registry) {}
+
+    ~MetricsServer() { stop(); }
+
+    MetricsServer(const MetricsServer&) = delete;
+    MetricsServer& operator=(const MetricsServer&) = delete;
+
+    // Listen on all interfaces; false if the port cannot be bound
+    bool start() {
+        if (running_.load()) {
+            return true;
+        }
+        int fd = socket(AF_INET, SOCK_STREAM, 0);
+        if (fd < 0) {
+            std::cerr << "Failed to create metrics socket: " << std::strerror(errno) << "\n";
+            return false;
+        }
+        int reuse = 1;
+        setsockopt(fd, SOL_SOCKET, SO_REUSEADDR, &reuse, sizeof(reuse));
+        struct sockaddr_in addr;
+        std::memset(&addr, 0, sizeof(addr));
+        addr.sin_family = AF_INET;
+        addr.sin_addr.s_addr = htonl(INADDR_ANY);
+        addr.sin_port = htons(port_);
+        if (bind(fd, reinterpret_cast<struct sockaddr*>(&addr), sizeof(addr)) < 0 || listen(fd, 16) < 0) {
+            std::cerr << "Failed to listen for metrics on port " << port_ << ": " << std::strerror(errno) << "\n";
+            close(fd);
+            return false;
+        }
+        socklen_t length = sizeof(addr);
+        if (getsockname(fd, reinterpret_cast<struct sockaddr*>(&addr), &length) == 0) {
+            port_ = ntohs(addr.sin_port);  // Resolves port 0
+        }
+        listenFd_ = fd;
+        refresh();
+        running_.store(true);
+        thread_ = std::thread([this] { serve(); });
+        return true;
+    }
+
+    void stop() {
+        if (!running_.exchange(false)) {
+            return;
+        }
+        if (thread_.joinable()) {
+            thread_.join();
+        }
+        close(listenFd_);
+        listenFd_ = -1;
+    }
+
+    // Text of the last refresh
+    std::string getReport() const {
+        std::lock_guard<std::mutex> lock(reportMutex_);
+        return report_;
+    }
+
+    uint16_t getPort() const { return port_; }
+    uint64_t getRequestCount() const { return requests_.load(std::memory_order_relaxed); }
+
+private:
+    uint16_t port_;
+    MetricsRegistry& registry_;
+    int listenFd_{-1};
+    std::thread thread_;
+    std::atomic<bool> running_{false};
+    std::atomic<uint64_t> requests_{0};
+    mutable std::mutex reportMutex_;
+    std::string report_;
+
+    void refresh() {
+        std::string report = formatMetrics(registry_);
+        std::lock_guard<std::mutex> lock(reportMutex_);
+        report_ = std::move(report);
+    }
+
+    void serve() {
+        auto nextRefresh = std::chrono::steady_clock::now() + std::chrono::milliseconds(MetricsConfig::REFRESH_INTERVAL_MS);
+        while (running_.load()) {
+            struct pollfd fds = {listenFd_, POLLIN, 0};
+            int ready = poll(&fds, 1, MetricsConfig::POLL_TIMEOUT_MS);
+            if (std::chrono::steady_clock::now() >= nextRefresh) {
+                refresh();
+                nextRefresh += std::chrono::milliseconds(MetricsConfig::REFRESH_INTERVAL_MS);
+            }
+            if (ready > 0 && (fds.revents & POLLIN)) {
+                int client = accept(listenFd_, nullptr, nullptr);
+                if (client >= 0) {
+                    respond(client);
+                    close(client);
+                }
+            }
+        }
+    }
+
+    // Any request gets the report; the client is not waited on for long
+    void respond(int client) {
+        char request[MetricsConfig::MAX_REQUEST_BYTES];
+        struct pollfd fds = {client, POLLIN, 0};
+        if (poll(&fds, 1, MetricsConfig::POLL_TIMEOUT_MS) > 0) {
+            (void)recv(client, request, sizeof(request), MSG_DONTWAIT);
+        }
+        std::string body = getReport();
+        std::string response = "HTTP/1.0 200 OK\r\nContent-Type: text/plain; version=0.0.4\r\nContent-Length: " +
+                               std::to_string(body.size()) + "\r\nConnection: close\r\n\r\n" + body;
+        size_t sent = 0;
+        while (sent < response.size()) {
+            ssize_t written = send(client, response.data() + sent, response.size() - sent, MSG_NOSIGNAL);
+            if (written <= 0) {
+                break;
+            }
+            sent += static_cast<size_t>(written);
+        }
+        requests_.fetch_add(1, std::memory_order_relaxed);
+    }
+};
+
+} // namespace wq::common
@@ -0,0 +1,239 @@
+#pragma once
+
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <type_traits>
+#include <utility>
+
+namespace wq::common {
+
+// Destructive-interference distance on every target we deploy to
+constexpr size_t CACHE_LINE_SIZE = 64;
+
+// Bounded single-producer / single-consumer ring.
+//
+// Head and tail live on their own cache lines and each side keeps a cached
+// copy of the other's index, so the steady state touches only local lines.
+// Batch calls publish or release a whole run of slots with one store.
+// The slots are inline, so large rings belong on the heap.
+template<typename T, size_t Capacity>
+class SpscRing {
+    static_assert(Capacity >= 2 && (Capacity & (Capacity - 1)) == 0,
+                  "ring capacity must be a power of two");
+    static_assert(std::is_default_constructible_v<T> && std::is_move_assignable_v<T>,
+                  "ring elements are stored in preconstructed slots");
+
+public:
+    using value_type = T;
+    static constexpr size_t CAPACITY = Capacity;
+
+    SpscRing() = default;
+
+    // Deleted copy/move - producers and consumers hold references
+    SpscRing(const SpscRing&) = delete;
+    SpscRing& operator=(const SpscRing&) = delete;
+
+    // Producer side
+    bool tryPush(const T& item) {
+        T copy = item;
+        return tryPush(std::move(copy));
+    }
+
+    bool tryPush(T&& item) {
+        size_t tail = tail_.load(std::memory_order_relaxed);
+        if (tail - cachedHead_ >= Capacity) {
+            cachedHead_ = head_.load(std::memory_order_acquire);
+            if (tail - cachedHead_ >= Capacity) {
+                return false;
+            }
+        }
+        slots_[tail & MASK] = std::move(item);
+        tail_.store(tail + 1, std::memory_order_release);
+        return true;
+    }
+
+    // Copy up to count items in; returns how many fit
+    size_t pushBatch(const T* items, size_t count) {
+        size_t tail = tail_.load(std::memory_order_relaxed);
+        size_t free = Capacity - (tail - cachedHead_);
+        if (free < count) {
+            cachedHead_ = head_.load(std::memory_order_acquire);
+            free = Capacity - (tail - cachedHead_);
+        }
+        size_t n = count < free ? count : free;
+        for (size_t i = 0; i < n; ++i) {
+            slots_[(tail + i) & MASK] = items[i];
+        }
+        if (n > 0) {
+            tail_.store(tail + n, std::memory_order_release);
+        }
+        return n;
+    }
+
+    // Consumer side
+    bool tryPop(T& out) {
+        size_t head = head_.load(std::memory_order_relaxed);
+        if (head == cachedTail_) {
+            cachedTail_ = tail_.load(std::memory_order_acquire);
+            if (head == cachedTail_) {
+                return false;
+            }
+        }
+        out = std::move(slots_[head & MASK]);
+        head_.store(head + 1, std::memory_order_release);
+        return true;
+    }
+
+    // Move up to maxCount items out; returns how many were taken
+    size_t popBatch(T* out, size_t maxCount) {
+        size_t head = head_.load(std::memory_order_relaxed);
+        size_t available = cachedTail_ - head;
+        if (available < maxCount) {
+            cachedTail_ = tail_.load(std::memory_order_acquire);
+            available = cachedTail_ - head;
+        }
+        size_t n = maxCount < available ? maxCount : available;
+        for (size_t i = 0; i < n; ++i) {
+            out[i] = std::move(slots_[(head + i) & MASK]);
+        }
+        if (n > 0) {
+            head_.store(head + n, std::memory_order_release);
+        }
+        return n;
+    }
+
+    // Approximate when called concurrently with either side
+    size_t size() const {
+        return tail_.load(std::memory_order_acquire) - head_.load(std::memory_order_acquire);
+    }
+
+    bool empty() const { return size() == 0; }
+
+private:
+    static constexpr size_t MASK = Capacity - 1;
+
+    // Consumer-owned line
+    alignas(CACHE_LINE_SIZE) std::atomic<size_t> head_{0};
+    size_t cachedTail_{0};
+
+    // Producer-owned line
+    alignas(CACHE_LINE_SIZE) std::atomic<size_t> tail_{0};
+    size_t cachedHead_{0};
+
+    alignas(CACHE_LINE_SIZE) T slots_[Capacity];
+};
+
+// Bounded multi-producer / multi-consumer ring (per-slot sequence numbers).
+//
+// Each slot carries the position it is ready for, so producers and consumers
+// claim positions with one CAS and never wait on each other except when the
+// ring is full or empty. Batch calls claim slot by slot, since a contiguous
+// range is not guaranteed free once several consumers release out of order.
+template<typename T, size_t Capacity>
+class MpmcRing {
+    static_assert(Capacity >= 2 && (Capacity & (Capacity - 1)) == 0,
+                  "ring capacity must be a power of two");
+    static_assert(std::is_default_constructible_v<T> && std::is_move_assignable_v<T>,
+                  "ring elements are stored in preconstructed slots");
+
+public:
+    using value_type = T;
+    static constexpr size_t CAPACITY = Capacity;
+
+    MpmcRing() {
+        for (size_t i = 0; i < Capacity; ++i) {
+            slots_[i].sequence.store(i, std::memory_order_relaxed);
+        }
+    }
+
+    // Deleted copy/move - producers and consumers hold references
+    MpmcRing(const MpmcRing&) = delete;
+    MpmcRing& operator=(const MpmcRing&) = delete;
+
+    bool tryPush(const T& item) {
+        T copy = item;
+        return tryPush(std::move(copy));
+    }
+
+    bool tryPush(T&& item) {
+        size_t position = enqueuePos_.load(std::memory_order_relaxed);
+        while (true) {
+            Slot& slot = slots_[position & MASK];
+            size_t sequence = slot.sequence.load(std::memory_order_acquire);
+            intptr_t diff = static_cast<intptr_t>(sequence) - static_cast<intptr_t>(position);
+            if (diff == 0) {
+                if (enqueuePos_.compare_exchange_weak(position, position + 1,
+                                                      std::memory_order_relaxed)) {
+                    slot.value = std::move(item);
+                    slot.sequence.store(position + 1, std::memory_order_release);
+                    return true;
+                }
+            } else if (diff < 0) {
+                return false;  // Full
+            } else {
+                position = enqueuePos_.load(std::memory_order_relaxed);
+            }
+        }
+    }
+
+    size_t pushBatch(const T* items, size_t count) {
+        size_t pushed = 0;
+        while (pushed < count && tryPush(items[pushed])) {
+            ++pushed;
+        }
+        return pushed;
+    }
+
+    bool tryPop(T& out) {
+        size_t position = dequeuePos_.load(std::memory_order_relaxed);
+        while (true) {
+            Slot& slot = slots_[position & MASK];
+            size_t sequence = slot.sequence.load(std::memory_order_acquire);
+            intptr_t diff = static_cast<intptr_t>(sequence) - static_cast<intptr_t>(position + 1);
+            if (diff == 0) {
+                if (dequeuePos_.compare_exchange_weak(position, position + 1,
+                                                      std::memory_order_relaxed)) {
+                    out = std::move(slot.value);
+                    slot.sequence.store(position + Capacity, std::memory_order_release);
+                    return true;
+                }
+            } else if (diff < 0) {
+                return false;  // Empty
+            } else {
+                position = dequeuePos_.load(std::memory_order_relaxed);
+            }
+        }
+    }
+
+    size_t popBatch(T* out, size_t maxCount) {
+        size_t popped = 0;
+        while (popped < maxCount && tryPop(out[popped])) {
+            ++popped;
+        }
+        return popped;
+    }
+
+    // Approximate when called concurrently
+    size_t size() const {
+        size_t enqueued = enqueuePos_.load(std::memory_order_acquire);
+        size_t dequeued = dequeuePos_.load(std::memory_order_acquire);
+        return enqueued > dequeued ? enqueued - dequeued : 0;
+    }
+
+    bool empty() const { return size() == 0; }
+
+private:
+    static constexpr size_t MASK = Capacity - 1;
+
+    struct Slot {
+        std::atomic<size_t> sequence;
+        T value;
+    };
+
+    alignas(CACHE_LINE_SIZE) std::atomic<size_t> enqueuePos_{0};
+    alignas(CACHE_LINE_SIZE) std::atomic<size_t> dequeuePos_{0};
+    alignas(CACHE_LINE_SIZE) Slot slots_[Capacity];
+};
+
+} // namespace wq::common
@@ -0,0 +1,113 @@
+#pragma once
+
+#include "topology.hpp"
+#include <atomic>
+#include <chrono>
+#include <cstddef>
+#include <functional>
+#include <memory>
+#include <string>
+#include <string_view>
+#include <thread>
+
+namespace wq::common {
+
+namespace RingConfig {
+    constexpr size_t DEFAULT_CONSUME_BATCH = 256;
+    constexpr int SPIN_ITERATIONS = 1024;     // Empty polls before yielding
+    constexpr int YIELD_ITERATIONS = 64;      // Yields before sleeping
+    constexpr int64_t IDLE_SLEEP_US = 50;
+}
+
+// Dedicated thread that drains a ring in batches and hands each batch to a
+// handler. It spins, then yields, then sleeps while the ring stays empty,
+// so a busy stage pays no wakeup latency and an idle one burns no core.
+// stop() drains whatever is still queued before joining. With a stage set,
+// the thread runs where the process topology places that stage.
+template<typename Ring>
+class RingConsumer {
+public:
+    using value_type = typename Ring::value_type;
+    using BatchHandler = std::function<void(value_type* items, size_t count)>;
+
+    RingConsumer(Ring& ring, BatchHandler handler,
+                 size_t batchSize = RingConfig::DEFAULT_CONSUME_BATCH)
+        : ring_(ring)
+        , handler_(std::move(handler))
+        , batchSize_(batchSize > 0 ? batchSize : 1)
+        , batch_(std::make_unique<value_type[]>(batchSize_)) {}
+
+    ~RingConsumer() { stop(); }
+
+    // Deleted copy/move - the worker thread captures this
+    RingConsumer(const RingConsumer&) = delete;
+    RingConsumer& operator=(const RingConsumer&) = delete;
+
+    // Before start(): the topology stage the thread belongs to
+    void setStage(std::string_view stage) { stage_ = stage; }
+
+    void start() {
+        if (running_.exchange(true)) {
+            return;
+        }
+        thread_ = topology().startThread(stage_, 0, [this]() { run(); });
+    }
+
+    void stop() {
+        if (!running_.exchange(false)) {
+            return;
+        }
+        if (thread_.joinable()) {
+            thread_.join();
+        }
+    }
+
+    bool isRunning() const { return running_.load(); }
+    uint64_t getConsumedCount() const { return consumed_.load(std::memory_order_relaxed); }
+
+private:
+    Ring& ring_;
+    BatchHandler handler_;
+    size_t batchSize_;
+    std::unique_ptr<value_type[]> batch_;
+    std::string stage_;
+    std::thread thread_;
+    std::atomic<bool> running_{false};
+    std::atomic<uint64_t> consumed_{0};
+
+    // Returns false once the ring was empty
+    bool drainOnce() {
+        size_t count = ring_.popBatch(batch_.get(), batchSize_);
+        if (count == 0) {
+            return false;
+        }
+        handler_(batch_.get(), count);
+        consumed_.fetch_add(count, std::memory_order_relaxed);
+        return true;
+    }
+
+    void run() {
+        int idle = 0;
+        while (running_.load(std::memory_order_relaxed)) {
+            if (drainOnce()) {
+                idle = 0;
+                continue;
+            }
+            ++idle;
+            if (idle <= RingConfig::SPIN_ITERATIONS) {
+                continue;
+            }
+            if (idle <= RingConfig::SPIN_ITERATIONS + RingConfig::YIELD_ITERATIONS) {
+                std::this_thread::yield();
+            } else {
+                std::this_thread::sleep_for(std::chrono::microseconds(RingConfig::IDLE_SLEEP_US));
+            }
+        }
+
+        // Deliver everything published before stop()
+        while (drainOnce()) {
+        }
+    }
+};
+
+} // namespace wq::common
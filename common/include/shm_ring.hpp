@@ -0,0 +1,242 @@
+#pragma once
+
+#include "ring_buffer.hpp"
+#include "topology.hpp"
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <fcntl.h>
+#include <signal.h>
+#include <unistd.h>
+#include <atomic>
+#include <cerrno>
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <new>
+#include <string>
+#include <string_view>
+#include <type_traits>
+
+namespace wq::common {
+
+namespace ShmConfig {
+    constexpr uint64_t MAGIC = 0x57514950434E4731ULL;  // "WQIPCNG1"
+    constexpr uint32_t VERSION = 1;
+}
+
+// Single-producer / single-consumer ring of fixed-layout records in a POSIX
+// shared-memory segment, for services running on the same host.
+//
+// The producer create()s the segment (replacing any stale one) and unlinks
+// it on destruction; the consumer open()s it and checks that the layout and
+// record type match. Record type T must be trivially copyable because both
+// processes read the same bytes. Indices use the same cached head/tail
+// scheme as SpscRing, with the atomics placed in the mapping itself.
+template<typename T, size_t Capacity>
+class ShmRing {
+    static_assert(Capacity >= 2 && (Capacity & (Capacity - 1)) == 0,
+                  "ring capacity must be a power of two");
+    static_assert(std::is_trivially_copyable_v<T>,
+                  "shared-memory records must be trivially copyable");
+    static_assert(std::atomic<uint64_t>::is_always_lock_free,
+                  "cross-process indices need lock-free atomics");
+
+public:
+    using value_type = T;
+    static constexpr size_t CAPACITY = Capacity;
+
+    // Bytes of the segment: header and records
+    static constexpr size_t mappingSize() { return MAPPING_SIZE; }
+
+    ~ShmRing() {
+        if (header_) {
+            munmap(header_, MAPPING_SIZE);
+        }
+        if (owner_) {
+            shm_unlink(name_.c_str());
+        }
+    }
+
+    // Deleted copy/move - the mapping is owned by this object
+    ShmRing(const ShmRing&) = delete;
+    ShmRing& operator=(const ShmRing&) = delete;
+
+    // Producer side: create a fresh segment, its pages preferring node
+    // unless it is -1; nullptr on failure
+    static std::unique_ptr<ShmRing> create(std::string_view name, int node = -1) {
+        std::string path(name);
+        shm_unlink(path.c_str());  // Drop a segment left behind by a crashed producer
+
+        int fd = shm_open(path.c_str(), O_CREAT | O_EXCL | O_RDWR, 0660);
+        if (fd < 0) {
+            return nullptr;
+        }
+        if (ftruncate(fd, static_cast<off_t>(MAPPING_SIZE)) != 0) {
+            close(fd);
+            shm_unlink(path.c_str());
+            return nullptr;
+        }
+        void* mapping = mmap(nullptr, MAPPING_SIZE, PROT_READ | PROT_WRITE, MAP_SHARED, fd, 0);
+        close(fd);
+        if (mapping == MAP_FAILED) {
+            shm_unlink(path.c_str());
+            return nullptr;
+        }
+        bindToNode(mapping, MAPPING_SIZE, node);  // Before the first page is touched
+
+        auto* header = new (mapping) Header();
+        header->version = ShmConfig::VERSION;
+        header->recordSize = static_cast<uint32_t>(sizeof(T));
+        header->capacity = Capacity;
+        header->producerPid = static_cast<int32_t>(getpid());
+        header->magic.store(ShmConfig::MAGIC, std::memory_order_release);  // Publish last
+
+        return std::unique_ptr<ShmRing>(new ShmRing(std::move(path), header, true));
+    }
+
+    // Consumer side: attach to a live producer's segment; nullptr if there is
+    // none or its layout does not match this record type
+    static std::unique_ptr<ShmRing> open(std::string_view name) {
+        std::string path(name);
+        int fd = shm_open(path.c_str(), O_RDWR, 0);
+        if (fd < 0) {
+            return nullptr;
+        }
+        struct stat info;
+        if (fstat(fd, &info) != 0 || static_cast<size_t>(info.st_size) < MAPPING_SIZE) {
+            close(fd);
+            return nullptr;
+        }
+        void* mapping = mmap(nullptr, MAPPING_SIZE, PROT_READ | PROT_WRITE, MAP_SHARED, fd, 0);
+        close(fd);
+        if (mapping == MAP_FAILED) {
+            return nullptr;
+        }
+
+        auto* header = static_cast<Header*>(mapping);
+        bool compatible = header->magic.load(std::memory_order_acquire) == ShmConfig::MAGIC
+            && header->version == ShmConfig::VERSION
+            && header->recordSize == sizeof(T)
+            && header->capacity == Capacity;
+        if (!compatible) {
+            munmap(mapping, MAPPING_SIZE);
+            return nullptr;
+        }
+
+        auto ring = std::unique_ptr<ShmRing>(new ShmRing(std::move(path), header, false));
+        if (!ring->isProducerAlive()) {
+            return nullptr;
+        }
+        return ring;
+    }
+
+    // True if the process that created the segment is still running
+    bool isProducerAlive() const {
+        pid_t pid = static_cast<pid_t>(header_->producerPid);
+        return pid > 0 && (kill(pid, 0) == 0 || errno == EPERM);
+    }
+
+    // Producer side
+    bool tryPush(const T& item) {
+        uint64_t tail = header_->tail.load(std::memory_order_relaxed);
+        if (tail - cachedHead_ >= Capacity) {
+            cachedHead_ = header_->head.load(std::memory_order_acquire);
+            if (tail - cachedHead_ >= Capacity) {
+                return false;
+            }
+        }
+        records_[tail & MASK] = item;
+        header_->tail.store(tail + 1, std::memory_order_release);
+        return true;
+    }
+
+    size_t pushBatch(const T* items, size_t count) {
+        uint64_t tail = header_->tail.load(std::memory_order_relaxed);
+        size_t free = Capacity - static_cast<size_t>(tail - cachedHead_);
+        if (free < count) {
+            cachedHead_ = header_->head.load(std::memory_order_acquire);
+            free = Capacity - static_cast<size_t>(tail - cachedHead_);
+        }
+        size_t n = count < free ? count : free;
+        for (size_t i = 0; i < n; ++i) {
+            records_[(tail + i) & MASK] = items[i];
+        }
+        if (n > 0) {
+            header_->tail.store(tail + n, std::memory_order_release);
+        }
+        return n;
+    }
+
+    // Consumer side
+    bool tryPop(T& out) {
+        uint64_t head = header_->head.load(std::memory_order_relaxed);
+        if (head == cachedTail_) {
+            cachedTail_ = header_->tail.load(std::memory_order_acquire);
+            if (head == cachedTail_) {
+                return false;
+            }
+        }
+        out = records_[head & MASK];
+        header_->head.store(head + 1, std::memory_order_release);
+        return true;
+    }
+
+    size_t popBatch(T* out, size_t maxCount) {
+        uint64_t head = header_->head.load(std::memory_order_relaxed);
+        size_t available = static_cast<size_t>(cachedTail_ - head);
+        if (available < maxCount) {
+            cachedTail_ = header_->tail.load(std::memory_order_acquire);
+            available = static_cast<size_t>(cachedTail_ - head);
+        }
+        size_t n = maxCount < available ? maxCount : available;
+        for (size_t i = 0; i < n; ++i) {
+            out[i] = records_[(head + i) & MASK];
+        }
+        if (n > 0) {
+            header_->head.store(head + n, std::memory_order_release);
+        }
+        return n;
+    }
+
+    size_t size() const {
+        return static_cast<size_t>(header_->tail.load(std::memory_order_acquire)
+                                   - header_->head.load(std::memory_order_acquire));
+    }
+
+    bool empty() const { return size() == 0; }
+    const std::string& name() const { return name_; }
+
+private:
+    // Layout shared by both processes - never reorder without bumping VERSION
+    struct Header {
+        std::atomic<uint64_t> magic{0};
+        uint32_t version{0};
+        uint32_t recordSize{0};
+        uint64_t capacity{0};
+        int32_t producerPid{0};
+        alignas(CACHE_LINE_SIZE) std::atomic<uint64_t> head{0};  // Consumer-owned
+        alignas(CACHE_LINE_SIZE) std::atomic<uint64_t> tail{0};  // Producer-owned
+    };
+
+    static constexpr size_t MASK = Capacity - 1;
+    static constexpr size_t RECORDS_OFFSET =
+        (sizeof(Header) + CACHE_LINE_SIZE - 1) / CACHE_LINE_SIZE * CACHE_LINE_SIZE;
+    static constexpr size_t MAPPING_SIZE = RECORDS_OFFSET + sizeof(T) * Capacity;
+
+    ShmRing(std::string name, Header* header, bool owner)
+        : name_(std::move(name))
+        , header_(header)
+        , records_(reinterpret_cast<T*>(reinterpret_cast<uint8_t*>(header) + RECORDS_OFFSET))
+        , owner_(owner)
+        , cachedHead_(header->head.load(std::memory_order_acquire))
+        , cachedTail_(header->tail.load(std::memory_order_acquire)) {}
+
+    std::string name_;
+    Header* header_;
+    T* records_;
+    bool owner_;
+    uint64_t cachedHead_;  // Producer's view of head
+    uint64_t cachedTail_;  // Consumer's view of tail
+};
+
+} // namespace wq::common
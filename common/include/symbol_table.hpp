@@ -0,0 +1,157 @@
+#pragma once
+
+#include "fixed_string.hpp"
+#include <atomic>
+#include <cstdint>
+#include <mutex>
+#include <string_view>
+
+namespace wq::common {
+
+// Dense process-wide identifiers, usable directly as array indexes
+using SymbolId = uint32_t;
+using AlphaIndex = uint32_t;
+
+constexpr uint32_t INVALID_INTERN_ID = UINT32_MAX;
+constexpr SymbolId INVALID_SYMBOL_ID = INVALID_INTERN_ID;
+constexpr AlphaIndex INVALID_ALPHA_INDEX = INVALID_INTERN_ID;
+
+// Fixed-capacity string interning table.
+//
+// Lookups are lock-free: an open-addressing index of atomic slots points into
+// a names array that is written before the slot is published. Inserts are rare
+// (first sighting of a symbol) and serialize on a mutex. Ids are assigned
+// densely from 0 and never reused, so they can index per-symbol arrays.
+// The arrays are inline, so instances belong in static storage.
+template<size_t Width, size_t Capacity>
+class InternTable {
+public:
+    using Name = FixedString<Width>;
+    static constexpr size_t CAPACITY = Capacity;
+
+    InternTable() {
+        for (auto& slot : slots_) {
+            slot.store(0, std::memory_order_relaxed);
+        }
+    }
+
+    // Deleted copy/move - referenced process-wide
+    InternTable(const InternTable&) = delete;
+    InternTable& operator=(const InternTable&) = delete;
+
+    // Id for name, inserting it on first use; INVALID_INTERN_ID when full
+    uint32_t intern(std::string_view name) {
+        return internName(Name(name));
+    }
+
+    // Same as intern() for a name that is already a fixed string
+    uint32_t internName(const Name& key) {
+        uint32_t id = findName(key);
+        if (id != INVALID_INTERN_ID) {
+            return id;
+        }
+
+        std::lock_guard<std::mutex> lock(insertMutex_);
+
+        // Re-probe under the lock: another thread may have inserted it
+        size_t index = key.hash() & SLOT_MASK;
+        while (true) {
+            uint32_t stored = slots_[index].load(std::memory_order_acquire);
+            if (stored == 0) {
+                break;
+            }
+            if (names_[stored - 1] == key) {
+                return stored - 1;
+            }
+            index = (index + 1) & SLOT_MASK;
+        }
+
+        uint32_t count = size_.load(std::memory_order_relaxed);
+        if (count >= Capacity) {
+            return INVALID_INTERN_ID;
+        }
+
+        names_[count] = key;
+        size_.store(count + 1, std::memory_order_release);
+        slots_[index].store(count + 1, std::memory_order_release);  // Publish after name write
+        return count;
+    }
+
+    // Id for name without inserting; INVALID_INTERN_ID if unknown
+    uint32_t find(std::string_view name) const {
+        return findName(Name(name));
+    }
+
+    uint32_t findName(const Name& key) const {
+        size_t index = key.hash() & SLOT_MASK;
+        while (true) {
+            uint32_t stored = slots_[index].load(std::memory_order_acquire);
+            if (stored == 0) {
+                return INVALID_INTERN_ID;
+            }
+            if (names_[stored - 1] == key) {
+                return stored - 1;
+            }
+            index = (index + 1) & SLOT_MASK;
+        }
+    }
+
+    // Name for an id returned by intern()
+    const Name& name(uint32_t id) const {
+        return names_[id];
+    }
+
+    size_t size() const {
+        return size_.load(std::memory_order_acquire);
+    }
+
+private:
+    // Load factor at most 0.5 keeps probe chains short
+    static constexpr size_t SLOT_COUNT = [] {
+        size_t slots = 1;
+        while (slots < Capacity * 2) {
+            slots <<= 1;
+        }
+        return slots;
+    }();
+    static constexpr size_t SLOT_MASK = SLOT_COUNT - 1;
+
+    std::atomic<uint32_t> slots_[SLOT_COUNT];  // id + 1, 0 = empty
+    Name names_[Capacity];
+    std::atomic<uint32_t> size_{0};
+    std::mutex insertMutex_;
+};
+
+namespace InternConfig {
+    constexpr size_t MAX_SYMBOLS = 65536;
+    constexpr size_t MAX_ALPHA_IDS = 16384;
+}
+
+using SymbolTable = InternTable<StringWidth::SYMBOL, InternConfig::MAX_SYMBOLS>;
+using AlphaIdTable = InternTable<StringWidth::ALPHA_ID, InternConfig::MAX_ALPHA_IDS>;
+
+// Process-wide tables shared by every service in the process
+inline SymbolTable& symbolTable() {
+    static SymbolTable table;
+    return table;
+}
+
+inline AlphaIdTable& alphaIdTable() {
+    static AlphaIdTable table;
+    return table;
+}
+
+// Convenience wrappers
+inline SymbolId internSymbol(std::string_view symbol) {
+    return symbolTable().intern(symbol);
+}
+
+inline SymbolId findSymbol(std::string_view symbol) {
+    return symbolTable().find(symbol);
+}
+
+inline AlphaIndex internAlphaId(std::string_view alphaId) {
+    return alphaIdTable().intern(alphaId);
+}
+
+} // namespace wq::common
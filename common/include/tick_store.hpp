@@ -0,0 +1,197 @@
+#pragma once
+
+#include "fixed_string.hpp"
+#include "ipc_transport.hpp"
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <fcntl.h>
+#include <unistd.h>
+#include <algorithm>
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <iostream>
+#include <memory>
+#include <string>
+
+namespace wq::common {
+
+namespace TickStoreConfig {
+    constexpr uint32_t MAGIC = 0x43545157;    // "WQTC"
+    constexpr uint32_t VERSION = 1;
+    constexpr size_t BLOCK_ROWS = 4096;       // Ticks per block
+    constexpr size_t PAGE_BYTES = 4096;
+    constexpr int64_t NS_PER_DAY = 86400LL * 1000000000LL;
+}
+
+// Columnar tick store: one append-only file per UTC day. A page-sized header
+// is followed by fixed-size, page-aligned blocks of BLOCK_ROWS ticks each,
+// stored column by column with the min/max timestamp of the block's rows,
+// so a reader can scan a single column or skip blocks outside a time range
+// without touching the rest of the file.
+//
+// The writer publishes rows by storing the block's row count with release
+// ordering after the columns, so a reader mapping the file during capture
+// sees a consistent prefix. Bump VERSION when changing any layout below.
+struct TickStoreHeader {
+    uint32_t magic;
+    uint32_t version;
+    uint32_t blockRows;
+    uint32_t blockBytes;
+    int64_t dayStartNs;                 // First nanosecond of the day the file covers
+    std::atomic<uint64_t> numBlocks;    // Blocks allocated, the last one possibly partial
+};
+
+struct alignas(64) TickStoreBlockHeader {
+    std::atomic<uint32_t> rows;
+    uint32_t reserved;
+    std::atomic<int64_t> minTimestampNs;
+    std::atomic<int64_t> maxTimestampNs;
+};
+
+struct TickStoreBlock {
+    static constexpr size_t ROWS = TickStoreConfig::BLOCK_ROWS;
+
+    TickStoreBlockHeader header;
+    int64_t timestampNs[ROWS];
+    double bidPrice[ROWS];
+    double askPrice[ROWS];
+    double lastPrice[ROWS];
+    int64_t bidSize[ROWS];
+    int64_t askSize[ROWS];
+    int64_t volume[ROWS];
+    SymbolString symbol[ROWS];
+    uint8_t exchange[ROWS];             // datafeed::Exchange
+    uint8_t assetType[ROWS];            // datafeed::AssetType
+
+    // Published rows; columns beyond this are unspecified
+    size_t size() const { return header.rows.load(std::memory_order_acquire); }
+    int64_t minTimestampNs() const { return header.minTimestampNs.load(std::memory_order_relaxed); }
+    int64_t maxTimestampNs() const { return header.maxTimestampNs.load(std::memory_order_relaxed); }
+
+    // Gather one row back into the feed's record layout
+    TickRecord record(size_t row) const {
+        TickRecord out{};
+        out.symbol = symbol[row];
+        out.bidPrice = bidPrice[row];
+        out.askPrice = askPrice[row];
+        out.lastPrice = lastPrice[row];
+        out.bidSize = bidSize[row];
+        out.askSize = askSize[row];
+        out.volume = volume[row];
+        out.timestampNs = timestampNs[row];
+        out.exchange = exchange[row];
+        out.assetType = assetType[row];
+        return out;
+    }
+};
+
+namespace TickStoreConfig {
+    constexpr size_t HEADER_BYTES = PAGE_BYTES;
+    constexpr size_t BLOCK_BYTES = (sizeof(TickStoreBlock) + PAGE_BYTES - 1) / PAGE_BYTES * PAGE_BYTES;
+
+    constexpr size_t blockOffset(size_t index) { return HEADER_BYTES + index * BLOCK_BYTES; }
+}
+
+static_assert(sizeof(TickStoreHeader) <= TickStoreConfig::HEADER_BYTES, "tick store header spills its page");
+static_assert(std::atomic<uint64_t>::is_always_lock_free && std::atomic<int64_t>::is_always_lock_free,
+              "tick store counters live in the file mapping");
+
+// Day index of a timestamp: files are named and rotated by it
+inline int64_t tickStoreDay(int64_t timestampNs) {
+    int64_t day = timestampNs / TickStoreConfig::NS_PER_DAY;
+    return timestampNs < 0 && timestampNs % TickStoreConfig::NS_PER_DAY != 0 ? day - 1 : day;
+}
+
+// Read-only, zero-copy view of a tick store file. Block columns point
+// straight into the mapping, which is shared so a file still being captured
+// shows rows as the writer publishes them (within the blocks mapped at open).
+class TickStoreReader {
+public:
+    // nullptr if the file is missing or not a tick store of this build
+    static std::unique_ptr<TickStoreReader> open(const std::string& path) {
+        int fd = ::open(path.c_str(), O_RDONLY);
+        if (fd < 0) {
+            std::cerr << "Failed to open tick store " << path << std::endl;
+            return nullptr;
+        }
+        struct stat info;
+        if (fstat(fd, &info) != 0 || static_cast<size_t>(info.st_size) < TickStoreConfig::HEADER_BYTES) {
+            close(fd);
+            std::cerr << "Tick store " << path << " is truncated" << std::endl;
+            return nullptr;
+        }
+        size_t size = static_cast<size_t>(info.st_size);
+        void* mapping = mmap(nullptr, size, PROT_READ, MAP_SHARED, fd, 0);
+        close(fd);
+        if (mapping == MAP_FAILED) {
+            std::cerr << "Failed to map tick store " << path << std::endl;
+            return nullptr;
+        }
+
+        const auto* header = static_cast<const TickStoreHeader*>(mapping);
+        bool compatible = header->magic == TickStoreConfig::MAGIC
+            && header->version == TickStoreConfig::VERSION
+            && header->blockRows == TickStoreConfig::BLOCK_ROWS
+            && header->blockBytes == TickStoreConfig::BLOCK_BYTES;
+        if (!compatible) {
+            munmap(mapping, size);
+            std::cerr << "Tick store " << path << " has an unsupported layout" << std::endl;
+            return nullptr;
+        }
+        return std::unique_ptr<TickStoreReader>(new TickStoreReader(mapping, size));
+    }
+
+    ~TickStoreReader() { munmap(mapping_, mappingSize_); }
+
+    // Deleted copy/move - blocks point into the mapping
+    TickStoreReader(const TickStoreReader&) = delete;
+    TickStoreReader& operator=(const TickStoreReader&) = delete;
+
+    int64_t dayStartNs() const { return header()->dayStartNs; }
+
+    size_t numBlocks() const {
+        size_t mapped = (mappingSize_ - TickStoreConfig::HEADER_BYTES) / TickStoreConfig::BLOCK_BYTES;
+        return std::min<size_t>(header()->numBlocks.load(std::memory_order_acquire), mapped);
+    }
+
+    const TickStoreBlock& block(size_t index) const {
+        return *reinterpret_cast<const TickStoreBlock*>(
+            static_cast<const char*>(mapping_) + TickStoreConfig::blockOffset(index));
+    }
+
+    size_t numRows() const {
+        size_t rows = 0;
+        for (size_t i = 0; i < numBlocks(); ++i) {
+            rows += block(i).size();
+        }
+        return rows;
+    }
+
+    // First block at or after `from` that may hold ticks at or after
+    // timestampNs; numBlocks() if none does. Channels interleave, so blocks
+    // are not strictly ordered and the index is scanned rather than bisected
+    // (one cache line per block).
+    size_t findBlock(int64_t timestampNs, size_t from = 0) const {
+        size_t count = numBlocks();
+        while (from < count && (block(from).size() == 0 || block(from).maxTimestampNs() < timestampNs)) {
+            ++from;
+        }
+        return from;
+    }
+
+    // Hint that the whole file will be read front to back
+    void adviseSequential() const { madvise(mapping_, mappingSize_, MADV_SEQUENTIAL); }
+
+private:
+    TickStoreReader(void* mapping, size_t mappingSize)
+        : mapping_(mapping)
+        , mappingSize_(mappingSize) {}
+
+    const TickStoreHeader* header() const { return static_cast<const TickStoreHeader*>(mapping_); }
+
+    void* mapping_;
+    size_t mappingSize_;
+};
+
+} // namespace wq::common
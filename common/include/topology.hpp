@@ -0,0 +1,407 @@
+#pragma once
+
+#include <linux/mempolicy.h>
+#include <pthread.h>
+#include <sched.h>
+#include <sys/mman.h>
+#include <sys/syscall.h>
+#include <unistd.h>
+#include <algorithm>
+#include <charconv>
+#include <cstddef>
+#include <cstdint>
+#include <cstdlib>
+#include <cstring>
+#include <fstream>
+#include <future>
+#include <iomanip>
+#include <iostream>
+#include <map>
+#include <memory>
+#include <memory_resource>
+#include <mutex>
+#include <new>
+#include <sstream>
+#include <string>
+#include <string_view>
+#include <thread>
+#include <utility>
+#include <vector>
+
+namespace wq::common {
+
+namespace TopologyConfig {
+    constexpr const char* ENV = "WQ_TOPOLOGY";                    // Topology file read by every service
+    constexpr const char* NODE_SYSFS = "/sys/devices/system/node/node";
+    constexpr int MAX_NODES = 64;                                 // One word of node mask
+}
+
+// Thread roles a topology file can place. One file describes the whole
+// host, so a service looks up both its own stages and the stages that
+// consume what it publishes.
+namespace TopologyStage {
+    constexpr std::string_view FEED_LISTENER = "feed.listener";          // Thread i serves channel i
+    constexpr std::string_view FEED_PUBLISHER = "feed.publisher";        // Ring to gRPC and shared memory
+    constexpr std::string_view FEED_CAPTURE = "feed.capture";
+    constexpr std::string_view FEED_RPC = "feed.rpc";
+    constexpr std::string_view ALPHA_BRIDGE = "alpha.bridge";            // Shared-memory ticks in
+    constexpr std::string_view ALPHA_INPUT = "alpha.input";              // Ticks to the workers
+    constexpr std::string_view ALPHA_WORKER = "alpha.worker";
+    constexpr std::string_view ALPHA_OUTPUT = "alpha.output";            // Signals out
+    constexpr std::string_view ALPHA_RPC = "alpha.rpc";
+    constexpr std::string_view AGGREGATOR_BRIDGE = "aggregator.bridge";  // Shared-memory signals in
+    constexpr std::string_view AGGREGATOR_INPUT = "aggregator.input";
+    constexpr std::string_view AGGREGATOR_RPC = "aggregator.rpc";
+    constexpr std::string_view RISK_BRIDGE = "risk.bridge";              // Shared-memory orders in
+    constexpr std::string_view RISK_INPUT = "risk.input";
+    constexpr std::string_view RISK_RPC = "risk.rpc";
+}
+
+namespace topology_detail {
+    inline std::string_view trim(std::string_view text) {
+        size_t begin = text.find_first_not_of(" \t\r\n");
+        if (begin == std::string_view::npos) {
+            return {};
+        }
+        return text.substr(begin, text.find_last_not_of(" \t\r\n") - begin + 1);
+    }
+
+    inline bool parseInt(std::string_view text, int& value) {
+        auto [end, error] = std::from_chars(text.data(), text.data() + text.size(), value);
+        return error == std::errc() && end == text.data() + text.size();
+    }
+}
+
+// "0-3,8,10-11" as the cpus it names, in order; false if malformed
+inline bool parseCpuList(std::string_view text, std::vector<int>& cpus) {
+    cpus.clear();
+    text = topology_detail::trim(text);
+    while (!text.empty()) {
+        size_t comma = text.find(',');
+        std::string_view item = text.substr(0, comma);
+        size_t dash = item.find('-');
+        int first = 0;
+        int last = 0;
+        if (!topology_detail::parseInt(item.substr(0, dash), first)) {
+            return false;
+        }
+        last = first;
+        if (dash != std::string_view::npos && !topology_detail::parseInt(item.substr(dash + 1), last)) {
+            return false;
+        }
+        if (first < 0 || last < first || last >= CPU_SETSIZE) {
+            return false;
+        }
+        for (int cpu = first; cpu <= last; ++cpu) {
+            cpus.push_back(cpu);
+        }
+        text = comma == std::string_view::npos ? std::string_view() : text.substr(comma + 1);
+    }
+    return !cpus.empty();
+}
+
+// Prefer node for the whole pages of [address, address + bytes), moving
+// those already touched. Edge pages, which may hold other objects, stay
+// where they are. Node -1 leaves the memory alone.
+inline bool bindToNode(void* address, size_t bytes, int node) {
+    if (node < 0) {
+        return true;
+    }
+    if (node >= TopologyConfig::MAX_NODES) {
+        return false;
+    }
+    uintptr_t page = static_cast<uintptr_t>(sysconf(_SC_PAGESIZE));
+    uintptr_t begin = (reinterpret_cast<uintptr_t>(address) + page - 1) / page * page;
+    uintptr_t end = (reinterpret_cast<uintptr_t>(address) + bytes) / page * page;
+    if (end <= begin) {
+        return true;
+    }
+    unsigned long mask = 1UL << node;
+    return syscall(SYS_mbind, begin, end - begin, MPOL_PREFERRED, &mask,
+                   TopologyConfig::MAX_NODES + 1, MPOL_MF_MOVE) == 0;
+}
+
+// Anonymous pages preferring one node, as the upstream of a pool whose
+// consumer runs there: whichever thread grows the pool, its chunks land on
+// the consumer's node. Every allocation is its own mapping, so this suits
+// the few large chunks a pool asks for, not individual objects.
+class NodeMemoryResource : public std::pmr::memory_resource {
+public:
+    explicit NodeMemoryResource(int node) : node_(node) {}
+
+    int node() const { return node_; }
+
+private:
+    int node_;
+
+    void* do_allocate(size_t bytes, size_t alignment) override {
+        // Mappings are page aligned, more than any pool chunk needs
+        if (alignment > static_cast<size_t>(sysconf(_SC_PAGESIZE))) {
+            throw std::bad_alloc();
+        }
+        void* pointer = mmap(nullptr, bytes, PROT_READ | PROT_WRITE, MAP_PRIVATE | MAP_ANONYMOUS, -1, 0);
+        if (pointer == MAP_FAILED) {
+            throw std::bad_alloc();
+        }
+        bindToNode(pointer, bytes, node_);
+        return pointer;
+    }
+
+    void do_deallocate(void* pointer, size_t bytes, size_t) override { munmap(pointer, bytes); }
+
+    bool do_is_equal(const std::pmr::memory_resource& other) const noexcept override { return this == &other; }
+};
+
+// Process-wide resource for node; the default resource for -1
+inline std::pmr::memory_resource* nodeResource(int node) {
+    static const std::vector<std::unique_ptr<NodeMemoryResource>> resources = [] {
+        std::vector<std::unique_ptr<NodeMemoryResource>> all;
+        for (int i = 0; i < TopologyConfig::MAX_NODES; ++i) {
+            all.push_back(std::make_unique<NodeMemoryResource>(i));
+        }
+        return all;
+    }();
+    if (node < 0 || node >= TopologyConfig::MAX_NODES) {
+        return std::pmr::get_default_resource();
+    }
+    return resources[static_cast<size_t>(node)].get();
+}
+
+// Where each stage's threads run, from a file of "stage cpulist" lines:
+//
+//     # stage          cores
+//     feed.listener    2,3
+//     alpha.worker     4-11
+//     aggregator.input 12
+//
+// Thread i of a stage is pinned to the stage's i-th core, wrapping around
+// when it has more threads than cores. Threads started with startThread()
+// pin themselves before running anything else, and under the kernel's
+// default local policy the state they create is then first-touched on
+// their node. Stages the file does not name keep their
+// defaults. Queues are placed on their consumer's node with place() or,
+// for shared-memory segments, at creation.
+//
+// Every pin and placement is recorded, so report() prints the layout the
+// process actually ended up with.
+class Topology {
+public:
+    // Names no stage: every thread keeps its default
+    Topology() : cpuNodes_(readCpuNodes()) {}
+
+    // nullptr if the file cannot be read, is malformed or names a cpu this
+    // host does not have
+    static std::unique_ptr<Topology> load(const std::string& path) {
+        std::ifstream file(path);
+        if (!file) {
+            std::cerr << "Failed to open topology " << path << std::endl;
+            return nullptr;
+        }
+        auto topology = std::make_unique<Topology>();
+        topology->source_ = path;
+        std::string line;
+        for (size_t number = 1; std::getline(file, line); ++number) {
+            std::string_view text = topology_detail::trim(std::string_view(line).substr(0, line.find('#')));
+            if (text.empty()) {
+                continue;
+            }
+            size_t space = text.find_first_of(" \t");
+            std::string stage(text.substr(0, space));
+            std::vector<int> cores;
+            bool valid = space != std::string_view::npos &&
+                         parseCpuList(text.substr(space), cores) &&
+                         topology->stages_.count(stage) == 0;
+            for (size_t i = 0; valid && i < cores.size(); ++i) {
+                valid = topology->nodeOfCpu(cores[i]) >= 0;
+            }
+            if (!valid) {
+                std::cerr << "Topology " << path << ":" << number << ": expected a new stage name and cores "
+                          << "this host has, got \"" << text << "\"" << std::endl;
+                return nullptr;
+            }
+            topology->stages_[stage] = std::move(cores);
+        }
+        return topology;
+    }
+
+    Topology(const Topology&) = delete;
+    Topology& operator=(const Topology&) = delete;
+
+    bool empty() const { return stages_.empty(); }
+    const std::string& source() const { return source_; }
+
+    size_t numCores(std::string_view stage) const {
+        auto it = stages_.find(stage);
+        return it == stages_.end() ? 0 : it->second.size();
+    }
+
+    // Core of thread index of stage, -1 if the stage is not named
+    int core(std::string_view stage, size_t index = 0) const {
+        auto it = stages_.find(stage);
+        return it == stages_.end() ? -1 : it->second[index % it->second.size()];
+    }
+
+    // Node of thread index of stage, -1 if the stage is not named
+    int nodeOf(std::string_view stage, size_t index = 0) const {
+        int cpu = core(stage, index);
+        return cpu < 0 ? -1 : nodeOfCpu(cpu);
+    }
+
+    // -1 for a cpu this host does not have
+    int nodeOfCpu(int cpu) const {
+        return cpu >= 0 && static_cast<size_t>(cpu) < cpuNodes_.size() ? cpuNodes_[static_cast<size_t>(cpu)] : -1;
+    }
+
+    size_t numNodes() const {
+        int highest = 0;
+        for (int node : cpuNodes_) {
+            highest = std::max(highest, node);
+        }
+        return static_cast<size_t>(highest) + 1;
+    }
+
+    // Start body on a new thread, pinned as thread index of stage (or to
+    // fallbackCore if the file does not name the stage) by the thread
+    // itself before body runs, so everything body touches is first-touched
+    // on its node. Returns once the pin is done and recorded; an empty
+    // stage starts the thread unpinned and unrecorded.
+    template<typename F>
+    std::thread startThread(std::string_view stage, size_t index, F&& body, int fallbackCore = -1) {
+        if (stage.empty()) {
+            return std::thread(std::forward<F>(body));
+        }
+        std::promise<void> pinned;
+        std::future<void> ready = pinned.get_future();
+        std::thread thread([this, stage = std::string(stage), index, fallbackCore,
+                            pinned = std::move(pinned), body = std::forward<F>(body)]() mutable {
+            pinCurrentThread(stage, index, fallbackCore);
+            pinned.set_value();
+            body();
+        });
+        ready.wait();
+        return thread;
+    }
+
+    // Pin the calling thread as thread index of stage, or to fallbackCore
+    // if the file does not name the stage; returns the core, -1 if left
+    // unpinned
+    int pinCurrentThread(std::string_view stage, size_t index, int fallbackCore = -1) {
+        int cpu = core(stage, index);
+        if (cpu < 0) {
+            cpu = fallbackCore;
+        }
+        if (cpu >= 0) {
+            cpu_set_t cpuset;
+            CPU_ZERO(&cpuset);
+            CPU_SET(cpu, &cpuset);
+            int rc = pthread_setaffinity_np(pthread_self(), sizeof(cpuset), &cpuset);
+            if (rc != 0) {
+                std::cerr << "Failed to pin " << stage << "[" << index << "] to core " << cpu
+                          << ": " << std::strerror(rc) << std::endl;
+                cpu = -1;
+            }
+        }
+        std::lock_guard<std::mutex> lock(mutex_);
+        threads_[{std::string(stage), index}] = cpu;
+        return cpu;
+    }
+
+    // Move the pages of an in-process queue to the node its consumer runs on
+    bool place(std::string_view name, void* address, size_t bytes, std::string_view consumerStage) {
+        int node = nodeOf(consumerStage);
+        if (node < 0) {
+            return true;
+        }
+        bool placed = bindToNode(address, bytes, node);
+        if (!placed) {
+            std::cerr << "Failed to place " << name << " on node " << node << ": "
+                      << std::strerror(errno) << std::endl;
+        }
+        notePlacement(name, bytes, placed ? node : -1, consumerStage);
+        return placed;
+    }
+
+    // Record memory placed by other means; bytes 0 for memory that grows
+    void notePlacement(std::string_view name, size_t bytes, int node, std::string_view consumerStage) {
+        std::lock_guard<std::mutex> lock(mutex_);
+        memory_[std::string(name)] = {bytes, node, std::string(consumerStage)};
+    }
+
+    // The stages this process started threads for, where they run, and the
+    // memory placed for them
+    void report(std::ostream& out) const {
+        std::lock_guard<std::mutex> lock(mutex_);
+        out << "Topology " << (source_.empty() ? "(none)" : source_)
+            << ", " << numNodes() << " NUMA node" << (numNodes() == 1 ? "" : "s") << std::endl;
+        for (const auto& [key, cpu] : threads_) {
+            std::ostringstream name;
+            name << key.first << "[" << key.second << "]";
+            out << "  " << std::left << std::setw(24) << name.str();
+            if (cpu < 0) {
+                out << "unpinned" << std::endl;
+            } else {
+                out << "core " << std::setw(4) << cpu << " node " << nodeOfCpu(cpu) << std::endl;
+            }
+        }
+        for (const auto& [name, placement] : memory_) {
+            out << "  " << std::left << std::setw(24) << name;
+            if (placement.bytes > 0) {
+                out << std::setw(10) << (std::to_string(placement.bytes >> 10) + " KiB");
+            } else {
+                out << std::setw(10) << "pooled";
+            }
+            out << (placement.node < 0 ? std::string("node default") : "node " + std::to_string(placement.node))
+                << " (for " << placement.consumer << ")" << std::endl;
+        }
+    }
+
+private:
+    struct Placement {
+        size_t bytes;
+        int node;
+        std::string consumer;
+    };
+
+    std::string source_;
+    std::map<std::string, std::vector<int>, std::less<>> stages_;
+    std::vector<int> cpuNodes_;               // Node of each cpu, -1 for absent ones
+    mutable std::mutex mutex_;
+    std::map<std::pair<std::string, size_t>, int> threads_;
+    std::map<std::string, Placement> memory_;
+
+    // From sysfs; without it every online cpu is on node 0
+    static std::vector<int> readCpuNodes() {
+        std::vector<int> nodes;
+        std::vector<int> cpus;
+        for (int node = 0; node < TopologyConfig::MAX_NODES; ++node) {
+            std::ifstream file(TopologyConfig::NODE_SYSFS + std::to_string(node) + "/cpulist");
+            std::string list;
+            if (!std::getline(file, list) || !parseCpuList(list, cpus)) {
+                continue;
+            }
+            for (int cpu : cpus) {
+                if (static_cast<size_t>(cpu) >= nodes.size()) {
+                    nodes.resize(static_cast<size_t>(cpu) + 1, -1);
+                }
+                nodes[static_cast<size_t>(cpu)] = node;
+            }
+        }
+        if (nodes.empty()) {
+            nodes.assign(std::max(1u, std::thread::hardware_concurrency()), 0);
+        }
+        return nodes;
+    }
+};
+
+// Process-wide layout, loaded from $WQ_TOPOLOGY on first use; empty if the
+// variable is unset or the file is rejected
+inline Topology& topology() {
+    static std::unique_ptr<Topology> instance = [] {
+        const char* path = std::getenv(TopologyConfig::ENV);
+        std::unique_ptr<Topology> loaded = path && *path ? Topology::load(path) : nullptr;
+        return loaded ? std::move(loaded) : std::make_unique<Topology>();
+    }();
+    return *instance;
+}
+
+} // namespace wq::common
@@ -3,7 +3,8 @@
 Market Data Generator - Simulates market data feed via UDP multicast
 
 This script generates realistic market data for testing the Data Feed Handler.
-Sends market ticks via UDP multicast to 239.255.0.1:12345
+Sends market ticks via UDP multicast to 239.255.0.1:12345, optionally
+duplicated on the B line 239.255.1.1:12347 for A/B arbitration.
 """
 
 import socket
@@ -38,9 +39,13 @@ class Symbol:
 class MarketDataGenerator:
     """Generates and broadcasts market data"""
     
-    def __init__(self, multicast_group: str = "239.255.0.1", port: int = 12345):
+    def __init__(self, multicast_group: str = "239.255.0.1", port: int = 12345,
+                 b_line: Tuple[str, int] = None, drop_rate: float = 0.0):
         self.multicast_group = multicast_group
         self.port = port
+        self.b_line = b_line
+        self.drop_rate = drop_rate
+        self.sequence = 0
         self.socket = socket.socket(socket.AF_INET, socket.SOCK_DGRAM)
         self.socket.setsockopt(socket.IPPROTO_IP, socket.IP_MULTICAST_TTL, 2)
         
@@ -59,7 +64,7 @@ class MarketDataGenerator:
         return symbols
         
     def generate_tick(self, symbol: Symbol) -> bytes:
-        """Generate market tick in NYSE format"""
+        """Generate market tick in NYSE format with trailing sequence number"""
         bid, ask = symbol.get_bid_ask()
         bid_size = random.randint(100, 10000)
         ask_size = random.randint(100, 10000)
@@ -67,13 +72,26 @@ class MarketDataGenerator:
         timestamp_ns = int(time.time() * 1e9)
         
         data = struct.pack(
-            'dddqqqq16s',
+            'dddqqqq16sQ',
             bid, ask, symbol.price,
             bid_size, ask_size, volume, timestamp_ns,
-            symbol.symbol.encode('utf-8').ljust(16, b'\x00')
+            symbol.symbol.encode('utf-8').ljust(16, b'\x00'),
+            self.sequence
         )
+        self.sequence += 1
         return data
         
+    def send(self, tick_data: bytes):
+        """Send a tick on the A line and, if configured, the B line"""
+        lines = [(self.multicast_group, self.port)]
+        if self.b_line:
+            lines.append(self.b_line)
+        for line in lines:
+            # Simulate independent packet loss on each line
+            if self.drop_rate > 0 and random.random() < self.drop_rate:
+                continue
+            self.socket.sendto(tick_data, line)
+        
     def run(self, ticks_per_second: int = 10, duration_seconds: int = 60):
         """Run the market data generator"""
         print(f"Starting market data generator")
@@ -92,7 +110,7 @@ class MarketDataGenerator:
                 symbol = random.choice(self.symbols)
                 symbol.update_price()
                 tick_data = self.generate_tick(symbol)
-                self.socket.sendto(tick_data, (self.multicast_group, self.port))
+                self.send(tick_data)
                 
                 tick_count += 1
                 if tick_count % 100 == 0:
@@ -113,7 +131,10 @@ if __name__ == '__main__':
     parser = argparse.ArgumentParser(description='Market Data Generator')
     parser.add_argument('--rate', type=int, default=10, help='Ticks per second')
     parser.add_argument('--duration', type=int, default=0, help='Duration in seconds (0 = infinite)')
+    parser.add_argument('--ab', action='store_true', help='Also publish on the B line 239.255.1.1:12347')
+    parser.add_argument('--drop-rate', type=float, default=0.0, help='Per-line packet drop probability')
     args = parser.parse_args()
     
-    generator = MarketDataGenerator()
+    b_line = ("239.255.1.1", 12347) if args.ab else None
+    generator = MarketDataGenerator(b_line=b_line, drop_rate=args.drop_rate)
     generator.run(args.rate, args.duration)
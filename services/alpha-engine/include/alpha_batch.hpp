@@ -0,0 +1,187 @@
+#pragma once
+
+#include "alpha_strategy.hpp"
+#include <algorithm>
+#include <cstdint>
+#include <memory>
+#include <optional>
+#include <string>
+#include <string_view>
+#include <unordered_map>
+#include <vector>
+
+namespace wq::alpha {
+
+namespace AlphaBatchConfig {
+    // Exact recompute of a member's running state every this many windows
+    constexpr size_t RESYNC_WINDOWS = 64;
+}
+
+// One parameterization inside a batch
+struct BatchMember {
+    std::string alphaId;
+    int param;  // Window or lookback, as for the single-alpha constructors
+};
+
+// A family of alphas of one kind evaluated together: one virtual call per
+// tick covers every member, and member state is kept as struct-of-arrays so
+// the per-member updates run as SIMD loops. Signals go into a buffer the
+// caller preallocates with room for size() entries.
+class IAlphaBatch {
+public:
+    virtual ~IAlphaBatch() = default;
+
+    virtual size_t size() const = 0;
+    virtual std::string_view getAlphaId(size_t member) const = 0;
+
+    // Evaluate every member on one tick; writes at most size() signals to
+    // out and returns how many were written
+    virtual size_t onMarketData(const MarketData& data, AlphaSignal* out) = 0;
+    virtual void initialize() = 0;
+    virtual void shutdown() = 0;
+
+    virtual bool isActive() const {
+        return true;
+    }
+
+    // Same contract as IAlphaStrategy::clone(): a fresh batch with the same
+    // members and no market state, or nullptr if it cannot be replicated
+    virtual std::unique_ptr<IAlphaBatch> clone() const {
+        return nullptr;
+    }
+
+    // Same contracts as IAlphaStrategy::serialize() and restore(), for the
+    // state of every member at once
+    virtual bool serialize(common::CheckpointWriter& /*out*/) const {
+        return false;
+    }
+
+    virtual bool restore(common::CheckpointSection& /*in*/, const SymbolFilter& /*keep*/) {
+        return false;
+    }
+
+    int64_t getLastUpdateTime() const {
+        return lastUpdateTime_;
+    }
+
+protected:
+    int64_t lastUpdateTime_{0};
+};
+
+// When each member's running state is next recomputed exactly: after its
+// window fills and then every AlphaBatchConfig::RESYNC_WINDOWS windows, the
+// same cadence as RollingMoments. nextDue lets a tick skip the scan.
+struct ResyncSchedule {
+    std::vector<size_t> dueAt;  // Sample count at which each member resyncs
+    size_t nextDue{0};
+    
+    explicit ResyncSchedule(const std::vector<int64_t>& windows);
+    
+    // Call resync(member) for every member due at sampleCount
+    template<typename Func>
+    void run(const std::vector<int64_t>& windows, size_t sampleCount, Func&& resync);
+};
+
+template<typename Func>
+void ResyncSchedule::run(const std::vector<int64_t>& windows, size_t sampleCount, Func&& resync) {
+    if (sampleCount < nextDue) {
+        return;
+    }
+    nextDue = static_cast<size_t>(-1);
+    for (size_t i = 0; i < dueAt.size(); ++i) {
+        if (sampleCount >= dueAt[i]) {
+            resync(i);
+            dueAt[i] += AlphaBatchConfig::RESYNC_WINDOWS * static_cast<size_t>(windows[i]);
+        }
+        nextDue = std::min(nextDue, dueAt[i]);
+    }
+}
+
+// N MeanReversionAlphas sharing one price history per symbol. Each member
+// slides its own Welford mean/variance over the last `param` prices.
+class MeanReversionBatch : public IAlphaBatch {
+public:
+    explicit MeanReversionBatch(std::vector<BatchMember> members);
+    ~MeanReversionBatch() override = default;
+
+    size_t size() const override { return alphaIds_.size(); }
+    std::string_view getAlphaId(size_t member) const override { return alphaIds_[member].view(); }
+
+    size_t onMarketData(const MarketData& data, AlphaSignal* out) override;
+    void initialize() override;
+    void shutdown() override;
+    bool isActive() const override;
+    std::unique_ptr<IAlphaBatch> clone() const override;
+    bool serialize(common::CheckpointWriter& out) const override;
+    bool restore(common::CheckpointSection& in, const SymbolFilter& keep) override;
+
+private:
+    struct SymbolState {
+        SymbolState(const std::vector<int64_t>& windows, size_t historySize);
+        std::vector<double> history;  // Last historySize prices, circular
+        std::vector<double> mean;
+        std::vector<double> m2;
+        ResyncSchedule resync;
+        size_t ticks{0};
+    };
+
+    std::vector<BatchMember> members_;
+    std::vector<AlphaIdString> alphaIds_;
+    std::vector<AlphaIndex> alphaIndices_;
+    std::vector<int64_t> windows_;
+    std::vector<double> lengths_;  // windows_ as doubles, for the kernels
+    size_t maxWindow_{1};
+    std::unordered_map<SymbolId, SymbolState> symbolStates_;
+    bool initialized_{false};
+
+    // Per-tick kernel output, reused
+    std::vector<double> signals_;
+    std::vector<double> confidences_;
+    std::vector<uint8_t> emit_;
+
+    void resyncMember(SymbolState& state, size_t member) const;
+};
+
+// N MomentumAlphas sharing one return history per symbol. Each member keeps
+// the sum and positive count of its last `param` returns.
+class MomentumBatch : public IAlphaBatch {
+public:
+    explicit MomentumBatch(std::vector<BatchMember> members);
+    ~MomentumBatch() override = default;
+
+    size_t size() const override { return alphaIds_.size(); }
+    std::string_view getAlphaId(size_t member) const override { return alphaIds_[member].view(); }
+
+    size_t onMarketData(const MarketData& data, AlphaSignal* out) override;
+    void initialize() override;
+    void shutdown() override;
+    std::unique_ptr<IAlphaBatch> clone() const override;
+    bool serialize(common::CheckpointWriter& out) const override;
+    bool restore(common::CheckpointSection& in, const SymbolFilter& keep) override;
+
+private:
+    struct SymbolState {
+        SymbolState(const std::vector<int64_t>& windows, size_t historySize);
+        std::vector<double> history;    // Last historySize returns, circular
+        std::vector<double> sum;
+        std::vector<double> positives;  // Whole numbers; double keeps the loop vectorizable
+        ResyncSchedule resync;
+        std::optional<double> lastPrice;
+        size_t returns{0};
+    };
+
+    std::vector<BatchMember> members_;
+    std::vector<AlphaIdString> alphaIds_;
+    std::vector<AlphaIndex> alphaIndices_;
+    std::vector<int64_t> windows_;
+    std::vector<double> lengths_;  // windows_ as doubles, for the kernels
+    size_t maxWindow_{1};
+    std::unordered_map<SymbolId, SymbolState> symbolStates_;
+
+    void resyncMember(SymbolState& state, size_t member) const;
+};
+
+// Name of the SIMD kernel set chosen for this CPU ("avx512", "avx2" or "scalar")
+const char* alphaBatchKernelName();
+
+} // namespace wq::alpha
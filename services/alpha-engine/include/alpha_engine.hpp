@@ -1,45 +1,160 @@
 #pragma once
 
+#include "alpha_batch.hpp"
+#include "alpha_plugin.hpp"
 #include "alpha_strategy.hpp"
+#include "checkpoint.hpp"
+#include "inline_task.hpp"
+#include "ipc_transport.hpp"
+#include "latency.hpp"
+#include "last_value_cache.hpp"
+#include "ring_buffer.hpp"
+#include "ring_consumer.hpp"
+#include "topology.hpp"
 #include <vector>
 #include <memory>
 #include <thread>
 #include <mutex>
 #include <condition_variable>
-#include <queue>
+#include <deque>
 #include <functional>
+#include <memory_resource>
 #include <atomic>
+#include <filesystem>
+#include <unordered_map>
+#include <unordered_set>
 
 namespace wq::alpha {
 
-// Market data compatible structure
+// Market data compatible structure - trivially copyable, no heap allocation per tick
 struct MarketData {
-    std::string symbol;
-    double price;
-    int64_t volume;
-    int64_t timestampNs;
-    
-    MarketData() = default;
-    MarketData(MarketData&&) noexcept = default;
-    MarketData& operator=(MarketData&&) noexcept = default;
+    SymbolString symbol;
+    SymbolId symbolId{common::INVALID_SYMBOL_ID};
+    double price{0};
+    int64_t volume{0};
+    int64_t timestampNs{0};
+    
+    // Set symbol and its interned id together
+    void setSymbol(std::string_view name) {
+        symbol = SymbolString(name);
+        symbolId = common::internSymbol(name);
+    }
+};
+
+// Co-located IPC conversions: feed ticks in, signals out
+inline MarketData fromTickRecord(const common::TickRecord& record) {
+    MarketData data;
+    data.symbol = record.symbol;
+    data.symbolId = common::symbolTable().internName(record.symbol);
+    data.price = record.lastPrice;
+    data.volume = record.volume;
+    data.timestampNs = record.timestampNs;
+    return data;
+}
+
+inline common::SignalRecord toSignalRecord(const AlphaSignal& signal) {
+    common::SignalRecord record{};
+    record.alphaId = signal.alphaId;
+    record.symbol = signal.symbol;
+    record.signal = signal.signal;
+    record.confidence = signal.confidence;
+    record.timestampNs = signal.timestampNs;
+    return record;
+}
+
+// A run of ticks shared by the tasks of one dispatch: rows for the C++
+// alphas, plus the columns ABI plugins read when withColumns is set. The
+// tick block points into this object, so it is neither copied nor moved.
+// Rows and columns come from resource, so a batch can live in a pool or arena.
+struct TickBatch {
+    std::pmr::vector<MarketData> rows;
+    std::pmr::vector<SymbolId> symbolIds;
+    std::pmr::vector<double> prices;
+    std::pmr::vector<int64_t> volumes;
+    std::pmr::vector<int64_t> timestampsNs;
+    wq_tick_block block{};
+    
+    TickBatch(const MarketData* ticks, size_t count, bool withColumns,
+              std::pmr::memory_resource* resource = std::pmr::get_default_resource());
+    
+    TickBatch(const TickBatch&) = delete;
+    TickBatch& operator=(const TickBatch&) = delete;
+};
+
+// Pool scheduling policy
+enum class SchedulingMode : uint8_t {
+    WORK_STEALING,   // Alphas are processed in chunks that idle workers steal;
+                     // only safe for alphas without per-tick state
+    SHARDED,         // Each worker owns a fixed set of alphas, processed in tick order
+    SYMBOL_SHARDED   // Each worker owns a replica of every alpha for the symbols
+                     // it owns, so each (alpha, symbol) pair has a single writer
 };
 
-// Thread pool for running alphas concurrently
+// Work-stealing thread pool for running alphas concurrently.
+//
+// Every worker owns a deque: it pops its own work LIFO and, when empty,
+// steals FIFO from the others, so submitters and workers rarely touch the
+// same lock. Pinned tasks go to a per-worker queue that is never stolen,
+// which keeps state owned by one worker single-threaded and in order.
+// Idle workers spin briefly, then sleep until work arrives.
+//
+// Each task is stamped when queued, so the pool reports the time tasks wait
+// (alpha.queue_delay) separately from the time they run (alpha.task).
+//
+// Tasks keep closures of up to TASK_INLINE_BYTES in place, and each deque
+// recycles its blocks through a pool resource, so queuing a per-tick task
+// does not touch the heap once the deques have grown.
+//
+// Worker i runs where the process topology places alpha.worker thread i,
+// and its deque blocks come from that worker's NUMA node, so the state a
+// worker builds and the queue it drains are local to it.
 class ThreadPool {
 public:
+    using Task = common::InlineTask<AlphaConfig::TASK_INLINE_BYTES>;
+    static constexpr size_t NO_WORKER = static_cast<size_t>(-1);
+    
     explicit ThreadPool(size_t numThreads);
     ~ThreadPool();
     
-    // Enqueue task with lambda support
+    // Enqueue task with lambda support - onto the caller's own deque when
+    // called from a worker, otherwise round-robin
     template<typename Func>
     void enqueue(Func&& task) {
+        size_t target = currentWorker() != NO_WORKER ? currentWorker() : nextQueue();
+        WorkerQueue& queue = *queues_[target];
+        stealablePending_.fetch_add(1);  // Before the push so the count never underflows
         {
-            std::unique_lock<std::mutex> lock(queueMutex_);
-            tasks_.emplace(std::forward<Func>(task));
+            std::lock_guard<std::mutex> lock(queue.mutex);
+            queue.tasks.push_back({Task(std::forward<Func>(task)), common::TscClock::now()});
         }
-        condition_.notify_one();
+        wake(false);
     }
     
+    // Spread a batch across all deques with one lock per deque and one wakeup
+    void enqueueBatch(std::vector<Task>& tasks);
+    
+    // Run task on the given worker only; tasks pinned to one worker run in
+    // submission order
+    template<typename Func>
+    void enqueueTo(size_t worker, Func&& task) {
+        WorkerQueue& queue = *queues_[worker % queues_.size()];
+        queue.pinnedPending.fetch_add(1);
+        {
+            std::lock_guard<std::mutex> lock(queue.mutex);
+            queue.pinned.push_back({Task(std::forward<Func>(task)), common::TscClock::now()});
+        }
+        wake(true);
+    }
+    
+    size_t size() const { return queues_.size(); }
+    
+    // Block until every task submitted so far has finished. Must not be
+    // called from a worker.
+    void waitIdle();
+    
+    // Index of the calling worker thread, NO_WORKER outside the pool
+    static size_t currentWorker();
+    
     // Deleted copy/move
     ThreadPool(const ThreadPool&) = delete;
     ThreadPool& operator=(const ThreadPool&) = delete;
@@ -50,64 +165,289 @@ public:
     bool isStopped() const { return stop_.load(); }
 
 private:
+    struct QueuedTask {
+        Task run;
+        uint64_t queuedAt;  // TscClock ticks
+    };
+    
+    struct alignas(common::CACHE_LINE_SIZE) WorkerQueue {
+        explicit WorkerQueue(std::pmr::memory_resource* upstream) : blocks(upstream) {}
+        
+        std::mutex mutex;
+        std::pmr::unsynchronized_pool_resource blocks;    // Deque blocks; used under mutex
+        std::pmr::deque<QueuedTask> tasks{&blocks};       // Stealable
+        std::pmr::deque<QueuedTask> pinned{&blocks};      // Owner only
+        std::atomic<size_t> pinnedPending{0};
+    };
+    
     std::vector<std::thread> workers_;
-    std::queue<std::function<void()>> tasks_;
-    std::mutex queueMutex_;
+    std::vector<std::unique_ptr<WorkerQueue>> queues_;
+    std::atomic<size_t> nextQueue_{0};
+    std::atomic<size_t> stealablePending_{0};
+    std::atomic<size_t> active_{0};  // Popped and not yet finished
+    
+    // Sleep/wake for idle workers; sleepers_ lets submitters skip the lock
+    std::mutex sleepMutex_;
     std::condition_variable condition_;
+    std::atomic<size_t> sleepers_{0};
     std::atomic<bool> stop_{false};
     
-    void workerThread();
+    size_t nextQueue() { return nextQueue_.fetch_add(1, std::memory_order_relaxed) % queues_.size(); }
+    void wake(bool all);
+    bool popTask(size_t self, QueuedTask& task);
+    void workerThread(size_t index);
 };
 
 // Signal callback type
 using SignalCallback = std::function<void(AlphaSignal&&)>;
 
+// Inter-stage transport: one upstream feeder, many worker producers downstream
+using MarketDataRing = common::SpscRing<MarketData, AlphaConfig::INPUT_RING_CAPACITY>;
+using SignalRing = common::MpmcRing<AlphaSignal, AlphaConfig::SIGNAL_RING_CAPACITY>;
+
+// Newest tick per symbol id
+using MarketDataCache = common::LastValueCache<MarketData>;
+
 // Alpha Engine Pool - manages thousands of alphas
 class AlphaEnginePool {
 public:
-    explicit AlphaEnginePool(size_t numThreads = 8);
+    explicit AlphaEnginePool(size_t numThreads = 8,
+                             SchedulingMode mode = SchedulingMode::SYMBOL_SHARDED);
     ~AlphaEnginePool();
     
     // Add alpha to the pool
     void addAlpha(std::unique_ptr<IAlphaStrategy> alpha);
     
-    // Load alphas from plugin directory
+    // Add a family of alphas evaluated together; scheduled like one alpha
+    void addAlphaBatch(std::unique_ptr<IAlphaBatch> batch);
+    
+    // Load alphas from plugin directory. The directory is remembered for
+    // refreshPlugins().
     bool loadPlugins(std::string_view pluginDir);
     
+    // Hot-reload the ABI plugin loaded from pluginPath without stopping the
+    // pool. The new version is loaded on the calling thread, then swapped in
+    // on the plugin's worker between two tick batches, taking over the old
+    // instance's state when both versions support it. Must not be called
+    // from a pool worker.
+    bool reloadPlugin(std::string_view pluginPath);
+    
+    // Reload plugins whose file changed and load new files from the plugin
+    // directories; returns how many were loaded or reloaded
+    size_t refreshPlugins();
+    
     // Process market data through all alphas
     void processMarketData(const MarketData& data);
     
+    // Process a run of ticks in order. Sharded modes submit one task per
+    // worker for the whole batch instead of one per tick; ABI plugins always
+    // get the whole batch in one on_ticks() call.
+    void processMarketDataBatch(const MarketData* ticks, size_t count);
+    
     // Register callback for signals
     void registerSignalCallback(SignalCallback callback);
     
+    // Block until every tick submitted so far has been processed and its
+    // signals emitted
+    void waitIdle() { threadPool_->waitIdle(); }
+    
+    // Consume ticks from a ring on a dedicated thread (started by start())
+    // instead of having the producer call processMarketData() directly. The
+    // thread and the ring are placed as the topology's alpha.input stage.
+    void attachInput(MarketDataRing& ring);
+    
+    // FULL (default): every tick reaches the alphas. CONFLATED: ticks only
+    // update a last-value cache, and each worker takes the newest tick of
+    // every symbol that changed since it last ran, so a hot symbol costs
+    // one pending task per worker instead of one per tick. Sharded modes
+    // only, as WORK_STEALING has no worker owning a symbol's ticks. Call
+    // before start(); conflated ticks must come from a single thread.
+    bool setInputPolicy(common::DeliveryPolicy policy);
+    common::DeliveryPolicy getInputPolicy() const { return inputPolicy_; }
+    
+    // Tick deliveries to workers skipped because a newer tick of the same
+    // symbol replaced them first (CONFLATED only)
+    uint64_t getConflatedCount() const;
+    
+    // Newest tick per symbol; nullptr unless CONFLATED
+    const MarketDataCache* getMarketDataCache() const { return tickCache_.get(); }
+    
+    // Push signals into a ring instead of invoking callbacks on the workers.
+    // A full ring drops the signal. The ring must outlive the pool.
+    void setSignalRing(SignalRing* ring) { signalRing_ = ring; }
+    size_t getSignalDrops() const { return signalDrops_.load(); }
+    
     // Get statistics - demonstrating different parameter passing
     void getStats(size_t& numAlphas, size_t& numSignals) const;  // By reference
     void getStats(size_t* numAlphas, size_t* numSignals) const;  // By pointer
     
+    // Snapshot the state of every alpha and batch that supports it into
+    // out, one section per instance. Sharded modes queue a pinned task on
+    // each worker between two dispatches, so every worker copies its state
+    // out as of the same tick while the feeder keeps going; WORK_STEALING
+    // drains the pool first. The watermark is the newest tick timestamp
+    // dispatched before the snapshot. ABI plugins are not included. Returns
+    // the sections written.
+    size_t checkpoint(common::CheckpointWriter& out);
+    
+    // Restore state written by checkpoint(), matched to alphas by id; the
+    // pool may have a different number of workers. Call before start(), once
+    // the alphas are added. Returns the sections restored; other alphas
+    // start cold.
+    size_t restoreCheckpoint(const common::CheckpointReader& in);
+    
     // Start and stop processing
     void start();
     void stop();
+    
+    SchedulingMode getSchedulingMode() const { return mode_; }
+    size_t getNumThreads() const { return threadPool_->size(); }
 
 private:
+    // A loaded ABI plugin. plugin is replaced only on the owning worker, so
+    // the tasks there never see it change mid-batch.
+    struct PluginSlot {
+        std::unique_ptr<AbiPlugin> plugin;
+        std::string path;
+        std::string name;
+        size_t numAlphas{0};
+        size_t worker{0};
+    };
+    
+    // Immutable view of the alphas shared with in-flight tasks; rebuilt by
+    // addAlpha so ticks never hold alphasMutex_ while alphas run
+    struct AlphaSnapshot {
+        std::vector<IAlphaStrategy*> alphas;
+        // Per worker. SHARDED: the alphas it owns. SYMBOL_SHARDED: alphas that
+        // cannot be cloned, owned whole and fed every tick.
+        std::vector<std::vector<IAlphaStrategy*>> shards;
+        // Per worker, SYMBOL_SHARDED only: its replica of every cloneable
+        // alpha, fed the ticks of the symbols the worker owns
+        std::vector<std::vector<IAlphaStrategy*>> replicas;
+        // Alpha batches, split the same way
+        std::vector<IAlphaBatch*> batches;
+        std::vector<std::vector<IAlphaBatch*>> batchShards;
+        std::vector<std::vector<IAlphaBatch*>> batchReplicas;
+        // Per worker: the ABI plugins it runs, once per tick batch
+        std::vector<std::vector<PluginSlot*>> pluginShards;
+        bool hasPlugins{false};
+        
+        // True if the worker has anything to run for a tick it does not own
+        bool ownsWhole(size_t worker) const {
+            return !shards[worker].empty() || !batchShards[worker].empty();
+        }
+        bool hasReplicas(size_t worker) const {
+            return !replicas[worker].empty() || !batchReplicas[worker].empty();
+        }
+    };
+    
+    // A worker's conflated input: symbols changed since it last drained
+    struct ConflatedInput {
+        common::ConflationQueue queue;
+        std::atomic<bool> scheduled{false};   // A drain task is queued
+        std::vector<MarketData> buffer;       // Drained ticks; worker only
+    };
+    
+    // Shared tick batches and their control blocks, recycled across threads.
+    // Declared before the pool so it outlives every queued task.
+    std::pmr::synchronized_pool_resource batchResource_;
     std::unique_ptr<ThreadPool> threadPool_;
+    SchedulingMode mode_;
+    common::DeliveryPolicy inputPolicy_{common::DeliveryPolicy::FULL};
+    std::unique_ptr<MarketDataCache> tickCache_;                  // CONFLATED only
+    std::vector<std::unique_ptr<ConflatedInput>> conflatedInputs_;  // Per worker, CONFLATED only
     std::vector<std::unique_ptr<IAlphaStrategy>> alphas_;
+    std::vector<std::vector<std::unique_ptr<IAlphaStrategy>>> replicas_;  // [alpha][worker], empty if not cloneable
+    std::vector<std::unique_ptr<IAlphaBatch>> batches_;
+    std::vector<std::vector<std::unique_ptr<IAlphaBatch>>> batchReplicas_;  // [batch][worker]
+    std::vector<std::unique_ptr<PluginSlot>> plugins_;
+    size_t numBatchedAlphas_{0};
+    std::shared_ptr<const AlphaSnapshot> snapshot_;
     std::vector<SignalCallback> signalCallbacks_;
+    std::unique_ptr<common::RingConsumer<MarketDataRing>> inputConsumer_;
+    SignalRing* signalRing_{nullptr};
+    std::atomic<size_t> signalDrops_{0};
     
     mutable std::mutex alphasMutex_;
+    
+    // Held while a dispatch queues its tasks, so checkpoint() tasks land
+    // between two dispatches on every worker. Uncontended on the feeder.
+    std::mutex dispatchMutex_;
+    int64_t lastDispatchedNs_{0};  // Newest tick timestamp dispatched; under dispatchMutex_
+    
     mutable std::atomic<size_t> numSignalsGenerated_{0};
     std::atomic<bool> running_{false};
     
     // Process single alpha
     void processAlpha(IAlphaStrategy* alpha, const MarketData& data);
     
+    // Process a run of alphas for one tick inside a single task
+    void processAlphas(IAlphaStrategy* const* alphas, size_t count, const MarketData& data);
+    
+    // Process batches for one tick, through the calling thread's signal buffer
+    void processBatches(IAlphaBatch* const* batches, size_t count, const MarketData& data);
+    
+    // Run ABI plugins over a whole tick block
+    void processPlugins(PluginSlot* const* plugins, size_t count, const wq_tick_block& ticks);
+    
+    // WORK_STEALING: one tick through the stealable chunk tasks
+    void dispatchStealable(const std::shared_ptr<const AlphaSnapshot>& snapshot, const MarketData& data);
+    
+    // Batch shared by the tasks of one dispatch, from batchResource_
+    std::shared_ptr<const TickBatch> makeBatch(const MarketData* ticks, size_t count, bool withColumns);
+    
+    // Unsharded modes: one pinned task per worker that runs plugins
+    void dispatchPlugins(const std::shared_ptr<const AlphaSnapshot>& snapshot,
+                         const std::shared_ptr<const TickBatch>& batch);
+    
+    // Count a generated signal and hand it downstream
+    void emitSignal(AlphaSignal& signal);
+    
+    // CONFLATED: cache the ticks and queue a drain on each worker that needs them
+    void conflateTicks(const MarketData* ticks, size_t count);
+    
+    // CONFLATED: run the newest ticks of the worker's changed symbols, on that worker
+    void drainConflated(size_t worker);
+    
+    // Note the newest timestamp of ticks about to be dispatched; caller holds dispatchMutex_
+    void noteDispatchedLocked(const MarketData* ticks, size_t count);
+    
+    // Write the state of what the worker runs: its owned alphas and batches
+    // and its replicas
+    size_t serializeWorker(const AlphaSnapshot& snapshot, size_t worker, common::CheckpointWriter& out) const;
+    
+    // Run one worker's share of a batch (sharded modes), on that worker
+    void processBatchOnWorker(const AlphaSnapshot& snapshot, const TickBatch& batch, size_t worker);
+    
+    // Worker owning a symbol's replicas under SYMBOL_SHARDED
+    size_t symbolOwner(SymbolId symbolId) const { return symbolId % threadPool_->size(); }
+    
+    std::shared_ptr<const AlphaSnapshot> loadSnapshot() const;
+    
+    // Rebuild snapshot_ after alphas_ changed; caller holds alphasMutex_
+    void rebuildSnapshotLocked();
+    
     // Notify callbacks
     void notifyCallbacks(AlphaSignal&& signal);
     
-    // Load single plugin
+    // Load single plugin; caller holds pluginMutex_
     bool loadPlugin(const std::string& pluginPath);
     
+    // Register a loaded ABI plugin with the next worker in turn
+    void addPlugin(std::unique_ptr<AbiPlugin> plugin);
+    
+    // Swap in a fresh copy of the slot's library; caller holds pluginMutex_
+    bool reloadPluginLocked(PluginSlot& slot);
+    
     // Dynamically allocated plugin handles
     std::vector<void*> pluginHandles_;
+    
+    // Serializes loads and reloads. Guards the fields below; plugins_ is
+    // written with both this and alphasMutex_ held.
+    std::mutex pluginMutex_;
+    std::vector<std::string> pluginDirs_;
+    std::unordered_map<std::string, std::filesystem::file_time_type> pluginFiles_;  // Last seen mtimes
+    std::unordered_set<std::string> legacyPlugins_;  // Loaded through AlphaPluginInterface; not reloadable
 };
 
 // Factory for creating specific alpha types
@@ -122,37 +462,14 @@ public:
     // Create alpha by name (demonstrates function overloading)
     static std::unique_ptr<IAlphaStrategy> create(std::string_view alphaType, std::string_view alphaId);
     static std::unique_ptr<IAlphaStrategy> create(std::string_view alphaType, std::string_view alphaId, int param);
-};
-
-// RAII wrapper for plugin loading
-class PluginLoader {
-public:
-    explicit PluginLoader(std::string_view path);
-    ~PluginLoader();
-    
-    // Move only
-    PluginLoader(PluginLoader&& other) noexcept;
-    PluginLoader& operator=(PluginLoader&& other) noexcept;
-    
-    // Deleted copy
-    PluginLoader(const PluginLoader&) = delete;
-    PluginLoader& operator=(const PluginLoader&) = delete;
     
-    bool isLoaded() const { return handle_ != nullptr; }
-    void* getHandle() const { return handle_; }
-    
-    // Get symbol with type deduction
-    template<typename T>
-    T getSymbol(std::string_view symbolName) const {
-        if (!handle_) return nullptr;
-        return reinterpret_cast<T>(getSymbolImpl(symbolName));
+    // Create a whole family as one batch: member i is "<idPrefix><i>" with params[i]
+    template<typename TBatch, typename... Args>
+    static std::unique_ptr<IAlphaBatch> createBatch(Args&&... args) {
+        return std::make_unique<TBatch>(std::forward<Args>(args)...);
     }
-
-private:
-    void* handle_{nullptr};
-    std::string path_;
-    
-    void* getSymbolImpl(std::string_view symbolName) const;
+    static std::unique_ptr<IAlphaBatch> createBatch(std::string_view alphaType, std::string_view idPrefix,
+                                                    const std::vector<int>& params);
 };
 
 } // namespace wq::alpha
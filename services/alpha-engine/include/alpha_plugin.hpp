@@ -0,0 +1,138 @@
+#pragma once
+
+#include "alpha_plugin_abi.h"
+#include "alpha_strategy.hpp"
+#include <algorithm>
+#include <cstdint>
+#include <memory>
+#include <string>
+#include <string_view>
+#include <vector>
+
+namespace wq::alpha {
+
+// RAII wrapper for plugin loading
+class PluginLoader {
+public:
+    explicit PluginLoader(std::string_view path);
+    ~PluginLoader();
+
+    // Move only
+    PluginLoader(PluginLoader&& other) noexcept;
+    PluginLoader& operator=(PluginLoader&& other) noexcept;
+
+    // Deleted copy
+    PluginLoader(const PluginLoader&) = delete;
+    PluginLoader& operator=(const PluginLoader&) = delete;
+
+    bool isLoaded() const { return handle_ != nullptr; }
+    void* getHandle() const { return handle_; }
+
+    // Get symbol with type deduction
+    template<typename T>
+    T getSymbol(std::string_view symbolName) const {
+        if (!handle_) return nullptr;
+        return reinterpret_cast<T>(getSymbolImpl(symbolName));
+    }
+
+private:
+    void* handle_{nullptr};
+    std::string path_;
+
+    void* getSymbolImpl(std::string_view symbolName) const;
+};
+
+// One instance of a plugin built against alpha_plugin_abi.h. The engine
+// reaches it only through the plugin's C function table. The signal columns
+// are owned here and reused from call to call. Not thread-safe: the engine
+// drives each instance from a single worker.
+class AbiPlugin {
+public:
+    // Open the library at path and create an instance. privateCopy maps a
+    // temporary copy of the file, so a library rebuilt in place is loaded
+    // afresh instead of dlopen() handing back the one already mapped.
+    // nullptr if the library is missing or incompatible (logged).
+    static std::unique_ptr<AbiPlugin> load(const std::string& path, std::string_view config,
+                                           bool privateCopy = false);
+
+    // Same, for a library the caller already opened
+    static std::unique_ptr<AbiPlugin> create(std::unique_ptr<PluginLoader> library,
+                                             const std::string& path, std::string_view config);
+
+    ~AbiPlugin();
+
+    AbiPlugin(const AbiPlugin&) = delete;
+    AbiPlugin& operator=(const AbiPlugin&) = delete;
+
+    const std::string& getName() const { return name_; }
+    const std::string& getVersion() const { return version_; }
+    const std::string& getPath() const { return path_; }
+
+    // Number of alphas the instance hosts
+    size_t size() const { return alphaIds_.size(); }
+
+    // Run one block of ticks and hand every signal to emit(AlphaSignal&).
+    // Output the plugin reports out of range is dropped.
+    template<typename Emit>
+    void onTicks(const wq_tick_block& ticks, Emit&& emit);
+
+    // Move a previous instance's warmed-up state into this one. false if
+    // either side lacks state transfer or the load fails; this instance
+    // then starts cold.
+    bool takeStateFrom(AbiPlugin& previous);
+
+private:
+    AbiPlugin(std::unique_ptr<PluginLoader> library, const wq_alpha_plugin_v1& api,
+              void* instance, const std::string& path);
+
+    std::unique_ptr<PluginLoader> library_;  // Declared first: closed after the instance is destroyed
+    wq_alpha_plugin_v1 api_;  // The plugin's table; fields past its struct_size are null
+    void* instance_;
+    std::string path_;
+    std::string name_;
+    std::string version_;
+    std::vector<AlphaIdString> alphaIds_;
+    std::vector<AlphaIndex> alphaIndices_;
+
+    // Signal block columns, grown to the largest tick block seen
+    std::vector<uint32_t> signalTicks_;
+    std::vector<uint32_t> signalAlphas_;
+    std::vector<double> signalValues_;
+    std::vector<double> signalConfidences_;
+    wq_signal_block signals_{};
+
+    wq_signal_block& prepareSignals(size_t numTicks);
+};
+
+template<typename Emit>
+void AbiPlugin::onTicks(const wq_tick_block& ticks, Emit&& emit) {
+    if (ticks.count == 0 || alphaIds_.empty()) {
+        return;
+    }
+
+    wq_signal_block& signals = prepareSignals(ticks.count);
+    api_.on_ticks(instance_, &ticks, &signals);
+
+    size_t count = std::min(signals.count, signals.capacity);
+    for (size_t n = 0; n < count; ++n) {
+        uint32_t tick = signals.ticks[n];
+        uint32_t alpha = signals.alphas[n];
+        if (tick >= ticks.count || alpha >= alphaIds_.size()) {
+            continue;
+        }
+
+        AlphaSignal signal;
+        signal.alphaId = alphaIds_[alpha];
+        signal.alphaIndex = alphaIndices_[alpha];
+        signal.symbol = SymbolString::fromBuffer(ticks.symbols + tick * ticks.symbol_stride,
+                                                 ticks.symbol_size);
+        signal.symbolId = ticks.symbol_ids[tick];
+        signal.signal = std::clamp(signals.signals[n], AlphaConfig::MIN_SIGNAL, AlphaConfig::MAX_SIGNAL);
+        signal.confidence = std::clamp(signals.confidences[n],
+                                       AlphaConfig::MIN_CONFIDENCE, AlphaConfig::MAX_CONFIDENCE);
+        signal.timestampNs = ticks.timestamps_ns[tick];
+        emit(signal);
+    }
+}
+
+} // namespace wq::alpha
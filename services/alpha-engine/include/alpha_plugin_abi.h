@@ -0,0 +1,87 @@
+#pragma once
+
+/*
+ * C ABI for alpha plugins. Plugins written against this header depend only
+ * on C types, not on the engine's compiler, standard library or vtables.
+ *
+ * A plugin exports one function, wq_alpha_plugin_entry(). The engine passes
+ * the ABI version it speaks. The plugin returns its descriptor, or NULL if
+ * it cannot serve that version. Ticks arrive in blocks of columns that
+ * point straight at the engine's buffers. Signals go into columns the
+ * engine preallocated. Nothing is copied or allocated per call.
+ *
+ * Compatibility rules: fields are only ever appended to these structs, and
+ * struct_size tells each side how much of the other's struct it may read.
+ * Removing or changing a field bumps WQ_ALPHA_ABI_VERSION.
+ */
+
+#include <stddef.h>
+#include <stdint.h>
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+#define WQ_ALPHA_ABI_VERSION 1u
+#define WQ_ALPHA_PLUGIN_ENTRY "wq_alpha_plugin_entry"
+
+/* Ticks for one on_ticks() call, in feed order. Column i of every array
+ * describes tick i. Symbols are NUL-padded fields of symbol_size bytes,
+ * symbol_stride bytes apart; symbol_ids are the engine's interned ids and
+ * stay stable for the life of the process. */
+typedef struct wq_tick_block {
+    uint32_t struct_size;
+    size_t count;
+    const uint32_t* symbol_ids;
+    const double* prices;
+    const int64_t* volumes;
+    const int64_t* timestamps_ns;
+    const char* symbols;
+    size_t symbol_stride;
+    size_t symbol_size;
+} wq_tick_block;
+
+/* Output of one on_ticks() call. The plugin writes signal n into column n
+ * and sets count. tick is the index of the tick that produced the signal;
+ * alpha is the index of the plugin alpha, below alpha_count(). capacity is
+ * at least ticks->count * alpha_count(). */
+typedef struct wq_signal_block {
+    uint32_t struct_size;
+    size_t capacity;
+    size_t count;
+    uint32_t* ticks;
+    uint32_t* alphas;
+    double* signals;     /* -1.0 to +1.0 */
+    double* confidences; /* 0.0 to 1.0 */
+} wq_signal_block;
+
+typedef struct wq_alpha_plugin_v1 {
+    uint32_t abi_version; /* WQ_ALPHA_ABI_VERSION the plugin was built against */
+    uint32_t struct_size; /* sizeof(wq_alpha_plugin_v1) in the plugin; the engine
+                           * treats fields past it as absent */
+    const char* name;     /* Stable across versions; hot reload matches on it */
+    const char* version;
+
+    /* One instance may host several alphas. config is the engine-supplied
+     * configuration string. */
+    void* (*create)(const char* config);
+    void (*destroy)(void* instance);
+    uint32_t (*alpha_count)(void* instance);
+    const char* (*alpha_id)(void* instance, uint32_t alpha);
+
+    /* Called on a single engine thread per instance, never concurrently */
+    void (*on_ticks)(void* instance, const wq_tick_block* ticks, wq_signal_block* signals);
+
+    /* Optional (may be NULL): carry warmed-up state across a hot reload.
+     * save_state writes at most capacity bytes and returns the size it
+     * needs, so a call with capacity 0 sizes the buffer. load_state returns
+     * 0 on success; on failure the new instance starts cold. */
+    size_t (*save_state)(void* instance, void* buffer, size_t capacity);
+    int (*load_state)(void* instance, const void* buffer, size_t size);
+} wq_alpha_plugin_v1;
+
+typedef const wq_alpha_plugin_v1* (*wq_alpha_plugin_entry_fn)(uint32_t host_abi_version);
+
+#ifdef __cplusplus
+}
+#endif
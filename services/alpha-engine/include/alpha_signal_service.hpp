@@ -0,0 +1,34 @@
+#pragma once
+
+#include "alpha_strategy.hpp"
+#include "async_server.hpp"
+#include "alpha_signals.grpc.pb.h"
+
+namespace wq::alpha {
+
+void toProto(const AlphaSignal& signal, proto::AlphaSignal* out);
+
+// AlphaSignalService on the async server. Each subscriber of StreamSignals
+// gets the signals of the alphas it asked for (all if none), batched into
+// AggregatedSignals messages and conflated to the newest signal per alpha
+// and symbol if it falls behind.
+class AlphaSignalServiceImpl {
+public:
+    using AsyncService = proto::AlphaSignalService::AsyncService;
+
+    // Registers with server, which must not have started yet
+    explicit AlphaSignalServiceImpl(common::AsyncServer& server);
+
+    // From the single signal consumer thread
+    void publish(const AlphaSignal* signals, size_t count);
+
+    size_t getSubscriberCount() const { return stream_.getSubscriberCount(); }
+    uint64_t getConflatedCount() const { return stream_.getConflatedCount(); }
+
+private:
+    AsyncService service_;
+    common::StreamPublisher<AsyncService, proto::SignalRequest, proto::AggregatedSignals, proto::AlphaSignal> stream_;
+    common::CallArena stagingArena_;  // Converted signals of one publish(), shared by all subscribers
+};
+
+} // namespace wq::alpha
@@ -1,32 +1,41 @@
 #pragma once
 
+#include "checkpoint.hpp"
+#include "fixed_string.hpp"
+#include "rolling_window.hpp"
+#include "symbol_table.hpp"
+#include <functional>
 #include <string>
+#include <unordered_map>
 #include <string_view>
 #include <memory>
 #include <optional>
+#include <vector>
 #include <cstdint>
 
 namespace wq::alpha {
 
+using common::AlphaIdString;
+using common::AlphaIndex;
+using common::SymbolId;
+using common::SymbolString;
+
 // Forward declaration
 struct MarketData;
 
-// Signal structure
+// Picks the symbols an instance takes from a checkpoint
+using SymbolFilter = std::function<bool(SymbolId)>;
+
+// Signal structure - identifiers are stored inline, so signals never allocate.
+// Trivially copyable: copies are a memcpy and signals can travel through rings.
 struct AlphaSignal {
-    std::string alphaId;
-    std::string symbol;
-    double signal;       // -1.0 to +1.0
-    double confidence;   // 0.0 to 1.0
-    int64_t timestampNs;
-    
-    // Move semantics
-    AlphaSignal() = default;
-    AlphaSignal(AlphaSignal&&) noexcept = default;
-    AlphaSignal& operator=(AlphaSignal&&) noexcept = default;
-    
-    // Deleted copy
-    AlphaSignal(const AlphaSignal&) = delete;
-    AlphaSignal& operator=(const AlphaSignal&) = delete;
+    AlphaIdString alphaId;
+    AlphaIndex alphaIndex{common::INVALID_ALPHA_INDEX};
+    SymbolString symbol;
+    SymbolId symbolId{common::INVALID_SYMBOL_ID};
+    double signal{0};       // -1.0 to +1.0
+    double confidence{0};   // 0.0 to 1.0
+    int64_t timestampNs{0};
 };
 
 // Abstract base class for Alpha strategies (demonstrates pure virtual functions)
@@ -45,6 +54,28 @@ public:
         return true;
     }
     
+    // Fresh instance with the same configuration and no market state, used to
+    // give each worker its own replica under SYMBOL_SHARDED scheduling.
+    // nullptr (the default) keeps a single instance owned by one worker.
+    virtual std::unique_ptr<IAlphaStrategy> clone() const {
+        return nullptr;
+    }
+    
+    // Write the market state into the checkpoint section the pool opened for
+    // this alpha, symbols by name rather than interned id. The default saves
+    // nothing and returns false, so the alpha starts cold after a restore.
+    virtual bool serialize(common::CheckpointWriter& /*out*/) const {
+        return false;
+    }
+    
+    // Merge state saved by serialize() on an instance with the same
+    // configuration, taking only the symbols keep accepts (a replica takes
+    // those its worker owns). False if the section does not fit, in which
+    // case the alpha keeps the state it had.
+    virtual bool restore(common::CheckpointSection& /*in*/, const SymbolFilter& /*keep*/) {
+        return false;
+    }
+    
     // Non-virtual public interface
     int64_t getLastUpdateTime() const {
         return lastUpdateTime_;
@@ -61,22 +92,29 @@ public:
     ~MeanReversionAlpha() override = default;
     
     std::string_view getAlphaId() const override {
-        return alphaId_;
+        return alphaId_.view();
     }
     
     std::optional<AlphaSignal> onMarketData(const MarketData& data) override;
     void initialize() override;
     void shutdown() override;
     bool isActive() const override;
+    std::unique_ptr<IAlphaStrategy> clone() const override;
+    bool serialize(common::CheckpointWriter& out) const override;
+    bool restore(common::CheckpointSection& in, const SymbolFilter& keep) override;
 
 private:
-    std::string alphaId_;
+    // Price window kept separately for every symbol
+    struct SymbolState {
+        explicit SymbolState(size_t windowSize) : prices(windowSize) {}
+        RollingMoments prices;
+    };
+    
+    AlphaIdString alphaId_;
+    AlphaIndex alphaIndex_;
     int windowSize_;
-    std::vector<double> priceHistory_;
+    std::unordered_map<SymbolId, SymbolState> symbolStates_;
     bool initialized_{false};
-    
-    double calculateMean() const;
-    double calculateStdDev() const;
 };
 
 // Momentum alpha
@@ -86,20 +124,70 @@ public:
     ~MomentumAlpha() override = default;
     
     std::string_view getAlphaId() const override {
-        return alphaId_;
+        return alphaId_.view();
     }
     
     std::optional<AlphaSignal> onMarketData(const MarketData& data) override;
     void initialize() override;
     void shutdown() override;
+    std::unique_ptr<IAlphaStrategy> clone() const override;
+    bool serialize(common::CheckpointWriter& out) const override;
+    bool restore(common::CheckpointSection& in, const SymbolFilter& keep) override;
 
 private:
-    std::string alphaId_;
+    // Return history kept separately for every symbol
+    struct SymbolState {
+        explicit SymbolState(size_t lookbackPeriod) : returns(lookbackPeriod) {}
+        RollingSum returns;
+        std::optional<double> lastPrice;
+    };
+    
+    AlphaIdString alphaId_;
+    AlphaIndex alphaIndex_;
     int lookbackPeriod_;
-    std::vector<double> returns_;
-    std::optional<double> lastPrice_;
+    std::unordered_map<SymbolId, SymbolState> symbolStates_;
 };
 
+// Checkpoint helpers for per-symbol state maps. Entries are keyed by symbol
+// name, since interned ids differ between runs; save(state, out) writes one
+// state and load(state, in) reads one back into a state built by make().
+template<typename State, typename Save>
+void serializeSymbolStates(common::CheckpointWriter& out, const std::unordered_map<SymbolId, State>& states,
+                           Save&& save) {
+    out.write<uint64_t>(states.size());
+    for (const auto& [symbolId, state] : states) {
+        out.write(common::symbolTable().name(symbolId));
+        save(state, out);
+    }
+}
+
+// Every entry is decoded before any is applied, so a section that does not
+// fit leaves states as they were. Entries keep rejects are skipped.
+template<typename State, typename Make, typename Load>
+bool restoreSymbolStates(common::CheckpointSection& in, const SymbolFilter& keep,
+                         std::unordered_map<SymbolId, State>& states, Make&& make, Load&& load) {
+    uint64_t count;
+    if (!in.read(count)) {
+        return false;
+    }
+    std::vector<std::pair<SymbolId, State>> restored;
+    for (uint64_t i = 0; i < count; ++i) {
+        SymbolString symbol;
+        State state = make();
+        if (!in.read(symbol) || !load(state, in)) {
+            return false;
+        }
+        SymbolId symbolId = common::symbolTable().internName(symbol);
+        if (symbolId != common::INVALID_SYMBOL_ID && keep(symbolId)) {
+            restored.emplace_back(symbolId, std::move(state));
+        }
+    }
+    for (auto& [symbolId, state] : restored) {
+        states.insert_or_assign(symbolId, std::move(state));
+    }
+    return true;
+}
+
 // Template class for generic alpha wrapper
 template<typename TSignal, typename TData>
 class AlphaWrapper {
@@ -144,6 +232,13 @@ namespace AlphaConfig {
     constexpr double MAX_SIGNAL = 1.0;
     constexpr double MIN_CONFIDENCE = 0.0;
     constexpr double MAX_CONFIDENCE = 1.0;
+    constexpr size_t INPUT_RING_CAPACITY = 65536;   // Ticks buffered from the feed
+    constexpr size_t SIGNAL_RING_CAPACITY = 65536;  // Signals buffered for the aggregator
+    constexpr size_t ALPHA_BATCH_SIZE = 32;         // Alphas per work-stealing task
+    constexpr size_t CONFLATION_DRAIN_BATCH = 256;  // Conflated ticks per worker batch
+    constexpr size_t TASK_INLINE_BYTES = 112;       // Pool task closures stored without allocating
+    constexpr const char* PLUGIN_DIR = "plugins";   // Default ABI plugin directory
+    constexpr int PLUGIN_REFRESH_TICKS = 10;        // Simulated ticks between plugin refreshes
 }
 
 } // namespace wq::alpha
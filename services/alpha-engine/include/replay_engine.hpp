@@ -0,0 +1,247 @@
+#pragma once
+
+#include "alpha_engine.hpp"
+#include "ipc_transport.hpp"
+#include "tick_store.hpp"
+#include <algorithm>
+#include <atomic>
+#include <cstdint>
+#include <functional>
+#include <limits>
+#include <memory>
+#include <string>
+#include <vector>
+
+namespace wq::alpha {
+
+namespace ReplayConfig {
+    constexpr size_t CHUNK_TICKS = 1024;             // Ticks between output barriers
+    constexpr uint32_t RECORD_FILE_MAGIC = 0x52545157;  // "WQTR"
+    constexpr uint32_t RECORD_FILE_VERSION = 1;
+}
+
+// Replay time: follows the timestamps of the ticks replayed so far instead of
+// the wall clock
+class SimulatedClock {
+public:
+    int64_t nowNs() const { return nowNs_.load(std::memory_order_acquire); }
+
+    // Never moves backwards
+    void advanceTo(int64_t timestampNs) {
+        if (timestampNs > nowNs_.load(std::memory_order_relaxed)) {
+            nowNs_.store(timestampNs, std::memory_order_release);
+        }
+    }
+
+private:
+    std::atomic<int64_t> nowNs_{0};
+};
+
+// Recorded ticks, in feed order
+class ITickSource {
+public:
+    virtual ~ITickSource() = default;
+
+    // Fill up to maxTicks ticks; 0 at the end of the data
+    virtual size_t read(MarketData* out, size_t maxTicks) = 0;
+
+    // Keep only symbols with hash % numShards == shard (a stable hash, so
+    // every run splits the same way)
+    void setSymbolShard(size_t shard, size_t numShards) {
+        numShards_ = std::max<size_t>(numShards, 1);
+        shard_ = shard % numShards_;
+    }
+
+    // Keep only ticks stamped after timestampNs, such as a checkpoint's
+    // watermark. Sources with a timestamp index also skip straight there.
+    virtual void resumeAfter(int64_t timestampNs) {
+        resumeAfterNs_ = timestampNs;
+    }
+
+protected:
+    bool inShard(const SymbolString& symbol) const {
+        return numShards_ <= 1 || symbol.hash() % numShards_ == shard_;
+    }
+    
+    // In this source's shard and after its resume point
+    bool wanted(const SymbolString& symbol, int64_t timestampNs) const {
+        return timestampNs > resumeAfterNs_ && inShard(symbol);
+    }
+
+private:
+    size_t shard_{0};
+    size_t numShards_{1};
+    int64_t resumeAfterNs_{std::numeric_limits<int64_t>::min()};
+};
+
+// Header of a tick record file: a flat array of common::TickRecord, as the
+// co-located feed publishes them
+struct TickRecordFileHeader {
+    uint32_t magic;
+    uint32_t version;
+    uint32_t recordSize;
+    uint32_t reserved;
+    uint64_t count;
+};
+
+// Tick record file mapped read-only; records are converted as they are read
+class TickRecordFileSource : public ITickSource {
+public:
+    // nullptr if the file is missing or not a tick record file of this build
+    static std::unique_ptr<TickRecordFileSource> open(const std::string& path);
+    ~TickRecordFileSource() override;
+
+    TickRecordFileSource(const TickRecordFileSource&) = delete;
+    TickRecordFileSource& operator=(const TickRecordFileSource&) = delete;
+
+    size_t read(MarketData* out, size_t maxTicks) override;
+    size_t size() const { return count_; }
+
+private:
+    TickRecordFileSource(void* mapping, size_t mappingSize);
+
+    void* mapping_;
+    size_t mappingSize_;
+    const common::TickRecord* records_;
+    size_t count_;
+    size_t position_{0};
+};
+
+// Write records as a tick record file; false on I/O failure
+bool writeTickRecordFile(const std::string& path, const common::TickRecord* records, size_t count);
+
+// Columnar tick store captured by the feed handler (common/tick_store.hpp),
+// read in place block by block
+class TickStoreSource : public ITickSource {
+public:
+    // nullptr if the file is missing or not a tick store of this build
+    static std::unique_ptr<TickStoreSource> open(const std::string& path);
+
+    // Skip every block holding only ticks before timestampNs, using the
+    // block timestamp index
+    void seek(int64_t timestampNs);
+
+    // Seeks as well as filtering
+    void resumeAfter(int64_t timestampNs) override;
+
+    size_t read(MarketData* out, size_t maxTicks) override;
+    size_t size() const { return reader_->numRows(); }
+
+private:
+    explicit TickStoreSource(std::unique_ptr<common::TickStoreReader> reader);
+
+    std::unique_ptr<common::TickStoreReader> reader_;
+    size_t block_{0};
+    size_t row_{0};
+};
+
+// Either kind of recording, told apart by its magic; nullptr if neither
+std::unique_ptr<ITickSource> openTickSource(const std::string& path);
+
+// Feed every tick of source into a running pool as the live feed would,
+// signals going wherever the pool sends them, and wait until they are
+// processed. Brings a pool restored from a checkpoint up to date when the
+// source resumes after the checkpoint's watermark. Returns the ticks fed.
+size_t catchUp(AlphaEnginePool& pool, ITickSource& source, size_t chunkTicks = ReplayConfig::CHUNK_TICKS);
+
+// Signals of a replay in deterministic order: by tick timestamp, then
+// symbol, then alpha id. Called from the replay thread once per chunk.
+using ReplaySignalSink = std::function<void(const AlphaSignal* signals, size_t count)>;
+
+struct ReplayResult {
+    size_t numTicks{0};
+    size_t numSignals{0};
+    int64_t firstTimestampNs{0};
+    int64_t lastTimestampNs{0};
+    double wallSeconds{0};
+};
+
+// Drives a pool from a tick source as fast as it can process the ticks.
+// Ticks go in as chunks; after each chunk the engine waits for the pool to
+// drain and releases that chunk's signals sorted, so the output does not
+// depend on how workers interleaved. Alphas must run under SHARDED or
+// SYMBOL_SHARDED scheduling for their state to evolve in tick order.
+class ReplayEngine {
+public:
+    // Registers a signal callback on pool, so the pool must not have a signal
+    // ring and should not outlive the engine while still processing ticks
+    ReplayEngine(AlphaEnginePool& pool, ReplaySignalSink sink,
+                 size_t chunkTicks = ReplayConfig::CHUNK_TICKS);
+
+    // Replay the source to its end; may be called again with the next source
+    ReplayResult run(ITickSource& source);
+
+    const SimulatedClock& getClock() const { return clock_; }
+
+private:
+    AlphaEnginePool& pool_;
+    ReplaySignalSink sink_;
+    size_t chunkTicks_;
+    SimulatedClock clock_;
+
+    // Consecutive signals of one worker with the same timestamp and symbol
+    struct SignalRun {
+        int64_t timestampNs;
+        uint32_t symbolRank;
+        uint32_t begin;
+        uint32_t end;
+    };
+    
+    // Written by each worker into its own buffer, merged on the replay thread
+    std::vector<std::vector<AlphaSignal>> workerSignals_;
+    std::vector<AlphaSignal> chunkSignals_;
+    std::vector<AlphaSignal> sortedSignals_;
+    std::vector<uint32_t> symbolRanks_;
+    std::vector<uint32_t> alphaRanks_;
+    std::vector<SignalRun> runs_;
+    std::vector<uint32_t> order_;
+
+    void flushChunk(ReplayResult& result);
+};
+
+// One unit of parallel replay: files replayed in order on a private pool,
+// optionally restricted to one symbol shard
+struct ReplayPartition {
+    std::vector<std::string> files;
+    size_t symbolShard{0};
+    size_t numSymbolShards{1};
+};
+
+struct ReplayOptions {
+    SchedulingMode mode{SchedulingMode::SYMBOL_SHARDED};
+    size_t threadsPerPartition{1};
+    size_t maxParallelPartitions{0};  // 0: one per core
+    size_t chunkTicks{ReplayConfig::CHUNK_TICKS};
+};
+
+// Fans replay out across cores: each partition gets its own pool, set up
+// with the same alphas, and partitions share no state. By-date partitions
+// start every day cold; by-symbol partitions give the same signals as one
+// pool for alphas that keep per-symbol state.
+class ReplayRunner {
+public:
+    using PoolSetup = std::function<void(AlphaEnginePool& pool)>;
+    // Called on the partition's replay thread, so concurrently across partitions
+    using SinkFactory = std::function<ReplaySignalSink(size_t partition)>;
+
+    ReplayRunner(PoolSetup setup, ReplayOptions options);
+
+    // Results are indexed like partitions
+    std::vector<ReplayResult> run(const std::vector<ReplayPartition>& partitions,
+                                  const SinkFactory& sinks);
+
+    // All files on one pool, in order
+    static std::vector<ReplayPartition> single(const std::vector<std::string>& files);
+    // One partition per file, with one file per trading day
+    static std::vector<ReplayPartition> byDate(const std::vector<std::string>& files);
+    // Every file, split into numShards symbol shards
+    static std::vector<ReplayPartition> bySymbol(const std::vector<std::string>& files, size_t numShards);
+
+private:
+    PoolSetup setup_;
+    ReplayOptions options_;
+
+    ReplayResult runPartition(const ReplayPartition& partition, ReplaySignalSink sink);
+};
+
+} // namespace wq::alpha
@@ -0,0 +1,260 @@
+#pragma once
+
+#include "checkpoint.hpp"
+#include <algorithm>
+#include <cmath>
+#include <cstddef>
+#include <optional>
+#include <vector>
+
+namespace wq::alpha {
+
+// Rolling-window building blocks for strategies. Every update is O(1) in
+// the window length, and the buffers are sized once at construction, so a
+// tick never allocates. Built-in alphas use them; plugin authors can too.
+// Each can be written to a checkpoint and restored exactly, so a restored
+// window continues bit for bit where the saved one stopped.
+
+// Fixed-capacity circular buffer; once full, each push evicts the oldest value
+template<typename T>
+class CircularBuffer {
+public:
+    explicit CircularBuffer(size_t capacity)
+        : values_(std::max<size_t>(capacity, 1)) {}
+
+    // Append value; returns the value it evicted, if the buffer was full
+    std::optional<T> push(const T& value) {
+        if (size_ < values_.size()) {
+            values_[(head_ + size_) % values_.size()] = value;
+            ++size_;
+            return std::nullopt;
+        }
+        T evicted = values_[head_];
+        values_[head_] = value;
+        head_ = (head_ + 1) % values_.size();
+        return evicted;
+    }
+
+    // Oldest first: [0] is the oldest value, [size() - 1] the newest
+    const T& operator[](size_t i) const { return values_[(head_ + i) % values_.size()]; }
+    const T& front() const { return (*this)[0]; }
+    const T& back() const { return (*this)[size_ - 1]; }
+
+    size_t size() const { return size_; }
+    size_t capacity() const { return values_.size(); }
+    bool empty() const { return size_ == 0; }
+    bool full() const { return size_ == values_.size(); }
+
+    void clear() {
+        head_ = 0;
+        size_ = 0;
+    }
+
+    template<typename Func>
+    void forEach(Func&& func) const {
+        for (size_t i = 0; i < size_; ++i) {
+            func((*this)[i]);
+        }
+    }
+
+    void serialize(common::CheckpointWriter& out) const {
+        out.write<uint64_t>(values_.size());
+        out.write<uint64_t>(head_);
+        out.write<uint64_t>(size_);
+        out.writeArray(values_.data(), values_.size());
+    }
+
+    // False, with the buffer unspecified, unless it was saved at this capacity
+    bool restore(common::CheckpointSection& in) {
+        uint64_t capacity, head, size;
+        if (!in.read(capacity) || !in.read(head) || !in.read(size) ||
+            capacity != values_.size() || head >= capacity || size > capacity ||
+            !in.readArray(values_.data(), values_.size())) {
+            return false;
+        }
+        head_ = head;
+        size_ = size;
+        return true;
+    }
+
+private:
+    std::vector<T> values_;
+    size_t head_{0};
+    size_t size_{0};
+};
+
+// Compensated (Kahan-Babuska/Neumaier) running sum: adding and subtracting
+// values for millions of ticks does not drift the way a plain double does
+class KahanSum {
+public:
+    void add(double value) {
+        double total = sum_ + value;
+        if (std::abs(sum_) >= std::abs(value)) {
+            compensation_ += (sum_ - total) + value;
+        } else {
+            compensation_ += (value - total) + sum_;
+        }
+        sum_ = total;
+    }
+
+    void subtract(double value) { add(-value); }
+    double value() const { return sum_ + compensation_; }
+
+    void reset() {
+        sum_ = 0;
+        compensation_ = 0;
+    }
+
+    void serialize(common::CheckpointWriter& out) const {
+        out.write(sum_);
+        out.write(compensation_);
+    }
+
+    bool restore(common::CheckpointSection& in) { return in.read(sum_) && in.read(compensation_); }
+
+private:
+    double sum_{0};
+    double compensation_{0};
+};
+
+// Rolling sum and count of positive values over the last `capacity` values
+class RollingSum {
+public:
+    explicit RollingSum(size_t capacity)
+        : window_(capacity) {}
+
+    void push(double value) {
+        if (auto evicted = window_.push(value)) {
+            sum_.subtract(*evicted);
+            positives_ -= *evicted > 0;
+        }
+        sum_.add(value);
+        positives_ += value > 0;
+    }
+
+    double sum() const { return sum_.value(); }
+    double mean() const { return window_.empty() ? 0.0 : sum() / window_.size(); }
+    size_t positiveCount() const { return positives_; }
+
+    size_t size() const { return window_.size(); }
+    size_t capacity() const { return window_.capacity(); }
+    bool full() const { return window_.full(); }
+    const CircularBuffer<double>& values() const { return window_; }
+
+    void clear() {
+        window_.clear();
+        sum_.reset();
+        positives_ = 0;
+    }
+
+    void serialize(common::CheckpointWriter& out) const {
+        window_.serialize(out);
+        sum_.serialize(out);
+        out.write<uint64_t>(positives_);
+    }
+
+    bool restore(common::CheckpointSection& in) {
+        uint64_t positives;
+        if (!window_.restore(in) || !sum_.restore(in) || !in.read(positives)) {
+            return false;
+        }
+        positives_ = positives;
+        return true;
+    }
+
+private:
+    CircularBuffer<double> window_;
+    KahanSum sum_;
+    size_t positives_{0};
+};
+
+// Rolling mean and variance over the last `capacity` values, by Welford's
+// update extended to evictions. Rounding error from the removals is flushed
+// by an exact two-pass recompute every RESYNC_WINDOWS full windows, which
+// keeps the amortized cost O(1).
+class RollingMoments {
+public:
+    static constexpr size_t RESYNC_WINDOWS = 64;
+
+    explicit RollingMoments(size_t capacity)
+        : window_(capacity) {}
+
+    void push(double value) {
+        auto evicted = window_.push(value);
+        if (!evicted) {
+            // Growing: plain Welford
+            double delta = value - mean_;
+            mean_ += delta / window_.size();
+            m2_ += delta * (value - mean_);
+            return;
+        }
+
+        // Sliding: replace the evicted value at constant size
+        double oldMean = mean_;
+        mean_ += (value - *evicted) / window_.size();
+        m2_ += (value - *evicted) * (value - mean_ + *evicted - oldMean);
+        m2_ = std::max(m2_, 0.0);
+
+        if (++evictions_ >= RESYNC_WINDOWS * window_.capacity()) {
+            resync();
+        }
+    }
+
+    double mean() const { return mean_; }
+
+    // Population variance, matching a from-scratch pass over the window
+    double variance() const { return window_.empty() ? 0.0 : m2_ / window_.size(); }
+    double stdDev() const { return std::sqrt(variance()); }
+
+    // Sum of squared deviations from the mean
+    double sumOfSquares() const { return m2_; }
+
+    size_t size() const { return window_.size(); }
+    size_t capacity() const { return window_.capacity(); }
+    bool full() const { return window_.full(); }
+    const CircularBuffer<double>& values() const { return window_; }
+
+    void clear() {
+        window_.clear();
+        mean_ = 0;
+        m2_ = 0;
+        evictions_ = 0;
+    }
+
+    void serialize(common::CheckpointWriter& out) const {
+        window_.serialize(out);
+        out.write(mean_);
+        out.write(m2_);
+        out.write<uint64_t>(evictions_);
+    }
+
+    bool restore(common::CheckpointSection& in) {
+        uint64_t evictions;
+        if (!window_.restore(in) || !in.read(mean_) || !in.read(m2_) || !in.read(evictions)) {
+            return false;
+        }
+        evictions_ = evictions;
+        return true;
+    }
+
+private:
+    CircularBuffer<double> window_;
+    double mean_{0};
+    double m2_{0};
+    size_t evictions_{0};
+
+    void resync() {
+        KahanSum sum;
+        window_.forEach([&sum](double value) { sum.add(value); });
+        mean_ = sum.value() / window_.size();
+        KahanSum squares;
+        window_.forEach([this, &squares](double value) {
+            double diff = value - mean_;
+            squares.add(diff * diff);
+        });
+        m2_ = squares.value();
+        evictions_ = 0;
+    }
+};
+
+} // namespace wq::alpha
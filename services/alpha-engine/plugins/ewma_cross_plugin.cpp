@@ -0,0 +1,153 @@
+// Example alpha plugin built against the C ABI only (alpha_plugin_abi.h).
+// It hosts several EWMA crossover alphas in one instance, keeps per-symbol
+// state, and implements save_state/load_state so hot reloads stay warm.
+
+#include "alpha_plugin_abi.h"
+#include <algorithm>
+#include <cmath>
+#include <cstring>
+#include <new>
+#include <string>
+#include <unordered_map>
+#include <vector>
+
+namespace {
+
+// Fast/slow spans, one alpha each
+constexpr int SPANS[][2] = {{5, 20}, {10, 50}, {20, 100}};
+constexpr uint32_t NUM_ALPHAS = sizeof(SPANS) / sizeof(SPANS[0]);
+
+// Saved state layout: header, then one record per symbol
+constexpr uint32_t STATE_MAGIC = 0x45574D41;  // "EWMA"
+constexpr uint32_t STATE_VERSION = 1;
+
+struct SymbolState {
+    double fast[NUM_ALPHAS];
+    double slow[NUM_ALPHAS];
+    uint64_t ticks;
+};
+
+struct Instance {
+    std::vector<std::string> alphaIds;
+    std::unordered_map<uint32_t, SymbolState> symbols;
+};
+
+void* create(const char* /*config*/) {
+    auto* instance = new (std::nothrow) Instance();
+    if (!instance) {
+        return nullptr;
+    }
+    for (const auto& span : SPANS) {
+        instance->alphaIds.push_back("EwmaCross_" + std::to_string(span[0]) + "_" + std::to_string(span[1]));
+    }
+    return instance;
+}
+
+void destroy(void* instance) {
+    delete static_cast<Instance*>(instance);
+}
+
+uint32_t alphaCount(void* /*instance*/) {
+    return NUM_ALPHAS;
+}
+
+const char* alphaId(void* instance, uint32_t alpha) {
+    return static_cast<Instance*>(instance)->alphaIds[alpha].c_str();
+}
+
+void onTicks(void* instance, const wq_tick_block* ticks, wq_signal_block* signals) {
+    auto& symbols = static_cast<Instance*>(instance)->symbols;
+    size_t count = 0;
+    for (size_t t = 0; t < ticks->count; ++t) {
+        double price = ticks->prices[t];
+        auto [it, inserted] = symbols.try_emplace(ticks->symbol_ids[t]);
+        SymbolState& state = it->second;
+        if (inserted) {
+            std::fill(std::begin(state.fast), std::end(state.fast), price);
+            std::fill(std::begin(state.slow), std::end(state.slow), price);
+            state.ticks = 0;
+        }
+        ++state.ticks;
+
+        for (uint32_t a = 0; a < NUM_ALPHAS; ++a) {
+            state.fast[a] += (price - state.fast[a]) * 2.0 / (SPANS[a][0] + 1);
+            state.slow[a] += (price - state.slow[a]) * 2.0 / (SPANS[a][1] + 1);
+            if (state.ticks < static_cast<uint64_t>(SPANS[a][1]) || state.slow[a] == 0.0 ||
+                count == signals->capacity) {
+                continue;
+            }
+            double spread = (state.fast[a] - state.slow[a]) / state.slow[a];
+            signals->ticks[count] = static_cast<uint32_t>(t);
+            signals->alphas[count] = a;
+            signals->signals[count] = std::tanh(spread * 100.0);
+            signals->confidences[count] = std::min(1.0, static_cast<double>(state.ticks) / (2.0 * SPANS[a][1]));
+            ++count;
+        }
+    }
+    signals->count = count;
+}
+
+size_t saveState(void* instance, void* buffer, size_t capacity) {
+    const auto& symbols = static_cast<Instance*>(instance)->symbols;
+    size_t needed = 3 * sizeof(uint32_t) + symbols.size() * (sizeof(uint32_t) + sizeof(SymbolState));
+    if (capacity < needed) {
+        return needed;
+    }
+
+    auto* out = static_cast<unsigned char*>(buffer);
+    uint32_t header[3] = {STATE_MAGIC, STATE_VERSION, NUM_ALPHAS};
+    std::memcpy(out, header, sizeof(header));
+    out += sizeof(header);
+    for (const auto& [symbolId, state] : symbols) {
+        std::memcpy(out, &symbolId, sizeof(symbolId));
+        std::memcpy(out + sizeof(symbolId), &state, sizeof(state));
+        out += sizeof(symbolId) + sizeof(state);
+    }
+    return needed;
+}
+
+int loadState(void* instance, const void* buffer, size_t size) {
+    auto& symbols = static_cast<Instance*>(instance)->symbols;
+    const auto* in = static_cast<const unsigned char*>(buffer);
+    uint32_t header[3];
+    constexpr size_t RECORD = sizeof(uint32_t) + sizeof(SymbolState);
+    if (size < sizeof(header)) {
+        return -1;
+    }
+    std::memcpy(header, in, sizeof(header));
+    if (header[0] != STATE_MAGIC || header[1] != STATE_VERSION || header[2] != NUM_ALPHAS ||
+        (size - sizeof(header)) % RECORD != 0) {
+        return -1;  // Different layout: start cold
+    }
+
+    symbols.clear();
+    for (size_t offset = sizeof(header); offset < size; offset += RECORD) {
+        uint32_t symbolId;
+        SymbolState state;
+        std::memcpy(&symbolId, in + offset, sizeof(symbolId));
+        std::memcpy(&state, in + offset + sizeof(symbolId), sizeof(state));
+        symbols.emplace(symbolId, state);
+    }
+    return 0;
+}
+
+const wq_alpha_plugin_v1 PLUGIN = {
+    WQ_ALPHA_ABI_VERSION,
+    sizeof(wq_alpha_plugin_v1),
+    "ewma_cross",
+    "1.0.0",
+    create,
+    destroy,
+    alphaCount,
+    alphaId,
+    onTicks,
+    saveState,
+    loadState,
+};
+
+} // namespace
+
+extern "C" __attribute__((visibility("default")))
+const wq_alpha_plugin_v1* wq_alpha_plugin_entry(uint32_t host_abi_version) {
+    return host_abi_version == WQ_ALPHA_ABI_VERSION ? &PLUGIN : nullptr;
+}
@@ -0,0 +1,643 @@
+#include "alpha_batch.hpp"
+#include "alpha_engine.hpp"
+#include "rolling_window.hpp"
+#include <algorithm>
+#include <cmath>
+
+#if defined(__x86_64__) || defined(__i386__)
+#include <immintrin.h>
+#define WQ_HAVE_X86_KERNELS 1
+#endif
+
+namespace wq::alpha {
+
+namespace {
+
+// Kernels over the member arrays of one symbol. In the sliding kernels every
+// member's window is full: the sample leaving member i's window sits
+// windows[i] slots behind pos in the circular history, read before the new
+// sample overwrites slot pos.
+
+using SlideMomentsFunc = void (*)(const double* history, int64_t historySize, int64_t pos,
+                                  const int64_t* windows, const double* lengths, double value,
+                                  double* mean, double* m2, size_t count);
+using ReversionSignalsFunc = void (*)(double price, const double* mean, const double* m2,
+                                      const double* lengths, double* signal, double* confidence,
+                                      uint8_t* emit, size_t count);
+using SlideSumsFunc = void (*)(const double* history, int64_t historySize, int64_t pos,
+                               const int64_t* windows, double value,
+                               double* sum, double* positives, size_t count);
+
+inline int64_t evictedSlot(int64_t pos, int64_t window, int64_t historySize) {
+    int64_t slot = pos - window;
+    return slot < 0 ? slot + historySize : slot;
+}
+
+// Single-member steps, shared by the scalar kernels, the SIMD tails and warm-up
+inline void slideMomentsAt(const double* history, int64_t historySize, int64_t pos,
+                           const int64_t* windows, const double* lengths, double value,
+                           double* mean, double* m2, size_t i) {
+    double evicted = history[evictedSlot(pos, windows[i], historySize)];
+    double oldMean = mean[i];
+    double delta = value - evicted;
+    double newMean = oldMean + delta / lengths[i];
+    double updated = m2[i] + delta * (value - newMean + evicted - oldMean);
+    mean[i] = newMean;
+    m2[i] = updated > 0 ? updated : 0;
+}
+
+inline void reversionSignalAt(double price, const double* mean, const double* m2,
+                              const double* lengths, double* signal, double* confidence,
+                              uint8_t* emit, size_t i) {
+    double stdDev = std::sqrt(m2[i] / lengths[i]);
+    double zScore = (price - mean[i]) / stdDev;
+    signal[i] = std::max(AlphaConfig::MIN_SIGNAL, std::min(AlphaConfig::MAX_SIGNAL, -zScore));
+    confidence[i] = std::min(1.0, std::abs(zScore) / 3.0);
+    emit[i] = stdDev >= 1e-6;
+}
+
+inline void slideSumsAt(const double* history, int64_t historySize, int64_t pos,
+                        const int64_t* windows, double value,
+                        double* sum, double* positives, size_t i) {
+    double evicted = history[evictedSlot(pos, windows[i], historySize)];
+    sum[i] += value - evicted;
+    positives[i] += static_cast<double>(value > 0) - static_cast<double>(evicted > 0);
+}
+
+void slideMomentsScalar(const double* history, int64_t historySize, int64_t pos,
+                        const int64_t* windows, const double* lengths, double value,
+                        double* mean, double* m2, size_t count) {
+    for (size_t i = 0; i < count; ++i) {
+        slideMomentsAt(history, historySize, pos, windows, lengths, value, mean, m2, i);
+    }
+}
+
+void reversionSignalsScalar(double price, const double* mean, const double* m2,
+                            const double* lengths, double* signal, double* confidence,
+                            uint8_t* emit, size_t count) {
+    for (size_t i = 0; i < count; ++i) {
+        reversionSignalAt(price, mean, m2, lengths, signal, confidence, emit, i);
+    }
+}
+
+void slideSumsScalar(const double* history, int64_t historySize, int64_t pos,
+                     const int64_t* windows, double value,
+                     double* sum, double* positives, size_t count) {
+    for (size_t i = 0; i < count; ++i) {
+        slideSumsAt(history, historySize, pos, windows, value, sum, positives, i);
+    }
+}
+
+#ifdef WQ_HAVE_X86_KERNELS
+
+__attribute__((target("avx2")))
+void slideMomentsAvx2(const double* history, int64_t historySize, int64_t pos,
+                      const int64_t* windows, const double* lengths, double value,
+                      double* mean, double* m2, size_t count) {
+    const __m256i posV = _mm256_set1_epi64x(pos);
+    const __m256i sizeV = _mm256_set1_epi64x(historySize);
+    const __m256i zeroI = _mm256_setzero_si256();
+    const __m256d zero = _mm256_setzero_pd();
+    const __m256d valueV = _mm256_set1_pd(value);
+    const size_t vectorEnd = count & ~size_t{3};
+
+    for (size_t i = 0; i < vectorEnd; i += 4) {
+        __m256i slot = _mm256_sub_epi64(posV, _mm256_loadu_si256(reinterpret_cast<const __m256i*>(windows + i)));
+        slot = _mm256_add_epi64(slot, _mm256_and_si256(_mm256_cmpgt_epi64(zeroI, slot), sizeV));
+        __m256d evicted = _mm256_i64gather_pd(history, slot, 8);
+
+        __m256d oldMean = _mm256_loadu_pd(mean + i);
+        __m256d delta = _mm256_sub_pd(valueV, evicted);
+        __m256d newMean = _mm256_add_pd(oldMean, _mm256_div_pd(delta, _mm256_loadu_pd(lengths + i)));
+        __m256d spread = _mm256_sub_pd(_mm256_add_pd(_mm256_sub_pd(valueV, newMean), evicted), oldMean);
+        __m256d updated = _mm256_add_pd(_mm256_loadu_pd(m2 + i), _mm256_mul_pd(delta, spread));
+        _mm256_storeu_pd(mean + i, newMean);
+        _mm256_storeu_pd(m2 + i, _mm256_max_pd(updated, zero));
+    }
+    for (size_t i = vectorEnd; i < count; ++i) {
+        slideMomentsAt(history, historySize, pos, windows, lengths, value, mean, m2, i);
+    }
+}
+
+__attribute__((target("avx2")))
+void reversionSignalsAvx2(double price, const double* mean, const double* m2,
+                          const double* lengths, double* signal, double* confidence,
+                          uint8_t* emit, size_t count) {
+    const __m256d priceV = _mm256_set1_pd(price);
+    const __m256d signBit = _mm256_set1_pd(-0.0);
+    const __m256d minSignal = _mm256_set1_pd(AlphaConfig::MIN_SIGNAL);
+    const __m256d maxSignal = _mm256_set1_pd(AlphaConfig::MAX_SIGNAL);
+    const __m256d one = _mm256_set1_pd(1.0);
+    const __m256d three = _mm256_set1_pd(3.0);
+    const __m256d minStdDev = _mm256_set1_pd(1e-6);
+    const size_t vectorEnd = count & ~size_t{3};
+
+    for (size_t i = 0; i < vectorEnd; i += 4) {
+        __m256d stdDev = _mm256_sqrt_pd(_mm256_div_pd(_mm256_loadu_pd(m2 + i), _mm256_loadu_pd(lengths + i)));
+        __m256d zScore = _mm256_div_pd(_mm256_sub_pd(priceV, _mm256_loadu_pd(mean + i)), stdDev);
+        __m256d clamped = _mm256_max_pd(_mm256_min_pd(_mm256_xor_pd(zScore, signBit), maxSignal), minSignal);
+        __m256d conf = _mm256_min_pd(_mm256_div_pd(_mm256_andnot_pd(signBit, zScore), three), one);
+        _mm256_storeu_pd(signal + i, clamped);
+        _mm256_storeu_pd(confidence + i, conf);
+
+        int mask = _mm256_movemask_pd(_mm256_cmp_pd(stdDev, minStdDev, _CMP_GE_OQ));
+        for (size_t lane = 0; lane < 4; ++lane) {
+            emit[i + lane] = (mask >> lane) & 1;
+        }
+    }
+    for (size_t i = vectorEnd; i < count; ++i) {
+        reversionSignalAt(price, mean, m2, lengths, signal, confidence, emit, i);
+    }
+}
+
+__attribute__((target("avx2")))
+void slideSumsAvx2(const double* history, int64_t historySize, int64_t pos,
+                   const int64_t* windows, double value,
+                   double* sum, double* positives, size_t count) {
+    const __m256i posV = _mm256_set1_epi64x(pos);
+    const __m256i sizeV = _mm256_set1_epi64x(historySize);
+    const __m256i zeroI = _mm256_setzero_si256();
+    const __m256d zero = _mm256_setzero_pd();
+    const __m256d one = _mm256_set1_pd(1.0);
+    const __m256d valueV = _mm256_set1_pd(value);
+    const __m256d valuePositive = _mm256_set1_pd(static_cast<double>(value > 0));
+    const size_t vectorEnd = count & ~size_t{3};
+
+    for (size_t i = 0; i < vectorEnd; i += 4) {
+        __m256i slot = _mm256_sub_epi64(posV, _mm256_loadu_si256(reinterpret_cast<const __m256i*>(windows + i)));
+        slot = _mm256_add_epi64(slot, _mm256_and_si256(_mm256_cmpgt_epi64(zeroI, slot), sizeV));
+        __m256d evicted = _mm256_i64gather_pd(history, slot, 8);
+
+        __m256d evictedPositive = _mm256_and_pd(_mm256_cmp_pd(evicted, zero, _CMP_GT_OQ), one);
+        _mm256_storeu_pd(sum + i, _mm256_add_pd(_mm256_loadu_pd(sum + i), _mm256_sub_pd(valueV, evicted)));
+        _mm256_storeu_pd(positives + i, _mm256_add_pd(_mm256_loadu_pd(positives + i),
+                                                      _mm256_sub_pd(valuePositive, evictedPositive)));
+    }
+    for (size_t i = vectorEnd; i < count; ++i) {
+        slideSumsAt(history, historySize, pos, windows, value, sum, positives, i);
+    }
+}
+
+// GCC's unmasked AVX-512 max/min/sqrt/gather fill the unused source from an
+// uninitialized vector, which trips -Wmaybe-uninitialized at -O3. The
+// all-lanes masked forms below compute the same thing from zeroed sources.
+constexpr __mmask8 ALL_LANES = 0xFF;
+
+__attribute__((target("avx512f")))
+void slideMomentsAvx512(const double* history, int64_t historySize, int64_t pos,
+                        const int64_t* windows, const double* lengths, double value,
+                        double* mean, double* m2, size_t count) {
+    const __m512i posV = _mm512_set1_epi64(pos);
+    const __m512i sizeV = _mm512_set1_epi64(historySize);
+    const __m512i zeroI = _mm512_setzero_si512();
+    const __m512d zero = _mm512_setzero_pd();
+    const __m512d valueV = _mm512_set1_pd(value);
+    const size_t vectorEnd = count & ~size_t{7};
+
+    for (size_t i = 0; i < vectorEnd; i += 8) {
+        __m512i slot = _mm512_sub_epi64(posV, _mm512_loadu_si512(windows + i));
+        slot = _mm512_mask_add_epi64(slot, _mm512_cmplt_epi64_mask(slot, zeroI), slot, sizeV);
+        __m512d evicted = _mm512_mask_i64gather_pd(zero, ALL_LANES, slot, history, 8);
+
+        __m512d oldMean = _mm512_loadu_pd(mean + i);
+        __m512d delta = _mm512_sub_pd(valueV, evicted);
+        __m512d newMean = _mm512_add_pd(oldMean, _mm512_div_pd(delta, _mm512_loadu_pd(lengths + i)));
+        __m512d spread = _mm512_sub_pd(_mm512_add_pd(_mm512_sub_pd(valueV, newMean), evicted), oldMean);
+        __m512d updated = _mm512_add_pd(_mm512_loadu_pd(m2 + i), _mm512_mul_pd(delta, spread));
+        _mm512_storeu_pd(mean + i, newMean);
+        _mm512_storeu_pd(m2 + i, _mm512_maskz_max_pd(ALL_LANES, updated, zero));
+    }
+    for (size_t i = vectorEnd; i < count; ++i) {
+        slideMomentsAt(history, historySize, pos, windows, lengths, value, mean, m2, i);
+    }
+}
+
+__attribute__((target("avx512f")))
+void reversionSignalsAvx512(double price, const double* mean, const double* m2,
+                            const double* lengths, double* signal, double* confidence,
+                            uint8_t* emit, size_t count) {
+    const __m512d priceV = _mm512_set1_pd(price);
+    const __m512d minSignal = _mm512_set1_pd(AlphaConfig::MIN_SIGNAL);
+    const __m512d maxSignal = _mm512_set1_pd(AlphaConfig::MAX_SIGNAL);
+    const __m512d one = _mm512_set1_pd(1.0);
+    const __m512d three = _mm512_set1_pd(3.0);
+    const __m512d minStdDev = _mm512_set1_pd(1e-6);
+    const __m512d zero = _mm512_setzero_pd();
+    const size_t vectorEnd = count & ~size_t{7};
+
+    for (size_t i = 0; i < vectorEnd; i += 8) {
+        __m512d variance = _mm512_div_pd(_mm512_loadu_pd(m2 + i), _mm512_loadu_pd(lengths + i));
+        __m512d stdDev = _mm512_maskz_sqrt_pd(ALL_LANES, variance);
+        __m512d zScore = _mm512_div_pd(_mm512_sub_pd(priceV, _mm512_loadu_pd(mean + i)), stdDev);
+        __m512d clamped = _mm512_maskz_max_pd(
+            ALL_LANES, _mm512_maskz_min_pd(ALL_LANES, _mm512_sub_pd(zero, zScore), maxSignal), minSignal);
+        __m512d conf = _mm512_maskz_min_pd(ALL_LANES, _mm512_div_pd(_mm512_abs_pd(zScore), three), one);
+        _mm512_storeu_pd(signal + i, clamped);
+        _mm512_storeu_pd(confidence + i, conf);
+
+        __mmask8 mask = _mm512_cmp_pd_mask(stdDev, minStdDev, _CMP_GE_OQ);
+        for (size_t lane = 0; lane < 8; ++lane) {
+            emit[i + lane] = (mask >> lane) & 1;
+        }
+    }
+    for (size_t i = vectorEnd; i < count; ++i) {
+        reversionSignalAt(price, mean, m2, lengths, signal, confidence, emit, i);
+    }
+}
+
+__attribute__((target("avx512f")))
+void slideSumsAvx512(const double* history, int64_t historySize, int64_t pos,
+                     const int64_t* windows, double value,
+                     double* sum, double* positives, size_t count) {
+    const __m512i posV = _mm512_set1_epi64(pos);
+    const __m512i sizeV = _mm512_set1_epi64(historySize);
+    const __m512i zeroI = _mm512_setzero_si512();
+    const __m512d zero = _mm512_setzero_pd();
+    const __m512d one = _mm512_set1_pd(1.0);
+    const __m512d valueV = _mm512_set1_pd(value);
+    const __m512d valuePositive = _mm512_set1_pd(static_cast<double>(value > 0));
+    const size_t vectorEnd = count & ~size_t{7};
+
+    for (size_t i = 0; i < vectorEnd; i += 8) {
+        __m512i slot = _mm512_sub_epi64(posV, _mm512_loadu_si512(windows + i));
+        slot = _mm512_mask_add_epi64(slot, _mm512_cmplt_epi64_mask(slot, zeroI), slot, sizeV);
+        __m512d evicted = _mm512_mask_i64gather_pd(zero, ALL_LANES, slot, history, 8);
+
+        __m512d evictedPositive = _mm512_mask_blend_pd(
+            _mm512_cmp_pd_mask(evicted, zero, _CMP_GT_OQ), zero, one);
+        _mm512_storeu_pd(sum + i, _mm512_add_pd(_mm512_loadu_pd(sum + i), _mm512_sub_pd(valueV, evicted)));
+        _mm512_storeu_pd(positives + i, _mm512_add_pd(_mm512_loadu_pd(positives + i),
+                                                      _mm512_sub_pd(valuePositive, evictedPositive)));
+    }
+    for (size_t i = vectorEnd; i < count; ++i) {
+        slideSumsAt(history, historySize, pos, windows, value, sum, positives, i);
+    }
+}
+
+#endif
+
+struct BatchKernels {
+    SlideMomentsFunc slideMoments;
+    ReversionSignalsFunc reversionSignals;
+    SlideSumsFunc slideSums;
+    const char* name;
+};
+
+BatchKernels selectKernels() {
+#ifdef WQ_HAVE_X86_KERNELS
+    __builtin_cpu_init();
+    if (__builtin_cpu_supports("avx512f")) {
+        return {&slideMomentsAvx512, &reversionSignalsAvx512, &slideSumsAvx512, "avx512"};
+    }
+    if (__builtin_cpu_supports("avx2")) {
+        return {&slideMomentsAvx2, &reversionSignalsAvx2, &slideSumsAvx2, "avx2"};
+    }
+#endif
+    return {&slideMomentsScalar, &reversionSignalsScalar, &slideSumsScalar, "scalar"};
+}
+
+const BatchKernels& kernels() {
+    static const BatchKernels selected = selectKernels();
+    return selected;
+}
+
+// Largest window, with every window clamped to at least one sample
+size_t prepareWindows(const std::vector<BatchMember>& members,
+                      std::vector<int64_t>& windows, std::vector<double>& lengths) {
+    size_t maxWindow = 1;
+    for (const auto& member : members) {
+        int64_t window = std::max(member.param, 1);
+        windows.push_back(window);
+        lengths.push_back(static_cast<double>(window));
+        maxWindow = std::max(maxWindow, static_cast<size_t>(window));
+    }
+    return maxWindow;
+}
+
+// Batch checkpoints open with the member windows, checked on restore
+void serializeWindows(common::CheckpointWriter& out, const std::vector<int64_t>& windows) {
+    out.write<uint64_t>(windows.size());
+    out.writeArray(windows.data(), windows.size());
+}
+
+bool windowsMatch(common::CheckpointSection& in, const std::vector<int64_t>& windows) {
+    uint64_t count;
+    if (!in.read(count) || count != windows.size()) {
+        return false;
+    }
+    std::vector<int64_t> saved(windows.size());
+    return in.readArray(saved.data(), saved.size()) && saved == windows;
+}
+
+} // namespace
+
+const char* alphaBatchKernelName() {
+    return kernels().name;
+}
+
+ResyncSchedule::ResyncSchedule(const std::vector<int64_t>& windows) {
+    nextDue = static_cast<size_t>(-1);
+    dueAt.reserve(windows.size());
+    for (int64_t window : windows) {
+        dueAt.push_back((AlphaBatchConfig::RESYNC_WINDOWS + 1) * static_cast<size_t>(window));
+        nextDue = std::min(nextDue, dueAt.back());
+    }
+}
+
+// MeanReversionBatch implementation
+MeanReversionBatch::SymbolState::SymbolState(const std::vector<int64_t>& windows, size_t historySize)
+    : history(historySize)
+    , mean(windows.size())
+    , m2(windows.size())
+    , resync(windows) {
+}
+
+MeanReversionBatch::MeanReversionBatch(std::vector<BatchMember> members)
+    : members_(std::move(members)) {
+    for (const auto& member : members_) {
+        alphaIds_.emplace_back(member.alphaId);
+        alphaIndices_.push_back(common::internAlphaId(member.alphaId));
+    }
+    maxWindow_ = prepareWindows(members_, windows_, lengths_);
+    signals_.resize(members_.size());
+    confidences_.resize(members_.size());
+    emit_.resize(members_.size());
+}
+
+void MeanReversionBatch::initialize() {
+    symbolStates_.clear();
+    initialized_ = true;
+}
+
+void MeanReversionBatch::shutdown() {
+    symbolStates_.clear();
+    initialized_ = false;
+}
+
+bool MeanReversionBatch::isActive() const {
+    return initialized_ && IAlphaBatch::isActive();
+}
+
+std::unique_ptr<IAlphaBatch> MeanReversionBatch::clone() const {
+    return std::make_unique<MeanReversionBatch>(members_);
+}
+
+bool MeanReversionBatch::serialize(common::CheckpointWriter& out) const {
+    serializeWindows(out, windows_);
+    out.write(lastUpdateTime_);
+    serializeSymbolStates(out, symbolStates_, [](const SymbolState& state, common::CheckpointWriter& to) {
+        to.write<uint64_t>(state.ticks);
+        to.write<uint64_t>(state.resync.nextDue);
+        to.writeArray(state.history.data(), state.history.size());
+        to.writeArray(state.mean.data(), state.mean.size());
+        to.writeArray(state.m2.data(), state.m2.size());
+        to.writeArray(state.resync.dueAt.data(), state.resync.dueAt.size());
+    });
+    return true;
+}
+
+bool MeanReversionBatch::restore(common::CheckpointSection& in, const SymbolFilter& keep) {
+    int64_t lastUpdateTime;
+    if (!windowsMatch(in, windows_) || !in.read(lastUpdateTime)) {
+        return false;
+    }
+    bool restored = restoreSymbolStates(in, keep, symbolStates_,
+        [this]() { return SymbolState(windows_, maxWindow_); },
+        [](SymbolState& state, common::CheckpointSection& from) {
+            uint64_t ticks, nextDue;
+            if (!from.read(ticks) || !from.read(nextDue) ||
+                !from.readArray(state.history.data(), state.history.size()) ||
+                !from.readArray(state.mean.data(), state.mean.size()) ||
+                !from.readArray(state.m2.data(), state.m2.size()) ||
+                !from.readArray(state.resync.dueAt.data(), state.resync.dueAt.size())) {
+                return false;
+            }
+            state.ticks = ticks;
+            state.resync.nextDue = nextDue;
+            return true;
+        });
+    if (restored) {
+        lastUpdateTime_ = std::max(lastUpdateTime_, lastUpdateTime);
+    }
+    return restored;
+}
+
+size_t MeanReversionBatch::onMarketData(const MarketData& data, AlphaSignal* out) {
+    if (!initialized_ || members_.empty()) {
+        return 0;
+    }
+
+    size_t count = members_.size();
+    auto& state = symbolStates_.try_emplace(data.symbolId, windows_, maxWindow_).first->second;
+    const BatchKernels& k = kernels();
+    double price = data.price;
+    int64_t historySize = static_cast<int64_t>(maxWindow_);
+    int64_t pos = static_cast<int64_t>(state.ticks % maxWindow_);
+
+    if (state.ticks >= maxWindow_) {
+        k.slideMoments(state.history.data(), historySize, pos, windows_.data(), lengths_.data(),
+                       price, state.mean.data(), state.m2.data(), count);
+    } else {
+        // Warm-up: members still filling grow their window, full ones slide
+        for (size_t i = 0; i < count; ++i) {
+            if (state.ticks >= static_cast<size_t>(windows_[i])) {
+                slideMomentsAt(state.history.data(), historySize, pos, windows_.data(), lengths_.data(),
+                               price, state.mean.data(), state.m2.data(), i);
+                continue;
+            }
+            double delta = price - state.mean[i];
+            state.mean[i] += delta / static_cast<double>(state.ticks + 1);
+            state.m2[i] += delta * (price - state.mean[i]);
+        }
+    }
+    state.history[pos] = price;
+    state.ticks++;
+    state.resync.run(windows_, state.ticks, [this, &state](size_t member) {
+        resyncMember(state, member);
+    });
+
+    k.reversionSignals(price, state.mean.data(), state.m2.data(), lengths_.data(),
+                       signals_.data(), confidences_.data(), emit_.data(), count);
+
+    size_t emitted = 0;
+    for (size_t i = 0; i < count; ++i) {
+        if (!emit_[i] || state.ticks < static_cast<size_t>(windows_[i])) {
+            continue;
+        }
+        AlphaSignal& signal = out[emitted++];
+        signal.alphaId = alphaIds_[i];
+        signal.alphaIndex = alphaIndices_[i];
+        signal.symbol = data.symbol;
+        signal.symbolId = data.symbolId;
+        signal.signal = signals_[i];
+        signal.confidence = confidences_[i];
+        signal.timestampNs = data.timestampNs;
+    }
+
+    lastUpdateTime_ = data.timestampNs;
+    return emitted;
+}
+
+void MeanReversionBatch::resyncMember(SymbolState& state, size_t member) const {
+    // Exact two-pass moments over the member's window, oldest first
+    size_t oldest = state.ticks - static_cast<size_t>(windows_[member]);
+    KahanSum sum;
+    for (size_t t = oldest; t < state.ticks; ++t) {
+        sum.add(state.history[t % maxWindow_]);
+    }
+    double mean = sum.value() / lengths_[member];
+    KahanSum squares;
+    for (size_t t = oldest; t < state.ticks; ++t) {
+        double diff = state.history[t % maxWindow_] - mean;
+        squares.add(diff * diff);
+    }
+    state.mean[member] = mean;
+    state.m2[member] = squares.value();
+}
+
+// MomentumBatch implementation
+MomentumBatch::SymbolState::SymbolState(const std::vector<int64_t>& windows, size_t historySize)
+    : history(historySize)
+    , sum(windows.size())
+    , positives(windows.size())
+    , resync(windows) {
+}
+
+MomentumBatch::MomentumBatch(std::vector<BatchMember> members)
+    : members_(std::move(members)) {
+    for (const auto& member : members_) {
+        alphaIds_.emplace_back(member.alphaId);
+        alphaIndices_.push_back(common::internAlphaId(member.alphaId));
+    }
+    maxWindow_ = prepareWindows(members_, windows_, lengths_);
+}
+
+void MomentumBatch::initialize() {
+    symbolStates_.clear();
+}
+
+void MomentumBatch::shutdown() {
+    symbolStates_.clear();
+}
+
+std::unique_ptr<IAlphaBatch> MomentumBatch::clone() const {
+    return std::make_unique<MomentumBatch>(members_);
+}
+
+bool MomentumBatch::serialize(common::CheckpointWriter& out) const {
+    serializeWindows(out, windows_);
+    out.write(lastUpdateTime_);
+    serializeSymbolStates(out, symbolStates_, [](const SymbolState& state, common::CheckpointWriter& to) {
+        to.write<uint64_t>(state.returns);
+        to.write<uint64_t>(state.resync.nextDue);
+        to.write<uint8_t>(state.lastPrice.has_value());
+        to.write(state.lastPrice.value_or(0.0));
+        to.writeArray(state.history.data(), state.history.size());
+        to.writeArray(state.sum.data(), state.sum.size());
+        to.writeArray(state.positives.data(), state.positives.size());
+        to.writeArray(state.resync.dueAt.data(), state.resync.dueAt.size());
+    });
+    return true;
+}
+
+bool MomentumBatch::restore(common::CheckpointSection& in, const SymbolFilter& keep) {
+    int64_t lastUpdateTime;
+    if (!windowsMatch(in, windows_) || !in.read(lastUpdateTime)) {
+        return false;
+    }
+    bool restored = restoreSymbolStates(in, keep, symbolStates_,
+        [this]() { return SymbolState(windows_, maxWindow_); },
+        [](SymbolState& state, common::CheckpointSection& from) {
+            uint64_t returns, nextDue;
+            uint8_t hasLastPrice;
+            double lastPrice;
+            if (!from.read(returns) || !from.read(nextDue) || !from.read(hasLastPrice) || !from.read(lastPrice) ||
+                !from.readArray(state.history.data(), state.history.size()) ||
+                !from.readArray(state.sum.data(), state.sum.size()) ||
+                !from.readArray(state.positives.data(), state.positives.size()) ||
+                !from.readArray(state.resync.dueAt.data(), state.resync.dueAt.size())) {
+                return false;
+            }
+            state.returns = returns;
+            state.resync.nextDue = nextDue;
+            if (hasLastPrice) {
+                state.lastPrice = lastPrice;
+            }
+            return true;
+        });
+    if (restored) {
+        lastUpdateTime_ = std::max(lastUpdateTime_, lastUpdateTime);
+    }
+    return restored;
+}
+
+size_t MomentumBatch::onMarketData(const MarketData& data, AlphaSignal* out) {
+    if (members_.empty()) {
+        return 0;
+    }
+
+    size_t count = members_.size();
+    auto& state = symbolStates_.try_emplace(data.symbolId, windows_, maxWindow_).first->second;
+
+    // Calculate return if we have previous price
+    if (!state.lastPrice.has_value()) {
+        state.lastPrice = data.price;
+        return 0;
+    }
+    double ret = (data.price - state.lastPrice.value()) / state.lastPrice.value();
+    state.lastPrice = data.price;
+
+    int64_t historySize = static_cast<int64_t>(maxWindow_);
+    int64_t pos = static_cast<int64_t>(state.returns % maxWindow_);
+    if (state.returns >= maxWindow_) {
+        kernels().slideSums(state.history.data(), historySize, pos, windows_.data(), ret,
+                            state.sum.data(), state.positives.data(), count);
+    } else {
+        for (size_t i = 0; i < count; ++i) {
+            if (state.returns >= static_cast<size_t>(windows_[i])) {
+                slideSumsAt(state.history.data(), historySize, pos, windows_.data(), ret,
+                            state.sum.data(), state.positives.data(), i);
+                continue;
+            }
+            state.sum[i] += ret;
+            state.positives[i] += ret > 0;
+        }
+    }
+    state.history[pos] = ret;
+    state.returns++;
+    state.resync.run(windows_, state.returns, [this, &state](size_t member) {
+        resyncMember(state, member);
+    });
+
+    size_t emitted = 0;
+    for (size_t i = 0; i < count; ++i) {
+        if (state.returns < static_cast<size_t>(windows_[i])) {
+            continue;
+        }
+        AlphaSignal& signal = out[emitted++];
+        signal.alphaId = alphaIds_[i];
+        signal.alphaIndex = alphaIndices_[i];
+        signal.symbol = data.symbol;
+        signal.symbolId = data.symbolId;
+        signal.signal = std::tanh(state.sum[i] * 10.0);
+        signal.confidence = std::abs(state.positives[i] / lengths_[i] - 0.5) * 2.0;
+        signal.timestampNs = data.timestampNs;
+    }
+
+    lastUpdateTime_ = data.timestampNs;
+    return emitted;
+}
+
+void MomentumBatch::resyncMember(SymbolState& state, size_t member) const {
+    KahanSum sum;
+    double positives = 0;
+    for (size_t t = state.returns - static_cast<size_t>(windows_[member]); t < state.returns; ++t) {
+        double value = state.history[t % maxWindow_];
+        sum.add(value);
+        positives += value > 0;
+    }
+    state.sum[member] = sum.value();
+    state.positives[member] = positives;
+}
+
+} // namespace wq::alpha
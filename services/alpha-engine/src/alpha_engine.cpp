@@ -1,20 +1,59 @@
 #include "alpha_engine.hpp"
+#include "arena.hpp"
 #include <dlfcn.h>
 #include <filesystem>
+#include <future>
 #include <iostream>
 #include <algorithm>
+#include <chrono>
+#include <string>
 
 namespace wq::alpha {
 
+namespace {
+
+// Checkpoint sections: the alpha id (first member's for a batch), then the
+// instance's own serialize() output
+constexpr const char* CHECKPOINT_ALPHA_SECTION = "alpha.strategy";
+constexpr const char* CHECKPOINT_BATCH_SECTION = "alpha.batch";
+
+// Empty polls before an idle worker goes to sleep
+constexpr int IDLE_SPINS = 256;
+
+// Sleep between polls once waitIdle() has spun IDLE_SPINS times
+constexpr int IDLE_WAIT_US = 20;
+
+// Worker index of the current thread, set once by workerThread()
+thread_local size_t currentWorkerIndex = ThreadPool::NO_WORKER;
+
+// Per-thread output buffer for alpha batches; grows to the largest batch once
+thread_local std::vector<AlphaSignal> batchSignals;
+
+// Per-thread staging for dispatchStealable(); keeps its capacity across ticks
+thread_local std::vector<ThreadPool::Task> stealableTasks;
+
+} // namespace
+
 // ThreadPool implementation
 ThreadPool::ThreadPool(size_t numThreads) {
-    workers_.reserve(numThreads);
+    numThreads = std::max<size_t>(numThreads, 1);
+    common::Topology& topology = common::topology();
+    queues_.reserve(numThreads);
+    for (size_t i = 0; i < numThreads; ++i) {
+        int node = topology.nodeOf(common::TopologyStage::ALPHA_WORKER, i);
+        queues_.push_back(std::make_unique<WorkerQueue>(common::nodeResource(node)));
+        if (node >= 0) {
+            topology.notePlacement("alpha.worker[" + std::to_string(i) + "] queue", 0, node,
+                                   common::TopologyStage::ALPHA_WORKER);
+        }
+    }
     
+    workers_.reserve(numThreads);
     for (size_t i = 0; i < numThreads; ++i) {
         // Use lambda to capture this
-        workers_.emplace_back([this]() {
-            this->workerThread();
-        });
+        workers_.push_back(topology.startThread(common::TopologyStage::ALPHA_WORKER, i, [this, i]() {
+            this->workerThread(i);
+        }));
     }
 }
 
@@ -22,11 +61,62 @@ ThreadPool::~ThreadPool() {
     stop();
 }
 
+size_t ThreadPool::currentWorker() {
+    return currentWorkerIndex;
+}
+
+void ThreadPool::enqueueBatch(std::vector<Task>& tasks) {
+    if (tasks.empty()) {
+        return;
+    }
+    
+    // Contiguous slices, one lock per deque
+    uint64_t queuedAt = common::TscClock::now();
+    stealablePending_.fetch_add(tasks.size());
+    size_t numQueues = queues_.size();
+    size_t first = nextQueue();
+    size_t perQueue = (tasks.size() + numQueues - 1) / numQueues;
+    size_t begin = 0;
+    for (size_t q = 0; q < numQueues && begin < tasks.size(); ++q) {
+        size_t end = std::min(begin + perQueue, tasks.size());
+        WorkerQueue& queue = *queues_[(first + q) % numQueues];
+        {
+            std::lock_guard<std::mutex> lock(queue.mutex);
+            for (size_t i = begin; i < end; ++i) {
+                queue.tasks.push_back({std::move(tasks[i]), queuedAt});
+            }
+        }
+        begin = end;
+    }
+    
+    tasks.clear();
+    wake(true);
+}
+
+void ThreadPool::wake(bool all) {
+    // Pairs with the sleepers_ increment in workerThread(): either the
+    // sleeper sees the new work or we see the sleeper
+    if (sleepers_.load() == 0) {
+        return;
+    }
+    {
+        std::lock_guard<std::mutex> lock(sleepMutex_);
+    }
+    if (all) {
+        condition_.notify_all();
+    } else {
+        condition_.notify_one();
+    }
+}
+
 void ThreadPool::stop() {
     if (stop_.exchange(true)) {
         return;  // Already stopped
     }
     
+    {
+        std::lock_guard<std::mutex> lock(sleepMutex_);
+    }
     condition_.notify_all();
     
     for (auto& worker : workers_) {
@@ -36,40 +126,152 @@ void ThreadPool::stop() {
     }
 }
 
-void ThreadPool::workerThread() {
-    while (true) {
-        std::function<void()> task;
-        
-        {
-            std::unique_lock<std::mutex> lock(queueMutex_);
-            
-            condition_.wait(lock, [this]() {
-                return stop_.load() || !tasks_.empty();
+void ThreadPool::waitIdle() {
+    // Pending counts before active_: a pop raises active_ before it lowers
+    // a pending count, so a task in hand is always seen by one of the reads
+    auto busy = [this]() {
+        bool pending = stealablePending_.load() > 0 ||
+            std::any_of(queues_.begin(), queues_.end(), [](const std::unique_ptr<WorkerQueue>& queue) {
+                return queue->pinnedPending.load() > 0;
             });
-            
-            if (stop_.load() && tasks_.empty()) {
-                return;
-            }
-            
-            if (!tasks_.empty()) {
-                task = std::move(tasks_.front());
-                tasks_.pop();
-            }
+        return pending || active_.load() > 0;
+    };
+    for (int spins = 0; busy(); ++spins) {
+        if (spins < IDLE_SPINS) {
+            std::this_thread::yield();
+        } else {
+            std::this_thread::sleep_for(std::chrono::microseconds(IDLE_WAIT_US));
+        }
+    }
+}
+
+bool ThreadPool::popTask(size_t self, QueuedTask& task) {
+    WorkerQueue& own = *queues_[self];
+    
+    // Pinned work first: nobody else can run it
+    if (own.pinnedPending.load(std::memory_order_relaxed) > 0) {
+        std::lock_guard<std::mutex> lock(own.mutex);
+        if (!own.pinned.empty()) {
+            task = std::move(own.pinned.front());
+            own.pinned.pop_front();
+            active_.fetch_add(1);  // Before the pending count drops, for waitIdle()
+            own.pinnedPending.fetch_sub(1);
+            return true;
+        }
+    }
+    
+    if (stealablePending_.load(std::memory_order_relaxed) == 0) {
+        return false;
+    }
+    
+    // Own deque LIFO (hot in cache), then steal the oldest task elsewhere
+    {
+        std::lock_guard<std::mutex> lock(own.mutex);
+        if (!own.tasks.empty()) {
+            task = std::move(own.tasks.back());
+            own.tasks.pop_back();
+            active_.fetch_add(1);
+            stealablePending_.fetch_sub(1);
+            return true;
+        }
+    }
+    for (size_t offset = 1; offset < queues_.size(); ++offset) {
+        WorkerQueue& victim = *queues_[(self + offset) % queues_.size()];
+        std::unique_lock<std::mutex> lock(victim.mutex, std::try_to_lock);
+        if (lock.owns_lock() && !victim.tasks.empty()) {
+            task = std::move(victim.tasks.front());
+            victim.tasks.pop_front();
+            active_.fetch_add(1);
+            stealablePending_.fetch_sub(1);
+            return true;
+        }
+    }
+    return false;
+}
+
+void ThreadPool::workerThread(size_t index) {
+    currentWorkerIndex = index;
+    WorkerQueue& own = *queues_[index];
+    common::LatencyProbe& queueDelay = common::latencyProbe("alpha.queue_delay");
+    common::LatencyProbe& taskTime = common::latencyProbe("alpha.task");
+    int idle = 0;
+    
+    while (true) {
+        QueuedTask task;
+        if (popTask(index, task)) {
+            idle = 0;
+            uint64_t started = common::TscClock::now();
+            queueDelay.record(started > task.queuedAt ? common::TscClock::toNs(started - task.queuedAt) : 0);
+            task.run();
+            taskTime.recordSince(started);
+            active_.fetch_sub(1);
+            continue;
         }
         
-        if (task) {
-            task();
+        // Stop only once this worker can see no work left
+        bool pending = stealablePending_.load() > 0 || own.pinnedPending.load() > 0;
+        if (stop_.load() && !pending) {
+            return;
+        }
+        if (pending || ++idle < IDLE_SPINS) {
+            std::this_thread::yield();  // Stealing missed a contended lock, or still spinning
+            continue;
         }
+        
+        std::unique_lock<std::mutex> lock(sleepMutex_);
+        sleepers_.fetch_add(1);
+        condition_.wait(lock, [this, &own]() {
+            return stop_.load() || stealablePending_.load() > 0 || own.pinnedPending.load() > 0;
+        });
+        sleepers_.fetch_sub(1);
+        idle = 0;
     }
 }
 
+// TickBatch implementation
+TickBatch::TickBatch(const MarketData* ticks, size_t count, bool withColumns,
+                     std::pmr::memory_resource* resource)
+    : rows(ticks, ticks + count, resource)
+    , symbolIds(resource)
+    , prices(resource)
+    , volumes(resource)
+    , timestampsNs(resource) {
+    if (!withColumns) {
+        return;
+    }
+    symbolIds.reserve(count);
+    prices.reserve(count);
+    volumes.reserve(count);
+    timestampsNs.reserve(count);
+    for (const auto& data : rows) {
+        symbolIds.push_back(data.symbolId);
+        prices.push_back(data.price);
+        volumes.push_back(data.volume);
+        timestampsNs.push_back(data.timestampNs);
+    }
+    
+    // Symbols are read in place from the rows
+    block.struct_size = sizeof(wq_tick_block);
+    block.count = count;
+    block.symbol_ids = symbolIds.data();
+    block.prices = prices.data();
+    block.volumes = volumes.data();
+    block.timestamps_ns = timestampsNs.data();
+    block.symbols = count > 0 ? rows[0].symbol.data() : nullptr;
+    block.symbol_stride = sizeof(MarketData);
+    block.symbol_size = SymbolString::CAPACITY;
+}
+
 // AlphaEnginePool implementation
-AlphaEnginePool::AlphaEnginePool(size_t numThreads)
-    : threadPool_(std::make_unique<ThreadPool>(numThreads)) {
+AlphaEnginePool::AlphaEnginePool(size_t numThreads, SchedulingMode mode)
+    : threadPool_(std::make_unique<ThreadPool>(numThreads))
+    , mode_(mode)
+    , snapshot_(std::make_shared<AlphaSnapshot>()) {
 }
 
 AlphaEnginePool::~AlphaEnginePool() {
     stop();
+    plugins_.clear();  // Instances are destroyed before their libraries close
     
     // Unload plugins using dynamic memory management
     for (void* handle : pluginHandles_) {
@@ -82,73 +284,586 @@ AlphaEnginePool::~AlphaEnginePool() {
 void AlphaEnginePool::addAlpha(std::unique_ptr<IAlphaStrategy> alpha) {
     std::lock_guard<std::mutex> lock(alphasMutex_);
     alpha->initialize();
+    
+    // One replica per worker, each starting from empty state
+    std::vector<std::unique_ptr<IAlphaStrategy>> replicas;
+    if (mode_ == SchedulingMode::SYMBOL_SHARDED) {
+        for (size_t worker = 0; worker < threadPool_->size(); ++worker) {
+            auto replica = alpha->clone();
+            if (!replica) {
+                replicas.clear();
+                break;
+            }
+            replica->initialize();
+            replicas.push_back(std::move(replica));
+        }
+    }
+    
     alphas_.push_back(std::move(alpha));
+    replicas_.push_back(std::move(replicas));
+    rebuildSnapshotLocked();
+}
+
+void AlphaEnginePool::addAlphaBatch(std::unique_ptr<IAlphaBatch> batch) {
+    std::lock_guard<std::mutex> lock(alphasMutex_);
+    batch->initialize();
+    
+    std::vector<std::unique_ptr<IAlphaBatch>> replicas;
+    if (mode_ == SchedulingMode::SYMBOL_SHARDED) {
+        for (size_t worker = 0; worker < threadPool_->size(); ++worker) {
+            auto replica = batch->clone();
+            if (!replica) {
+                replicas.clear();
+                break;
+            }
+            replica->initialize();
+            replicas.push_back(std::move(replica));
+        }
+    }
+    
+    numBatchedAlphas_ += batch->size();
+    batches_.push_back(std::move(batch));
+    batchReplicas_.push_back(std::move(replicas));
+    rebuildSnapshotLocked();
+}
+
+void AlphaEnginePool::rebuildSnapshotLocked() {
+    size_t numWorkers = threadPool_->size();
+    auto snapshot = std::make_shared<AlphaSnapshot>();
+    snapshot->alphas.reserve(alphas_.size());
+    snapshot->shards.resize(numWorkers);
+    snapshot->replicas.resize(numWorkers);
+    size_t numOwned = 0;
+    for (size_t i = 0; i < alphas_.size(); ++i) {
+        snapshot->alphas.push_back(alphas_[i].get());
+        if (replicas_[i].empty()) {
+            snapshot->shards[numOwned++ % numWorkers].push_back(alphas_[i].get());
+            continue;
+        }
+        for (size_t worker = 0; worker < numWorkers; ++worker) {
+            snapshot->replicas[worker].push_back(replicas_[i][worker].get());
+        }
+    }
+    
+    snapshot->batchShards.resize(numWorkers);
+    snapshot->batchReplicas.resize(numWorkers);
+    numOwned = 0;
+    for (size_t i = 0; i < batches_.size(); ++i) {
+        snapshot->batches.push_back(batches_[i].get());
+        if (batchReplicas_[i].empty()) {
+            snapshot->batchShards[numOwned++ % numWorkers].push_back(batches_[i].get());
+            continue;
+        }
+        for (size_t worker = 0; worker < numWorkers; ++worker) {
+            snapshot->batchReplicas[worker].push_back(batchReplicas_[i][worker].get());
+        }
+    }
+    
+    snapshot->pluginShards.resize(numWorkers);
+    for (const auto& slot : plugins_) {
+        snapshot->pluginShards[slot->worker].push_back(slot.get());
+    }
+    snapshot->hasPlugins = !plugins_.empty();
+    snapshot_ = std::move(snapshot);
+}
+
+std::shared_ptr<const AlphaEnginePool::AlphaSnapshot> AlphaEnginePool::loadSnapshot() const {
+    std::lock_guard<std::mutex> lock(alphasMutex_);
+    return snapshot_;
 }
 
 void AlphaEnginePool::start() {
     running_.store(true);
+    if (inputConsumer_) {
+        inputConsumer_->start();
+    }
 }
 
 void AlphaEnginePool::stop() {
+    // Drain queued ticks into the pool before it shuts down
+    if (inputConsumer_) {
+        inputConsumer_->stop();
+    }
     running_.store(false);
     threadPool_->stop();
 }
 
+void AlphaEnginePool::attachInput(MarketDataRing& ring) {
+    inputConsumer_ = std::make_unique<common::RingConsumer<MarketDataRing>>(ring,
+        [this](MarketData* ticks, size_t count) {
+            processMarketDataBatch(ticks, count);
+        });
+    inputConsumer_->setStage(common::TopologyStage::ALPHA_INPUT);
+    common::topology().place("alpha.input ring", &ring, sizeof(ring), common::TopologyStage::ALPHA_INPUT);
+    if (running_.load()) {
+        inputConsumer_->start();
+    }
+}
+
+bool AlphaEnginePool::setInputPolicy(common::DeliveryPolicy policy) {
+    if (policy == common::DeliveryPolicy::CONFLATED && mode_ == SchedulingMode::WORK_STEALING) {
+        std::cerr << "Conflated input needs a sharded scheduling mode" << std::endl;
+        return false;
+    }
+    if (running_.load()) {
+        std::cerr << "Input policy must be set before start()" << std::endl;
+        return false;
+    }
+    inputPolicy_ = policy;
+    conflatedInputs_.clear();
+    tickCache_.reset();
+    if (policy == common::DeliveryPolicy::CONFLATED) {
+        tickCache_ = std::make_unique<MarketDataCache>();
+        for (size_t worker = 0; worker < threadPool_->size(); ++worker) {
+            auto input = std::make_unique<ConflatedInput>();
+            input->buffer.resize(AlphaConfig::CONFLATION_DRAIN_BATCH);
+            conflatedInputs_.push_back(std::move(input));
+        }
+    }
+    return true;
+}
+
+uint64_t AlphaEnginePool::getConflatedCount() const {
+    uint64_t total = 0;
+    for (const auto& input : conflatedInputs_) {
+        total += input->queue.getConflatedCount();
+    }
+    return total;
+}
+
 void AlphaEnginePool::processMarketData(const MarketData& data) {
     if (!running_.load()) {
         return;
     }
+    if (tickCache_ || mode_ == SchedulingMode::SYMBOL_SHARDED) {
+        processMarketDataBatch(&data, 1);
+        return;
+    }
+    
+    std::lock_guard<std::mutex> dispatch(dispatchMutex_);
+    noteDispatchedLocked(&data, 1);
+    if (mode_ == SchedulingMode::SHARDED) {
+        // One pinned task per worker covering the alphas it owns
+        auto snapshot = loadSnapshot();
+        for (size_t worker = 0; worker < snapshot->shards.size(); ++worker) {
+            if (!snapshot->ownsWhole(worker)) {
+                continue;
+            }
+            auto task = [this, snapshot, worker, data]() {
+                const auto& shard = snapshot->shards[worker];
+                const auto& batches = snapshot->batchShards[worker];
+                this->processAlphas(shard.data(), shard.size(), data);
+                this->processBatches(batches.data(), batches.size(), data);
+            };
+            static_assert(ThreadPool::Task::fitsInline<decltype(task)>, "per-tick tasks must not allocate");
+            threadPool_->enqueueTo(worker, std::move(task));
+        }
+        if (snapshot->hasPlugins) {
+            dispatchPlugins(snapshot, makeBatch(&data, 1, true));
+        }
+        return;
+    }
+    
+    auto snapshot = loadSnapshot();
+    dispatchStealable(snapshot, data);
+    if (snapshot->hasPlugins) {
+        dispatchPlugins(snapshot, makeBatch(&data, 1, true));
+    }
+}
+
+void AlphaEnginePool::dispatchStealable(const std::shared_ptr<const AlphaSnapshot>& snapshot,
+                                        const MarketData& data) {
+    // One stealable task per chunk of alphas, submitted as a batch
+    std::vector<ThreadPool::Task>& tasks = stealableTasks;
+    for (size_t begin = 0; begin < snapshot->alphas.size(); begin += AlphaConfig::ALPHA_BATCH_SIZE) {
+        size_t count = std::min(AlphaConfig::ALPHA_BATCH_SIZE, snapshot->alphas.size() - begin);
+        auto task = [this, snapshot, begin, count, data]() {
+            this->processAlphas(snapshot->alphas.data() + begin, count, data);
+        };
+        static_assert(ThreadPool::Task::fitsInline<decltype(task)>, "per-tick tasks must not allocate");
+        tasks.emplace_back(std::move(task));
+    }
+    for (size_t i = 0; i < snapshot->batches.size(); ++i) {
+        tasks.emplace_back([this, snapshot, i, data]() {
+            this->processBatches(snapshot->batches.data() + i, 1, data);
+        });
+    }
+    threadPool_->enqueueBatch(tasks);
+}
+
+void AlphaEnginePool::processMarketDataBatch(const MarketData* ticks, size_t count) {
+    if (!running_.load() || count == 0) {
+        return;
+    }
+    std::lock_guard<std::mutex> dispatch(dispatchMutex_);
+    noteDispatchedLocked(ticks, count);
+    if (tickCache_) {
+        conflateTicks(ticks, count);
+        return;
+    }
+    auto snapshot = loadSnapshot();
+    if (mode_ == SchedulingMode::WORK_STEALING) {
+        for (size_t i = 0; i < count; ++i) {
+            dispatchStealable(snapshot, ticks[i]);
+        }
+        if (snapshot->hasPlugins) {
+            dispatchPlugins(snapshot, makeBatch(ticks, count, true));
+        }
+        return;
+    }
     
+    // One copy of the batch shared by every worker's task; pinned tasks run
+    // in submission order, so each worker sees the ticks in feed order
+    auto batch = makeBatch(ticks, count, snapshot->hasPlugins);
+    for (size_t worker = 0; worker < threadPool_->size(); ++worker) {
+        bool needed = snapshot->ownsWhole(worker) || !snapshot->pluginShards[worker].empty();
+        if (!needed && snapshot->hasReplicas(worker)) {
+            needed = std::any_of(ticks, ticks + count, [this, worker](const MarketData& data) {
+                return symbolOwner(data.symbolId) == worker;
+            });
+        }
+        if (!needed) {
+            continue;
+        }
+        auto task = [this, snapshot, batch, worker]() {
+            this->processBatchOnWorker(*snapshot, *batch, worker);
+        };
+        static_assert(ThreadPool::Task::fitsInline<decltype(task)>, "per-batch tasks must not allocate");
+        threadPool_->enqueueTo(worker, std::move(task));
+    }
+}
+
+void AlphaEnginePool::noteDispatchedLocked(const MarketData* ticks, size_t count) {
+    for (size_t i = 0; i < count; ++i) {
+        lastDispatchedNs_ = std::max(lastDispatchedNs_, ticks[i].timestampNs);
+    }
+}
+
+size_t AlphaEnginePool::checkpoint(common::CheckpointWriter& out) {
+    auto snapshot = loadSnapshot();
+    size_t numWorkers = threadPool_->size();
+    std::vector<common::CheckpointWriter> parts(numWorkers);
+    std::vector<size_t> written(numWorkers, 0);
+    bool onCaller = threadPool_->isStopped() || mode_ == SchedulingMode::WORK_STEALING;
+    std::vector<std::promise<void>> copied(onCaller ? 0 : numWorkers);
+    std::vector<std::future<void>> done;
+    {
+        std::lock_guard<std::mutex> dispatch(dispatchMutex_);
+        out.advanceWatermark(lastDispatchedNs_);
+        if (onCaller) {
+            // Stealable tasks have no owning worker to copy state out on
+            if (!threadPool_->isStopped()) {
+                threadPool_->waitIdle();
+            }
+            for (size_t worker = 0; worker < numWorkers; ++worker) {
+                written[worker] = serializeWorker(*snapshot, worker, parts[worker]);
+            }
+        } else {
+            for (size_t worker = 0; worker < numWorkers; ++worker) {
+                done.push_back(copied[worker].get_future());
+                threadPool_->enqueueTo(worker, [this, &snapshot, &parts, &written, &copied, worker]() {
+                    written[worker] = serializeWorker(*snapshot, worker, parts[worker]);
+                    copied[worker].set_value();
+                });
+            }
+        }
+    }
+    for (auto& future : done) {
+        future.wait();
+    }
+    
+    size_t sections = 0;
+    for (size_t worker = 0; worker < numWorkers; ++worker) {
+        out.append(parts[worker]);
+        sections += written[worker];
+    }
+    return sections;
+}
+
+size_t AlphaEnginePool::serializeWorker(const AlphaSnapshot& snapshot, size_t worker,
+                                        common::CheckpointWriter& out) const {
+    size_t sections = 0;
+    auto saveAlphas = [&out, &sections](const std::vector<IAlphaStrategy*>& alphas) {
+        for (const IAlphaStrategy* alpha : alphas) {
+            out.beginSection(CHECKPOINT_ALPHA_SECTION);
+            out.write(AlphaIdString(alpha->getAlphaId()));
+            if (alpha->serialize(out)) {
+                out.endSection();
+                ++sections;
+            } else {
+                out.abandonSection();
+            }
+        }
+    };
+    auto saveBatches = [&out, &sections](const std::vector<IAlphaBatch*>& batches) {
+        for (const IAlphaBatch* batch : batches) {
+            if (batch->size() == 0) {
+                continue;
+            }
+            out.beginSection(CHECKPOINT_BATCH_SECTION);
+            out.write(AlphaIdString(batch->getAlphaId(0)));
+            if (batch->serialize(out)) {
+                out.endSection();
+                ++sections;
+            } else {
+                out.abandonSection();
+            }
+        }
+    };
+    saveAlphas(snapshot.shards[worker]);
+    saveAlphas(snapshot.replicas[worker]);
+    saveBatches(snapshot.batchShards[worker]);
+    saveBatches(snapshot.batchReplicas[worker]);
+    return sections;
+}
+
+size_t AlphaEnginePool::restoreCheckpoint(const common::CheckpointReader& in) {
+    if (running_.load()) {
+        std::cerr << "Checkpoints must be restored before start()" << std::endl;
+        return 0;
+    }
     std::lock_guard<std::mutex> lock(alphasMutex_);
+    size_t numWorkers = threadPool_->size();
+    auto keepAll = [](SymbolId) { return true; };
+    
+    // Each instance restores on the worker that runs it, so the state it
+    // rebuilds is first-touched on that worker's node
+    std::unordered_map<const void*, size_t> ownerWorker;
+    bool onCaller = threadPool_->isStopped() || mode_ == SchedulingMode::WORK_STEALING;
+    for (size_t worker = 0; worker < numWorkers && !onCaller; ++worker) {
+        for (const IAlphaStrategy* alpha : snapshot_->shards[worker]) {
+            ownerWorker.emplace(alpha, worker);
+        }
+        for (const IAlphaBatch* batch : snapshot_->batchShards[worker]) {
+            ownerWorker.emplace(batch, worker);
+        }
+    }
+    auto onWorker = [this, onCaller](size_t worker, auto&& restore) {
+        if (onCaller || worker == ThreadPool::NO_WORKER) {
+            return restore();
+        }
+        std::promise<bool> result;
+        std::future<bool> restored = result.get_future();
+        threadPool_->enqueueTo(worker, [&result, &restore]() { result.set_value(restore()); });
+        return restored.get();
+    };
+    
+    // A section is offered to every instance of its alpha: the one owned
+    // whole takes every symbol, each replica the symbols its worker owns
+    auto restoreInto = [this, numWorkers, &keepAll, &ownerWorker, &onWorker](auto& owner, auto& replicas,
+                                                                           common::CheckpointSection& section) {
+        if (replicas.empty()) {
+            auto it = ownerWorker.find(owner.get());
+            return onWorker(it == ownerWorker.end() ? ThreadPool::NO_WORKER : it->second, [&]() {
+                common::CheckpointSection copy = section;
+                return owner->restore(copy, keepAll);
+            });
+        }
+        bool restored = true;
+        for (size_t worker = 0; worker < numWorkers; ++worker) {
+            restored = onWorker(worker, [&]() {
+                common::CheckpointSection copy = section;
+                return replicas[worker]->restore(copy, [this, worker](SymbolId symbolId) {
+                    return symbolOwner(symbolId) == worker;
+                });
+            }) && restored;
+        }
+        return restored;
+    };
+    
+    std::unordered_map<std::string_view, size_t> alphaIndex;
+    for (size_t i = 0; i < alphas_.size(); ++i) {
+        alphaIndex.emplace(alphas_[i]->getAlphaId(), i);
+    }
+    std::unordered_map<std::string_view, size_t> batchIndex;
+    for (size_t i = 0; i < batches_.size(); ++i) {
+        if (batches_[i]->size() > 0) {
+            batchIndex.emplace(batches_[i]->getAlphaId(0), i);
+        }
+    }
+    
+    size_t restored = 0;
+    auto restoreSections = [&in, &restored, &restoreInto](const char* name, const auto& index,
+                                                         auto& owners, auto& replicas) {
+        for (auto section : in.sections(name)) {
+            AlphaIdString alphaId;
+            if (!section.read(alphaId)) {
+                continue;
+            }
+            auto it = index.find(alphaId.view());
+            if (it == index.end()) {
+                std::cerr << "Checkpoint has state for unknown alpha " << alphaId << std::endl;
+                continue;
+            }
+            if (restoreInto(owners[it->second], replicas[it->second], section)) {
+                ++restored;
+            } else {
+                std::cerr << "Checkpoint state for " << alphaId
+                          << " does not match its configuration; starting it cold" << std::endl;
+            }
+        }
+    };
+    restoreSections(CHECKPOINT_ALPHA_SECTION, alphaIndex, alphas_, replicas_);
+    restoreSections(CHECKPOINT_BATCH_SECTION, batchIndex, batches_, batchReplicas_);
     
-    // Process each alpha in thread pool using lambda with move semantics
-    for (auto& alpha : alphas_) {
-        if (!alpha->isActive()) {
+    std::lock_guard<std::mutex> dispatch(dispatchMutex_);
+    lastDispatchedNs_ = std::max(lastDispatchedNs_, in.watermarkNs());
+    return restored;
+}
+
+void AlphaEnginePool::conflateTicks(const MarketData* ticks, size_t count) {
+    auto snapshot = loadSnapshot();
+    size_t numWorkers = threadPool_->size();
+    for (size_t i = 0; i < count; ++i) {
+        SymbolId symbolId = ticks[i].symbolId;
+        if (tickCache_->update(symbolId, ticks[i]) == 0) {
+            continue;  // No symbol id: nothing to conflate it under
+        }
+        for (size_t worker = 0; worker < numWorkers; ++worker) {
+            bool needed = snapshot->ownsWhole(worker) || !snapshot->pluginShards[worker].empty() ||
+                          (snapshot->hasReplicas(worker) && symbolOwner(symbolId) == worker);
+            if (needed) {
+                conflatedInputs_[worker]->queue.mark(symbolId);
+            }
+        }
+    }
+    
+    // At most one drain queued per worker, however many ticks arrive
+    for (size_t worker = 0; worker < numWorkers; ++worker) {
+        ConflatedInput& input = *conflatedInputs_[worker];
+        if (!input.queue.empty() && !input.scheduled.exchange(true, std::memory_order_acq_rel)) {
+            threadPool_->enqueueTo(worker, [this, worker]() { this->drainConflated(worker); });
+        }
+    }
+}
+
+void AlphaEnginePool::drainConflated(size_t worker) {
+    ConflatedInput& input = *conflatedInputs_[worker];
+    // Cleared first: a symbol marked from here on queues another drain
+    input.scheduled.exchange(false, std::memory_order_acq_rel);
+    auto snapshot = loadSnapshot();
+    size_t count;
+    while ((count = input.queue.drain(*tickCache_, input.buffer.data(), input.buffer.size())) > 0) {
+        // Worker-local batch: its columns live only until the next drain
+        common::ArenaScope scope;
+        TickBatch batch(input.buffer.data(), count, snapshot->hasPlugins, scope.resource());
+        processBatchOnWorker(*snapshot, batch, worker);
+    }
+}
+
+std::shared_ptr<const TickBatch> AlphaEnginePool::makeBatch(const MarketData* ticks, size_t count,
+                                                            bool withColumns) {
+    // Control block and rows alike come from the pool resource, so steady
+    // state reuses the blocks freed by earlier batches
+    return std::allocate_shared<TickBatch>(std::pmr::polymorphic_allocator<TickBatch>(&batchResource_),
+                                           ticks, count, withColumns, &batchResource_);
+}
+
+void AlphaEnginePool::dispatchPlugins(const std::shared_ptr<const AlphaSnapshot>& snapshot,
+                                      const std::shared_ptr<const TickBatch>& batch) {
+    for (size_t worker = 0; worker < snapshot->pluginShards.size(); ++worker) {
+        if (snapshot->pluginShards[worker].empty()) {
             continue;
         }
-        
-        // Capture raw pointer for thread safety
-        IAlphaStrategy* alphaPtr = alpha.get();
-        
-        // Enqueue task with lambda
-        threadPool_->enqueue([this, alphaPtr, data]() {
-            this->processAlpha(alphaPtr, data);
+        threadPool_->enqueueTo(worker, [this, snapshot, batch, worker]() {
+            const auto& plugins = snapshot->pluginShards[worker];
+            this->processPlugins(plugins.data(), plugins.size(), batch->block);
         });
     }
 }
 
+void AlphaEnginePool::processBatchOnWorker(const AlphaSnapshot& snapshot, const TickBatch& batch,
+                                           size_t worker) {
+    const auto& owned = snapshot.shards[worker];
+    const auto& replicas = snapshot.replicas[worker];
+    const auto& ownedBatches = snapshot.batchShards[worker];
+    const auto& batchReplicas = snapshot.batchReplicas[worker];
+    const auto& plugins = snapshot.pluginShards[worker];
+    bool hasReplicas = snapshot.hasReplicas(worker);
+    for (const auto& data : batch.rows) {
+        processAlphas(owned.data(), owned.size(), data);
+        processBatches(ownedBatches.data(), ownedBatches.size(), data);
+        if (hasReplicas && symbolOwner(data.symbolId) == worker) {
+            processAlphas(replicas.data(), replicas.size(), data);
+            processBatches(batchReplicas.data(), batchReplicas.size(), data);
+        }
+    }
+    processPlugins(plugins.data(), plugins.size(), batch.block);
+}
+
+void AlphaEnginePool::processAlphas(IAlphaStrategy* const* alphas, size_t count, const MarketData& data) {
+    for (size_t i = 0; i < count; ++i) {
+        if (alphas[i]->isActive()) {
+            processAlpha(alphas[i], data);
+        }
+    }
+}
+
 void AlphaEnginePool::processAlpha(IAlphaStrategy* alpha, const MarketData& data) {
     auto signal = alpha->onMarketData(data);
     
     if (signal.has_value()) {
-        numSignalsGenerated_++;
-        notifyCallbacks(std::move(signal.value()));
+        emitSignal(signal.value());
     }
 }
 
+void AlphaEnginePool::processBatches(IAlphaBatch* const* batches, size_t count, const MarketData& data) {
+    for (size_t i = 0; i < count; ++i) {
+        if (!batches[i]->isActive()) {
+            continue;
+        }
+        if (batchSignals.size() < batches[i]->size()) {
+            batchSignals.resize(batches[i]->size());
+        }
+        size_t numSignals = batches[i]->onMarketData(data, batchSignals.data());
+        for (size_t s = 0; s < numSignals; ++s) {
+            emitSignal(batchSignals[s]);
+        }
+    }
+}
+
+void AlphaEnginePool::processPlugins(PluginSlot* const* plugins, size_t count, const wq_tick_block& ticks) {
+    for (size_t i = 0; i < count; ++i) {
+        plugins[i]->plugin->onTicks(ticks, [this](AlphaSignal& signal) {
+            emitSignal(signal);
+        });
+    }
+}
+
+void AlphaEnginePool::emitSignal(AlphaSignal& signal) {
+    static common::LatencyProbe& probe = common::latencyProbe("alpha.signal_emit");
+    common::ScopedLatency latency(probe);
+    numSignalsGenerated_++;
+    if (signalRing_) {
+        if (!signalRing_->tryPush(signal)) {
+            signalDrops_++;
+        }
+        return;
+    }
+    notifyCallbacks(std::move(signal));
+}
+
 void AlphaEnginePool::registerSignalCallback(SignalCallback callback) {
     signalCallbacks_.push_back(std::move(callback));
 }
 
 void AlphaEnginePool::notifyCallbacks(AlphaSignal&& signal) {
-    // Use std::for_each with lambda
-    std::for_each(signalCallbacks_.begin(), signalCallbacks_.end(),
+    if (signalCallbacks_.empty()) {
+        return;
+    }
+    
+    // Every callback but the last gets a copy (a memcpy); the last one takes the original
+    std::for_each(signalCallbacks_.begin(), signalCallbacks_.end() - 1,
         [&signal](const SignalCallback& callback) {
-            // Create copy for each callback
-            AlphaSignal signalCopy;
-            signalCopy.alphaId = signal.alphaId;
-            signalCopy.symbol = signal.symbol;
-            signalCopy.signal = signal.signal;
-            signalCopy.confidence = signal.confidence;
-            signalCopy.timestampNs = signal.timestampNs;
-            callback(std::move(signalCopy));
+            callback(AlphaSignal(signal));
         });
+    signalCallbacks_.back()(std::move(signal));
 }
 
 // Pass by reference
 void AlphaEnginePool::getStats(size_t& numAlphas, size_t& numSignals) const {
     std::lock_guard<std::mutex> lock(alphasMutex_);
-    numAlphas = alphas_.size();
+    numAlphas = alphas_.size() + numBatchedAlphas_;
     numSignals = numSignalsGenerated_.load();
 }
 
@@ -156,7 +871,7 @@ void AlphaEnginePool::getStats(size_t& numAlphas, size_t& numSignals) const {
 void AlphaEnginePool::getStats(size_t* numAlphas, size_t* numSignals) const {
     std::lock_guard<std::mutex> lock(alphasMutex_);
     if (numAlphas) {
-        *numAlphas = alphas_.size();
+        *numAlphas = alphas_.size() + numBatchedAlphas_;
     }
     if (numSignals) {
         *numSignals = numSignalsGenerated_.load();
@@ -170,8 +885,15 @@ bool AlphaEnginePool::loadPlugins(std::string_view pluginDir) {
         return false;
     }
     
+    std::lock_guard<std::mutex> lock(pluginMutex_);
+    std::string dir(pluginDir);
+    if (std::find(pluginDirs_.begin(), pluginDirs_.end(), dir) == pluginDirs_.end()) {
+        pluginDirs_.push_back(dir);
+    }
     for (const auto& entry : fs::directory_iterator(pluginDir)) {
-        if (entry.path().extension() == ".so") {
+        if (entry.path().extension() == ".so" && pluginFiles_.count(entry.path().string()) == 0) {
+            std::error_code error;
+            pluginFiles_[entry.path().string()] = fs::last_write_time(entry.path(), error);
             loadPlugin(entry.path().string());
         }
     }
@@ -179,7 +901,112 @@ bool AlphaEnginePool::loadPlugins(std::string_view pluginDir) {
     return true;
 }
 
+bool AlphaEnginePool::reloadPlugin(std::string_view pluginPath) {
+    std::lock_guard<std::mutex> lock(pluginMutex_);
+    for (const auto& slot : plugins_) {
+        if (slot->path == pluginPath) {
+            std::error_code error;
+            pluginFiles_[slot->path] = std::filesystem::last_write_time(slot->path, error);
+            return reloadPluginLocked(*slot);
+        }
+    }
+    std::cerr << "No ABI plugin loaded from " << pluginPath << std::endl;
+    return false;
+}
+
+size_t AlphaEnginePool::refreshPlugins() {
+    namespace fs = std::filesystem;
+    
+    std::lock_guard<std::mutex> lock(pluginMutex_);
+    size_t numLoaded = 0;
+    for (const auto& dir : pluginDirs_) {
+        std::error_code error;
+        for (const auto& entry : fs::directory_iterator(dir, error)) {
+            if (entry.path().extension() != ".so") {
+                continue;
+            }
+            std::string path = entry.path().string();
+            auto modified = fs::last_write_time(entry.path(), error);
+            if (error) {
+                continue;  // Removed or being replaced; next refresh sees it
+            }
+            auto seen = pluginFiles_.find(path);
+            if (seen != pluginFiles_.end() && seen->second == modified) {
+                continue;
+            }
+            pluginFiles_[path] = modified;
+            
+            auto slot = std::find_if(plugins_.begin(), plugins_.end(),
+                [&path](const std::unique_ptr<PluginSlot>& plugin) { return plugin->path == path; });
+            if (slot != plugins_.end()) {
+                numLoaded += reloadPluginLocked(**slot);
+            } else if (legacyPlugins_.count(path) != 0) {
+                std::cerr << "Plugin " << path << " changed but uses the legacy interface; "
+                          << "restart to load it" << std::endl;
+            } else {
+                numLoaded += loadPlugin(path);
+            }
+        }
+    }
+    return numLoaded;
+}
+
+bool AlphaEnginePool::reloadPluginLocked(PluginSlot& slot) {
+    // Everything slow happens here, off the workers
+    auto plugin = AbiPlugin::load(slot.path, "{}", true);
+    if (!plugin) {
+        return false;
+    }
+    if (plugin->getName() != slot.name) {
+        std::cerr << "Plugin " << slot.path << " is now " << plugin->getName()
+                  << ", not " << slot.name << "; not reloaded" << std::endl;
+        return false;
+    }
+    
+    // Pinned behind the batches already queued for this worker and ahead of
+    // the next ones, so no tick is skipped or seen twice
+    size_t numAlphas = plugin->size();
+    bool warm = false;
+    auto swap = [&slot, &plugin, &warm]() {
+        warm = plugin->takeStateFrom(*slot.plugin);
+        std::swap(slot.plugin, plugin);
+    };
+    if (threadPool_->isStopped()) {
+        swap();
+    } else {
+        std::promise<void> swapped;
+        auto done = swapped.get_future();
+        threadPool_->enqueueTo(slot.worker, [&swap, &swapped]() {
+            swap();
+            swapped.set_value();
+        });
+        done.wait();
+    }
+    plugin.reset();  // The old version, no longer reachable from any worker
+    
+    {
+        std::lock_guard<std::mutex> lock(alphasMutex_);
+        numBatchedAlphas_ = numBatchedAlphas_ - slot.numAlphas + numAlphas;
+        slot.numAlphas = numAlphas;
+    }
+    std::cout << "Reloaded plugin " << slot.name << " " << slot.plugin->getVersion()
+              << (warm ? "" : " (cold start)") << std::endl;
+    return true;
+}
+
 bool AlphaEnginePool::loadPlugin(const std::string& pluginPath) {
+    // Plugins built against the C ABI first, then the legacy C++ interface
+    auto library = std::make_unique<PluginLoader>(pluginPath);
+    if (library->getSymbol<wq_alpha_plugin_entry_fn>(WQ_ALPHA_PLUGIN_ENTRY)) {
+        auto plugin = AbiPlugin::create(std::move(library), pluginPath, "{}");
+        if (!plugin) {
+            return false;
+        }
+        addPlugin(std::move(plugin));
+        return true;
+    }
+    library.reset();
+    
     void* handle = dlopen(pluginPath.c_str(), RTLD_LAZY);
     if (!handle) {
         std::cerr << "Failed to load plugin: " << dlerror() << std::endl;
@@ -210,6 +1037,7 @@ bool AlphaEnginePool::loadPlugin(const std::string& pluginPath) {
     if (alpha) {
         addAlpha(std::unique_ptr<IAlphaStrategy>(alpha));
         pluginHandles_.push_back(handle);
+        legacyPlugins_.insert(pluginPath);
         return true;
     }
     
@@ -217,6 +1045,20 @@ bool AlphaEnginePool::loadPlugin(const std::string& pluginPath) {
     return false;
 }
 
+void AlphaEnginePool::addPlugin(std::unique_ptr<AbiPlugin> plugin) {
+    std::lock_guard<std::mutex> lock(alphasMutex_);
+    auto slot = std::make_unique<PluginSlot>();
+    slot->path = plugin->getPath();
+    slot->name = plugin->getName();
+    slot->numAlphas = plugin->size();
+    slot->worker = plugins_.size() % threadPool_->size();
+    slot->plugin = std::move(plugin);
+    
+    numBatchedAlphas_ += slot->numAlphas;
+    plugins_.push_back(std::move(slot));
+    rebuildSnapshotLocked();
+}
+
 // AlphaFactory implementation
 std::unique_ptr<IAlphaStrategy> AlphaFactory::create(
     std::string_view alphaType, 
@@ -245,40 +1087,24 @@ std::unique_ptr<IAlphaStrategy> AlphaFactory::create(
     return nullptr;
 }
 
-// PluginLoader implementation
-PluginLoader::PluginLoader(std::string_view path)
-    : path_(path) {
-    handle_ = dlopen(path_.c_str(), RTLD_LAZY);
-}
-
-PluginLoader::~PluginLoader() {
-    if (handle_) {
-        dlclose(handle_);
-        handle_ = nullptr;
+std::unique_ptr<IAlphaBatch> AlphaFactory::createBatch(
+    std::string_view alphaType,
+    std::string_view idPrefix,
+    const std::vector<int>& params) {
+    
+    std::vector<BatchMember> members;
+    members.reserve(params.size());
+    for (size_t i = 0; i < params.size(); ++i) {
+        members.push_back({std::string(idPrefix) + std::to_string(i), params[i]});
     }
-}
-
-PluginLoader::PluginLoader(PluginLoader&& other) noexcept
-    : handle_(other.handle_)
-    , path_(std::move(other.path_)) {
-    other.handle_ = nullptr;
-}
-
-PluginLoader& PluginLoader::operator=(PluginLoader&& other) noexcept {
-    if (this != &other) {
-        if (handle_) {
-            dlclose(handle_);
-        }
-        handle_ = other.handle_;
-        path_ = std::move(other.path_);
-        other.handle_ = nullptr;
+    
+    if (alphaType == "MeanReversion") {
+        return createBatch<MeanReversionBatch>(std::move(members));
+    } else if (alphaType == "Momentum") {
+        return createBatch<MomentumBatch>(std::move(members));
     }
-    return *this;
-}
-
-void* PluginLoader::getSymbolImpl(std::string_view symbolName) const {
-    if (!handle_) return nullptr;
-    return dlsym(handle_, std::string(symbolName).c_str());
+    
+    return nullptr;
 }
 
 } // namespace wq::alpha
@@ -0,0 +1,183 @@
+#include "alpha_plugin.hpp"
+#include <dlfcn.h>
+#include <unistd.h>
+#include <algorithm>
+#include <atomic>
+#include <cstddef>
+#include <cstring>
+#include <filesystem>
+#include <iostream>
+
+namespace wq::alpha {
+
+namespace {
+
+// Distinguishes the temporary copies one process maps
+std::atomic<uint64_t> pluginCopies{0};
+
+// Every v1 plugin has at least the fields up to on_ticks; later ones were
+// appended, and a plugin built before them simply lacks them
+constexpr size_t REQUIRED_PLUGIN_BYTES = offsetof(wq_alpha_plugin_v1, on_ticks) +
+                                         sizeof(wq_alpha_plugin_v1::on_ticks);
+
+} // namespace
+
+// PluginLoader implementation
+PluginLoader::PluginLoader(std::string_view path)
+    : path_(path) {
+    handle_ = dlopen(path_.c_str(), RTLD_LAZY);
+}
+
+PluginLoader::~PluginLoader() {
+    if (handle_) {
+        dlclose(handle_);
+        handle_ = nullptr;
+    }
+}
+
+PluginLoader::PluginLoader(PluginLoader&& other) noexcept
+    : handle_(other.handle_)
+    , path_(std::move(other.path_)) {
+    other.handle_ = nullptr;
+}
+
+PluginLoader& PluginLoader::operator=(PluginLoader&& other) noexcept {
+    if (this != &other) {
+        if (handle_) {
+            dlclose(handle_);
+        }
+        handle_ = other.handle_;
+        path_ = std::move(other.path_);
+        other.handle_ = nullptr;
+    }
+    return *this;
+}
+
+void* PluginLoader::getSymbolImpl(std::string_view symbolName) const {
+    if (!handle_) return nullptr;
+    return dlsym(handle_, std::string(symbolName).c_str());
+}
+
+// AbiPlugin implementation
+std::unique_ptr<AbiPlugin> AbiPlugin::load(const std::string& path, std::string_view config,
+                                           bool privateCopy) {
+    namespace fs = std::filesystem;
+
+    if (!privateCopy) {
+        auto library = std::make_unique<PluginLoader>(path);
+        if (!library->isLoaded()) {
+            std::cerr << "Failed to load plugin: " << dlerror() << std::endl;
+            return nullptr;
+        }
+        return create(std::move(library), path, config);
+    }
+
+    // dlopen() matches libraries by path, so a rebuilt file at the same path
+    // would resolve to the old mapping. The copy can go as soon as it is
+    // mapped.
+    fs::path copy = fs::temp_directory_path() /
+        ("wq-alpha-" + std::to_string(getpid()) + "-" + std::to_string(pluginCopies++) + ".so");
+    std::error_code error;
+    fs::copy_file(path, copy, fs::copy_options::overwrite_existing, error);
+    if (error) {
+        std::cerr << "Failed to copy plugin " << path << ": " << error.message() << std::endl;
+        return nullptr;
+    }
+    auto library = std::make_unique<PluginLoader>(copy.string());
+    if (!library->isLoaded()) {
+        std::cerr << "Failed to load plugin: " << dlerror() << std::endl;
+    }
+    fs::remove(copy, error);
+    if (!library->isLoaded()) {
+        return nullptr;
+    }
+    return create(std::move(library), path, config);
+}
+
+std::unique_ptr<AbiPlugin> AbiPlugin::create(std::unique_ptr<PluginLoader> library,
+                                             const std::string& path, std::string_view config) {
+    auto entry = library->getSymbol<wq_alpha_plugin_entry_fn>(WQ_ALPHA_PLUGIN_ENTRY);
+    if (!entry) {
+        std::cerr << "Plugin " << path << " missing " << WQ_ALPHA_PLUGIN_ENTRY << std::endl;
+        return nullptr;
+    }
+
+    // Copy only the struct_size bytes the plugin has; fields it predates
+    // stay null, which reads as absent
+    const wq_alpha_plugin_v1* exported = entry(WQ_ALPHA_ABI_VERSION);
+    wq_alpha_plugin_v1 api{};
+    if (exported && exported->abi_version == WQ_ALPHA_ABI_VERSION &&
+        exported->struct_size >= REQUIRED_PLUGIN_BYTES) {
+        std::memcpy(&api, exported, std::min<size_t>(exported->struct_size, sizeof(api)));
+    }
+    if (!api.name || !api.create || !api.destroy || !api.alpha_count || !api.alpha_id || !api.on_ticks) {
+        std::cerr << "Plugin " << path << " does not support ABI version "
+                  << WQ_ALPHA_ABI_VERSION << std::endl;
+        return nullptr;
+    }
+
+    std::string configString(config);
+    void* instance = api.create(configString.c_str());
+    if (!instance) {
+        std::cerr << "Plugin " << api.name << " failed to create an instance" << std::endl;
+        return nullptr;
+    }
+    return std::unique_ptr<AbiPlugin>(new AbiPlugin(std::move(library), api, instance, path));
+}
+
+AbiPlugin::AbiPlugin(std::unique_ptr<PluginLoader> library, const wq_alpha_plugin_v1& api,
+                     void* instance, const std::string& path)
+    : library_(std::move(library))
+    , api_(api)
+    , instance_(instance)
+    , path_(path)
+    , name_(api.name)
+    , version_(api.version ? api.version : "") {
+    uint32_t numAlphas = api_.alpha_count(instance_);
+    alphaIds_.reserve(numAlphas);
+    alphaIndices_.reserve(numAlphas);
+    for (uint32_t alpha = 0; alpha < numAlphas; ++alpha) {
+        const char* id = api_.alpha_id(instance_, alpha);
+        std::string alphaId = id ? id : name_ + "_" + std::to_string(alpha);
+        alphaIds_.emplace_back(alphaId);
+        alphaIndices_.push_back(common::internAlphaId(alphaId));
+    }
+    signals_.struct_size = sizeof(wq_signal_block);
+}
+
+AbiPlugin::~AbiPlugin() {
+    api_.destroy(instance_);
+}
+
+bool AbiPlugin::takeStateFrom(AbiPlugin& previous) {
+    if (!previous.api_.save_state || !api_.load_state) {
+        return false;
+    }
+
+    size_t size = previous.api_.save_state(previous.instance_, nullptr, 0);
+    std::vector<unsigned char> buffer(size);
+    size_t written = previous.api_.save_state(previous.instance_, buffer.data(), buffer.size());
+    if (written > buffer.size()) {
+        return false;  // State grew between the two calls
+    }
+    return api_.load_state(instance_, buffer.data(), written) == 0;
+}
+
+wq_signal_block& AbiPlugin::prepareSignals(size_t numTicks) {
+    size_t capacity = numTicks * alphaIds_.size();
+    if (signalTicks_.size() < capacity) {
+        signalTicks_.resize(capacity);
+        signalAlphas_.resize(capacity);
+        signalValues_.resize(capacity);
+        signalConfidences_.resize(capacity);
+        signals_.ticks = signalTicks_.data();
+        signals_.alphas = signalAlphas_.data();
+        signals_.signals = signalValues_.data();
+        signals_.confidences = signalConfidences_.data();
+    }
+    signals_.capacity = capacity;
+    signals_.count = 0;
+    return signals_;
+}
+
+} // namespace wq::alpha
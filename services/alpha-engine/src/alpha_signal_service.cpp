@@ -0,0 +1,50 @@
+#include "alpha_signal_service.hpp"
+#include <algorithm>
+
+namespace wq::alpha {
+
+namespace {
+
+std::string signalKey(const proto::AlphaSignal& signal) {
+    std::string key = signal.alpha_id();
+    key += '|';
+    key += signal.symbol();
+    return key;
+}
+
+} // namespace
+
+// Strings are copied straight into the signal's arena
+void toProto(const AlphaSignal& signal, proto::AlphaSignal* out) {
+    std::string_view alphaId = signal.alphaId.view();
+    std::string_view symbol = signal.symbol.view();
+    out->set_alpha_id(alphaId.data(), alphaId.size());
+    out->set_symbol(symbol.data(), symbol.size());
+    out->set_signal(signal.signal);
+    out->set_confidence(signal.confidence);
+    out->set_timestamp_ns(signal.timestampNs);
+}
+
+AlphaSignalServiceImpl::AlphaSignalServiceImpl(common::AsyncServer& server)
+    : stream_(server, service_, &AsyncService::RequestStreamSignals,
+              &proto::AggregatedSignals::mutable_signals, signalKey) {
+    stream_.setFilter([](const proto::SignalRequest& request, const proto::AlphaSignal& signal) {
+        const auto& alphaIds = request.alpha_ids();
+        return alphaIds.empty() || std::find(alphaIds.begin(), alphaIds.end(), signal.alpha_id()) != alphaIds.end();
+    });
+    server.addService(&service_);
+}
+
+void AlphaSignalServiceImpl::publish(const AlphaSignal* signals, size_t count) {
+    if (count == 0 || stream_.getSubscriberCount() == 0) {
+        return;
+    }
+    auto* staged = stagingArena_.create<proto::AggregatedSignals>();
+    for (size_t i = 0; i < count; ++i) {
+        toProto(signals[i], staged->add_signals());
+    }
+    stream_.publish(staged->signals());
+    stagingArena_.reset();
+}
+
+} // namespace wq::alpha
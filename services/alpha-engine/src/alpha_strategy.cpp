@@ -1,5 +1,6 @@
 #include "alpha_strategy.hpp"
-#include <numeric>
+#include "alpha_engine.hpp"
+#include <algorithm>
 #include <cmath>
 #include <chrono>
 
@@ -7,21 +8,48 @@ namespace wq::alpha {
 
 // MeanReversionAlpha implementation
 MeanReversionAlpha::MeanReversionAlpha(std::string alphaId, int windowSize)
-    : alphaId_(std::move(alphaId))
+    : alphaId_(alphaId)
+    , alphaIndex_(common::internAlphaId(alphaId))
     , windowSize_(windowSize) {
-    priceHistory_.reserve(windowSize);
 }
 
 void MeanReversionAlpha::initialize() {
-    priceHistory_.clear();
+    symbolStates_.clear();
     initialized_ = true;
 }
 
 void MeanReversionAlpha::shutdown() {
-    priceHistory_.clear();
+    symbolStates_.clear();
     initialized_ = false;
 }
 
+std::unique_ptr<IAlphaStrategy> MeanReversionAlpha::clone() const {
+    return std::make_unique<MeanReversionAlpha>(alphaId_.str(), windowSize_);
+}
+
+bool MeanReversionAlpha::serialize(common::CheckpointWriter& out) const {
+    out.write<int64_t>(windowSize_);
+    out.write(lastUpdateTime_);
+    serializeSymbolStates(out, symbolStates_, [](const SymbolState& state, common::CheckpointWriter& to) {
+        state.prices.serialize(to);
+    });
+    return true;
+}
+
+bool MeanReversionAlpha::restore(common::CheckpointSection& in, const SymbolFilter& keep) {
+    int64_t windowSize, lastUpdateTime;
+    if (!in.read(windowSize) || windowSize != windowSize_ || !in.read(lastUpdateTime)) {
+        return false;
+    }
+    bool restored = restoreSymbolStates(in, keep, symbolStates_,
+        [this]() { return SymbolState(windowSize_); },
+        [](SymbolState& state, common::CheckpointSection& from) { return state.prices.restore(from); });
+    if (restored) {
+        lastUpdateTime_ = std::max(lastUpdateTime_, lastUpdateTime);
+    }
+    return restored;
+}
+
 bool MeanReversionAlpha::isActive() const {
     return initialized_ && IAlphaStrategy::isActive();
 }
@@ -31,19 +59,17 @@ std::optional<AlphaSignal> MeanReversionAlpha::onMarketData(const MarketData& da
         return std::nullopt;
     }
     
-    // Add price to history
-    priceHistory_.push_back(data.price);
-    if (priceHistory_.size() > static_cast<size_t>(windowSize_)) {
-        priceHistory_.erase(priceHistory_.begin());
-    }
+    // Add price to this symbol's window
+    auto& prices = symbolStates_.try_emplace(data.symbolId, windowSize_).first->second.prices;
+    prices.push(data.price);
     
     // Need enough data
-    if (priceHistory_.size() < static_cast<size_t>(windowSize_)) {
+    if (!prices.full()) {
         return std::nullopt;
     }
     
-    double mean = calculateMean();
-    double stdDev = calculateStdDev();
+    double mean = prices.mean();
+    double stdDev = prices.stdDev();
     
     if (stdDev < 1e-6) {
         return std::nullopt;  // Not enough volatility
@@ -65,7 +91,9 @@ std::optional<AlphaSignal> MeanReversionAlpha::onMarketData(const MarketData& da
     // Create signal using move semantics
     AlphaSignal alphaSignal;
     alphaSignal.alphaId = alphaId_;
+    alphaSignal.alphaIndex = alphaIndex_;
     alphaSignal.symbol = data.symbol;
+    alphaSignal.symbolId = data.symbolId;
     alphaSignal.signal = signal;
     alphaSignal.confidence = confidence;
     alphaSignal.timestampNs = data.timestampNs;
@@ -75,71 +103,92 @@ std::optional<AlphaSignal> MeanReversionAlpha::onMarketData(const MarketData& da
     return alphaSignal;
 }
 
-double MeanReversionAlpha::calculateMean() const {
-    return std::accumulate(priceHistory_.begin(), priceHistory_.end(), 0.0) 
-           / priceHistory_.size();
-}
-
-double MeanReversionAlpha::calculateStdDev() const {
-    double mean = calculateMean();
-    double variance = std::accumulate(priceHistory_.begin(), priceHistory_.end(), 0.0,
-        [mean](double acc, double price) {
-            double diff = price - mean;
-            return acc + diff * diff;
-        }) / priceHistory_.size();
-    
-    return std::sqrt(variance);
-}
-
 // MomentumAlpha implementation
 MomentumAlpha::MomentumAlpha(std::string alphaId, int lookbackPeriod)
-    : alphaId_(std::move(alphaId))
+    : alphaId_(alphaId)
+    , alphaIndex_(common::internAlphaId(alphaId))
     , lookbackPeriod_(lookbackPeriod) {
-    returns_.reserve(lookbackPeriod);
 }
 
 void MomentumAlpha::initialize() {
-    returns_.clear();
-    lastPrice_.reset();
+    symbolStates_.clear();
 }
 
 void MomentumAlpha::shutdown() {
-    returns_.clear();
-    lastPrice_.reset();
+    symbolStates_.clear();
+}
+
+std::unique_ptr<IAlphaStrategy> MomentumAlpha::clone() const {
+    return std::make_unique<MomentumAlpha>(alphaId_.str(), lookbackPeriod_);
+}
+
+bool MomentumAlpha::serialize(common::CheckpointWriter& out) const {
+    out.write<int64_t>(lookbackPeriod_);
+    out.write(lastUpdateTime_);
+    serializeSymbolStates(out, symbolStates_, [](const SymbolState& state, common::CheckpointWriter& to) {
+        state.returns.serialize(to);
+        to.write<uint8_t>(state.lastPrice.has_value());
+        to.write(state.lastPrice.value_or(0.0));
+    });
+    return true;
+}
+
+bool MomentumAlpha::restore(common::CheckpointSection& in, const SymbolFilter& keep) {
+    int64_t lookbackPeriod, lastUpdateTime;
+    if (!in.read(lookbackPeriod) || lookbackPeriod != lookbackPeriod_ || !in.read(lastUpdateTime)) {
+        return false;
+    }
+    bool restored = restoreSymbolStates(in, keep, symbolStates_,
+        [this]() { return SymbolState(lookbackPeriod_); },
+        [](SymbolState& state, common::CheckpointSection& from) {
+            uint8_t hasLastPrice;
+            double lastPrice;
+            if (!state.returns.restore(from) || !from.read(hasLastPrice) || !from.read(lastPrice)) {
+                return false;
+            }
+            if (hasLastPrice) {
+                state.lastPrice = lastPrice;
+            }
+            return true;
+        });
+    if (restored) {
+        lastUpdateTime_ = std::max(lastUpdateTime_, lastUpdateTime);
+    }
+    return restored;
 }
 
 std::optional<AlphaSignal> MomentumAlpha::onMarketData(const MarketData& data) {
+    auto& state = symbolStates_.try_emplace(data.symbolId, lookbackPeriod_).first->second;
+    auto& returns = state.returns;
+    
     // Calculate return if we have previous price
-    if (lastPrice_.has_value()) {
-        double ret = (data.price - lastPrice_.value()) / lastPrice_.value();
-        returns_.push_back(ret);
-        
-        if (returns_.size() > static_cast<size_t>(lookbackPeriod_)) {
-            returns_.erase(returns_.begin());
-        }
+    if (state.lastPrice.has_value()) {
+        double ret = (data.price - state.lastPrice.value()) / state.lastPrice.value();
+        returns.push(ret);
     }
     
-    lastPrice_ = data.price;
+    state.lastPrice = data.price;
     
     // Need enough data
-    if (returns_.size() < static_cast<size_t>(lookbackPeriod_)) {
+    if (!returns.full()) {
         return std::nullopt;
     }
     
     // Calculate cumulative return
-    double cumulativeReturn = std::accumulate(returns_.begin(), returns_.end(), 0.0);
+    double cumulativeReturn = returns.sum();
     
     // Signal is based on momentum direction
     double signal = std::tanh(cumulativeReturn * 10.0);  // Sigmoid-like scaling
     
     // Confidence based on consistency of returns
-    int positiveReturns = std::count_if(returns_.begin(), returns_.end(),
-        [](double r) { return r > 0; });
-    double consistency = std::abs(static_cast<double>(positiveReturns) / returns_.size() - 0.5) * 2.0;
+    size_t positiveReturns = returns.positiveCount();
+    double consistency = std::abs(static_cast<double>(positiveReturns) / returns.size() - 0.5) * 2.0;
     
     AlphaSignal alphaSignal;
     alphaSignal.alphaId = alphaId_;
+    alphaSignal.alphaIndex = alphaIndex_;
     alphaSignal.symbol = data.symbol;
+    alphaSignal.symbolId = data.symbolId;
     alphaSignal.signal = signal;
     alphaSignal.confidence = consistency;
     alphaSignal.timestampNs = data.timestampNs;
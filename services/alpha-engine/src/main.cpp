@@ -1,9 +1,18 @@
 #include "alpha_engine.hpp"
+#include "alpha_signal_service.hpp"
 #include "alpha_strategy.hpp"
+#include "checkpoint.hpp"
+#include "metrics_server.hpp"
+#include "replay_engine.hpp"
+#include "topology.hpp"
 #include <iostream>
 #include <csignal>
 #include <atomic>
 #include <chrono>
+#include <filesystem>
+#include <memory>
+#include <string>
+#include <string_view>
 
 std::atomic<bool> running{true};
 
@@ -21,56 +30,196 @@ int main(int argc, char** argv) {
     
     using namespace wq::alpha;
     
-    // Create alpha engine pool with 8 worker threads
-    AlphaEnginePool engine(8);
+    // Create alpha engine pool with a worker per alpha.worker core, or 8
+    // unpinned workers without a topology naming them
+    wq::common::Topology& topology = wq::common::topology();
+    size_t numWorkers = topology.numCores(wq::common::TopologyStage::ALPHA_WORKER);
+    AlphaEnginePool engine(numWorkers > 0 ? numWorkers : 8);
     
     // Add sample alphas (in real system, load from plugins)
     std::cout << "Loading alpha strategies..." << std::endl;
     
-    for (int i = 0; i < 100; i++) {
-        std::string alphaId = "MeanReversion_" + std::to_string(i);
-        auto alpha = AlphaFactory::create<MeanReversionAlpha>(alphaId, 20);
-        engine.addAlpha(std::move(alpha));
+    // Each family is registered as one batch: MeanReversion_0..99, Momentum_0..99
+    engine.addAlphaBatch(AlphaFactory::createBatch("MeanReversion", "MeanReversion_",
+                                                   std::vector<int>(100, 20)));
+    engine.addAlphaBatch(AlphaFactory::createBatch("Momentum", "Momentum_",
+                                                   std::vector<int>(100, 10)));
+    
+    // Usage: alpha-engine [plugin-dir] [--conflate] [--checkpoint FILE] [--tick-store FILE]
+    const char* pluginDir = AlphaConfig::PLUGIN_DIR;
+    bool conflate = false;
+    std::string checkpointPath;
+    std::string tickStorePath;
+    for (int i = 1; i < argc; ++i) {
+        std::string_view arg = argv[i];
+        if (arg == "--conflate") {
+            conflate = true;
+        } else if (arg == "--checkpoint" && i + 1 < argc) {
+            checkpointPath = argv[++i];
+        } else if (arg == "--tick-store" && i + 1 < argc) {
+            tickStorePath = argv[++i];
+        } else {
+            pluginDir = argv[i];
+        }
+    }
+    
+    // Research plugins; files dropped or rebuilt there are picked up while running
+    if (engine.loadPlugins(pluginDir)) {
+        std::cout << "Watching plugin directory " << pluginDir << std::endl;
+    }
+    
+    // Ticks arrive through an SPSC ring and signals leave through an MPMC
+    // ring, so neither the feeder nor the workers wait on downstream output
+    auto tickRing = std::make_unique<MarketDataRing>();
+    auto signalRing = std::make_unique<SignalRing>();
+    topology.place("alpha.output ring", signalRing.get(), sizeof(SignalRing), wq::common::TopologyStage::ALPHA_OUTPUT);
+    engine.attachInput(*tickRing);
+    engine.setSignalRing(signalRing.get());
+    
+    // Alphas see the newest tick per symbol rather than falling behind a hot one
+    if (conflate && engine.setInputPolicy(wq::common::DeliveryPolicy::CONFLATED)) {
+        std::cout << "Conflating market data per symbol" << std::endl;
+    }
+    
+    // Warm restart: alpha state from the last checkpoint, if there is one
+    std::unique_ptr<wq::common::CheckpointReader> restored;
+    if (!checkpointPath.empty() && std::filesystem::exists(checkpointPath)) {
+        restored = wq::common::CheckpointReader::open(checkpointPath);
+        if (restored) {
+            std::cout << "Restored " << engine.restoreCheckpoint(*restored)
+                      << " alpha states from " << checkpointPath << std::endl;
+        }
     }
     
-    for (int i = 0; i < 100; i++) {
-        std::string alphaId = "Momentum_" + std::to_string(i);
-        auto alpha = AlphaFactory::create<MomentumAlpha>(alphaId, 10);
-        engine.addAlpha(std::move(alpha));
+    // Co-located aggregator reads signals from shared memory
+    auto signalShm = wq::common::publishColocated<wq::common::SignalShmRing>(
+        wq::common::IpcConfig::SIGNAL_SEGMENT, wq::common::TopologyStage::AGGREGATOR_BRIDGE);
+    
+    // Remote subscribers stream batched signals over gRPC
+    wq::common::AsyncServer server(wq::common::ServerConfig::ALPHA_SIGNAL_ADDRESS);
+    AlphaSignalServiceImpl signalService(server);
+    server.setStage(wq::common::TopologyStage::ALPHA_RPC);
+    if (!server.start()) {
+        return 1;
     }
+    std::cout << "Serving AlphaSignalService on " << server.getAddress() << std::endl;
     
-    // Register signal callback using lambda
-    engine.registerSignalCallback([](AlphaSignal&& signal) {
-        std::cout << "Signal: " << signal.alphaId 
-                  << " " << signal.symbol
-                  << " signal=" << signal.signal
-                  << " confidence=" << signal.confidence << std::endl;
+    // Queueing delay versus compute in the pool, plus counters, for scraping
+    auto& registry = wq::common::metrics();
+    registry.setCounter("alpha.signals", [&engine] {
+        size_t alphas, signals;
+        engine.getStats(alphas, signals);
+        return static_cast<double>(signals);
     });
+    registry.setCounter("alpha.signal_drops", [&engine] { return static_cast<double>(engine.getSignalDrops()); });
+    registry.setCounter("alpha.conflated", [&engine] { return static_cast<double>(engine.getConflatedCount()); });
+    wq::common::MetricsServer metricsServer(wq::common::MetricsConfig::ALPHA_ENGINE_PORT);
+    if (metricsServer.start()) {
+        std::cout << "Serving metrics on port " << metricsServer.getPort() << std::endl;
+    }
+    
+    wq::common::RingConsumer<SignalRing> signalConsumer(*signalRing,
+        [shm = signalShm.get(), &signalService](AlphaSignal* signals, size_t count) {
+            signalService.publish(signals, count);
+            for (size_t i = 0; i < count; ++i) {
+                const AlphaSignal& signal = signals[i];
+                if (shm) {
+                    shm->tryPush(toSignalRecord(signal));
+                }
+                std::cout << "Signal: " << signal.alphaId 
+                          << " " << signal.symbol
+                          << " signal=" << signal.signal
+                          << " confidence=" << signal.confidence << std::endl;
+            }
+        });
+    signalConsumer.setStage(wq::common::TopologyStage::ALPHA_OUTPUT);
+    signalConsumer.start();
+    
+    // Ticks come from a co-located feed handler when one is running
+    auto tickShm = wq::common::attachColocated<wq::common::TickShmRing>(
+        wq::common::IpcConfig::MARKET_DATA_SEGMENT);
+    std::unique_ptr<wq::common::RingConsumer<wq::common::TickShmRing>> tickBridge;
+    if (tickShm) {
+        tickBridge = std::make_unique<wq::common::RingConsumer<wq::common::TickShmRing>>(*tickShm,
+            [&tickRing](wq::common::TickRecord* records, size_t count) {
+                for (size_t i = 0; i < count; ++i) {
+                    tickRing->tryPush(fromTickRecord(records[i]));
+                }
+            });
+        tickBridge->setStage(wq::common::TopologyStage::ALPHA_BRIDGE);
+    }
     
     // Start engine
     engine.start();
     
+    // Catch up on the ticks captured after the checkpoint before live ones
+    if (restored && !tickStorePath.empty()) {
+        if (auto source = openTickSource(tickStorePath)) {
+            source->resumeAfter(restored->watermarkNs());
+            std::cout << "Replayed " << catchUp(engine, *source)
+                      << " ticks captured since the checkpoint" << std::endl;
+        }
+    }
+    restored.reset();
+    if (tickBridge) {
+        tickBridge->start();
+    }
+    
+    // Periodic snapshots from this thread; workers only copy their state out
+    int64_t lastCheckpointNs = std::chrono::high_resolution_clock::now().time_since_epoch().count();
+    auto writeCheckpoint = [&engine, &checkpointPath](int64_t nowNs) {
+        wq::common::CheckpointWriter writer;
+        size_t sections = engine.checkpoint(writer);
+        if (writer.commit(checkpointPath, nowNs)) {
+            std::cout << "Checkpointed " << sections << " alpha states to " << checkpointPath << std::endl;
+        }
+    };
+    
     size_t numAlphas, numSignals;
     engine.getStats(numAlphas, numSignals);
     std::cout << "Service started with " << numAlphas << " alphas" << std::endl;
+    topology.report(std::cout);
     
-    // Simulate market data feed
-    std::cout << "Simulating market data..." << std::endl;
+    // Without a co-located feed, simulate the remote market data stream
+    if (tickShm) {
+        std::cout << "Consuming market data from shared memory " << tickShm->name() << std::endl;
+    } else {
+        std::cout << "Simulating market data..." << std::endl;
+    }
     
     int tickCount = 0;
+    MarketData data;
+    data.setSymbol("AAPL");  // Interned once, reused for every tick
     while (running) {
+        int64_t nowNs = std::chrono::high_resolution_clock::now().time_since_epoch().count();
+        if (!checkpointPath.empty() && nowNs - lastCheckpointNs >= wq::common::CheckpointConfig::INTERVAL_NS) {
+            writeCheckpoint(nowNs);
+            lastCheckpointNs = nowNs;
+        }
+        
+        if (tickShm) {
+            std::this_thread::sleep_for(std::chrono::seconds(1));
+            engine.refreshPlugins();
+            engine.getStats(numAlphas, numSignals);
+            std::cout << "Consumed " << tickBridge->getConsumedCount() << " ticks, "
+                      << "Conflated " << engine.getConflatedCount() << ", "
+                      << "Generated " << numSignals << " signals" << std::endl;
+            continue;
+        }
+        
         // Create sample market data
-        MarketData data;
-        data.symbol = "AAPL";
         data.price = 150.0 + (std::rand() % 100) / 100.0;
         data.volume = 10000;
         data.timestampNs = std::chrono::high_resolution_clock::now()
             .time_since_epoch().count();
         
-        // Process through all alphas
-        engine.processMarketData(data);
+        // Hand the tick to the engine's input thread
+        tickRing->tryPush(data);
         
         tickCount++;
+        if (tickCount % AlphaConfig::PLUGIN_REFRESH_TICKS == 0) {
+            engine.refreshPlugins();
+        }
         if (tickCount % 10 == 0) {
             engine.getStats(numAlphas, numSignals);
             std::cout << "Processed " << tickCount << " ticks, "
@@ -80,8 +229,17 @@ int main(int argc, char** argv) {
         std::this_thread::sleep_for(std::chrono::milliseconds(100));
     }
     
-    // Cleanup
+    // Cleanup - upstream first, so in-flight ticks and signals are delivered
+    if (tickBridge) {
+        tickBridge->stop();
+    }
     engine.stop();
+    if (!checkpointPath.empty()) {
+        writeCheckpoint(std::chrono::high_resolution_clock::now().time_since_epoch().count());
+    }
+    signalConsumer.stop();
+    server.shutdown();
+    metricsServer.stop();
     std::cout << "Service stopped" << std::endl;
     
     return 0;
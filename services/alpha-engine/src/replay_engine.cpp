@@ -0,0 +1,392 @@
+#include "replay_engine.hpp"
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#include <algorithm>
+#include <chrono>
+#include <cstdio>
+#include <cstring>
+#include <iostream>
+#include <thread>
+#include <tuple>
+
+namespace wq::alpha {
+
+namespace {
+
+constexpr uint32_t UNRANKED = static_cast<uint32_t>(-1);
+
+template<typename Name>
+bool nameLess(const Name& a, const Name& b) {
+    return std::memcmp(a.data(), b.data(), Name::CAPACITY) < 0;
+}
+
+// Position of each signal's name among the distinct names in signals, in
+// name order. Interned ids differ from run to run, names do not; ranking the
+// few distinct names once lets the sort compare integers instead.
+template<typename Name, typename Id>
+void rankByName(const std::vector<AlphaSignal>& signals, Name AlphaSignal::*name, Id AlphaSignal::*id,
+                std::vector<uint32_t>& ranks) {
+    std::vector<std::pair<Name, Id>> distinct;
+    std::vector<uint32_t> byId;
+    for (const auto& signal : signals) {
+        Id key = signal.*id;
+        if (key == common::INVALID_INTERN_ID || (key < byId.size() && byId[key] != UNRANKED)) {
+            continue;
+        }
+        if (key >= byId.size()) {
+            byId.resize(key + 1, UNRANKED);
+        }
+        byId[key] = 0;
+        distinct.emplace_back(signal.*name, key);
+    }
+    std::sort(distinct.begin(), distinct.end(), [](const auto& a, const auto& b) {
+        return nameLess(a.first, b.first);
+    });
+    for (uint32_t rank = 0; rank < distinct.size(); ++rank) {
+        byId[distinct[rank].second] = rank;
+    }
+    
+    // Signals without an id rank by name, after every named one
+    ranks.resize(signals.size());
+    for (size_t i = 0; i < signals.size(); ++i) {
+        Id key = signals[i].*id;
+        ranks[i] = key != common::INVALID_INTERN_ID ? byId[key] : static_cast<uint32_t>(distinct.size());
+    }
+}
+
+} // namespace
+
+// TickRecordFileSource implementation
+std::unique_ptr<TickRecordFileSource> TickRecordFileSource::open(const std::string& path) {
+    int fd = ::open(path.c_str(), O_RDONLY);
+    if (fd < 0) {
+        std::cerr << "Failed to open tick file " << path << std::endl;
+        return nullptr;
+    }
+    struct stat info;
+    if (fstat(fd, &info) != 0 || static_cast<size_t>(info.st_size) < sizeof(TickRecordFileHeader)) {
+        close(fd);
+        std::cerr << "Tick file " << path << " is truncated" << std::endl;
+        return nullptr;
+    }
+    size_t size = static_cast<size_t>(info.st_size);
+    void* mapping = mmap(nullptr, size, PROT_READ, MAP_PRIVATE, fd, 0);
+    close(fd);
+    if (mapping == MAP_FAILED) {
+        std::cerr << "Failed to map tick file " << path << std::endl;
+        return nullptr;
+    }
+
+    const auto* header = static_cast<const TickRecordFileHeader*>(mapping);
+    bool compatible = header->magic == ReplayConfig::RECORD_FILE_MAGIC
+        && header->version == ReplayConfig::RECORD_FILE_VERSION
+        && header->recordSize == sizeof(common::TickRecord)
+        && header->count <= (size - sizeof(TickRecordFileHeader)) / sizeof(common::TickRecord);
+    if (!compatible) {
+        munmap(mapping, size);
+        std::cerr << "Tick file " << path << " has an unsupported layout" << std::endl;
+        return nullptr;
+    }
+
+    // Read front to back exactly once
+    madvise(mapping, size, MADV_SEQUENTIAL);
+    return std::unique_ptr<TickRecordFileSource>(new TickRecordFileSource(mapping, size));
+}
+
+TickRecordFileSource::TickRecordFileSource(void* mapping, size_t mappingSize)
+    : mapping_(mapping)
+    , mappingSize_(mappingSize)
+    , records_(reinterpret_cast<const common::TickRecord*>(
+          static_cast<const char*>(mapping) + sizeof(TickRecordFileHeader)))
+    , count_(static_cast<const TickRecordFileHeader*>(mapping)->count) {
+}
+
+TickRecordFileSource::~TickRecordFileSource() {
+    munmap(mapping_, mappingSize_);
+}
+
+size_t TickRecordFileSource::read(MarketData* out, size_t maxTicks) {
+    size_t numRead = 0;
+    while (numRead < maxTicks && position_ < count_) {
+        const common::TickRecord& record = records_[position_++];
+        if (!wanted(record.symbol, record.timestampNs)) {
+            continue;
+        }
+        out[numRead++] = fromTickRecord(record);
+    }
+    return numRead;
+}
+
+bool writeTickRecordFile(const std::string& path, const common::TickRecord* records, size_t count) {
+    FILE* file = std::fopen(path.c_str(), "wb");
+    if (!file) {
+        return false;
+    }
+    TickRecordFileHeader header{};
+    header.magic = ReplayConfig::RECORD_FILE_MAGIC;
+    header.version = ReplayConfig::RECORD_FILE_VERSION;
+    header.recordSize = sizeof(common::TickRecord);
+    header.count = count;
+    bool ok = std::fwrite(&header, sizeof(header), 1, file) == 1
+        && std::fwrite(records, sizeof(common::TickRecord), count, file) == count;
+    return std::fclose(file) == 0 && ok;
+}
+
+// TickStoreSource implementation
+std::unique_ptr<TickStoreSource> TickStoreSource::open(const std::string& path) {
+    auto reader = common::TickStoreReader::open(path);
+    if (!reader) {
+        return nullptr;
+    }
+    reader->adviseSequential();
+    return std::unique_ptr<TickStoreSource>(new TickStoreSource(std::move(reader)));
+}
+
+TickStoreSource::TickStoreSource(std::unique_ptr<common::TickStoreReader> reader)
+    : reader_(std::move(reader)) {
+}
+
+void TickStoreSource::seek(int64_t timestampNs) {
+    block_ = reader_->findBlock(timestampNs);
+    row_ = 0;
+}
+
+void TickStoreSource::resumeAfter(int64_t timestampNs) {
+    ITickSource::resumeAfter(timestampNs);
+    seek(timestampNs);
+}
+
+size_t TickStoreSource::read(MarketData* out, size_t maxTicks) {
+    size_t numRead = 0;
+    size_t numBlocks = reader_->numBlocks();
+    while (numRead < maxTicks && block_ < numBlocks) {
+        const common::TickStoreBlock& block = reader_->block(block_);
+        size_t rows = block.size();
+        // Filter on the symbol column before gathering the rest of the row
+        for (; row_ < rows && numRead < maxTicks; ++row_) {
+            if (wanted(block.symbol[row_], block.timestampNs[row_])) {
+                out[numRead++] = fromTickRecord(block.record(row_));
+            }
+        }
+        if (row_ < rows) {
+            continue;
+        }
+        // The last block may still be filling under a live capture
+        if (rows < common::TickStoreBlock::ROWS && block_ + 1 == numBlocks) {
+            break;
+        }
+        ++block_;
+        row_ = 0;
+    }
+    return numRead;
+}
+
+std::unique_ptr<ITickSource> openTickSource(const std::string& path) {
+    uint32_t magic = 0;
+    FILE* file = std::fopen(path.c_str(), "rb");
+    if (file) {
+        size_t numRead = std::fread(&magic, sizeof(magic), 1, file);
+        std::fclose(file);
+        if (numRead == 1 && magic == common::TickStoreConfig::MAGIC) {
+            return TickStoreSource::open(path);
+        }
+    }
+    return TickRecordFileSource::open(path);
+}
+
+size_t catchUp(AlphaEnginePool& pool, ITickSource& source, size_t chunkTicks) {
+    std::vector<MarketData> chunk(std::max<size_t>(chunkTicks, 1));
+    size_t numTicks = 0;
+    size_t count;
+    while ((count = source.read(chunk.data(), chunk.size())) > 0) {
+        pool.processMarketDataBatch(chunk.data(), count);
+        numTicks += count;
+    }
+    pool.waitIdle();
+    return numTicks;
+}
+
+// ReplayEngine implementation
+ReplayEngine::ReplayEngine(AlphaEnginePool& pool, ReplaySignalSink sink, size_t chunkTicks)
+    : pool_(pool)
+    , sink_(std::move(sink))
+    , chunkTicks_(std::max<size_t>(chunkTicks, 1))
+    , workerSignals_(pool.getNumThreads() + 1) {
+    // Last buffer: anything emitted outside the workers
+    pool_.registerSignalCallback([this](AlphaSignal&& signal) {
+        size_t worker = std::min(ThreadPool::currentWorker(), workerSignals_.size() - 1);
+        workerSignals_[worker].push_back(signal);
+    });
+}
+
+ReplayResult ReplayEngine::run(ITickSource& source) {
+    auto started = std::chrono::steady_clock::now();
+    pool_.start();
+
+    ReplayResult result;
+    std::vector<MarketData> chunk(chunkTicks_);
+    while (size_t count = source.read(chunk.data(), chunk.size())) {
+        if (result.numTicks == 0) {
+            result.firstTimestampNs = chunk[0].timestampNs;
+        }
+        result.numTicks += count;
+        result.lastTimestampNs = chunk[count - 1].timestampNs;
+
+        pool_.processMarketDataBatch(chunk.data(), count);
+        pool_.waitIdle();
+        clock_.advanceTo(result.lastTimestampNs);
+        flushChunk(result);
+    }
+
+    result.wallSeconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - started).count();
+    return result;
+}
+
+void ReplayEngine::flushChunk(ReplayResult& result) {
+    chunkSignals_.clear();
+    for (auto& signals : workerSignals_) {
+        chunkSignals_.insert(chunkSignals_.end(), signals.begin(), signals.end());
+        signals.clear();
+    }
+    if (chunkSignals_.empty()) {
+        return;
+    }
+    
+    // Order by timestamp, symbol, alpha id. Each worker emits a tick's
+    // signals together, so sort those runs by (timestamp, symbol) and then
+    // only the signals within equal runs by alpha. Ties keep arrival order,
+    // which for one (alpha, symbol) pair is the order its single writer ran in.
+    rankByName(chunkSignals_, &AlphaSignal::symbol, &AlphaSignal::symbolId, symbolRanks_);
+    rankByName(chunkSignals_, &AlphaSignal::alphaId, &AlphaSignal::alphaIndex, alphaRanks_);
+    runs_.clear();
+    for (size_t begin = 0; begin < chunkSignals_.size();) {
+        size_t end = begin + 1;
+        while (end < chunkSignals_.size() && chunkSignals_[end].timestampNs == chunkSignals_[begin].timestampNs &&
+               symbolRanks_[end] == symbolRanks_[begin]) {
+            ++end;
+        }
+        runs_.push_back({chunkSignals_[begin].timestampNs, symbolRanks_[begin],
+                         static_cast<uint32_t>(begin), static_cast<uint32_t>(end)});
+        begin = end;
+    }
+    std::stable_sort(runs_.begin(), runs_.end(), [](const SignalRun& a, const SignalRun& b) {
+        return std::tie(a.timestampNs, a.symbolRank) < std::tie(b.timestampNs, b.symbolRank);
+    });
+    
+    order_.clear();
+    for (size_t r = 0; r < runs_.size();) {
+        size_t groupBegin = order_.size();
+        size_t next = r;
+        for (; next < runs_.size() && runs_[next].timestampNs == runs_[r].timestampNs &&
+               runs_[next].symbolRank == runs_[r].symbolRank; ++next) {
+            for (uint32_t i = runs_[next].begin; i < runs_[next].end; ++i) {
+                order_.push_back(i);
+            }
+        }
+        std::stable_sort(order_.begin() + groupBegin, order_.end(), [this](uint32_t a, uint32_t b) {
+            return alphaRanks_[a] < alphaRanks_[b];
+        });
+        r = next;
+    }
+    sortedSignals_.resize(order_.size());
+    for (size_t i = 0; i < order_.size(); ++i) {
+        sortedSignals_[i] = chunkSignals_[order_[i]];
+    }
+
+    result.numSignals += sortedSignals_.size();
+    if (sink_) {
+        sink_(sortedSignals_.data(), sortedSignals_.size());
+    }
+}
+
+// ReplayRunner implementation
+ReplayRunner::ReplayRunner(PoolSetup setup, ReplayOptions options)
+    : setup_(std::move(setup))
+    , options_(options) {
+}
+
+std::vector<ReplayResult> ReplayRunner::run(const std::vector<ReplayPartition>& partitions,
+                                            const SinkFactory& sinks) {
+    std::vector<ReplayResult> results(partitions.size());
+    size_t parallel = options_.maxParallelPartitions;
+    if (parallel == 0) {
+        size_t cores = std::max<unsigned>(std::thread::hardware_concurrency(), 1);
+        parallel = std::max<size_t>(cores / std::max<size_t>(options_.threadsPerPartition, 1), 1);
+    }
+    parallel = std::min(parallel, partitions.size());
+
+    // Runners take partitions in turn until none are left
+    std::atomic<size_t> next{0};
+    auto runner = [&]() {
+        for (size_t i = next++; i < partitions.size(); i = next++) {
+            results[i] = runPartition(partitions[i], sinks ? sinks(i) : ReplaySignalSink());
+        }
+    };
+    std::vector<std::thread> threads;
+    for (size_t t = 1; t < parallel; ++t) {
+        threads.emplace_back(runner);
+    }
+    runner();
+    for (auto& thread : threads) {
+        thread.join();
+    }
+    return results;
+}
+
+ReplayResult ReplayRunner::runPartition(const ReplayPartition& partition, ReplaySignalSink sink) {
+    AlphaEnginePool pool(options_.threadsPerPartition, options_.mode);
+    setup_(pool);
+    ReplayEngine engine(pool, std::move(sink), options_.chunkTicks);
+
+    ReplayResult total;
+    for (const auto& path : partition.files) {
+        auto source = openTickSource(path);
+        if (!source) {
+            continue;
+        }
+        source->setSymbolShard(partition.symbolShard, partition.numSymbolShards);
+        ReplayResult result = engine.run(*source);
+        if (total.numTicks == 0) {
+            total.firstTimestampNs = result.firstTimestampNs;
+        }
+        if (result.numTicks > 0) {
+            total.lastTimestampNs = result.lastTimestampNs;
+        }
+        total.numTicks += result.numTicks;
+        total.numSignals += result.numSignals;
+        total.wallSeconds += result.wallSeconds;
+    }
+    pool.stop();
+    return total;
+}
+
+std::vector<ReplayPartition> ReplayRunner::single(const std::vector<std::string>& files) {
+    ReplayPartition partition;
+    partition.files = files;
+    return {partition};
+}
+
+std::vector<ReplayPartition> ReplayRunner::byDate(const std::vector<std::string>& files) {
+    std::vector<ReplayPartition> partitions;
+    for (const auto& file : files) {
+        ReplayPartition partition;
+        partition.files.push_back(file);
+        partitions.push_back(std::move(partition));
+    }
+    return partitions;
+}
+
+std::vector<ReplayPartition> ReplayRunner::bySymbol(const std::vector<std::string>& files, size_t numShards) {
+    numShards = std::max<size_t>(numShards, 1);
+    std::vector<ReplayPartition> partitions(numShards);
+    for (size_t shard = 0; shard < numShards; ++shard) {
+        partitions[shard].files = files;
+        partitions[shard].symbolShard = shard;
+        partitions[shard].numSymbolShards = numShards;
+    }
+    return partitions;
+}
+
+} // namespace wq::alpha
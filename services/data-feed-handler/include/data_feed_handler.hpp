@@ -1,6 +1,10 @@
 #pragma once
 
 #include "data_types.hpp"
+#include "ipc_transport.hpp"
+#include "line_arbitrator.hpp"
+#include "ring_buffer.hpp"
+#include <array>
 #include <functional>
 #include <memory>
 #include <vector>
@@ -9,8 +13,50 @@
 
 namespace wq::datafeed {
 
+// Constexpr configuration
+namespace Config {
+    constexpr size_t MAX_PACKET_SIZE = 65536;
+    constexpr size_t BUFFER_SIZE = 1024 * 1024;  // 1MB
+    constexpr int MAX_NORMALIZERS = 16;
+    constexpr size_t DEFAULT_RECV_BATCH = 64;    // Datagrams per recvmmsg
+    constexpr size_t MAX_RECV_BATCH = 1024;      // UIO_MAXIOV
+    constexpr int POLL_TIMEOUT_MS = 100;
+    constexpr size_t ARBITRATION_WINDOW = 65536;  // Sequences tracked per feed
+    constexpr size_t OUTPUT_RING_CAPACITY = 65536;  // Updates buffered for the next stage
+}
+
 // Forward declarations
 class DataFeedHandler;
+class TickCaptureSink;
+
+// Receive path selection
+enum class ReceiveMode : uint8_t {
+    BLOCKING,   // One recvfrom per datagram
+    BATCHED     // Many datagrams per recvmmsg into a preallocated ring
+};
+
+// Socket and receive loop tuning, applied when the listener opens its socket
+struct ReceiveOptions {
+    ReceiveMode mode{ReceiveMode::BLOCKING};
+    size_t batchSize{Config::DEFAULT_RECV_BATCH};
+    int socketRecvBufferBytes{0};   // SO_RCVBUF, 0 keeps the kernel default
+    int busyPollMicros{0};          // SO_BUSY_POLL, 0 disables busy polling
+    bool spinWait{false};           // Spin on non-blocking reads instead of poll()
+};
+
+// One multicast feed line served by its own socket and listener thread
+struct FeedChannel {
+    std::string name;                   // e.g. "NYSE", "CME-A"
+    Exchange exchange{Exchange::UNKNOWN};  // Selects the normalizer; UNKNOWN probes all
+    std::string multicastGroup;
+    uint16_t port{0};
+    int cpuCore{-1};                    // Pin the listener thread, -1 leaves it unpinned;
+                                        // the topology's feed.listener cores take precedence
+    int arbitrationGroup{-1};           // Channels sharing a group are A/B lines of one feed
+};
+
+// Hand-off to the next stage; every listener thread is a producer
+using MarketDataRing = common::MpmcRing<MarketData, Config::OUTPUT_RING_CAPACITY>;
 
 // Type alias for callback function pointer
 using DataCallback = std::function<void(const MarketData&)>;
@@ -20,12 +66,18 @@ typedef void (*RawDataCallback)(const uint8_t*, size_t);
 
 // Smart pointer factory class demonstrating friend
 class DataFeedHandlerFactory {
-private:
-    friend class DataFeedHandler;
-    
+public:
+    // Single channel handler - packets are probed against every normalizer
     static std::unique_ptr<DataFeedHandler> createHandler(
         std::string_view multicastGroup,
         uint16_t port);
+    
+    // One listener thread per channel, packets routed by FeedChannel::exchange
+    static std::unique_ptr<DataFeedHandler> createHandler(
+        std::vector<FeedChannel> channels);
+
+private:
+    friend class DataFeedHandler;
 };
 
 // Main data feed handler class
@@ -47,13 +99,34 @@ public:
     // Stop listening
     void stop();
     
-    // Register callback with lambda support
+    // Register callback with lambda support. Callbacks run on every channel's
+    // listener thread, so they must be safe to call concurrently.
     void registerCallback(DataCallback callback);
     
     // Function overloading - different signatures
     void registerCallback(RawDataCallback callback);
     
-    // Register normalizer by exchange
+    // Publish into a ring instead of invoking callbacks on the listener
+    // threads. A full ring drops the update rather than stalling the socket.
+    // The ring must outlive the handler; nullptr restores callback delivery.
+    void setOutputRing(MarketDataRing* ring) { outputRing_ = ring; }
+    int64_t getOutputDrops() const { return outputDrops_.load(); }
+    
+    // Also record every update to disk. The sink only queues the update on
+    // the listener thread and writes it from its own thread; it must outlive
+    // the handler, and nullptr stops capturing.
+    void setCaptureSink(TickCaptureSink* sink) { captureSink_ = sink; }
+    
+    // Configure the receive path - takes effect on the next start()
+    void setReceiveOptions(const ReceiveOptions& options);
+    const ReceiveOptions& getReceiveOptions() const { return receiveOptions_; }
+    
+    // Add a feed channel - takes effect on the next start()
+    void addChannel(FeedChannel channel);
+    const std::vector<FeedChannel>& getChannels() const { return channels_; }
+    
+    // Register normalizer by exchange. NYSE and NASDAQ are decoded by built-in
+    // compile-time layouts; registering a normalizer for them overrides that.
     void registerNormalizer(Exchange exchange, std::shared_ptr<DataNormalizer> normalizer);
     
     // Get statistics - pass by reference
@@ -62,6 +135,11 @@ public:
     // Get statistics - pass by pointer
     void getStats(int64_t* packetsReceived, int64_t* packetsProcessed) const;
     
+    // A/B arbitration statistics summed over all feeds. sequenceGaps counts
+    // sequences skipped on arrival; gapsRecovered those later filled by another line.
+    void getArbitrationStats(int64_t& duplicatesDropped, int64_t& sequenceGaps,
+                             int64_t& gapsRecovered) const;
+    
     // Type deduction with const reference
     template<typename T>
     auto processData(const T& data) -> decltype(auto) {
@@ -69,8 +147,9 @@ public:
     }
     
 private:
-    // Private constructor - only factory can create
+    // Private constructors - only factory can create
     explicit DataFeedHandler(std::string multicastGroup, uint16_t port);
+    explicit DataFeedHandler(std::vector<FeedChannel> channels);
     
     friend class DataFeedHandlerFactory;
     
@@ -81,24 +160,76 @@ private:
     }
     
     // Member variables with smart pointers
-    std::string multicastGroup_;
-    uint16_t port_;
+    std::vector<FeedChannel> channels_;
     std::atomic<bool> running_{false};
-    std::unique_ptr<std::thread> listenerThread_;
+    std::vector<std::thread> listenerThreads_;
     std::vector<DataCallback> callbacks_;
-    std::vector<std::weak_ptr<DataNormalizer>> normalizers_;
+    std::array<std::weak_ptr<DataNormalizer>, NUM_EXCHANGES> normalizersByExchange_;
+    std::array<bool, NUM_EXCHANGES> runtimeNormalizer_{};  // Bypass the static decoder
+    std::vector<std::weak_ptr<DataNormalizer>> normalizers_;  // Probe order for UNKNOWN channels
+    ReceiveOptions receiveOptions_;
+    std::vector<std::unique_ptr<LineArbitrator>> arbitrators_;
+    std::vector<LineArbitrator*> channelArbitrators_;  // Per channel, nullptr if unarbitrated
+    int wakeFd_{-1};  // eventfd used by stop() to wake a blocked listener
+    MarketDataRing* outputRing_{nullptr};
+    TickCaptureSink* captureSink_{nullptr};
     
     // Statistics
     mutable std::atomic<int64_t> packetsReceived_{0};
     mutable std::atomic<int64_t> packetsProcessed_{0};
+    std::atomic<int64_t> outputDrops_{0};
+    
+    // Listener loop for one channel
+    void listenerLoop(const FeedChannel& channel, LineArbitrator* arbitrator);
+    
+    // Build one arbitrator per arbitration group
+    void setupArbitration();
+    
+    // Create, tune and bind the channel's multicast socket; returns -1 on failure
+    int openSocket(const FeedChannel& channel) const;
+    
+    // Receive loops selected by ReceiveOptions::mode
+    void receiveBlocking(int sockfd, Exchange exchange, LineArbitrator* arbitrator);
+    void receiveBatched(int sockfd, Exchange exchange, LineArbitrator* arbitrator);
+    
+    // Wait until the socket is readable, clearing socket errors on the way;
+    // false once stop() was requested or if poll() itself fails
+    bool waitReadable(int sockfd) const;
+    
+    // False if the arbitrator has already seen this datagram's sequence
+    bool admitDatagram(const uint8_t* data, size_t length, LineArbitrator* arbitrator);
     
-    // Listener loop
-    void listenerLoop();
+    // Arbitrate a received datagram, then process it if it is the first copy
+    void handleDatagram(const uint8_t* data, size_t length, Exchange exchange,
+                        LineArbitrator* arbitrator);
     
-    // Process received packet
-    void processPacket(const uint8_t* data, size_t length);
+    // Process received packet from a channel of the given exchange
+    void processPacket(const uint8_t* data, size_t length, Exchange exchange);
+    
+    // Decode and validate a whole receive batch as one SoA block
+    void processBatch(const uint8_t* const* packets, const size_t* lengths, size_t count,
+                      Exchange exchange, MarketDataBlock& block);
+    
+    // Deliver a normalized update to the output ring or every callback
+    void publish(const MarketData& data);
 };
 
+// Fixed-layout record published to co-located consumers
+inline common::TickRecord toTickRecord(const MarketData& data) {
+    common::TickRecord record{};
+    record.symbol = data.symbol;
+    record.bidPrice = data.bidPrice;
+    record.askPrice = data.askPrice;
+    record.lastPrice = data.lastPrice;
+    record.bidSize = data.bidSize;
+    record.askSize = data.askSize;
+    record.volume = data.volume;
+    record.timestampNs = data.timestampNs;
+    record.exchange = static_cast<uint8_t>(data.exchange);
+    record.assetType = static_cast<uint8_t>(data.assetType);
+    return record;
+}
+
 // Optional wrapper for market data
 struct MarketDataResult {
     std::optional<MarketData> data;
@@ -109,11 +240,4 @@ struct MarketDataResult {
     }
 };
 
-// Constexpr configuration
-namespace Config {
-    constexpr size_t MAX_PACKET_SIZE = 65536;
-    constexpr size_t BUFFER_SIZE = 1024 * 1024;  // 1MB
-    constexpr int MAX_NORMALIZERS = 16;
-}
-
 } // namespace wq::datafeed
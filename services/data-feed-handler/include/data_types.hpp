@@ -1,6 +1,9 @@
 #pragma once
 
+#include "fixed_string.hpp"
+#include "symbol_table.hpp"
 #include <cstdint>
+#include <cstring>
 #include <string>
 #include <string_view>
 #include <optional>
@@ -9,6 +12,9 @@
 
 namespace wq::datafeed {
 
+using common::SymbolId;
+using common::SymbolString;
+
 // Enum class for asset types
 enum class AssetType : uint8_t {
     EQUITY,
@@ -25,6 +31,13 @@ enum class Exchange : uint8_t {
     UNKNOWN
 };
 
+// Number of concrete exchanges (UNKNOWN excluded) - sizes per-exchange tables
+constexpr size_t NUM_EXCHANGES = static_cast<size_t>(Exchange::UNKNOWN);
+
+constexpr size_t exchangeIndex(Exchange exch) {
+    return static_cast<size_t>(exch);
+}
+
 // Constexpr function to convert enum to string
 constexpr std::string_view assetTypeToString(AssetType type) {
     switch (type) {
@@ -44,50 +57,24 @@ constexpr std::string_view exchangeToString(Exchange exch) {
     }
 }
 
-// Market data structure
+// Market data structure - trivially copyable, no heap allocation per tick
 struct MarketData {
-    std::string symbol;
-    double bidPrice;
-    double askPrice;
-    double lastPrice;
-    int64_t bidSize;
-    int64_t askSize;
-    int64_t volume;
-    int64_t timestampNs;
-    AssetType assetType;
-    Exchange exchange;
+    SymbolString symbol;
+    SymbolId symbolId{common::INVALID_SYMBOL_ID};  // Interned id keys per-symbol state
+    double bidPrice{0};
+    double askPrice{0};
+    double lastPrice{0};
+    int64_t bidSize{0};
+    int64_t askSize{0};
+    int64_t volume{0};
+    int64_t timestampNs{0};
+    AssetType assetType{AssetType::UNKNOWN};
+    Exchange exchange{Exchange::UNKNOWN};
     
-    // Default constructor
-    MarketData() = default;
-    
-    // Move constructor
-    MarketData(MarketData&& other) noexcept
-        : symbol(std::move(other.symbol))
-        , bidPrice(other.bidPrice)
-        , askPrice(other.askPrice)
-        , lastPrice(other.lastPrice)
-        , bidSize(other.bidSize)
-        , askSize(other.askSize)
-        , volume(other.volume)
-        , timestampNs(other.timestampNs)
-        , assetType(other.assetType)
-        , exchange(other.exchange) {}
-    
-    // Move assignment
-    MarketData& operator=(MarketData&& other) noexcept {
-        if (this != &other) {
-            symbol = std::move(other.symbol);
-            bidPrice = other.bidPrice;
-            askPrice = other.askPrice;
-            lastPrice = other.lastPrice;
-            bidSize = other.bidSize;
-            askSize = other.askSize;
-            volume = other.volume;
-            timestampNs = other.timestampNs;
-            assetType = other.assetType;
-            exchange = other.exchange;
-        }
-        return *this;
+    // Set symbol and its interned id together
+    void setSymbol(std::string_view name) {
+        symbol = SymbolString(name);
+        symbolId = common::internSymbol(name);
     }
     
     // Calculate mid price
@@ -101,6 +88,9 @@ struct MarketData {
     }
 };
 
+// SoA block filled by the batch API (market_data_block.hpp)
+struct MarketDataBlock;
+
 // Abstract base class for data normalizers (demonstrates virtual functions)
 class DataNormalizer {
 public:
@@ -109,6 +99,13 @@ public:
     // Pure virtual function - makes this an abstract class
     virtual std::optional<MarketData> normalize(const uint8_t* rawData, size_t length) = 0;
     
+    // Decode up to MarketDataBlock::CAPACITY packets into SoA columns with a
+    // validity bitmask; returns the number of valid rows. The default calls
+    // normalize() per packet; built-in exchanges override it with vectorized
+    // validation.
+    virtual size_t normalizeBatch(const uint8_t* const* packets, const size_t* lengths,
+                                  size_t count, MarketDataBlock& out);
+    
     // Virtual function with default implementation
     virtual bool validate(const MarketData& data) const {
         return data.bidPrice > 0 && data.askPrice > 0 && data.askPrice >= data.bidPrice;
@@ -130,6 +127,8 @@ public:
     NYSENormalizer() : DataNormalizer("NYSE") {}
     
     std::optional<MarketData> normalize(const uint8_t* rawData, size_t length) override;
+    size_t normalizeBatch(const uint8_t* const* packets, const size_t* lengths,
+                          size_t count, MarketDataBlock& out) override;
     bool validate(const MarketData& data) const override;
 };
 
@@ -139,6 +138,8 @@ public:
     NASDAQNormalizer() : DataNormalizer("NASDAQ") {}
     
     std::optional<MarketData> normalize(const uint8_t* rawData, size_t length) override;
+    size_t normalizeBatch(const uint8_t* const* packets, const size_t* lengths,
+                          size_t count, MarketDataBlock& out) override;
 };
 
 // Template function for type-safe data parsing
@@ -149,6 +150,22 @@ T parseField(const uint8_t* data, size_t offset) {
     return value;
 }
 
+// Common packet trailer shared by the NYSE and NASDAQ layouts
+namespace WireFormat {
+    constexpr size_t MIN_PACKET_SIZE = 64;
+    constexpr size_t SYMBOL_OFFSET = 56;
+    constexpr size_t SEQUENCE_OFFSET = 72;          // After the 16 byte symbol
+    constexpr size_t SEQUENCED_PACKET_SIZE = 80;
+}
+
+// Per-line sequence number, absent on unsequenced (legacy) packets
+inline std::optional<uint64_t> parseSequence(const uint8_t* data, size_t length) {
+    if (length < WireFormat::SEQUENCED_PACKET_SIZE) {
+        return std::nullopt;
+    }
+    return parseField<uint64_t>(data, WireFormat::SEQUENCE_OFFSET);
+}
+
 // Function template overloading
 template<typename T>
 void logValue(const T& value, std::string_view name);
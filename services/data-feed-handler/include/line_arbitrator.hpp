@@ -0,0 +1,59 @@
+#pragma once
+
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+
+namespace wq::datafeed {
+
+// Outcome of offering one sequenced packet to the arbitrator
+enum class ArbitrationResult : uint8_t {
+    ACCEPTED,   // First copy of this sequence number - publish it
+    RECOVERED,  // First copy, but it fills a gap opened earlier by the other line
+    DUPLICATE,  // Already published from the other line - drop
+    STALE       // Older than the tracking window - drop
+};
+
+// Lock-free A/B line arbitration for one redundant feed.
+//
+// Every line's listener thread calls accept() concurrently. Each sequence
+// number owns a slot in a power-of-two window; a single CAS on that slot
+// decides which line delivers it first. A jump past the highest sequence
+// seen so far counts as a gap until the missing numbers arrive on either line.
+class LineArbitrator {
+public:
+    explicit LineArbitrator(size_t windowSize);
+
+    // Deleted copy/move - listener threads hold raw pointers
+    LineArbitrator(const LineArbitrator&) = delete;
+    LineArbitrator& operator=(const LineArbitrator&) = delete;
+
+    ArbitrationResult accept(uint64_t sequence);
+
+    // Statistics
+    int64_t getDuplicates() const { return duplicates_.load(std::memory_order_relaxed); }
+    int64_t getGaps() const { return gaps_.load(std::memory_order_relaxed); }
+    int64_t getRecovered() const { return recovered_.load(std::memory_order_relaxed); }
+    int64_t getStale() const { return stale_.load(std::memory_order_relaxed); }
+
+    // Sequences opened as gaps and never delivered by any line
+    int64_t getOutstandingGaps() const { return getGaps() - getRecovered(); }
+
+private:
+    const size_t windowMask_;
+
+    // Slot holds sequence + 1 of the last packet published through it (0 = empty)
+    std::unique_ptr<std::atomic<uint64_t>[]> slots_;
+
+    // Highest sequence seen + 1 (0 until the first packet)
+    alignas(64) std::atomic<uint64_t> nextExpected_{0};
+    std::atomic<uint64_t> firstSequence_{UINT64_MAX};
+
+    alignas(64) std::atomic<int64_t> duplicates_{0};
+    std::atomic<int64_t> gaps_{0};
+    std::atomic<int64_t> recovered_{0};
+    std::atomic<int64_t> stale_{0};
+};
+
+} // namespace wq::datafeed
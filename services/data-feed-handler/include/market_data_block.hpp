@@ -0,0 +1,114 @@
+#pragma once
+
+#include "data_types.hpp"
+#include <array>
+#include <cstddef>
+#include <cstdint>
+
+namespace wq::datafeed {
+
+// Structure-of-arrays block of normalized updates decoded from one receive
+// batch. Row i is valid iff bit i of validMask is set; invalid rows hold
+// whatever was decoded and must be skipped.
+struct MarketDataBlock {
+    static constexpr size_t CAPACITY = 1024;
+    static constexpr size_t MASK_WORDS = CAPACITY / 64;
+
+    size_t count{0};
+    alignas(64) double bidPrice[CAPACITY];
+    alignas(64) double askPrice[CAPACITY];
+    alignas(64) double lastPrice[CAPACITY];
+    alignas(64) int64_t bidSize[CAPACITY];
+    alignas(64) int64_t askSize[CAPACITY];
+    alignas(64) int64_t volume[CAPACITY];
+    alignas(64) int64_t timestampNs[CAPACITY];
+    alignas(64) SymbolId symbolId[CAPACITY];
+    SymbolString symbol[CAPACITY];
+    AssetType assetType[CAPACITY];
+    Exchange exchange[CAPACITY];
+    std::array<uint64_t, MASK_WORDS> validMask{};
+
+    void clear() {
+        count = 0;
+        validMask.fill(0);
+    }
+
+    bool isValid(size_t row) const {
+        return (validMask[row / 64] >> (row % 64)) & 1;
+    }
+
+    void setValid(size_t row, bool valid) {
+        uint64_t bit = uint64_t{1} << (row % 64);
+        validMask[row / 64] = valid ? (validMask[row / 64] | bit) : (validMask[row / 64] & ~bit);
+    }
+
+    size_t validCount() const {
+        size_t total = 0;
+        for (size_t w = 0; w < (count + 63) / 64; ++w) {
+            total += static_cast<size_t>(__builtin_popcountll(validMask[w]));
+        }
+        return total;
+    }
+
+    // Scatter one AoS update into row i
+    void store(size_t row, const MarketData& data) {
+        bidPrice[row] = data.bidPrice;
+        askPrice[row] = data.askPrice;
+        lastPrice[row] = data.lastPrice;
+        bidSize[row] = data.bidSize;
+        askSize[row] = data.askSize;
+        volume[row] = data.volume;
+        timestampNs[row] = data.timestampNs;
+        symbolId[row] = data.symbolId;
+        symbol[row] = data.symbol;
+        assetType[row] = data.assetType;
+        exchange[row] = data.exchange;
+    }
+
+    // Gather row i back into an AoS update for per-tick consumers
+    MarketData row(size_t i) const {
+        MarketData data;
+        data.bidPrice = bidPrice[i];
+        data.askPrice = askPrice[i];
+        data.lastPrice = lastPrice[i];
+        data.bidSize = bidSize[i];
+        data.askSize = askSize[i];
+        data.volume = volume[i];
+        data.timestampNs = timestampNs[i];
+        data.symbolId = symbolId[i];
+        data.symbol = symbol[i];
+        data.assetType = assetType[i];
+        data.exchange = exchange[i];
+        return data;
+    }
+
+    // Visit every valid row index
+    template<typename Func>
+    void forEachValid(Func&& func) const {
+        for (size_t w = 0; w < (count + 63) / 64; ++w) {
+            uint64_t bits = validMask[w];
+            while (bits) {
+                size_t row = w * 64 + static_cast<size_t>(__builtin_ctzll(bits));
+                func(row);
+                bits &= bits - 1;
+            }
+        }
+    }
+};
+
+// Validity kernels: AND the price checks from DataNormalizer::validate
+// (bid > 0, ask > 0, ask >= bid) and, if requested, the NYSE spread check
+// (spread <= 10% of mid) into validMask for rows [0, count). Rows whose bit
+// is already clear stay invalid. Dispatches to AVX-512 / AVX2 at runtime
+// with a scalar fallback.
+void validateBlock(MarketDataBlock& block, bool checkSpread);
+
+// Individual kernels, exposed for benchmarking and testing
+void validateBlockScalar(MarketDataBlock& block, bool checkSpread);
+void validateBlockAvx2(MarketDataBlock& block, bool checkSpread);
+void validateBlockAvx512(MarketDataBlock& block, bool checkSpread);
+
+// Name of the kernel selected by validateBlock() on this CPU
+const char* validateBlockKernelName();
+
+} // namespace wq::datafeed
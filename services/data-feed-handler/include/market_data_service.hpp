@@ -0,0 +1,40 @@
+#pragma once
+
+#include "async_server.hpp"
+#include "data_types.hpp"
+#include "last_value_cache.hpp"
+#include "market_data.grpc.pb.h"
+
+namespace wq::datafeed {
+
+void toProto(const MarketData& data, proto::MarketTick* tick);
+
+// MarketDataService on the async server. Each subscriber of StreamMarketData
+// gets the ticks for the symbols it asked for (all if none), batched into
+// MarketDataStream messages: every tick by default, conflated to the newest
+// tick per symbol and exchange if it falls behind or asked to be conflated.
+// A last-value cache of every symbol's newest tick is the first message of
+// each stream, so a late subscriber starts from the current book.
+class MarketDataServiceImpl {
+public:
+    using AsyncService = proto::MarketDataService::AsyncService;
+
+    // Registers with server, which must not have started yet
+    explicit MarketDataServiceImpl(common::AsyncServer& server);
+
+    // From the single output consumer thread
+    void publish(const MarketData* updates, size_t count);
+
+    size_t getSubscriberCount() const { return stream_.getSubscriberCount(); }
+    uint64_t getConflatedCount() const { return stream_.getConflatedCount(); }
+    
+    const common::LastValueCache<MarketData>& getLastValues() const { return lastValues_; }
+
+private:
+    AsyncService service_;
+    common::StreamPublisher<AsyncService, proto::MarketDataRequest, proto::MarketDataStream, proto::MarketTick> stream_;
+    common::LastValueCache<MarketData> lastValues_;  // Newest tick per symbol id
+    common::CallArena stagingArena_;  // Converted ticks of one publish(), shared by all subscribers
+};
+
+} // namespace wq::datafeed
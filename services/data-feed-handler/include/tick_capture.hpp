@@ -0,0 +1,112 @@
+#pragma once
+
+#include "data_types.hpp"
+#include "ring_buffer.hpp"
+#include "ring_consumer.hpp"
+#include "tick_store.hpp"
+#include <atomic>
+#include <cstdint>
+#include <limits>
+#include <memory>
+#include <string>
+
+namespace wq::datafeed {
+
+namespace CaptureConfig {
+    constexpr size_t RING_CAPACITY = 65536;    // Ticks buffered ahead of the writer
+    constexpr size_t WRITE_BATCH = 1024;       // Ticks written per drain
+}
+
+// Appends ticks to one tick store file (see tick_store.hpp). The current
+// block is the only part of the file mapped for writing; appended rows
+// become visible to readers on publish(). Single writer.
+class TickStoreWriter {
+public:
+    // Create the file, or reopen it and continue after its last row; nullptr
+    // if it cannot be opened or belongs to another layout or day
+    static std::unique_ptr<TickStoreWriter> open(const std::string& path, int64_t dayStartNs);
+    ~TickStoreWriter();
+
+    TickStoreWriter(const TickStoreWriter&) = delete;
+    TickStoreWriter& operator=(const TickStoreWriter&) = delete;
+
+    // False if the file could not grow; the tick is not stored
+    bool append(const MarketData& data);
+
+    // Release rows appended since the last call to readers
+    void publish();
+
+    uint64_t getRowCount() const { return rowsBefore_ + rows_; }
+
+private:
+    TickStoreWriter(int fd, common::TickStoreHeader* header);
+
+    int fd_;
+    common::TickStoreHeader* header_;
+    common::TickStoreBlock* block_{nullptr};
+    size_t blockIndex_{0};
+    uint32_t rows_{0};                  // Rows written into the current block
+    uint64_t rowsBefore_{0};            // Rows in earlier blocks
+    int64_t minTimestampNs_{0};
+    int64_t maxTimestampNs_{0};
+
+    // Grow the file by one block and map it for writing
+    bool mapBlock(size_t index);
+    void unmapBlock();
+};
+
+// Records every published tick under a directory as one tick store file per
+// UTC day (ticks-YYYYMMDD.wqc), off the receive path: listener threads only
+// push into a ring, and a writer thread drains it into the mapped columns.
+// A full ring drops the tick and counts it rather than stall the socket.
+class TickCaptureSink {
+public:
+    using CaptureRing = common::MpmcRing<MarketData, CaptureConfig::RING_CAPACITY>;
+
+    // nullptr if the directory cannot be created
+    static std::unique_ptr<TickCaptureSink> create(const std::string& directory);
+    ~TickCaptureSink();
+
+    TickCaptureSink(const TickCaptureSink&) = delete;
+    TickCaptureSink& operator=(const TickCaptureSink&) = delete;
+
+    void start();
+
+    // Writes out everything captured before returning
+    void stop();
+
+    // Called from listener threads
+    bool capture(const MarketData& data) {
+        if (!ring_->tryPush(data)) {
+            drops_.fetch_add(1, std::memory_order_relaxed);
+            return false;
+        }
+        return true;
+    }
+
+    uint64_t getWrittenCount() const { return written_.load(std::memory_order_relaxed); }
+    uint64_t getDrops() const { return drops_.load(std::memory_order_relaxed); }
+    uint64_t getWriteErrors() const { return writeErrors_.load(std::memory_order_relaxed); }
+
+    // File holding the ticks of a day, as numbered by common::tickStoreDay()
+    static std::string pathForDay(const std::string& directory, int64_t day);
+
+private:
+    explicit TickCaptureSink(std::string directory);
+
+    std::string directory_;
+    std::unique_ptr<CaptureRing> ring_;
+    common::RingConsumer<CaptureRing> consumer_;
+
+    // Writer thread only
+    std::unique_ptr<TickStoreWriter> writer_;
+    int64_t day_{std::numeric_limits<int64_t>::min()};
+
+    std::atomic<uint64_t> written_{0};
+    std::atomic<uint64_t> drops_{0};
+    std::atomic<uint64_t> writeErrors_{0};
+
+    void write(const MarketData* ticks, size_t count);
+};
+
+} // namespace wq::datafeed
@@ -0,0 +1,149 @@
+#pragma once
+
+#include "data_types.hpp"
+#include "market_data_block.hpp"
+#include <array>
+
+namespace wq::datafeed {
+
+// Compile-time description of an exchange's binary layout. Each exchange
+// differs only in field offsets and extra validation, so one decoder
+// template covers all of them with every offset folded into the code.
+struct NYSEWireLayout {
+    static constexpr Exchange EXCHANGE = Exchange::NYSE;
+    static constexpr AssetType ASSET_TYPE = AssetType::EQUITY;
+    static constexpr size_t BID_PRICE = 0;
+    static constexpr size_t ASK_PRICE = 8;
+    static constexpr size_t LAST_PRICE = 16;
+    static constexpr size_t BID_SIZE = 24;
+    static constexpr size_t ASK_SIZE = 32;
+    static constexpr size_t VOLUME = 40;
+    static constexpr size_t TIMESTAMP = 48;
+    static constexpr size_t SYMBOL = WireFormat::SYMBOL_OFFSET;
+    static constexpr bool CHECK_SPREAD = true;  // Mirrors NYSENormalizer::validate
+};
+
+struct NASDAQWireLayout {
+    static constexpr Exchange EXCHANGE = Exchange::NASDAQ;
+    static constexpr AssetType ASSET_TYPE = AssetType::EQUITY;
+    static constexpr size_t BID_PRICE = 8;
+    static constexpr size_t ASK_PRICE = 16;
+    static constexpr size_t LAST_PRICE = 0;
+    static constexpr size_t BID_SIZE = 32;
+    static constexpr size_t ASK_SIZE = 40;
+    static constexpr size_t VOLUME = 24;
+    static constexpr size_t TIMESTAMP = 48;
+    static constexpr size_t SYMBOL = WireFormat::SYMBOL_OFFSET;
+    static constexpr bool CHECK_SPREAD = false;
+};
+
+namespace WireValidation {
+    constexpr double MAX_SPREAD_FRACTION = 0.1;  // Spread > 10% of mid is suspicious
+}
+
+// Parse every field of a packet already known to be long enough
+template<typename Layout>
+inline void decodeFields(const uint8_t* rawData, size_t length, MarketData& out) {
+    out.bidPrice = parseField<double>(rawData, Layout::BID_PRICE);
+    out.askPrice = parseField<double>(rawData, Layout::ASK_PRICE);
+    out.lastPrice = parseField<double>(rawData, Layout::LAST_PRICE);
+    out.bidSize = parseField<int64_t>(rawData, Layout::BID_SIZE);
+    out.askSize = parseField<int64_t>(rawData, Layout::ASK_SIZE);
+    out.volume = parseField<int64_t>(rawData, Layout::VOLUME);
+    out.timestampNs = parseField<int64_t>(rawData, Layout::TIMESTAMP);
+    out.symbol = SymbolString::fromBuffer(rawData + Layout::SYMBOL, length - Layout::SYMBOL);
+    out.symbolId = common::symbolTable().internName(out.symbol);
+    out.assetType = Layout::ASSET_TYPE;
+    out.exchange = Layout::EXCHANGE;
+}
+
+// Same rules as DataNormalizer::validate plus the layout's extra checks
+template<typename Layout>
+inline bool validateFields(const MarketData& data) {
+    if (!(data.bidPrice > 0 && data.askPrice > 0 && data.askPrice >= data.bidPrice)) {
+        return false;
+    }
+    if constexpr (Layout::CHECK_SPREAD) {
+        if (data.spread() > data.midPrice() * WireValidation::MAX_SPREAD_FRACTION) {
+            return false;
+        }
+    }
+    return true;
+}
+
+// Fully inlined decode + validate; false if the packet is short or invalid
+template<typename Layout>
+inline bool decodePacket(const uint8_t* rawData, size_t length, MarketData& out) {
+    if (length < WireFormat::MIN_PACKET_SIZE) {
+        return false;
+    }
+    decodeFields<Layout>(rawData, length, out);
+    return validateFields<Layout>(out);
+}
+
+// Decode a burst of packets into SoA columns, then validate the whole block
+// with the vectorized kernels. Returns the number of valid rows.
+template<typename Layout>
+inline size_t decodeBlock(const uint8_t* const* packets, const size_t* lengths, size_t count,
+                          MarketDataBlock& out) {
+    out.clear();
+    out.count = count < MarketDataBlock::CAPACITY ? count : MarketDataBlock::CAPACITY;
+    
+    for (size_t i = 0; i < out.count; ++i) {
+        const uint8_t* raw = packets[i];
+        if (lengths[i] < WireFormat::MIN_PACKET_SIZE) {
+            out.bidPrice[i] = 0;  // Keeps the kernels' loads defined; row stays invalid
+            out.askPrice[i] = 0;
+            continue;
+        }
+        out.bidPrice[i] = parseField<double>(raw, Layout::BID_PRICE);
+        out.askPrice[i] = parseField<double>(raw, Layout::ASK_PRICE);
+        out.lastPrice[i] = parseField<double>(raw, Layout::LAST_PRICE);
+        out.bidSize[i] = parseField<int64_t>(raw, Layout::BID_SIZE);
+        out.askSize[i] = parseField<int64_t>(raw, Layout::ASK_SIZE);
+        out.volume[i] = parseField<int64_t>(raw, Layout::VOLUME);
+        out.timestampNs[i] = parseField<int64_t>(raw, Layout::TIMESTAMP);
+        out.symbol[i] = SymbolString::fromBuffer(raw + Layout::SYMBOL, lengths[i] - Layout::SYMBOL);
+        out.symbolId[i] = common::symbolTable().internName(out.symbol[i]);
+        out.assetType[i] = Layout::ASSET_TYPE;
+        out.exchange[i] = Layout::EXCHANGE;
+        out.setValid(i, true);
+    }
+    
+    validateBlock(out, Layout::CHECK_SPREAD);
+    return out.validCount();
+}
+
+// Static decoder signature - no virtual call, no optional, no weak_ptr lock
+using DecodeFunc = bool (*)(const uint8_t* rawData, size_t length, MarketData& out);
+
+// Compile-time dispatch table indexed by exchangeIndex(); nullptr where no
+// built-in layout exists (those exchanges need a runtime DataNormalizer)
+constexpr std::array<DecodeFunc, NUM_EXCHANGES> STATIC_DECODERS = {
+    &decodePacket<NYSEWireLayout>,      // Exchange::NYSE
+    &decodePacket<NASDAQWireLayout>,    // Exchange::NASDAQ
+    nullptr                             // Exchange::CME
+};
+
+// Batch counterpart of STATIC_DECODERS
+using BlockDecodeFunc = size_t (*)(const uint8_t* const* packets, const size_t* lengths,
+                                   size_t count, MarketDataBlock& out);
+
+constexpr std::array<BlockDecodeFunc, NUM_EXCHANGES> STATIC_BLOCK_DECODERS = {
+    &decodeBlock<NYSEWireLayout>,       // Exchange::NYSE
+    &decodeBlock<NASDAQWireLayout>,     // Exchange::NASDAQ
+    nullptr                             // Exchange::CME
+};
+
+static_assert(exchangeIndex(Exchange::NYSE) == 0 && exchangeIndex(Exchange::NASDAQ) == 1,
+              "STATIC_DECODERS order must follow the Exchange enum");
+
+constexpr DecodeFunc staticDecoder(Exchange exchange) {
+    return exchange == Exchange::UNKNOWN ? nullptr : STATIC_DECODERS[exchangeIndex(exchange)];
+}
+
+constexpr BlockDecodeFunc staticBlockDecoder(Exchange exchange) {
+    return exchange == Exchange::UNKNOWN ? nullptr : STATIC_BLOCK_DECODERS[exchangeIndex(exchange)];
+}
+
+} // namespace wq::datafeed
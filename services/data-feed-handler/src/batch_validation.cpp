@@ -0,0 +1,151 @@
+#include "market_data_block.hpp"
+#include "wire_format.hpp"
+
+#if defined(__x86_64__) || defined(__i386__)
+#include <immintrin.h>
+#define WQ_HAVE_X86_KERNELS 1
+#endif
+
+namespace wq::datafeed {
+
+namespace {
+
+// Single-row check, shared by the scalar kernel and the SIMD tails
+inline bool rowValid(const MarketDataBlock& block, size_t i, bool checkSpread) {
+    double bid = block.bidPrice[i];
+    double ask = block.askPrice[i];
+    if (!(bid > 0 && ask > 0 && ask >= bid)) {
+        return false;
+    }
+    // Same operation order as spread() > midPrice() * MAX_SPREAD_FRACTION
+    if (checkSpread && (ask - bid) > (bid + ask) * 0.5 * WireValidation::MAX_SPREAD_FRACTION) {
+        return false;
+    }
+    return true;
+}
+
+inline void scalarRange(MarketDataBlock& block, size_t begin, size_t end, bool checkSpread) {
+    for (size_t i = begin; i < end; ++i) {
+        if (!rowValid(block, i, checkSpread)) {
+            block.setValid(i, false);
+        }
+    }
+}
+
+using ValidateFunc = void (*)(MarketDataBlock&, bool);
+
+} // namespace
+
+void validateBlockScalar(MarketDataBlock& block, bool checkSpread) {
+    scalarRange(block, 0, block.count, checkSpread);
+}
+
+#ifdef WQ_HAVE_X86_KERNELS
+
+__attribute__((target("avx2")))
+void validateBlockAvx2(MarketDataBlock& block, bool checkSpread) {
+    const __m256d zero = _mm256_setzero_pd();
+    const __m256d half = _mm256_set1_pd(0.5);
+    const __m256d fraction = _mm256_set1_pd(WireValidation::MAX_SPREAD_FRACTION);
+    const size_t vectorEnd = block.count & ~size_t{3};
+
+    for (size_t i = 0; i < vectorEnd; i += 4) {
+        __m256d bid = _mm256_load_pd(block.bidPrice + i);
+        __m256d ask = _mm256_load_pd(block.askPrice + i);
+
+        __m256d ok = _mm256_and_pd(_mm256_cmp_pd(bid, zero, _CMP_GT_OQ),
+                                   _mm256_cmp_pd(ask, zero, _CMP_GT_OQ));
+        ok = _mm256_and_pd(ok, _mm256_cmp_pd(ask, bid, _CMP_GE_OQ));
+
+        if (checkSpread) {
+            __m256d spread = _mm256_sub_pd(ask, bid);
+            __m256d limit = _mm256_mul_pd(_mm256_mul_pd(_mm256_add_pd(bid, ask), half), fraction);
+            ok = _mm256_andnot_pd(_mm256_cmp_pd(spread, limit, _CMP_GT_OQ), ok);
+        }
+
+        // Four lanes never straddle a 64-bit mask word (i is a multiple of 4)
+        uint64_t bits = static_cast<uint64_t>(_mm256_movemask_pd(ok));
+        uint64_t lanes = uint64_t{0xF} << (i % 64);
+        block.validMask[i / 64] &= ~lanes | (bits << (i % 64));
+    }
+
+    scalarRange(block, vectorEnd, block.count, checkSpread);
+}
+
+__attribute__((target("avx512f")))
+void validateBlockAvx512(MarketDataBlock& block, bool checkSpread) {
+    const __m512d zero = _mm512_setzero_pd();
+    const __m512d half = _mm512_set1_pd(0.5);
+    const __m512d fraction = _mm512_set1_pd(WireValidation::MAX_SPREAD_FRACTION);
+    const size_t vectorEnd = block.count & ~size_t{7};
+
+    for (size_t i = 0; i < vectorEnd; i += 8) {
+        __m512d bid = _mm512_load_pd(block.bidPrice + i);
+        __m512d ask = _mm512_load_pd(block.askPrice + i);
+
+        __mmask8 ok = _mm512_cmp_pd_mask(bid, zero, _CMP_GT_OQ);
+        ok = _mm512_mask_cmp_pd_mask(ok, ask, zero, _CMP_GT_OQ);
+        ok = _mm512_mask_cmp_pd_mask(ok, ask, bid, _CMP_GE_OQ);
+
+        if (checkSpread) {
+            __m512d spread = _mm512_sub_pd(ask, bid);
+            __m512d limit = _mm512_mul_pd(_mm512_mul_pd(_mm512_add_pd(bid, ask), half), fraction);
+            ok = _mm512_mask_cmp_pd_mask(ok, spread, limit, _CMP_NGT_UQ);  // !(spread > limit), as scalar
+        }
+
+        uint64_t bits = static_cast<uint64_t>(ok);
+        uint64_t lanes = uint64_t{0xFF} << (i % 64);
+        block.validMask[i / 64] &= ~lanes | (bits << (i % 64));
+    }
+
+    scalarRange(block, vectorEnd, block.count, checkSpread);
+}
+
+#else
+
+void validateBlockAvx2(MarketDataBlock& block, bool checkSpread) {
+    validateBlockScalar(block, checkSpread);
+}
+
+void validateBlockAvx512(MarketDataBlock& block, bool checkSpread) {
+    validateBlockScalar(block, checkSpread);
+}
+
+#endif
+
+namespace {
+
+struct KernelSelection {
+    ValidateFunc func;
+    const char* name;
+};
+
+KernelSelection selectKernel() {
+#ifdef WQ_HAVE_X86_KERNELS
+    __builtin_cpu_init();
+    if (__builtin_cpu_supports("avx512f")) {
+        return {&validateBlockAvx512, "avx512"};
+    }
+    if (__builtin_cpu_supports("avx2")) {
+        return {&validateBlockAvx2, "avx2"};
+    }
+#endif
+    return {&validateBlockScalar, "scalar"};
+}
+
+const KernelSelection& kernel() {
+    static const KernelSelection selected = selectKernel();
+    return selected;
+}
+
+} // namespace
+
+void validateBlock(MarketDataBlock& block, bool checkSpread) {
+    kernel().func(block, checkSpread);
+}
+
+const char* validateBlockKernelName() {
+    return kernel().name;
+}
+
+} // namespace wq::datafeed
@@ -1,13 +1,26 @@
 #include "data_feed_handler.hpp"
+#include "latency.hpp"
+#include "market_data_block.hpp"
+#include "tick_capture.hpp"
+#include "topology.hpp"
+#include "wire_format.hpp"
 #include <sys/socket.h>
 #include <netinet/in.h>
 #include <arpa/inet.h>
+#include <sys/eventfd.h>
+#include <poll.h>
 #include <unistd.h>
 #include <algorithm>
+#include <cerrno>
+#include <cstring>
 #include <iostream>
+#include <map>
 
 namespace wq::datafeed {
 
+static_assert(Config::MAX_RECV_BATCH <= MarketDataBlock::CAPACITY,
+              "a full recvmmsg batch must fit in one MarketDataBlock");
+
 // DataFeedHandlerFactory implementation
 std::unique_ptr<DataFeedHandler> DataFeedHandlerFactory::createHandler(
     std::string_view multicastGroup,
@@ -18,23 +31,46 @@ std::unique_ptr<DataFeedHandler> DataFeedHandlerFactory::createHandler(
     );
 }
 
-// DataFeedHandler private constructor
-DataFeedHandler::DataFeedHandler(std::string multicastGroup, uint16_t port)
-    : multicastGroup_(std::move(multicastGroup))
-    , port_(port) {
+std::unique_ptr<DataFeedHandler> DataFeedHandlerFactory::createHandler(
+    std::vector<FeedChannel> channels) {
+    return std::unique_ptr<DataFeedHandler>(
+        new DataFeedHandler(std::move(channels))
+    );
+}
+
+// DataFeedHandler private constructors
+DataFeedHandler::DataFeedHandler(std::string multicastGroup, uint16_t port) {
+    FeedChannel channel;
+    channel.name = "default";
+    channel.multicastGroup = std::move(multicastGroup);
+    channel.port = port;
+    channels_.push_back(std::move(channel));
+}
+
+DataFeedHandler::DataFeedHandler(std::vector<FeedChannel> channels)
+    : channels_(std::move(channels)) {
 }
 
 // Move constructor implementation (demonstrates move semantics)
 DataFeedHandler::DataFeedHandler(DataFeedHandler&& other) noexcept
-    : multicastGroup_(std::move(other.multicastGroup_))
-    , port_(other.port_)
+    : channels_(std::move(other.channels_))
     , running_(other.running_.load())
-    , listenerThread_(std::move(other.listenerThread_))
+    , listenerThreads_(std::move(other.listenerThreads_))
     , callbacks_(std::move(other.callbacks_))
+    , normalizersByExchange_(std::move(other.normalizersByExchange_))
+    , runtimeNormalizer_(other.runtimeNormalizer_)
     , normalizers_(std::move(other.normalizers_))
+    , receiveOptions_(other.receiveOptions_)
+    , arbitrators_(std::move(other.arbitrators_))
+    , channelArbitrators_(std::move(other.channelArbitrators_))
+    , wakeFd_(other.wakeFd_)
+    , outputRing_(other.outputRing_)
+    , captureSink_(other.captureSink_)
     , packetsReceived_(other.packetsReceived_.load())
-    , packetsProcessed_(other.packetsProcessed_.load()) {
+    , packetsProcessed_(other.packetsProcessed_.load())
+    , outputDrops_(other.outputDrops_.load()) {
     other.running_ = false;
+    other.wakeFd_ = -1;
 }
 
 // Move assignment implementation
@@ -42,16 +78,25 @@ DataFeedHandler& DataFeedHandler::operator=(DataFeedHandler&& other) noexcept {
     if (this != &other) {
         stop();  // Stop current operation
         
-        multicastGroup_ = std::move(other.multicastGroup_);
-        port_ = other.port_;
+        channels_ = std::move(other.channels_);
         running_ = other.running_.load();
-        listenerThread_ = std::move(other.listenerThread_);
+        listenerThreads_ = std::move(other.listenerThreads_);
         callbacks_ = std::move(other.callbacks_);
+        normalizersByExchange_ = std::move(other.normalizersByExchange_);
+        runtimeNormalizer_ = other.runtimeNormalizer_;
         normalizers_ = std::move(other.normalizers_);
+        receiveOptions_ = other.receiveOptions_;
+        arbitrators_ = std::move(other.arbitrators_);
+        channelArbitrators_ = std::move(other.channelArbitrators_);
+        wakeFd_ = other.wakeFd_;
+        outputRing_ = other.outputRing_;
+        captureSink_ = other.captureSink_;
         packetsReceived_ = other.packetsReceived_.load();
         packetsProcessed_ = other.packetsProcessed_.load();
+        outputDrops_ = other.outputDrops_.load();
         
         other.running_ = false;
+        other.wakeFd_ = -1;
     }
     return *this;
 }
@@ -65,10 +110,31 @@ bool DataFeedHandler::start() {
         return false;  // Already running
     }
     
-    // Create listener thread using lambda
-    listenerThread_ = std::make_unique<std::thread>([this]() {
-        this->listenerLoop();
-    });
+    // Non-blocking eventfd lets stop() interrupt poll() immediately
+    wakeFd_ = eventfd(0, EFD_NONBLOCK | EFD_CLOEXEC);
+    if (wakeFd_ < 0) {
+        std::cerr << "Failed to create wake eventfd\n";
+        running_ = false;
+        return false;
+    }
+    
+    setupArbitration();
+    
+    // One listener thread per channel using lambda, on the topology's
+    // listener core for the channel if it names one, else the channel's own
+    common::Topology& topology = common::topology();
+    listenerThreads_.reserve(channels_.size());
+    for (size_t i = 0; i < channels_.size(); ++i) {
+        FeedChannel& channel = channels_[i];
+        if (topology.core(common::TopologyStage::FEED_LISTENER, i) >= 0) {
+            channel.cpuCore = topology.core(common::TopologyStage::FEED_LISTENER, i);
+        }
+        LineArbitrator* arbitrator = channelArbitrators_[i];
+        listenerThreads_.push_back(topology.startThread(common::TopologyStage::FEED_LISTENER, i,
+            [this, &channel, arbitrator]() {
+                this->listenerLoop(channel, arbitrator);
+            }, channel.cpuCore));
+    }
     
     return true;
 }
@@ -78,10 +144,29 @@ void DataFeedHandler::stop() {
         return;  // Not running
     }
     
-    if (listenerThread_ && listenerThread_->joinable()) {
-        listenerThread_->join();
+    // Wake the listener if it is blocked in poll()
+    if (wakeFd_ >= 0) {
+        uint64_t one = 1;
+        ssize_t written = write(wakeFd_, &one, sizeof(one));
+        (void)written;
+    }
+    
+    for (auto& thread : listenerThreads_) {
+        if (thread.joinable()) {
+            thread.join();
+        }
     }
-    listenerThread_.reset();
+    listenerThreads_.clear();
+    
+    if (wakeFd_ >= 0) {
+        close(wakeFd_);
+        wakeFd_ = -1;
+    }
+}
+
+void DataFeedHandler::setReceiveOptions(const ReceiveOptions& options) {
+    receiveOptions_ = options;
+    receiveOptions_.batchSize = std::clamp<size_t>(options.batchSize, 1, Config::MAX_RECV_BATCH);
 }
 
 // Function overloading - std::function version
@@ -98,7 +183,16 @@ void DataFeedHandler::registerCallback(RawDataCallback callback) {
     });
 }
 
+void DataFeedHandler::addChannel(FeedChannel channel) {
+    channels_.push_back(std::move(channel));
+}
+
 void DataFeedHandler::registerNormalizer(Exchange exchange, std::shared_ptr<DataNormalizer> normalizer) {
+    // Direct route for channels of this exchange, overriding any built-in layout
+    if (exchange != Exchange::UNKNOWN) {
+        normalizersByExchange_[exchangeIndex(exchange)] = normalizer;
+        runtimeNormalizer_[exchangeIndex(exchange)] = true;
+    }
     normalizers_.push_back(normalizer);  // Store weak_ptr
 }
 
@@ -118,74 +212,344 @@ void DataFeedHandler::getStats(int64_t* packetsReceived, int64_t* packetsProcess
     }
 }
 
-void DataFeedHandler::listenerLoop() {
+int DataFeedHandler::openSocket(const FeedChannel& channel) const {
     // Create UDP socket for multicast
-    int sockfd = socket(AF_INET, SOCK_DGRAM, 0);
+    int sockfd = socket(AF_INET, SOCK_DGRAM | SOCK_NONBLOCK, 0);
     if (sockfd < 0) {
         std::cerr << "Failed to create socket\n";
-        return;
+        return -1;
     }
     
     // Allow multiple sockets to bind to the same address
     int reuse = 1;
     setsockopt(sockfd, SOL_SOCKET, SO_REUSEADDR, &reuse, sizeof(reuse));
     
+    // Larger kernel buffer absorbs bursts at the open
+    if (receiveOptions_.socketRecvBufferBytes > 0) {
+        int size = receiveOptions_.socketRecvBufferBytes;
+        if (setsockopt(sockfd, SOL_SOCKET, SO_RCVBUF, &size, sizeof(size)) < 0) {
+            std::cerr << "Failed to set SO_RCVBUF: " << std::strerror(errno) << "\n";
+        }
+    }
+    
+    // Busy poll the NIC queue from the syscall instead of waiting for the interrupt
+#ifdef SO_BUSY_POLL
+    if (receiveOptions_.busyPollMicros > 0) {
+        int usecs = receiveOptions_.busyPollMicros;
+        if (setsockopt(sockfd, SOL_SOCKET, SO_BUSY_POLL, &usecs, sizeof(usecs)) < 0) {
+            std::cerr << "Failed to set SO_BUSY_POLL: " << std::strerror(errno) << "\n";
+        }
+    }
+#endif
+    
     // Bind to the multicast port
     struct sockaddr_in localAddr;
     std::memset(&localAddr, 0, sizeof(localAddr));
     localAddr.sin_family = AF_INET;
     localAddr.sin_addr.s_addr = htonl(INADDR_ANY);
-    localAddr.sin_port = htons(port_);
+    localAddr.sin_port = htons(channel.port);
     
     if (bind(sockfd, (struct sockaddr*)&localAddr, sizeof(localAddr)) < 0) {
-        std::cerr << "Failed to bind socket\n";
+        std::cerr << "Failed to bind socket for channel " << channel.name << "\n";
         close(sockfd);
-        return;
+        return -1;
     }
     
     // Join multicast group
     struct ip_mreq mreq;
-    mreq.imr_multiaddr.s_addr = inet_addr(multicastGroup_.c_str());
+    mreq.imr_multiaddr.s_addr = inet_addr(channel.multicastGroup.c_str());
     mreq.imr_interface.s_addr = htonl(INADDR_ANY);
     setsockopt(sockfd, IPPROTO_IP, IP_ADD_MEMBERSHIP, &mreq, sizeof(mreq));
     
-    std::vector<uint8_t> buffer(Config::MAX_PACKET_SIZE);
+    return sockfd;
+}
+
+void DataFeedHandler::setupArbitration() {
+    arbitrators_.clear();
+    channelArbitrators_.assign(channels_.size(), nullptr);
     
-    while (running_.load()) {
-        struct sockaddr_in senderAddr;
-        socklen_t senderLen = sizeof(senderAddr);
+    std::map<int, LineArbitrator*> byGroup;
+    for (size_t i = 0; i < channels_.size(); ++i) {
+        int group = channels_[i].arbitrationGroup;
+        if (group < 0) {
+            continue;
+        }
         
-        ssize_t recvLen = recvfrom(sockfd, buffer.data(), buffer.size(), 0,
-                                   (struct sockaddr*)&senderAddr, &senderLen);
+        auto it = byGroup.find(group);
+        if (it == byGroup.end()) {
+            arbitrators_.push_back(std::make_unique<LineArbitrator>(Config::ARBITRATION_WINDOW));
+            it = byGroup.emplace(group, arbitrators_.back().get()).first;
+        }
+        channelArbitrators_[i] = it->second;
+    }
+}
+
+// Pass by reference
+void DataFeedHandler::getArbitrationStats(int64_t& duplicatesDropped, int64_t& sequenceGaps,
+                                          int64_t& gapsRecovered) const {
+    duplicatesDropped = 0;
+    sequenceGaps = 0;
+    gapsRecovered = 0;
+    for (const auto& arbitrator : arbitrators_) {
+        duplicatesDropped += arbitrator->getDuplicates() + arbitrator->getStale();
+        sequenceGaps += arbitrator->getGaps();
+        gapsRecovered += arbitrator->getRecovered();
+    }
+}
+
+void DataFeedHandler::listenerLoop(const FeedChannel& channel, LineArbitrator* arbitrator) {
+    int sockfd = openSocket(channel);
+    if (sockfd < 0) {
+        return;
+    }
+    
+    if (receiveOptions_.mode == ReceiveMode::BATCHED) {
+        receiveBatched(sockfd, channel.exchange, arbitrator);
+    } else {
+        receiveBlocking(sockfd, channel.exchange, arbitrator);
+    }
+    
+    close(sockfd);
+}
+
+bool DataFeedHandler::waitReadable(int sockfd) const {
+    struct pollfd fds[2];
+    fds[0].fd = sockfd;
+    fds[0].events = POLLIN;
+    fds[1].fd = wakeFd_;
+    fds[1].events = POLLIN;
+    
+    while (running_.load(std::memory_order_relaxed)) {
+        int ready = poll(fds, 2, Config::POLL_TIMEOUT_MS);
+        if (ready < 0) {
+            if (errno == EINTR) {
+                continue;
+            }
+            std::cerr << "poll failed on feed socket: " << std::strerror(errno) << "\n";
+            return false;
+        }
+        if (ready == 0) {
+            continue;
+        }
+        // Wake event means stop() was called
+        if (fds[1].revents & POLLIN) {
+            return false;
+        }
+        if (fds[0].revents & POLLIN) {
+            return true;
+        }
+        if (fds[0].revents & POLLNVAL) {
+            return false;
+        }
+        if (fds[0].revents & (POLLERR | POLLHUP)) {
+            // A queued error (e.g. from ICMP) is not fatal to a datagram
+            // socket: consume it and keep listening
+            int error = 0;
+            socklen_t length = sizeof(error);
+            getsockopt(sockfd, SOL_SOCKET, SO_ERROR, &error, &length);
+        }
+    }
+    return false;
+}
+
+void DataFeedHandler::receiveBlocking(int sockfd, Exchange exchange, LineArbitrator* arbitrator) {
+    std::vector<uint8_t> buffer(Config::MAX_PACKET_SIZE);
+    common::LatencyProbe& receiveProbe = common::latencyProbe("feed.receive");
+    common::LatencyProbe& normalizeProbe = common::latencyProbe("feed.normalize");
+    
+    while (running_.load(std::memory_order_relaxed)) {
+        if (!receiveOptions_.spinWait && !waitReadable(sockfd)) {
+            break;
+        }
         
-        if (recvLen > 0) {
+        // Drain everything queued before going back to poll()
+        while (true) {
+            struct sockaddr_in senderAddr;
+            socklen_t senderLen = sizeof(senderAddr);
+            
+            uint64_t receiveStart = common::TscClock::now();
+            ssize_t recvLen = recvfrom(sockfd, buffer.data(), buffer.size(), MSG_DONTWAIT,
+                                       (struct sockaddr*)&senderAddr, &senderLen);
+            
+            if (recvLen <= 0) {
+                break;
+            }
+            uint64_t normalizeStart = common::TscClock::now();
+            receiveProbe.record(common::TscClock::toNs(normalizeStart - receiveStart));
             packetsReceived_++;
-            processPacket(buffer.data(), recvLen);
+            handleDatagram(buffer.data(), recvLen, exchange, arbitrator);
+            normalizeProbe.recordSince(normalizeStart);
         }
     }
+}
+
+void DataFeedHandler::receiveBatched(int sockfd, Exchange exchange, LineArbitrator* arbitrator) {
+    const size_t batchSize = receiveOptions_.batchSize;
     
-    close(sockfd);
+    // Preallocated ring: one MAX_PACKET_SIZE slot per datagram in the batch
+    std::vector<uint8_t> ring(batchSize * Config::MAX_PACKET_SIZE);
+    std::vector<struct iovec> iovecs(batchSize);
+    std::vector<struct mmsghdr> messages(batchSize);
+    
+    // Datagrams that survive arbitration, decoded together into one block
+    std::vector<const uint8_t*> accepted(batchSize);
+    std::vector<size_t> acceptedLengths(batchSize);
+    auto block = std::make_unique<MarketDataBlock>();
+    common::LatencyProbe& receiveProbe = common::latencyProbe("feed.receive_batch");
+    common::LatencyProbe& normalizeProbe = common::latencyProbe("feed.normalize_batch");
+    
+    for (size_t i = 0; i < batchSize; ++i) {
+        iovecs[i].iov_base = ring.data() + i * Config::MAX_PACKET_SIZE;
+        iovecs[i].iov_len = Config::MAX_PACKET_SIZE;
+        std::memset(&messages[i], 0, sizeof(messages[i]));
+        messages[i].msg_hdr.msg_iov = &iovecs[i];
+        messages[i].msg_hdr.msg_iovlen = 1;
+    }
+    
+    while (running_.load(std::memory_order_relaxed)) {
+        if (!receiveOptions_.spinWait && !waitReadable(sockfd)) {
+            break;
+        }
+        
+        // Keep pulling full batches until the socket queue is empty
+        while (running_.load(std::memory_order_relaxed)) {
+            uint64_t receiveStart = common::TscClock::now();
+            int received = recvmmsg(sockfd, messages.data(), static_cast<unsigned int>(batchSize),
+                                    MSG_DONTWAIT, nullptr);
+            if (received <= 0) {
+                break;
+            }
+            uint64_t normalizeStart = common::TscClock::now();
+            receiveProbe.record(common::TscClock::toNs(normalizeStart - receiveStart));
+            
+            packetsReceived_ += received;
+            size_t count = 0;
+            for (int i = 0; i < received; ++i) {
+                const uint8_t* data = static_cast<const uint8_t*>(iovecs[i].iov_base);
+                if (admitDatagram(data, messages[i].msg_len, arbitrator)) {
+                    accepted[count] = data;
+                    acceptedLengths[count] = messages[i].msg_len;
+                    ++count;
+                }
+            }
+            processBatch(accepted.data(), acceptedLengths.data(), count, exchange, *block);
+            normalizeProbe.recordSince(normalizeStart);
+            
+            if (static_cast<size_t>(received) < batchSize) {
+                break;
+            }
+        }
+    }
+}
+
+bool DataFeedHandler::admitDatagram(const uint8_t* data, size_t length, LineArbitrator* arbitrator) {
+    // Drop the second copy of A/B packets before paying for normalization
+    if (arbitrator) {
+        if (auto sequence = parseSequence(data, length)) {
+            auto result = arbitrator->accept(sequence.value());
+            if (result == ArbitrationResult::DUPLICATE || result == ArbitrationResult::STALE) {
+                return false;
+            }
+        }
+    }
+    return true;
+}
+
+void DataFeedHandler::handleDatagram(const uint8_t* data, size_t length, Exchange exchange,
+                                     LineArbitrator* arbitrator) {
+    if (admitDatagram(data, length, arbitrator)) {
+        processPacket(data, length, exchange);
+    }
 }
 
-void DataFeedHandler::processPacket(const uint8_t* data, size_t length) {
-    // Try each normalizer (weak_ptr usage)
+void DataFeedHandler::processPacket(const uint8_t* data, size_t length, Exchange exchange) {
+    // Known exchange without a runtime override: compile-time decoder
+    if (exchange != Exchange::UNKNOWN && !runtimeNormalizer_[exchangeIndex(exchange)]) {
+        if (DecodeFunc decode = staticDecoder(exchange)) {
+            MarketData update;
+            if (decode(data, length, update)) {
+                packetsProcessed_++;
+                publish(update);
+            }
+            return;
+        }
+    }
+    
+    // Known exchange: route straight to its normalizer
+    if (exchange != Exchange::UNKNOWN) {
+        if (auto normalizer = normalizersByExchange_[exchangeIndex(exchange)].lock()) {
+            auto result = normalizer->normalize(data, length);
+            if (result.has_value()) {
+                packetsProcessed_++;
+                publish(result.value());
+            }
+        }
+        return;
+    }
+    
+    // Unknown source: try each normalizer (weak_ptr usage)
     for (auto& weakNormalizer : normalizers_) {
         if (auto normalizer = weakNormalizer.lock()) {  // Convert weak_ptr to shared_ptr
             auto result = normalizer->normalize(data, length);
             
             if (result.has_value()) {
                 packetsProcessed_++;
-                
-                // Notify all callbacks using lambda
-                std::for_each(callbacks_.begin(), callbacks_.end(),
-                    [&result](const DataCallback& callback) {
-                        callback(result.value());
-                    });
-                
+                publish(result.value());
                 break;  // Successfully processed
             }
         }
     }
 }
 
+void DataFeedHandler::processBatch(const uint8_t* const* packets, const size_t* lengths, size_t count,
+                                   Exchange exchange, MarketDataBlock& block) {
+    if (count == 0) {
+        return;
+    }
+    
+    // Unknown source: every packet may need a different normalizer
+    if (exchange == Exchange::UNKNOWN) {
+        for (size_t i = 0; i < count; ++i) {
+            processPacket(packets[i], lengths[i], exchange);
+        }
+        return;
+    }
+    
+    // Same precedence as processPacket: static layout unless overridden
+    size_t valid = 0;
+    BlockDecodeFunc decode = staticBlockDecoder(exchange);
+    if (decode && !runtimeNormalizer_[exchangeIndex(exchange)]) {
+        valid = decode(packets, lengths, count, block);
+    } else if (auto normalizer = normalizersByExchange_[exchangeIndex(exchange)].lock()) {
+        valid = normalizer->normalizeBatch(packets, lengths, count, block);
+    } else {
+        return;
+    }
+    
+    packetsProcessed_ += static_cast<int64_t>(valid);
+    block.forEachValid([this, &block](size_t row) {
+        publish(block.row(row));
+    });
+}
+
+void DataFeedHandler::publish(const MarketData& data) {
+    if (captureSink_) {
+        captureSink_->capture(data);
+    }
+    
+    // Next stage consumes on its own thread - never block the listener
+    if (outputRing_) {
+        if (!outputRing_->tryPush(data)) {
+            outputDrops_++;
+        }
+        return;
+    }
+    
+    // Notify all callbacks using lambda
+    std::for_each(callbacks_.begin(), callbacks_.end(),
+        [&data](const DataCallback& callback) {
+            callback(data);
+        });
+}
+
 } // namespace wq::datafeed
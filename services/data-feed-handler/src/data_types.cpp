@@ -1,33 +1,38 @@
 #include "data_types.hpp"
+#include "wire_format.hpp"
+#include <algorithm>
 #include <cstring>
 #include <chrono>
 
 namespace wq::datafeed {
 
+// DataNormalizer default batch implementation - one normalize() per packet
+size_t DataNormalizer::normalizeBatch(const uint8_t* const* packets, const size_t* lengths,
+                                      size_t count, MarketDataBlock& out) {
+    out.clear();
+    out.count = std::min(count, MarketDataBlock::CAPACITY);
+    
+    size_t valid = 0;
+    for (size_t i = 0; i < out.count; ++i) {
+        if (auto data = normalize(packets[i], lengths[i])) {
+            out.store(i, data.value());
+            out.setValid(i, true);
+            ++valid;
+        }
+    }
+    return valid;
+}
+
 // NYSENormalizer implementation
 std::optional<MarketData> NYSENormalizer::normalize(const uint8_t* rawData, size_t length) {
-    if (length < 64) {
+    if (length < WireFormat::MIN_PACKET_SIZE) {
         return std::nullopt;
     }
     
     MarketData data;
     
-    // Parse binary data using template function
-    data.bidPrice = parseField<double>(rawData, 0);
-    data.askPrice = parseField<double>(rawData, 8);
-    data.lastPrice = parseField<double>(rawData, 16);
-    data.bidSize = parseField<int64_t>(rawData, 24);
-    data.askSize = parseField<int64_t>(rawData, 32);
-    data.volume = parseField<int64_t>(rawData, 40);
-    data.timestampNs = parseField<int64_t>(rawData, 48);
-    
-    // Parse symbol (null-terminated string at offset 56)
-    char symbolBuf[16] = {0};
-    std::memcpy(symbolBuf, rawData + 56, std::min(length - 56, sizeof(symbolBuf) - 1));
-    data.symbol = symbolBuf;
-    
-    data.assetType = AssetType::EQUITY;
-    data.exchange = Exchange::NYSE;
+    // Parse binary data using the compile-time NYSE layout
+    decodeFields<NYSEWireLayout>(rawData, length, data);
     
     if (!validate(data)) {
         return std::nullopt;
@@ -43,36 +48,29 @@ bool NYSENormalizer::validate(const MarketData& data) const {
     }
     
     // Additional NYSE-specific validations
-    if (data.spread() > data.midPrice() * 0.1) {  // Spread > 10% is suspicious
+    if (data.spread() > data.midPrice() * WireValidation::MAX_SPREAD_FRACTION) {
         return false;
     }
     
     return true;
 }
 
+// Batch decode with the vectorized NYSE checks
+size_t NYSENormalizer::normalizeBatch(const uint8_t* const* packets, const size_t* lengths,
+                                      size_t count, MarketDataBlock& out) {
+    return decodeBlock<NYSEWireLayout>(packets, lengths, count, out);
+}
+
 // NASDAQNormalizer implementation
 std::optional<MarketData> NASDAQNormalizer::normalize(const uint8_t* rawData, size_t length) {
-    if (length < 64) {
+    if (length < WireFormat::MIN_PACKET_SIZE) {
         return std::nullopt;
     }
     
     MarketData data;
     
     // NASDAQ has slightly different format
-    data.lastPrice = parseField<double>(rawData, 0);
-    data.bidPrice = parseField<double>(rawData, 8);
-    data.askPrice = parseField<double>(rawData, 16);
-    data.volume = parseField<int64_t>(rawData, 24);
-    data.bidSize = parseField<int64_t>(rawData, 32);
-    data.askSize = parseField<int64_t>(rawData, 40);
-    data.timestampNs = parseField<int64_t>(rawData, 48);
-    
-    char symbolBuf[16] = {0};
-    std::memcpy(symbolBuf, rawData + 56, std::min(length - 56, sizeof(symbolBuf) - 1));
-    data.symbol = symbolBuf;
-    
-    data.assetType = AssetType::EQUITY;
-    data.exchange = Exchange::NASDAQ;
+    decodeFields<NASDAQWireLayout>(rawData, length, data);
     
     if (!validate(data)) {
         return std::nullopt;
@@ -81,4 +79,9 @@ std::optional<MarketData> NASDAQNormalizer::normalize(const uint8_t* rawData, si
     return data;
 }
 
+size_t NASDAQNormalizer::normalizeBatch(const uint8_t* const* packets, const size_t* lengths,
+                                        size_t count, MarketDataBlock& out) {
+    return decodeBlock<NASDAQWireLayout>(packets, lengths, count, out);
+}
+
 } // namespace wq::datafeed
@@ -0,0 +1,65 @@
+#include "line_arbitrator.hpp"
+
+namespace wq::datafeed {
+
+// Round up so slot lookup is a mask instead of a modulo
+static size_t roundUpPowerOfTwo(size_t value) {
+    size_t result = 1;
+    while (result < value) {
+        result <<= 1;
+    }
+    return result;
+}
+
+LineArbitrator::LineArbitrator(size_t windowSize)
+    : windowMask_(roundUpPowerOfTwo(windowSize) - 1)
+    , slots_(new std::atomic<uint64_t>[windowMask_ + 1]) {
+    for (size_t i = 0; i <= windowMask_; ++i) {
+        slots_[i].store(0, std::memory_order_relaxed);
+    }
+}
+
+ArbitrationResult LineArbitrator::accept(uint64_t sequence) {
+    const uint64_t tag = sequence + 1;
+    auto& slot = slots_[sequence & windowMask_];
+    
+    // Claim the slot - only one line can publish a given sequence
+    uint64_t current = slot.load(std::memory_order_acquire);
+    while (true) {
+        if (current == tag) {
+            duplicates_.fetch_add(1, std::memory_order_relaxed);
+            return ArbitrationResult::DUPLICATE;
+        }
+        if (current > tag) {
+            // Slot already reused by a sequence a full window ahead
+            stale_.fetch_add(1, std::memory_order_relaxed);
+            return ArbitrationResult::STALE;
+        }
+        if (slot.compare_exchange_weak(current, tag, std::memory_order_acq_rel)) {
+            break;
+        }
+    }
+    
+    // Advance the high-water mark, counting any sequences skipped over
+    uint64_t expected = nextExpected_.load(std::memory_order_relaxed);
+    while (tag > expected) {
+        if (nextExpected_.compare_exchange_weak(expected, tag, std::memory_order_relaxed)) {
+            if (expected == 0) {
+                firstSequence_.store(sequence, std::memory_order_relaxed);
+            } else if (tag > expected + 1) {
+                gaps_.fetch_add(static_cast<int64_t>(tag - expected - 1), std::memory_order_relaxed);
+            }
+            return ArbitrationResult::ACCEPTED;
+        }
+    }
+    
+    // Below the high-water mark: packets from before the first one seen never opened a gap
+    if (sequence < firstSequence_.load(std::memory_order_relaxed)) {
+        return ArbitrationResult::ACCEPTED;
+    }
+    
+    recovered_.fetch_add(1, std::memory_order_relaxed);
+    return ArbitrationResult::RECOVERED;
+}
+
+} // namespace wq::datafeed
@@ -1,8 +1,14 @@
 #include "data_feed_handler.hpp"
 #include "data_types.hpp"
+#include "market_data_service.hpp"
+#include "metrics_server.hpp"
+#include "ring_consumer.hpp"
+#include "tick_capture.hpp"
+#include "topology.hpp"
 #include <iostream>
 #include <csignal>
 #include <atomic>
+#include <memory>
 
 std::atomic<bool> running{true};
 
@@ -20,24 +26,101 @@ int main(int argc, char** argv) {
     
     using namespace wq::datafeed;
     
-    // Create data feed handler
-    auto handler = DataFeedHandlerFactory::createHandler("239.255.0.1", 12345);
-    
-    // Register normalizers
-    handler->registerNormalizer(Exchange::NYSE, 
-        std::make_shared<NYSENormalizer>());
-    handler->registerNormalizer(Exchange::NASDAQ, 
-        std::make_shared<NASDAQNormalizer>());
-    
-    // Register callback using lambda
-    handler->registerCallback([](const MarketData& data) {
-        std::cout << "Market Data: " 
-                  << data.symbol << " "
-                  << "Bid=" << data.bidPrice << " "
-                  << "Ask=" << data.askPrice << " "
-                  << "Last=" << data.lastPrice << " "
-                  << "Exchange=" << exchangeToString(data.exchange) << std::endl;
+    // Create data feed handler - one pinned listener thread per exchange feed
+    // NYSE publishes redundant A/B lines, arbitrated as group 0
+    std::vector<FeedChannel> channels = {
+        {"NYSE-A", Exchange::NYSE, "239.255.0.1", 12345, 2, 0},
+        {"NYSE-B", Exchange::NYSE, "239.255.1.1", 12347, 4, 0},
+        {"NASDAQ", Exchange::NASDAQ, "239.255.0.2", 12346, 3, -1},
+    };
+    auto handler = DataFeedHandlerFactory::createHandler(std::move(channels));
+    
+    // Drain bursts with recvmmsg into a larger socket buffer
+    ReceiveOptions receiveOptions;
+    receiveOptions.mode = ReceiveMode::BATCHED;
+    receiveOptions.socketRecvBufferBytes = 8 * 1024 * 1024;
+    handler->setReceiveOptions(receiveOptions);
+    
+    // No normalizers to register: NYSE and NASDAQ are decoded by the built-in
+    // compile-time layouts. Feeds without one need registerNormalizer(), and
+    // since the handler holds weak_ptrs those normalizers must outlive it.
+    
+    // Listener threads publish into a ring; one consumer thread drains it, so
+    // slow output never backs up into the sockets and needs no locking
+    auto outputRing = std::make_unique<MarketDataRing>();
+    handler->setOutputRing(outputRing.get());
+    wq::common::topology().place("feed.publisher ring", outputRing.get(), sizeof(MarketDataRing),
+                                 wq::common::TopologyStage::FEED_PUBLISHER);
+    
+    // Co-located consumers (alpha engine) read ticks from shared memory
+    auto tickShm = wq::common::publishColocated<wq::common::TickShmRing>(
+        wq::common::IpcConfig::MARKET_DATA_SEGMENT, wq::common::TopologyStage::ALPHA_BRIDGE);
+    if (tickShm) {
+        std::cout << "Publishing ticks to shared memory " << tickShm->name() << std::endl;
+    }
+    
+    // Optional capture directory: one columnar tick store per day, written
+    // from the sink's own thread
+    std::unique_ptr<TickCaptureSink> capture;
+    if (argc > 1) {
+        capture = TickCaptureSink::create(argv[1]);
+        if (!capture) {
+            return 1;
+        }
+        handler->setCaptureSink(capture.get());
+        capture->start();
+        std::cout << "Capturing ticks to " << argv[1] << std::endl;
+    }
+    
+    // Remote subscribers stream batched ticks over gRPC
+    wq::common::AsyncServer server(wq::common::ServerConfig::MARKET_DATA_ADDRESS);
+    MarketDataServiceImpl marketDataService(server);
+    server.setStage(wq::common::TopologyStage::FEED_RPC);
+    if (!server.start()) {
+        return 1;
+    }
+    std::cout << "Serving MarketDataService on " << server.getAddress()
+              << " (" << server.getQueueCount() << " completion queues)" << std::endl;
+    
+    // Stage latencies and counters for scraping
+    auto& registry = wq::common::metrics();
+    registry.setCounter("feed.packets_received", [&handler] {
+        int64_t received, processed;
+        handler->getStats(received, processed);
+        return static_cast<double>(received);
+    });
+    registry.setCounter("feed.packets_processed", [&handler] {
+        int64_t received, processed;
+        handler->getStats(received, processed);
+        return static_cast<double>(processed);
+    });
+    registry.setCounter("feed.ring_drops", [&handler] { return static_cast<double>(handler->getOutputDrops()); });
+    registry.setCounter("feed.conflated", [&marketDataService] {
+        return static_cast<double>(marketDataService.getConflatedCount());
     });
+    wq::common::MetricsServer metricsServer(wq::common::MetricsConfig::DATA_FEED_PORT);
+    if (metricsServer.start()) {
+        std::cout << "Serving metrics on port " << metricsServer.getPort() << std::endl;
+    }
+    
+    wq::common::RingConsumer<MarketDataRing> consumer(*outputRing,
+        [shm = tickShm.get(), &marketDataService](MarketData* updates, size_t count) {
+            marketDataService.publish(updates, count);
+            for (size_t i = 0; i < count; ++i) {
+                const MarketData& data = updates[i];
+                if (shm) {
+                    shm->tryPush(toTickRecord(data));
+                }
+                std::cout << "Market Data: " 
+                          << data.symbol << " "
+                          << "Bid=" << data.bidPrice << " "
+                          << "Ask=" << data.askPrice << " "
+                          << "Last=" << data.lastPrice << " "
+                          << "Exchange=" << exchangeToString(data.exchange) << std::endl;
+            }
+        });
+    consumer.setStage(wq::common::TopologyStage::FEED_PUBLISHER);
+    consumer.start();
     
     // Start listening
     if (!handler->start()) {
@@ -46,7 +129,12 @@ int main(int argc, char** argv) {
     }
     
     std::cout << "Service started successfully" << std::endl;
-    std::cout << "Listening for market data on multicast 239.255.0.1:12345" << std::endl;
+    for (const auto& channel : handler->getChannels()) {
+        std::cout << "Listening for " << channel.name << " market data on multicast "
+                  << channel.multicastGroup << ":" << channel.port
+                  << " (core " << channel.cpuCore << ")" << std::endl;
+    }
+    wq::common::topology().report(std::cout);
     
     // Main loop
     while (running) {
@@ -56,14 +144,34 @@ int main(int argc, char** argv) {
         int64_t received, processed;
         handler->getStats(received, processed);
         
+        int64_t duplicates, gaps, recovered;
+        handler->getArbitrationStats(duplicates, gaps, recovered);
+        
         if (received > 0) {
             std::cout << "Stats: Received=" << received 
-                      << ", Processed=" << processed << std::endl;
+                      << ", Processed=" << processed
+                      << ", Duplicates=" << duplicates
+                      << ", Gaps=" << gaps
+                      << ", Recovered=" << recovered
+                      << ", RingDrops=" << handler->getOutputDrops()
+                      << ", Subscribers=" << marketDataService.getSubscriberCount()
+                      << ", Conflated=" << marketDataService.getConflatedCount();
+            if (capture) {
+                std::cout << ", Captured=" << capture->getWrittenCount()
+                          << ", CaptureDrops=" << capture->getDrops();
+            }
+            std::cout << std::endl;
         }
     }
     
-    // Cleanup
+    // Cleanup - stop producers before draining the ring
     handler->stop();
+    consumer.stop();
+    server.shutdown();
+    metricsServer.stop();
+    if (capture) {
+        capture->stop();
+    }
     std::cout << "Service stopped" << std::endl;
     
     return 0;
@@ -0,0 +1,73 @@
+#include "market_data_service.hpp"
+#include <algorithm>
+
+namespace wq::datafeed {
+
+namespace {
+
+bool wantsSymbol(const proto::MarketDataRequest& request, std::string_view symbol) {
+    const auto& symbols = request.symbols();
+    return symbols.empty() || std::find(symbols.begin(), symbols.end(), symbol) != symbols.end();
+}
+
+std::string tickKey(const proto::MarketTick& tick) {
+    std::string key = tick.symbol();
+    key += '|';
+    key += tick.exchange();
+    return key;
+}
+
+} // namespace
+
+// Strings are copied straight into the tick's arena
+void toProto(const MarketData& data, proto::MarketTick* tick) {
+    std::string_view symbol = data.symbol.view();
+    std::string_view exchange = exchangeToString(data.exchange);
+    tick->set_symbol(symbol.data(), symbol.size());
+    tick->set_bid_price(data.bidPrice);
+    tick->set_ask_price(data.askPrice);
+    tick->set_last_price(data.lastPrice);
+    tick->set_bid_size(data.bidSize);
+    tick->set_ask_size(data.askSize);
+    tick->set_volume(data.volume);
+    tick->set_timestamp_ns(data.timestampNs);
+    tick->set_exchange(exchange.data(), exchange.size());
+}
+
+MarketDataServiceImpl::MarketDataServiceImpl(common::AsyncServer& server)
+    : stream_(server, service_, &AsyncService::RequestStreamMarketData,
+              &proto::MarketDataStream::mutable_ticks, tickKey) {
+    stream_.setFilter([](const proto::MarketDataRequest& request, const proto::MarketTick& tick) {
+        return wantsSymbol(request, tick.symbol());
+    });
+    stream_.setPolicy([](const proto::MarketDataRequest& request) {
+        return request.conflate() ? common::DeliveryPolicy::CONFLATED : common::DeliveryPolicy::FULL;
+    });
+    stream_.setSnapshot([this](const proto::MarketDataRequest& request, proto::MarketDataStream& batch) {
+        lastValues_.forEach([&](size_t, const MarketData& data) {
+            if (wantsSymbol(request, data.symbol.view())) {
+                toProto(data, batch.add_ticks());
+            }
+        });
+    });
+    server.addService(&service_);
+}
+
+// The cache is updated first: a subscriber joining meanwhile may see a
+// tick both in its snapshot and live, but never in neither
+void MarketDataServiceImpl::publish(const MarketData* updates, size_t count) {
+    for (size_t i = 0; i < count; ++i) {
+        lastValues_.update(updates[i].symbolId, updates[i]);
+    }
+    if (count == 0 || stream_.getSubscriberCount() == 0) {
+        return;
+    }
+    auto* staged = stagingArena_.create<proto::MarketDataStream>();
+    for (size_t i = 0; i < count; ++i) {
+        toProto(updates[i], staged->add_ticks());
+    }
+    stream_.publish(staged->ticks());
+    stagingArena_.reset();
+}
+
+} // namespace wq::datafeed
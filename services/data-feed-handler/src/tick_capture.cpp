@@ -0,0 +1,237 @@
+#include "tick_capture.hpp"
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#include <cstdio>
+#include <ctime>
+#include <filesystem>
+#include <iostream>
+#include <new>
+
+namespace wq::datafeed {
+
+using common::TickStoreBlock;
+using common::TickStoreHeader;
+namespace StoreConfig = common::TickStoreConfig;
+
+// TickStoreWriter implementation
+std::unique_ptr<TickStoreWriter> TickStoreWriter::open(const std::string& path, int64_t dayStartNs) {
+    int fd = ::open(path.c_str(), O_RDWR | O_CREAT, 0644);
+    if (fd < 0) {
+        std::cerr << "Failed to open tick store " << path << std::endl;
+        return nullptr;
+    }
+    struct stat info;
+    if (fstat(fd, &info) != 0) {
+        close(fd);
+        return nullptr;
+    }
+    bool fresh = info.st_size == 0;
+    if ((fresh && ftruncate(fd, static_cast<off_t>(StoreConfig::HEADER_BYTES)) != 0) ||
+        (!fresh && static_cast<size_t>(info.st_size) < StoreConfig::HEADER_BYTES)) {
+        close(fd);
+        std::cerr << "Tick store " << path << " is truncated" << std::endl;
+        return nullptr;
+    }
+    void* mapping = mmap(nullptr, StoreConfig::HEADER_BYTES, PROT_READ | PROT_WRITE, MAP_SHARED, fd, 0);
+    if (mapping == MAP_FAILED) {
+        close(fd);
+        std::cerr << "Failed to map tick store " << path << std::endl;
+        return nullptr;
+    }
+
+    TickStoreHeader* header = nullptr;
+    if (fresh) {
+        header = new (mapping) TickStoreHeader();
+        header->version = StoreConfig::VERSION;
+        header->blockRows = StoreConfig::BLOCK_ROWS;
+        header->blockBytes = StoreConfig::BLOCK_BYTES;
+        header->dayStartNs = dayStartNs;
+        header->numBlocks.store(0, std::memory_order_relaxed);
+        header->magic = StoreConfig::MAGIC;  // Readers reject the file until this is set
+    } else {
+        header = static_cast<TickStoreHeader*>(mapping);
+        bool compatible = header->magic == StoreConfig::MAGIC
+            && header->version == StoreConfig::VERSION
+            && header->blockRows == StoreConfig::BLOCK_ROWS
+            && header->blockBytes == StoreConfig::BLOCK_BYTES
+            && header->dayStartNs == dayStartNs
+            && static_cast<size_t>(info.st_size) >= StoreConfig::blockOffset(header->numBlocks.load());
+        if (!compatible) {
+            munmap(mapping, StoreConfig::HEADER_BYTES);
+            close(fd);
+            std::cerr << "Tick store " << path << " has an unsupported layout" << std::endl;
+            return nullptr;
+        }
+    }
+
+    auto writer = std::unique_ptr<TickStoreWriter>(new TickStoreWriter(fd, header));
+
+    // Continue filling the last block; every earlier one is full
+    size_t numBlocks = header->numBlocks.load(std::memory_order_relaxed);
+    if (numBlocks > 0) {
+        if (!writer->mapBlock(numBlocks - 1)) {
+            return nullptr;
+        }
+        writer->rowsBefore_ = (numBlocks - 1) * StoreConfig::BLOCK_ROWS;
+        writer->rows_ = static_cast<uint32_t>(writer->block_->size());
+        writer->minTimestampNs_ = writer->block_->minTimestampNs();
+        writer->maxTimestampNs_ = writer->block_->maxTimestampNs();
+    }
+    return writer;
+}
+
+TickStoreWriter::TickStoreWriter(int fd, TickStoreHeader* header)
+    : fd_(fd)
+    , header_(header) {
+}
+
+TickStoreWriter::~TickStoreWriter() {
+    publish();
+    unmapBlock();
+    munmap(header_, StoreConfig::HEADER_BYTES);
+    close(fd_);
+}
+
+bool TickStoreWriter::mapBlock(size_t index) {
+    size_t offset = StoreConfig::blockOffset(index);
+    bool grow = index >= header_->numBlocks.load(std::memory_order_relaxed);
+    if (grow && ftruncate(fd_, static_cast<off_t>(offset + StoreConfig::BLOCK_BYTES)) != 0) {
+        std::cerr << "Failed to grow tick store" << std::endl;
+        return false;
+    }
+    // Prefault the block here so appends never take a page fault
+    void* mapping = mmap(nullptr, StoreConfig::BLOCK_BYTES, PROT_READ | PROT_WRITE,
+                         MAP_SHARED | MAP_POPULATE, fd_, static_cast<off_t>(offset));
+    if (mapping == MAP_FAILED) {
+        std::cerr << "Failed to map tick store block " << index << std::endl;
+        return false;
+    }
+    block_ = static_cast<TickStoreBlock*>(mapping);
+    blockIndex_ = index;
+    if (grow) {
+        header_->numBlocks.store(index + 1, std::memory_order_release);
+    }
+    return true;
+}
+
+void TickStoreWriter::unmapBlock() {
+    if (block_) {
+        munmap(block_, StoreConfig::BLOCK_BYTES);
+        block_ = nullptr;
+    }
+}
+
+bool TickStoreWriter::append(const MarketData& data) {
+    if (!block_ || rows_ == TickStoreBlock::ROWS) {
+        publish();
+        if (block_) {
+            rowsBefore_ += rows_;
+            unmapBlock();
+        }
+        rows_ = 0;
+        if (!mapBlock(header_->numBlocks.load(std::memory_order_relaxed))) {
+            return false;
+        }
+    }
+
+    TickStoreBlock& block = *block_;
+    size_t row = rows_++;
+    block.timestampNs[row] = data.timestampNs;
+    block.bidPrice[row] = data.bidPrice;
+    block.askPrice[row] = data.askPrice;
+    block.lastPrice[row] = data.lastPrice;
+    block.bidSize[row] = data.bidSize;
+    block.askSize[row] = data.askSize;
+    block.volume[row] = data.volume;
+    block.symbol[row] = data.symbol;
+    block.exchange[row] = static_cast<uint8_t>(data.exchange);
+    block.assetType[row] = static_cast<uint8_t>(data.assetType);
+
+    if (row == 0) {
+        minTimestampNs_ = maxTimestampNs_ = data.timestampNs;
+    } else {
+        minTimestampNs_ = std::min(minTimestampNs_, data.timestampNs);
+        maxTimestampNs_ = std::max(maxTimestampNs_, data.timestampNs);
+    }
+    return true;
+}
+
+void TickStoreWriter::publish() {
+    if (!block_) {
+        return;
+    }
+    block_->header.minTimestampNs.store(minTimestampNs_, std::memory_order_relaxed);
+    block_->header.maxTimestampNs.store(maxTimestampNs_, std::memory_order_relaxed);
+    block_->header.rows.store(rows_, std::memory_order_release);  // Columns and index first
+}
+
+// TickCaptureSink implementation
+std::unique_ptr<TickCaptureSink> TickCaptureSink::create(const std::string& directory) {
+    std::error_code error;
+    std::filesystem::create_directories(directory, error);
+    if (error) {
+        std::cerr << "Cannot create capture directory " << directory << ": " << error.message() << std::endl;
+        return nullptr;
+    }
+    return std::unique_ptr<TickCaptureSink>(new TickCaptureSink(directory));
+}
+
+TickCaptureSink::TickCaptureSink(std::string directory)
+    : directory_(std::move(directory))
+    , ring_(std::make_unique<CaptureRing>())
+    , consumer_(*ring_, [this](MarketData* ticks, size_t count) { write(ticks, count); },
+                CaptureConfig::WRITE_BATCH) {
+    consumer_.setStage(common::TopologyStage::FEED_CAPTURE);
+    common::topology().place("feed.capture ring", ring_.get(), sizeof(CaptureRing), common::TopologyStage::FEED_CAPTURE);
+}
+
+TickCaptureSink::~TickCaptureSink() {
+    stop();
+}
+
+void TickCaptureSink::start() {
+    consumer_.start();
+}
+
+void TickCaptureSink::stop() {
+    consumer_.stop();
+    writer_.reset();  // Unmap; the next start() appends to the same file
+    day_ = std::numeric_limits<int64_t>::min();
+}
+
+std::string TickCaptureSink::pathForDay(const std::string& directory, int64_t day) {
+    std::time_t seconds = static_cast<std::time_t>(day * 86400);
+    std::tm date{};
+    gmtime_r(&seconds, &date);
+    char name[48];  // Room for three full-width ints, whatever the date
+    std::snprintf(name, sizeof(name), "ticks-%04d%02d%02d.wqc",
+                  date.tm_year + 1900, date.tm_mon + 1, date.tm_mday);
+    return (std::filesystem::path(directory) / name).string();
+}
+
+void TickCaptureSink::write(const MarketData* ticks, size_t count) {
+    uint64_t written = 0;
+    for (size_t i = 0; i < count; ++i) {
+        const MarketData& tick = ticks[i];
+        int64_t day = common::tickStoreDay(tick.timestampNs);
+        if (day != day_) {
+            // New day: close the previous file and roll over
+            writer_.reset();
+            writer_ = TickStoreWriter::open(pathForDay(directory_, day), day * StoreConfig::NS_PER_DAY);
+            day_ = day;
+        }
+        if (!writer_ || !writer_->append(tick)) {
+            writeErrors_.fetch_add(1, std::memory_order_relaxed);
+            continue;
+        }
+        ++written;
+    }
+    if (writer_) {
+        writer_->publish();
+    }
+    written_.fetch_add(written, std::memory_order_relaxed);
+}
+
+} // namespace wq::datafeed
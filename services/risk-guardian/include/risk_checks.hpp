@@ -1,15 +1,21 @@
 #pragma once
 
+#include "fixed_string.hpp"
+#include "risk_state.hpp"
+#include "symbol_table.hpp"
 #include <string>
 #include <string_view>
 #include <memory>
 #include <optional>
 #include <vector>
-#include <unordered_map>
 #include <chrono>
 
 namespace wq::risk {
 
+using common::OrderIdString;
+using common::SymbolId;
+using common::SymbolString;
+
 // Order side enum
 enum class OrderSide : uint8_t {
     BUY,
@@ -25,6 +31,13 @@ enum class ViolationType : uint8_t {
     NONE
 };
 
+// Set of violations, bit n for ViolationType n
+using ViolationMask = uint32_t;
+
+constexpr ViolationMask violationBit(ViolationType type) {
+    return ViolationMask{1} << static_cast<uint32_t>(type);
+}
+
 constexpr std::string_view violationTypeToString(ViolationType type) {
     switch (type) {
         case ViolationType::FAT_FINGER: return "FAT_FINGER";
@@ -35,29 +48,61 @@ constexpr std::string_view violationTypeToString(ViolationType type) {
     }
 }
 
-// Order structure
+// Order structure - identifiers inline, no heap allocation per order
 struct Order {
-    std::string orderId;
-    std::string symbol;
-    double quantity;
-    OrderSide side;
-    double price;
-    int64_t timestampNs;
+    OrderIdString orderId;
+    SymbolString symbol;
+    SymbolId symbolId{common::INVALID_SYMBOL_ID};
+    double quantity{0};
+    OrderSide side{OrderSide::BUY};
+    double price{0};
+    int64_t timestampNs{0};
     
     Order() = default;
     Order(Order&&) noexcept = default;
     Order& operator=(Order&&) noexcept = default;
+    
+    // Set symbol and its interned id together
+    void setSymbol(std::string_view name) {
+        symbol = SymbolString(name);
+        symbolId = common::internSymbol(name);
+    }
+    
+    // Interned id, resolving it from the symbol text if the caller did not set it
+    SymbolId resolveSymbolId() const {
+        return symbolId != common::INVALID_SYMBOL_ID ? symbolId : common::findSymbol(symbol.view());
+    }
 };
 
 // Position tracking
 struct Position {
-    std::string symbol;
+    SymbolString symbol;
+    SymbolId symbolId{common::INVALID_SYMBOL_ID};
     double quantity;
     double avgCost;
+    double markPrice;
     double unrealizedPnL;
     double realizedPnL;
     
-    Position() : quantity(0), avgCost(0), unrealizedPnL(0), realizedPnL(0) {}
+    Position() : quantity(0), avgCost(0), markPrice(0), unrealizedPnL(0), realizedPnL(0) {}
+};
+
+// A basket of orders with the risk inputs they need, gathered from one
+// version of the risk state, as parallel columns: entry i is orders[i].
+// The prior* columns hold what earlier orders of the basket add in the same
+// symbol, so each order is checked as if the ones before it had filled.
+struct BasketView {
+    const Order* orders{nullptr};
+    size_t count{0};
+    const double* quantity{nullptr};        // |quantity|
+    const double* notional{nullptr};        // Signed quantity * price; sells negative
+    const double* adv{nullptr};             // 0 when unknown
+    const double* positionValue{nullptr};   // Before the basket
+    const double* priorQuantity{nullptr};   // Sum of |quantity| of earlier orders in the symbol
+    const double* priorNotional{nullptr};   // Sum of notional of earlier orders in the symbol
+    double nav{0};
+    double startOfDayNAV{0};
+    double pnl{0};
 };
 
 // Abstract base class for risk checks (demonstrates pure virtual functions)
@@ -65,12 +110,34 @@ class IRiskCheck {
 public:
     virtual ~IRiskCheck() = default;  // Virtual destructor
     
-    // Pure virtual function
-    virtual bool validate(const Order& order, std::string& reason) const = 0;
+    // Fast path: true if the order passes. Must not allocate. Called inside
+    // RiskState::read(), so it may run more than once per order and must
+    // read live data only from state.
+    virtual bool check(const Order& order, const RiskState& state) const = 0;
+    
+    // Explain why an order that failed check() was rejected
+    virtual void describe(const Order& order, const RiskState& state, std::string& reason) const = 0;
+    
+    // Basket path: OR the check's violation bit into violations[i] for each
+    // failing order in [begin, end). Reads only the view, never the live
+    // state; disjoint ranges may run on different threads.
+    virtual void checkBasket(const BasketView& basket, size_t begin, size_t end,
+                             ViolationMask* violations) const = 0;
+    
+    // check() against one version of state, with the reason filled in on failure
+    virtual bool validate(const Order& order, const RiskState& state, std::string& reason) const {
+        if (state.read([&] { return check(order, state); })) {
+            return true;
+        }
+        describe(order, state, reason);
+        return false;
+    }
     
-    // Virtual function with default implementation
     virtual std::string_view getCheckName() const = 0;
     
+    // Violation reported when the check fails
+    virtual ViolationType getViolationType() const = 0;
+    
     // Virtual function for enabling/disabling
     virtual bool isEnabled() const {
         return enabled_;
@@ -90,15 +157,17 @@ public:
     explicit FatFingerCheck(double maxAdvPercentage = 0.05);
     ~FatFingerCheck() override = default;
     
-    bool validate(const Order& order, std::string& reason) const override;
+    // Reads the symbol's ADV (Average Daily Volume) from the state
+    bool check(const Order& order, const RiskState& state) const override;
+    void describe(const Order& order, const RiskState& state, std::string& reason) const override;
+    // Quantity counts the earlier orders of the basket in the same symbol
+    void checkBasket(const BasketView& basket, size_t begin, size_t end,
+                     ViolationMask* violations) const override;
     std::string_view getCheckName() const override { return "FatFingerCheck"; }
-    
-    // Set ADV (Average Daily Volume) for a symbol
-    void setADV(std::string_view symbol, double adv);
+    ViolationType getViolationType() const override { return ViolationType::FAT_FINGER; }
 
 private:
     double maxAdvPercentage_;
-    mutable std::unordered_map<std::string, double> advMap_;
 };
 
 // Drawdown check - prevents trading when losses are too high
@@ -107,16 +176,16 @@ public:
     explicit DrawdownCheck(double maxDrawdownPercentage = 0.05);
     ~DrawdownCheck() override = default;
     
-    bool validate(const Order& order, std::string& reason) const override;
+    // Reads PnL and start-of-day NAV from the state
+    bool check(const Order& order, const RiskState& state) const override;
+    void describe(const Order& order, const RiskState& state, std::string& reason) const override;
+    void checkBasket(const BasketView& basket, size_t begin, size_t end,
+                     ViolationMask* violations) const override;
     std::string_view getCheckName() const override { return "DrawdownCheck"; }
-    
-    void updatePnL(double currentPnL);
-    void updateStartOfDayNAV(double nav);
+    ViolationType getViolationType() const override { return ViolationType::DRAWDOWN; }
 
 private:
     double maxDrawdownPercentage_;
-    mutable double startOfDayNAV_{0};
-    mutable double currentPnL_{0};
 };
 
 // Concentration check - prevents over-concentration in single asset
@@ -125,16 +194,28 @@ public:
     explicit ConcentrationCheck(double maxConcentrationPercentage = 0.10);
     ~ConcentrationCheck() override = default;
     
-    bool validate(const Order& order, std::string& reason) const override;
+    // Reads the symbol's position value and the NAV from the state
+    bool check(const Order& order, const RiskState& state) const override;
+    void describe(const Order& order, const RiskState& state, std::string& reason) const override;
+    // Position value counts the earlier orders of the basket in the same symbol
+    void checkBasket(const BasketView& basket, size_t begin, size_t end,
+                     ViolationMask* violations) const override;
     std::string_view getCheckName() const override { return "ConcentrationCheck"; }
-    
-    void updatePosition(std::string_view symbol, double quantity, double value);
-    void updateTotalNAV(double nav);
+    ViolationType getViolationType() const override { return ViolationType::CONCENTRATION; }
 
 private:
     double maxConcentrationPercentage_;
-    mutable std::unordered_map<std::string, double> positionValues_;
-    mutable double totalNAV_{0};
+    
+    // |position value| / NAV once the order fills
+    static double concentrationAfter(const Order& order, const RiskState& state);
+};
+
+// Compact verdict of the validation fast path - trivially copyable, no heap
+struct RiskVerdict {
+    bool approved{true};
+    ViolationMask violations{0};
+    
+    bool has(ViolationType type) const { return (violations & violationBit(type)) != 0; }
 };
 
 // Risk check result
@@ -165,21 +246,52 @@ public:
         checks_.push_back(std::move(check));
     }
     
-    RiskCheckResult validateAll(const TOrder& order) const {
+    RiskCheckResult validateAll(const TOrder& order, const RiskState& state) const {
         RiskCheckResult result;
+        describeAll(order, state, checkAll(order, state), result);
+        return result;
+    }
+    
+    // Violations of every enabled check, without building any message. All
+    // checks see the same version of state.
+    ViolationMask checkAll(const TOrder& order, const RiskState& state) const {
+        return state.read([&] {
+            ViolationMask violations = 0;
+            for (const auto& check : checks_) {
+                if (check->isEnabled() && !check->check(reinterpret_cast<const Order&>(order), state)) {
+                    violations |= violationBit(check->getViolationType());
+                }
+            }
+            return violations;
+        });
+    }
+    
+    // Add the reasons for the given violations to result. Only done for
+    // rejected orders, so the fast path never formats a message.
+    void describeAll(const TOrder& order, const RiskState& state, ViolationMask violations,
+                     RiskCheckResult& result) const {
+        if (violations == 0) {
+            return;
+        }
         std::string reason;
-        
         for (const auto& check : checks_) {
-            if (!check->isEnabled()) {
+            if (!check->isEnabled() || (violations & violationBit(check->getViolationType())) == 0) {
                 continue;
             }
-            
-            if (!check->validate(reinterpret_cast<const Order&>(order), reason)) {
-                result.addViolation(ViolationType::NONE, reason);
+            reason.clear();
+            check->describe(reinterpret_cast<const Order&>(order), state, reason);
+            result.addViolation(check->getViolationType(), reason);
+        }
+    }
+    
+    // Basket path over [begin, end): violations[i] gets every enabled
+    // check's bit for orders[i]. violations must start cleared.
+    void checkBasket(const BasketView& basket, size_t begin, size_t end, ViolationMask* violations) const {
+        for (const auto& check : checks_) {
+            if (check->isEnabled()) {
+                check->checkBasket(basket, begin, end, violations);
             }
         }
-        
-        return result;
     }
     
     size_t getCheckCount() const {
@@ -1,48 +1,155 @@
 #pragma once
 
 #include "risk_checks.hpp"
+#include "checkpoint.hpp"
+#include "ipc_transport.hpp"
+#include "ring_buffer.hpp"
+#include "ring_consumer.hpp"
+#include <functional>
 #include <memory>
 #include <mutex>
 #include <shared_mutex>
 #include <atomic>
 #include <unordered_map>
+#include <vector>
 
 namespace wq::risk {
 
 // Forward declaration for friend class
 class RiskGuardianBuilder;
 
-// Position manager with smart pointers
+// Position book stored column by column, indexed by interned symbol id.
+// Gross exposure, net exposure and PnL are running totals adjusted by each
+// fill and price update, so reading them is O(1) and takes no lock.
+// Positions are marked at the last market price, or at the last fill price
+// until a market price arrives. Fills use average-cost accounting: adding
+// blends the cost, reducing realizes PnL against it.
 class PositionManager {
 public:
     PositionManager() = default;
     
-    // Get position - returns shared_ptr
-    std::shared_ptr<Position> getPosition(std::string_view symbol);
+    // Copy of a position; all zero if the symbol was never traded
+    Position getPosition(std::string_view symbol) const;
+    Position getPosition(SymbolId symbolId) const;
     
-    // Get position - returns weak_ptr (demonstrates weak_ptr usage)
-    std::weak_ptr<Position> getPositionWeak(std::string_view symbol);
-    
-    // Update position
+    // Apply a fill of quantity shares (negative to sell) at price
     void updatePosition(std::string_view symbol, double quantity, double price);
+    void updatePosition(SymbolId symbolId, double quantity, double price);
+    
+    // Re-mark every position in the symbol
+    void updateMarketPrice(SymbolId symbolId, double price);
+    
+    // Quantity times mark price; 0 if the symbol was never traded
+    double getPositionValue(SymbolId symbolId) const;
     
     // Get all positions
-    std::vector<std::shared_ptr<Position>> getAllPositions() const;
+    std::vector<Position> getAllPositions() const;
     
-    // Calculate total exposure
-    double calculateTotalExposure() const;
+    // Calculate total exposure - the running gross exposure
+    double calculateTotalExposure() const { return getGrossExposure(); }
+    
+    double getGrossExposure() const { return grossExposure_.load(std::memory_order_relaxed); }  // sum |qty * mark|
+    double getNetExposure() const { return netExposure_.load(std::memory_order_relaxed); }      // sum qty * mark
+    double getUnrealizedPnL() const { return unrealizedPnL_.load(std::memory_order_relaxed); }  // sum qty * (mark - cost)
+    double getRealizedPnL() const { return realizedPnL_.load(std::memory_order_relaxed); }
     
     // Get statistics by reference
     void getStats(size_t& numPositions, double& totalExposure) const;
     
     // Get statistics by pointer with const correctness
     void getStats(size_t* numPositions, double* totalExposure) const;
+    
+    // Write every traded symbol's row, by name, into the open section
+    void checkpoint(common::CheckpointWriter& out) const;
+    
+    // Replace the rows of the symbols in a section written by checkpoint(),
+    // adjusting the totals; returns the positions restored
+    size_t restore(common::CheckpointSection& in);
 
 private:
-    mutable std::shared_mutex mutex_;  // Reader-writer lock
-    std::unordered_map<std::string, std::shared_ptr<Position>> positions_;
+    mutable std::shared_mutex mutex_;  // Exclusive for fills and marks, shared for position reads
+    
+    // Columns, one entry per symbol id up to the highest seen
+    std::vector<double> quantity_;
+    std::vector<double> avgCost_;
+    std::vector<double> markPrice_;
+    std::vector<double> realized_;
+    std::vector<uint8_t> hasMarketPrice_;   // Else marked at the last fill
+    std::vector<uint8_t> traded_;
+    std::vector<SymbolId> tradedIds_;       // Symbols with a position, in first-fill order
+    
+    // Totals, written under the exclusive lock and read without it
+    std::atomic<double> grossExposure_{0};
+    std::atomic<double> netExposure_{0};
+    std::atomic<double> unrealizedPnL_{0};
+    std::atomic<double> realizedPnL_{0};
+    std::atomic<size_t> numPositions_{0};
+    
+    // Grow every column to hold symbolId
+    void reserveLocked(SymbolId symbolId);
+    
+    // Add (sign 1) or remove (sign -1) one symbol's share of the totals
+    void accumulateLocked(SymbolId symbolId, double sign);
+    
+    Position positionLocked(SymbolId symbolId) const;
+};
+
+namespace GuardianConfig {
+    constexpr size_t ORDER_RING_CAPACITY = 4096;  // Orders buffered from the portfolio stage
+    constexpr size_t MIN_BASKET_ORDERS_PER_THREAD = 4096;  // Smaller baskets run on the caller's thread
+    constexpr int BASKET_READ_ATTEMPTS = 4;       // Lock-free basket gathers before pausing writers
+}
+
+// Totals of one validateBasket() call
+struct BasketResult {
+    size_t approved{0};
+    size_t rejected{0};
+    double grossNotional{0};        // Sum of |quantity * price| over the basket
+    double grossExposureAfter{0};   // Book gross exposure once every order fills
+    double netExposureAfter{0};
+    uint64_t stateVersion{0};       // RiskState version the basket was checked against
 };
 
+// Inter-stage transport: a single order submitter feeds the guardian
+using OrderRing = common::SpscRing<Order, GuardianConfig::ORDER_RING_CAPACITY>;
+
+// Receives each ring-submitted order with its verdict, on the consumer thread
+using OrderResultCallback = std::function<void(const Order&, const RiskCheckResult&)>;
+
+// Co-located IPC conversions: order requests in, verdicts out
+inline Order fromOrderRecord(const common::OrderRecord& record) {
+    Order order;
+    order.orderId = record.orderId;
+    order.symbol = record.symbol;
+    order.symbolId = common::symbolTable().internName(record.symbol);
+    order.quantity = record.quantity;
+    order.side = static_cast<OrderSide>(record.side);
+    order.price = record.price;
+    order.timestampNs = record.timestampNs;
+    return order;
+}
+
+inline common::OrderVerdictRecord toVerdictRecord(const Order& order, const RiskVerdict& verdict) {
+    common::OrderVerdictRecord record{};
+    record.orderId = order.orderId;
+    record.approved = verdict.approved;
+    record.violationMask = verdict.violations;
+    return record;
+}
+
+inline common::OrderVerdictRecord toVerdictRecord(const Order& order, const RiskCheckResult& result) {
+    common::OrderVerdictRecord record{};
+    record.orderId = order.orderId;
+    record.approved = result.approved;
+    for (ViolationType violation : result.violations) {
+        record.violationMask |= violationBit(violation);
+    }
+    return record;
+}
+
+// Threads that check the ranges of a split basket, kept between baskets
+class BasketHelpers;
+
 // Main Risk Guardian class
 class RiskGuardian {
 public:
@@ -54,20 +161,43 @@ public:
     RiskGuardian(RiskGuardian&&) noexcept = default;
     RiskGuardian& operator=(RiskGuardian&&) noexcept = default;
     
-    ~RiskGuardian() = default;
+    ~RiskGuardian();
     
-    // Validate order - main entry point (< 50µs target)
+    // Validate order - main entry point (< 50µs target). Approved orders
+    // cost no more than checkOrder(); reasons are built only on reject.
     RiskCheckResult validateOrder(const Order& order);
     
+    // Fast path: verdict and violation mask only. Takes no lock and does
+    // not allocate, so any number of threads can validate at once, while
+    // fills and prices keep updating the risk state.
+    RiskVerdict checkOrder(const Order& order);
+    
+    // Reasons for a verdict returned by checkOrder() or validateBasket().
+    // Messages quote the limits in force when this is called, and the order
+    // on its own rather than with the rest of its basket.
+    RiskCheckResult explainVerdict(const Order& order, const RiskVerdict& verdict) const;
+    
     // Function overloading for different order types
     RiskCheckResult validateOrder(std::string_view symbol, double quantity, OrderSide side, double price);
     
+    // Validate orders drained from a ring on a dedicated thread until
+    // detachOrderInput(). The ring must stay alive until then. The thread
+    // and the ring are placed as the topology's risk.input stage.
+    void attachOrderInput(OrderRing& ring, OrderResultCallback callback);
+    void detachOrderInput();
+    
     // Update position after execution
     void updatePosition(std::string_view symbol, double executedQty, double executedPrice);
     
-    // Set market data for calculations
+    // Set market data for calculations; re-marks the symbol's position
     void updateMarketPrice(std::string_view symbol, double price);
     
+    // Set ADV (Average Daily Volume) for the fat finger check
+    void setADV(std::string_view symbol, double adv);
+    
+    // The updates above publish into this state, which every check reads
+    const RiskState& getRiskState() const { return *riskState_; }
+    
     // Get position manager (demonstrates const method returning non-const pointer via friend)
     PositionManager* getPositionManager() { return &positionManager_; }
     const PositionManager* getPositionManager() const { return &positionManager_; }
@@ -78,7 +208,32 @@ public:
         return static_cast<T>(validationCount_.load());
     }
     
-    // Lambda-based batch validation
+    // Initial NAV plus realized and unrealized PnL, from running totals
+    double getCurrentNAV() const {
+        return currentNAV_ + positionManager_.getRealizedPnL() + positionManager_.getUnrealizedPnL();
+    }
+    
+    // Validations that took longer than RiskLimits::MAX_VALIDATION_TIME_NS
+    uint64_t getSlowValidationCount() const { return slowValidationCount_.load(std::memory_order_relaxed); }
+    
+    // Positions and PnL for a checkpoint. Limits and ADV are configuration
+    // and come from startup, not from the file.
+    void checkpoint(common::CheckpointWriter& out) const;
+    
+    // Restore positions written by checkpoint() and publish them into the
+    // risk state, before orders arrive. Returns the positions restored.
+    size_t restoreCheckpoint(const common::CheckpointReader& in);
+    
+    // Validate a basket against one version of the risk state in a single
+    // pass, writing count verdicts. Each order is checked as if the earlier
+    // orders of the basket had filled, so child orders cannot add up past a
+    // limit each would pass alone. With threads > 1, large baskets are split
+    // across the caller and up to threads - 1 helper threads, started on
+    // first use and kept; a basket that finds the helpers busy with another
+    // runs on its caller alone. Does not allocate once warmed up.
+    BasketResult validateBasket(const Order* orders, size_t count, RiskVerdict* verdicts, size_t threads = 1);
+    
+    // Lambda-based batch validation; each order is checked on its own
     template<typename Container, typename Callback>
     void validateBatch(const Container& orders, Callback&& callback) {
         for (const auto& order : orders) {
@@ -95,19 +250,27 @@ private:
     
     PositionManager positionManager_;
     RiskCheckAggregator<Order> checkAggregator_;
+    std::unique_ptr<RiskState> riskState_;  // Per-symbol columns, too large to hold inline
+    std::mutex stateWriteMutex_;            // Serializes writers of riskState_ and positionManager_
     
-    mutable std::mutex validationMutex_;
     std::atomic<uint64_t> validationCount_{0};
     std::atomic<uint64_t> approvedCount_{0};
     std::atomic<uint64_t> rejectedCount_{0};
+    std::atomic<uint64_t> slowValidationCount_{0};
     
-    std::unordered_map<std::string, double> marketPrices_;
-    mutable std::shared_mutex pricesMutex_;
+    double currentNAV_;                 // Initial NAV
     
-    double currentNAV_;
+    std::mutex basketHelpersMutex_;         // Held by the basket using the helpers
+    std::unique_ptr<BasketHelpers> basketHelpers_;
+    
+    std::unique_ptr<common::RingConsumer<OrderRing>> orderConsumer_;  // Last: stops first
     
     // Helper to calculate order value
     double calculateOrderValue(const Order& order) const;
+    
+    // Publish the symbol's position value with the current PnL and NAV.
+    // Caller holds stateWriteMutex_.
+    void publishPositionLocked(SymbolId symbolId);
 };
 
 // Builder pattern for RiskGuardian construction
@@ -0,0 +1,36 @@
+#pragma once
+
+#include "async_server.hpp"
+#include "risk_guardian.hpp"
+#include "risk.grpc.pb.h"
+
+namespace wq::risk {
+
+// Proto conversions for RiskService
+Order fromOrderRequest(const proto::OrderRequest& request);
+void toProto(const RiskVerdict& verdict, const RiskCheckResult* reasons, proto::RiskCheckResult* result);
+
+// RiskService on the async server. ValidateOrder runs the lock-free
+// checkOrder() on the polling thread and formats reasons only for rejects;
+// ValidateBasket runs validateBasket() over the whole request.
+class RiskServiceImpl {
+public:
+    using AsyncService = proto::RiskService::AsyncService;
+
+    // Registers with server, which must not have started yet
+    RiskServiceImpl(common::AsyncServer& server, RiskGuardian& guardian);
+
+    uint64_t getOrderCallCount() const { return validateOrder_.getCallCount(); }
+    uint64_t getBasketCallCount() const { return validateBasket_.getCallCount(); }
+
+private:
+    RiskGuardian& guardian_;
+    AsyncService service_;
+    common::UnaryMethod<AsyncService, proto::OrderRequest, proto::RiskCheckResult> validateOrder_;
+    common::UnaryMethod<AsyncService, proto::BasketRequest, proto::BasketResult> validateBasket_;
+
+    grpc::Status validateOrder(const proto::OrderRequest& request, proto::RiskCheckResult& result);
+    grpc::Status validateBasket(const proto::BasketRequest& request, proto::BasketResult& result);
+};
+
+} // namespace wq::risk
@@ -0,0 +1,128 @@
+#pragma once
+
+#include "symbol_table.hpp"
+#include <atomic>
+#include <cstdint>
+#include <memory>
+
+namespace wq::risk {
+
+using common::SymbolId;
+
+// Inputs of the risk checks: per-symbol ADV and position value, plus NAV and
+// PnL. One writer at a time updates it in place; validators read it without
+// locking through read(), which retries until it has seen a single published
+// version (seqlock). A write is a handful of stores, so at full market data
+// rate readers rarely retry, and nothing is copied per update.
+class RiskState {
+public:
+    static constexpr size_t CAPACITY = common::InternConfig::MAX_SYMBOLS;
+
+    RiskState()
+        : adv_(new std::atomic<double>[CAPACITY]())
+        , positionValue_(new std::atomic<double>[CAPACITY]()) {}
+
+    RiskState(const RiskState&) = delete;
+    RiskState& operator=(const RiskState&) = delete;
+
+    // Marks a write in progress; the values set inside it become visible to
+    // readers together. Writers must be serialized by the caller.
+    class WriteScope {
+    public:
+        explicit WriteScope(RiskState& state) : state_(state) {
+            state_.sequence_.store(state_.sequence_.load(std::memory_order_relaxed) + 1,
+                                   std::memory_order_relaxed);
+            std::atomic_thread_fence(std::memory_order_release);
+        }
+        ~WriteScope() {
+            state_.sequence_.store(state_.sequence_.load(std::memory_order_relaxed) + 1,
+                                   std::memory_order_release);
+        }
+
+        WriteScope(const WriteScope&) = delete;
+        WriteScope& operator=(const WriteScope&) = delete;
+
+    private:
+        RiskState& state_;
+    };
+
+    // Writers, inside a WriteScope. Ids past CAPACITY are ignored.
+    void setADV(SymbolId symbolId, double adv) { store(adv_, symbolId, adv); }
+    void setPositionValue(SymbolId symbolId, double value) { store(positionValue_, symbolId, value); }
+    void setNAV(double nav) { nav_.store(nav, std::memory_order_relaxed); }
+    void setStartOfDayNAV(double nav) { startOfDayNAV_.store(nav, std::memory_order_relaxed); }
+    void setPnL(double pnl) { pnl_.store(pnl, std::memory_order_relaxed); }
+    void setExposure(double gross, double net) {
+        grossExposure_.store(gross, std::memory_order_relaxed);
+        netExposure_.store(net, std::memory_order_relaxed);
+    }
+
+    // Run reader() against one consistent version and return its result.
+    // reader may run more than once, so it must have no side effects.
+    template<typename Reader>
+    auto read(Reader&& reader) const {
+        while (true) {
+            uint64_t before = sequence_.load(std::memory_order_acquire);
+            if (before & 1) {
+                continue;  // Write in progress
+            }
+            auto result = reader();
+            std::atomic_thread_fence(std::memory_order_acquire);
+            if (sequence_.load(std::memory_order_relaxed) == before) {
+                return result;
+            }
+        }
+    }
+
+    // read() for readers too long to reliably fit between writes: runs
+    // reader() at most attempts times, false if every run overlapped a write
+    template<typename Reader>
+    bool tryRead(Reader&& reader, int attempts) const {
+        for (int i = 0; i < attempts; ++i) {
+            uint64_t before = sequence_.load(std::memory_order_acquire);
+            if (before & 1) {
+                continue;
+            }
+            reader();
+            std::atomic_thread_fence(std::memory_order_acquire);
+            if (sequence_.load(std::memory_order_relaxed) == before) {
+                return true;
+            }
+        }
+        return false;
+    }
+
+    // Readers, inside read(). 0 when unknown.
+    double adv(SymbolId symbolId) const { return load(adv_, symbolId); }
+    double positionValue(SymbolId symbolId) const { return load(positionValue_, symbolId); }
+    double nav() const { return nav_.load(std::memory_order_relaxed); }
+    double startOfDayNAV() const { return startOfDayNAV_.load(std::memory_order_relaxed); }
+    double pnl() const { return pnl_.load(std::memory_order_relaxed); }
+    double grossExposure() const { return grossExposure_.load(std::memory_order_relaxed); }
+    double netExposure() const { return netExposure_.load(std::memory_order_relaxed); }
+
+    // Completed writes since construction
+    uint64_t version() const { return sequence_.load(std::memory_order_acquire) / 2; }
+
+private:
+    std::unique_ptr<std::atomic<double>[]> adv_;
+    std::unique_ptr<std::atomic<double>[]> positionValue_;
+    std::atomic<double> nav_{0};
+    std::atomic<double> startOfDayNAV_{0};
+    std::atomic<double> pnl_{0};
+    std::atomic<double> grossExposure_{0};
+    std::atomic<double> netExposure_{0};
+    alignas(64) std::atomic<uint64_t> sequence_{0};  // Odd while a write is in progress
+
+    static void store(const std::unique_ptr<std::atomic<double>[]>& column, SymbolId symbolId, double value) {
+        if (symbolId < CAPACITY) {
+            column[symbolId].store(value, std::memory_order_relaxed);
+        }
+    }
+
+    static double load(const std::unique_ptr<std::atomic<double>[]>& column, SymbolId symbolId) {
+        return symbolId < CAPACITY ? column[symbolId].load(std::memory_order_relaxed) : 0.0;
+    }
+};
+
+} // namespace wq::risk
@@ -1,8 +1,17 @@
 #include "risk_guardian.hpp"
+#include "checkpoint.hpp"
+#include "metrics_server.hpp"
+#include "risk_service.hpp"
+#include "topology.hpp"
 #include <iostream>
 #include <csignal>
 #include <atomic>
 #include <chrono>
+#include <filesystem>
+#include <memory>
+#include <string>
+#include <string_view>
+#include <thread>
 
 std::atomic<bool> running{true};
 
@@ -34,13 +43,102 @@ int main(int argc, char** argv) {
     std::cout << "  - Drawdown Limit: 5%" << std::endl;
     std::cout << "  - Concentration Limit: 10%" << std::endl;
     
+    // Usage: risk-guardian [--checkpoint FILE]
+    std::string checkpointPath;
+    for (int i = 1; i + 1 < argc; ++i) {
+        if (std::string_view(argv[i]) == "--checkpoint") {
+            checkpointPath = argv[++i];
+        }
+    }
+    
+    // Warm restart: positions and PnL from the last checkpoint, before any order
+    if (!checkpointPath.empty() && std::filesystem::exists(checkpointPath)) {
+        if (auto restored = wq::common::CheckpointReader::open(checkpointPath)) {
+            std::cout << "Restored " << guardian->restoreCheckpoint(*restored)
+                      << " positions from " << checkpointPath << std::endl;
+        }
+    }
+    auto writeCheckpoint = [&guardian, &checkpointPath](int64_t nowNs) {
+        wq::common::CheckpointWriter writer;
+        guardian->checkpoint(writer);
+        if (writer.commit(checkpointPath, nowNs)) {
+            std::cout << "Checkpointed positions to " << checkpointPath << std::endl;
+        }
+    };
+    
+    // Remote submitters (EMS) call ValidateOrder and ValidateBasket over gRPC
+    wq::common::AsyncServer server(wq::common::ServerConfig::RISK_ADDRESS);
+    RiskServiceImpl riskService(server, *guardian);
+    server.setStage(wq::common::TopologyStage::RISK_RPC);
+    if (!server.start()) {
+        return 1;
+    }
+    std::cout << "Serving RiskService on " << server.getAddress()
+              << " (" << server.getQueueCount() << " completion queues)" << std::endl;
+    
+    // Validation latencies and counters for scraping
+    auto& registry = wq::common::metrics();
+    registry.setCounter("risk.validations", [&guardian] {
+        return static_cast<double>(guardian->getValidationCount<uint64_t>());
+    });
+    registry.setCounter("risk.slow_validations", [&guardian] {
+        return static_cast<double>(guardian->getSlowValidationCount());
+    });
+    wq::common::MetricsServer metricsServer(wq::common::MetricsConfig::RISK_GUARDIAN_PORT);
+    if (metricsServer.start()) {
+        std::cout << "Serving metrics on port " << metricsServer.getPort() << std::endl;
+    }
+    
+    // Orders from a co-located submitter arrive over shared memory and their
+    // verdicts go back the same way; otherwise orders are simulated
+    auto orderShm = wq::common::attachColocated<wq::common::OrderShmRing>(
+        wq::common::IpcConfig::ORDER_SEGMENT);
+    auto verdictShm = orderShm
+        ? wq::common::publishColocated<wq::common::VerdictShmRing>(wq::common::IpcConfig::VERDICT_SEGMENT)
+        : nullptr;
+    std::unique_ptr<wq::common::RingConsumer<wq::common::OrderShmRing>> orderBridge;
+    if (orderShm) {
+        orderBridge = std::make_unique<wq::common::RingConsumer<wq::common::OrderShmRing>>(*orderShm,
+            [&guardian, verdicts = verdictShm.get()](wq::common::OrderRecord* records, size_t count) {
+                for (size_t i = 0; i < count; ++i) {
+                    Order order = fromOrderRecord(records[i]);
+                    auto verdict = guardian->checkOrder(order);  // Submitter only needs the mask
+                    if (verdict.approved) {
+                        double qtyChange = order.side == OrderSide::BUY ?
+                            order.quantity : -order.quantity;
+                        guardian->updatePosition(order.symbol.view(), qtyChange, order.price);
+                    }
+                    if (verdicts) {
+                        verdicts->tryPush(toVerdictRecord(order, verdict));
+                    }
+                }
+            });
+        orderBridge->setStage(wq::common::TopologyStage::RISK_BRIDGE);
+        orderBridge->start();
+        std::cout << "Validating orders from shared memory " << orderShm->name() << std::endl;
+    }
+    wq::common::topology().report(std::cout);
+    
     // Simulate order validation
     int orderCount = 0;
+    int64_t lastCheckpointNs = std::chrono::high_resolution_clock::now().time_since_epoch().count();
     while (running) {
+        int64_t nowNs = std::chrono::high_resolution_clock::now().time_since_epoch().count();
+        if (!checkpointPath.empty() && nowNs - lastCheckpointNs >= wq::common::CheckpointConfig::INTERVAL_NS) {
+            writeCheckpoint(nowNs);
+            lastCheckpointNs = nowNs;
+        }
+        
+        if (orderShm) {
+            std::this_thread::sleep_for(std::chrono::seconds(1));
+            std::cout << "Total validations: " << guardian->getValidationCount<uint64_t>() << std::endl;
+            continue;
+        }
+        
         // Create test order
         Order order;
         order.orderId = "Order_" + std::to_string(orderCount++);
-        order.symbol = "AAPL";
+        order.setSymbol("AAPL");
         order.quantity = 100 + (std::rand() % 500);
         order.side = (std::rand() % 2) ? OrderSide::BUY : OrderSide::SELL;
         order.price = 150.0 + (std::rand() % 100) / 10.0;
@@ -66,7 +164,7 @@ int main(int argc, char** argv) {
             // Update position after approval
             double qtyChange = order.side == OrderSide::BUY ? 
                 order.quantity : -order.quantity;
-            guardian->updatePosition(order.symbol, qtyChange, order.price);
+            guardian->updatePosition(order.symbol.view(), qtyChange, order.price);
         } else {
             std::cout << "✗ REJECTED: " << result.reason << std::endl;
             std::cout << "  Violations: ";
@@ -81,6 +179,7 @@ int main(int argc, char** argv) {
             uint64_t validationCount = guardian->getValidationCount<uint64_t>();
             std::cout << "\n=== Statistics ===" << std::endl;
             std::cout << "Total validations: " << validationCount << std::endl;
+            std::cout << "Over 50us budget: " << guardian->getSlowValidationCount() << std::endl;
             
             size_t numPositions;
             double totalExposure;
@@ -92,6 +191,14 @@ int main(int argc, char** argv) {
         std::this_thread::sleep_for(std::chrono::milliseconds(500));
     }
     
+    if (orderBridge) {
+        orderBridge->stop();
+    }
+    if (!checkpointPath.empty()) {
+        writeCheckpoint(std::chrono::high_resolution_clock::now().time_since_epoch().count());
+    }
+    server.shutdown();
+    metricsServer.stop();
     std::cout << "\nService stopped" << std::endl;
     return 0;
 }
@@ -4,104 +4,136 @@
 
 namespace wq::risk {
 
+// Quantity with the order's direction: sells reduce the position
+static double signedQuantity(const Order& order) {
+    return order.side == OrderSide::SELL ? -std::abs(order.quantity) : std::abs(order.quantity);
+}
+
 // FatFingerCheck implementation
 FatFingerCheck::FatFingerCheck(double maxAdvPercentage)
     : maxAdvPercentage_(maxAdvPercentage) {}
 
-bool FatFingerCheck::validate(const Order& order, std::string& reason) const {
-    auto it = advMap_.find(order.symbol);
-    if (it == advMap_.end()) {
+bool FatFingerCheck::check(const Order& order, const RiskState& state) const {
+    double adv = state.adv(order.resolveSymbolId());
+    if (adv <= 0) {
         // No ADV data, cannot validate
         return true;
     }
     
-    double adv = it->second;
     double maxAllowedQty = adv * maxAdvPercentage_;
-    
     if (std::abs(order.quantity) > maxAllowedQty) {
-        reason = "Order quantity " + std::to_string(order.quantity) +
-                " exceeds " + std::to_string(maxAdvPercentage_ * 100) +
-                "% of ADV (" + std::to_string(maxAllowedQty) + ")";
         return false;
     }
     
     return true;
 }
 
-void FatFingerCheck::setADV(std::string_view symbol, double adv) {
-    advMap_[std::string(symbol)] = adv;
+void FatFingerCheck::checkBasket(const BasketView& basket, size_t begin, size_t end,
+                                 ViolationMask* violations) const {
+    // Branch-free so the compiler can vectorize across the basket
+    const ViolationMask bit = violationBit(ViolationType::FAT_FINGER);
+    for (size_t i = begin; i < end; ++i) {
+        double adv = basket.adv[i];
+        bool rejected = adv > 0 && basket.priorQuantity[i] + basket.quantity[i] > adv * maxAdvPercentage_;
+        violations[i] |= bit & -static_cast<ViolationMask>(rejected);
+    }
+}
+
+void FatFingerCheck::describe(const Order& order, const RiskState& state, std::string& reason) const {
+    double maxAllowedQty = state.read([&] { return state.adv(order.resolveSymbolId()); }) * maxAdvPercentage_;
+    reason = "Order quantity " + std::to_string(order.quantity) +
+            " exceeds " + std::to_string(maxAdvPercentage_ * 100) +
+            "% of ADV (" + std::to_string(maxAllowedQty) + ")";
 }
 
 // DrawdownCheck implementation
 DrawdownCheck::DrawdownCheck(double maxDrawdownPercentage)
     : maxDrawdownPercentage_(maxDrawdownPercentage) {}
 
-bool DrawdownCheck::validate(const Order& order, std::string& reason) const {
-    if (startOfDayNAV_ <= 0) {
+bool DrawdownCheck::check(const Order& order, const RiskState& state) const {
+    double startOfDayNAV = state.startOfDayNAV();
+    if (startOfDayNAV <= 0) {
         return true;  // No baseline
     }
     
-    double currentDrawdown = -currentPnL_ / startOfDayNAV_;
+    double currentDrawdown = -state.pnl() / startOfDayNAV;
     
-    if (currentDrawdown > maxDrawdownPercentage_) {
-        // Block buy orders when in drawdown
-        if (order.side == OrderSide::BUY) {
-            reason = "Strategy is in " + 
-                    std::to_string(currentDrawdown * 100) + 
-                    "% drawdown, exceeds limit of " +
-                    std::to_string(maxDrawdownPercentage_ * 100) + "%";
-            return false;
-        }
+    // Block buy orders when in drawdown
+    if (currentDrawdown > maxDrawdownPercentage_ && order.side == OrderSide::BUY) {
+        return false;
     }
     
     return true;
 }
 
-void DrawdownCheck::updatePnL(double currentPnL) {
-    currentPnL_ = currentPnL;
+void DrawdownCheck::checkBasket(const BasketView& basket, size_t begin, size_t end,
+                                ViolationMask* violations) const {
+    // One drawdown for the whole basket; only its buys are blocked
+    bool blocked = basket.startOfDayNAV > 0 && -basket.pnl / basket.startOfDayNAV > maxDrawdownPercentage_;
+    if (!blocked) {
+        return;
+    }
+    const ViolationMask bit = violationBit(ViolationType::DRAWDOWN);
+    for (size_t i = begin; i < end; ++i) {
+        violations[i] |= bit & -static_cast<ViolationMask>(basket.orders[i].side == OrderSide::BUY);
+    }
 }
 
-void DrawdownCheck::updateStartOfDayNAV(double nav) {
-    startOfDayNAV_ = nav;
+void DrawdownCheck::describe(const Order& /*order*/, const RiskState& state, std::string& reason) const {
+    double currentDrawdown = state.read([&] {
+        return state.startOfDayNAV() > 0 ? -state.pnl() / state.startOfDayNAV() : 0.0;
+    });
+    reason = "Strategy is in " + 
+            std::to_string(currentDrawdown * 100) + 
+            "% drawdown, exceeds limit of " +
+            std::to_string(maxDrawdownPercentage_ * 100) + "%";
 }
 
 // ConcentrationCheck implementation
 ConcentrationCheck::ConcentrationCheck(double maxConcentrationPercentage)
     : maxConcentrationPercentage_(maxConcentrationPercentage) {}
 
-bool ConcentrationCheck::validate(const Order& order, std::string& reason) const {
-    if (totalNAV_ <= 0) {
-        return true;  // No NAV data
-    }
-    
+double ConcentrationCheck::concentrationAfter(const Order& order, const RiskState& state) {
     // Calculate position value after this order
-    double currentValue = 0;
-    auto it = positionValues_.find(order.symbol);
-    if (it != positionValues_.end()) {
-        currentValue = it->second;
+    double currentValue = state.positionValue(order.resolveSymbolId());
+    double newValue = currentValue + (signedQuantity(order) * order.price);
+    return std::abs(newValue) / state.nav();
+}
+
+bool ConcentrationCheck::check(const Order& order, const RiskState& state) const {
+    if (state.nav() <= 0) {
+        return true;  // No NAV data
     }
     
-    double newValue = currentValue + (order.quantity * order.price);
-    double concentration = std::abs(newValue) / totalNAV_;
-    
-    if (concentration > maxConcentrationPercentage_) {
-        reason = "Order would result in " +
-                std::to_string(concentration * 100) +
-                "% concentration in " + order.symbol +
-                ", exceeds limit of " +
-                std::to_string(maxConcentrationPercentage_ * 100) + "%";
+    if (concentrationAfter(order, state) > maxConcentrationPercentage_) {
         return false;
     }
     
     return true;
 }
 
-void ConcentrationCheck::updatePosition(std::string_view symbol, double quantity, double value) {
-    positionValues_[std::string(symbol)] = value;
+void ConcentrationCheck::checkBasket(const BasketView& basket, size_t begin, size_t end,
+                                     ViolationMask* violations) const {
+    if (basket.nav <= 0) {
+        return;  // No NAV data
+    }
+    const ViolationMask bit = violationBit(ViolationType::CONCENTRATION);
+    for (size_t i = begin; i < end; ++i) {
+        double value = basket.positionValue[i] + basket.priorNotional[i] + basket.notional[i];
+        bool rejected = std::abs(value) / basket.nav > maxConcentrationPercentage_;
+        violations[i] |= bit & -static_cast<ViolationMask>(rejected);
+    }
 }
 
-void ConcentrationCheck::updateTotalNAV(double nav) {
-    totalNAV_ = nav;
+void ConcentrationCheck::describe(const Order& order, const RiskState& state, std::string& reason) const {
+    double concentration = state.read([&] {
+        return state.nav() > 0 ? concentrationAfter(order, state) : 0.0;
+    });
+    reason = "Order would result in " +
+            std::to_string(concentration * 100) +
+            "% concentration in " + order.symbol.str() +
+            ", exceeds limit of " +
+            std::to_string(maxConcentrationPercentage_ * 100) + "%";
 }
 
 } // namespace wq::risk
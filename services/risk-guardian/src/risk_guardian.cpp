@@ -1,131 +1,542 @@
 #include "risk_guardian.hpp"
+#include "latency.hpp"
 #include <algorithm>
 #include <chrono>
+#include <cmath>
+#include <condition_variable>
+#include <thread>
 
 namespace wq::risk {
 
-// PositionManager implementation
-std::shared_ptr<Position> PositionManager::getPosition(std::string_view symbol) {
-    std::unique_lock<std::shared_mutex> lock(mutex_);
+namespace {
+
+// Per-thread columns of validateBasket(), reused across baskets
+struct BasketScratch {
+    std::vector<SymbolId> symbolIds;
+    std::vector<double> quantity;
+    std::vector<double> notional;
+    std::vector<double> adv;
+    std::vector<double> positionValue;
+    std::vector<double> priorQuantity;
+    std::vector<double> priorNotional;
+    std::vector<ViolationMask> violations;
     
-    std::string symbolStr(symbol);
-    auto it = positions_.find(symbolStr);
+    // Running sums by symbol id, cleared through touched after each basket
+    std::vector<double> symbolQuantity;
+    std::vector<double> symbolNotional;
+    std::vector<SymbolId> touched;          // Distinct symbols of the basket
+    std::vector<double> touchedValue;       // Their position value before it
     
-    if (it == positions_.end()) {
-        // Create new position
-        auto position = std::make_shared<Position>();
-        position->symbol = symbolStr;
-        positions_[symbolStr] = position;
+    void resize(size_t count) {
+        symbolIds.resize(count);
+        quantity.resize(count);
+        notional.resize(count);
+        adv.resize(count);
+        positionValue.resize(count);
+        priorQuantity.resize(count);
+        priorNotional.resize(count);
+        violations.assign(count, 0);
+        touched.clear();
+    }
+};
+
+// Checkpointed row of the position book
+struct PositionRecord {
+    SymbolString symbol;
+    double quantity;
+    double avgCost;
+    double markPrice;
+    double realizedPnL;
+    uint8_t hasMarketPrice;
+};
+
+constexpr const char* CHECKPOINT_SECTION = "risk.positions";
+
+BasketScratch& basketScratch() {
+    thread_local BasketScratch scratch;
+    return scratch;
+}
+
+} // namespace
+
+// PositionManager implementation
+Position PositionManager::getPosition(std::string_view symbol) const {
+    Position position = getPosition(common::findSymbol(symbol));
+    position.symbol = SymbolString(symbol);
+    return position;
+}
+
+Position PositionManager::getPosition(SymbolId symbolId) const {
+    std::shared_lock<std::shared_mutex> lock(mutex_);
+    if (symbolId >= traded_.size() || !traded_[symbolId]) {
+        Position position;
+        position.symbolId = symbolId;
         return position;
     }
-    
-    return it->second;
+    return positionLocked(symbolId);
 }
 
-std::weak_ptr<Position> PositionManager::getPositionWeak(std::string_view symbol) {
-    // Return weak_ptr to avoid circular references
-    return std::weak_ptr<Position>(getPosition(symbol));
+Position PositionManager::positionLocked(SymbolId symbolId) const {
+    Position position;
+    position.symbol = common::symbolTable().name(symbolId);
+    position.symbolId = symbolId;
+    position.quantity = quantity_[symbolId];
+    position.avgCost = avgCost_[symbolId];
+    position.markPrice = markPrice_[symbolId];
+    position.unrealizedPnL = quantity_[symbolId] * (markPrice_[symbolId] - avgCost_[symbolId]);
+    position.realizedPnL = realized_[symbolId];
+    return position;
 }
 
 void PositionManager::updatePosition(std::string_view symbol, double quantity, double price) {
-    auto position = getPosition(symbol);
-    
+    updatePosition(common::internSymbol(symbol), quantity, price);
+}
+
+void PositionManager::updatePosition(SymbolId symbolId, double quantity, double price) {
+    if (symbolId == common::INVALID_SYMBOL_ID || quantity == 0) {
+        return;
+    }
     std::unique_lock<std::shared_mutex> lock(mutex_);
+    reserveLocked(symbolId);
+    if (!traded_[symbolId]) {
+        traded_[symbolId] = 1;
+        tradedIds_.push_back(symbolId);
+        numPositions_.store(tradedIds_.size(), std::memory_order_relaxed);
+    }
+    accumulateLocked(symbolId, -1.0);
     
-    // Update average cost
-    double oldQty = position->quantity;
+    double oldQty = quantity_[symbolId];
     double newQty = oldQty + quantity;
+    double& avgCost = avgCost_[symbolId];
     
-    if (newQty != 0) {
-        position->avgCost = ((oldQty * position->avgCost) + (quantity * price)) / newQty;
+    if (oldQty == 0 || (oldQty > 0) == (quantity > 0)) {
+        // Opening or adding: blend the cost
+        avgCost = ((oldQty * avgCost) + (quantity * price)) / newQty;
     } else {
-        position->avgCost = 0;
+        // Reducing: the closed shares realize PnL against the average cost
+        double closed = std::min(std::abs(quantity), std::abs(oldQty));
+        double pnl = closed * (price - avgCost) * (oldQty > 0 ? 1.0 : -1.0);
+        realized_[symbolId] += pnl;
+        realizedPnL_.store(realizedPnL_.load(std::memory_order_relaxed) + pnl, std::memory_order_relaxed);
+        if (newQty == 0) {
+            avgCost = 0;
+        } else if ((newQty > 0) != (oldQty > 0)) {
+            avgCost = price;  // Flipped: the remainder opens at this fill
+        }
     }
     
-    position->quantity = newQty;
+    quantity_[symbolId] = newQty;
+    if (!hasMarketPrice_[symbolId]) {
+        markPrice_[symbolId] = price;
+    }
+    accumulateLocked(symbolId, 1.0);
+}
+
+void PositionManager::updateMarketPrice(SymbolId symbolId, double price) {
+    if (symbolId == common::INVALID_SYMBOL_ID) {
+        return;
+    }
+    std::unique_lock<std::shared_mutex> lock(mutex_);
+    reserveLocked(symbolId);
+    accumulateLocked(symbolId, -1.0);
+    markPrice_[symbolId] = price;
+    hasMarketPrice_[symbolId] = 1;
+    accumulateLocked(symbolId, 1.0);
 }
 
-std::vector<std::shared_ptr<Position>> PositionManager::getAllPositions() const {
+void PositionManager::reserveLocked(SymbolId symbolId) {
+    if (symbolId < quantity_.size()) {
+        return;
+    }
+    // Ids are dense, so the columns stay close to the number of symbols
+    size_t size = std::max<size_t>(quantity_.size() * 2, 64);
+    while (size <= symbolId) {
+        size *= 2;
+    }
+    quantity_.resize(size);
+    avgCost_.resize(size);
+    markPrice_.resize(size);
+    realized_.resize(size);
+    hasMarketPrice_.resize(size);
+    traded_.resize(size);
+}
+
+void PositionManager::accumulateLocked(SymbolId symbolId, double sign) {
+    double quantity = quantity_[symbolId];
+    if (quantity == 0) {
+        return;
+    }
+    double value = quantity * markPrice_[symbolId];
+    double unrealized = value - quantity * avgCost_[symbolId];
+    grossExposure_.store(grossExposure_.load(std::memory_order_relaxed) + sign * std::abs(value),
+                         std::memory_order_relaxed);
+    netExposure_.store(netExposure_.load(std::memory_order_relaxed) + sign * value,
+                       std::memory_order_relaxed);
+    unrealizedPnL_.store(unrealizedPnL_.load(std::memory_order_relaxed) + sign * unrealized,
+                         std::memory_order_relaxed);
+}
+
+double PositionManager::getPositionValue(SymbolId symbolId) const {
     std::shared_lock<std::shared_mutex> lock(mutex_);
-    
-    std::vector<std::shared_ptr<Position>> result;
-    result.reserve(positions_.size());
-    
-    // Use lambda with std::transform
-    std::transform(positions_.begin(), positions_.end(), std::back_inserter(result),
-        [](const auto& pair) {
-            return pair.second;
-        });
-    
-    return result;
+    return symbolId < quantity_.size() ? quantity_[symbolId] * markPrice_[symbolId] : 0.0;
 }
 
-double PositionManager::calculateTotalExposure() const {
+std::vector<Position> PositionManager::getAllPositions() const {
     std::shared_lock<std::shared_mutex> lock(mutex_);
     
-    double totalExposure = 0.0;
+    std::vector<Position> result;
+    result.reserve(tradedIds_.size());
     
-    // Use lambda with std::for_each
-    std::for_each(positions_.begin(), positions_.end(),
-        [&totalExposure](const auto& pair) {
-            const auto& pos = pair.second;
-            totalExposure += std::abs(pos->quantity * pos->avgCost);
+    // Use lambda with std::transform
+    std::transform(tradedIds_.begin(), tradedIds_.end(), std::back_inserter(result),
+        [this](SymbolId symbolId) {
+            return positionLocked(symbolId);
         });
     
-    return totalExposure;
+    return result;
 }
 
 // Pass by reference
 void PositionManager::getStats(size_t& numPositions, double& totalExposure) const {
-    std::shared_lock<std::shared_mutex> lock(mutex_);
-    numPositions = positions_.size();
-    totalExposure = calculateTotalExposure();
+    numPositions = numPositions_.load(std::memory_order_relaxed);
+    totalExposure = getGrossExposure();
 }
 
 // Pass by pointer with const correctness
 void PositionManager::getStats(size_t* numPositions, double* totalExposure) const {
-    std::shared_lock<std::shared_mutex> lock(mutex_);
-    
     if (numPositions) {
-        *numPositions = positions_.size();
+        *numPositions = numPositions_.load(std::memory_order_relaxed);
     }
     if (totalExposure) {
-        *totalExposure = calculateTotalExposure();
+        *totalExposure = getGrossExposure();
+    }
+}
+
+void PositionManager::checkpoint(common::CheckpointWriter& out) const {
+    std::shared_lock<std::shared_mutex> lock(mutex_);
+    out.write<uint64_t>(tradedIds_.size());
+    for (SymbolId symbolId : tradedIds_) {
+        PositionRecord record{};
+        record.symbol = common::symbolTable().name(symbolId);
+        record.quantity = quantity_[symbolId];
+        record.avgCost = avgCost_[symbolId];
+        record.markPrice = markPrice_[symbolId];
+        record.realizedPnL = realized_[symbolId];
+        record.hasMarketPrice = hasMarketPrice_[symbolId];
+        out.write(record);
     }
 }
 
+size_t PositionManager::restore(common::CheckpointSection& in) {
+    uint64_t count;
+    if (!in.read(count)) {
+        return 0;
+    }
+    std::unique_lock<std::shared_mutex> lock(mutex_);
+    size_t restored = 0;
+    PositionRecord record;
+    for (uint64_t i = 0; i < count && in.read(record); ++i) {
+        SymbolId symbolId = common::symbolTable().internName(record.symbol);
+        if (symbolId == common::INVALID_SYMBOL_ID) {
+            continue;
+        }
+        reserveLocked(symbolId);
+        if (!traded_[symbolId]) {
+            traded_[symbolId] = 1;
+            tradedIds_.push_back(symbolId);
+        }
+        accumulateLocked(symbolId, -1.0);
+        double realized = record.realizedPnL - realized_[symbolId];
+        realizedPnL_.store(realizedPnL_.load(std::memory_order_relaxed) + realized, std::memory_order_relaxed);
+        quantity_[symbolId] = record.quantity;
+        avgCost_[symbolId] = record.avgCost;
+        markPrice_[symbolId] = record.markPrice;
+        realized_[symbolId] = record.realizedPnL;
+        hasMarketPrice_[symbolId] = record.hasMarketPrice;
+        accumulateLocked(symbolId, 1.0);
+        ++restored;
+    }
+    numPositions_.store(tradedIds_.size(), std::memory_order_relaxed);
+    return restored;
+}
+
+// Parts 1..n-1 of a split basket run on helper threads while the caller
+// runs part 0. The job is passed as a function pointer and a context, so
+// a basket costs two wakeups and no allocation once enough helpers exist.
+class BasketHelpers {
+public:
+    BasketHelpers() = default;
+    
+    ~BasketHelpers() {
+        {
+            std::lock_guard<std::mutex> lock(mutex_);
+            stopping_ = true;
+        }
+        start_.notify_all();
+        for (auto& thread : threads_) {
+            thread.join();
+        }
+    }
+    
+    BasketHelpers(const BasketHelpers&) = delete;
+    BasketHelpers& operator=(const BasketHelpers&) = delete;
+    
+    // work(part) for every part below parts; returns once all are done
+    template<typename Work>
+    void run(size_t parts, Work& work) {
+        while (threads_.size() + 1 < parts) {
+            // Starts waiting for the next job, not the one before it
+            threads_.emplace_back([this, part = threads_.size() + 1, seen = generation_] { loop(part, seen); });
+        }
+        {
+            std::lock_guard<std::mutex> lock(mutex_);
+            job_ = [](void* context, size_t part) { (*static_cast<Work*>(context))(part); };
+            context_ = &work;
+            parts_ = parts;
+            pending_ = parts - 1;
+            ++generation_;
+        }
+        start_.notify_all();
+        work(0);
+        std::unique_lock<std::mutex> lock(mutex_);
+        done_.wait(lock, [this] { return pending_ == 0; });
+    }
+
+private:
+    std::vector<std::thread> threads_;    // Thread i runs part i + 1
+    std::mutex mutex_;
+    std::condition_variable start_;
+    std::condition_variable done_;
+    void (*job_)(void*, size_t){nullptr};
+    void* context_{nullptr};
+    size_t parts_{0};
+    size_t pending_{0};
+    uint64_t generation_{0};
+    bool stopping_{false};
+    
+    void loop(size_t part, uint64_t seen) {
+        std::unique_lock<std::mutex> lock(mutex_);
+        while (true) {
+            start_.wait(lock, [&] { return stopping_ || generation_ != seen; });
+            if (stopping_) {
+                return;
+            }
+            seen = generation_;
+            if (part >= parts_) {
+                continue;  // Basket split fewer ways than there are helpers
+            }
+            auto job = job_;
+            void* context = context_;
+            lock.unlock();
+            job(context, part);
+            lock.lock();
+            if (--pending_ == 0) {
+                done_.notify_one();
+            }
+        }
+    }
+};
+
 // RiskGuardian private constructor
 RiskGuardian::RiskGuardian(double initialNAV)
-    : currentNAV_(initialNAV) {}
+    : riskState_(std::make_unique<RiskState>())
+    , currentNAV_(initialNAV) {
+    RiskState::WriteScope write(*riskState_);
+    riskState_->setStartOfDayNAV(initialNAV);
+    riskState_->setNAV(initialNAV);
+}
+
+RiskGuardian::~RiskGuardian() = default;
 
 RiskCheckResult RiskGuardian::validateOrder(const Order& order) {
+    RiskVerdict verdict = checkOrder(order);
+    if (verdict.approved) {
+        return RiskCheckResult();
+    }
+    return explainVerdict(order, verdict);
+}
+
+RiskVerdict RiskGuardian::checkOrder(const Order& order) {
     // Measure validation time for 50µs requirement
-    auto startTime = std::chrono::high_resolution_clock::now();
+    static common::LatencyProbe& probe = common::latencyProbe("risk.check");
+    uint64_t startTicks = common::TscClock::now();
+    
+    validationCount_.fetch_add(1, std::memory_order_relaxed);
+    
+    // Run all risk checks against one version of the risk state
+    RiskVerdict verdict;
+    verdict.violations = checkAggregator_.checkAll(order, *riskState_);
+    verdict.approved = verdict.violations == 0;
+    
+    if (verdict.approved) {
+        approvedCount_.fetch_add(1, std::memory_order_relaxed);
+    } else {
+        rejectedCount_.fetch_add(1, std::memory_order_relaxed);
+    }
+    
+    uint64_t elapsedNs = common::TscClock::elapsedNs(startTicks);
+    probe.record(elapsedNs);
+    
+    // Count overruns of the 50µs target; the caller still gets its verdict
+    if (elapsedNs > static_cast<uint64_t>(RiskLimits::MAX_VALIDATION_TIME_NS)) {
+        slowValidationCount_.fetch_add(1, std::memory_order_relaxed);
+    }
+    
+    return verdict;
+}
+
+RiskCheckResult RiskGuardian::explainVerdict(const Order& order, const RiskVerdict& verdict) const {
+    RiskCheckResult result;
+    checkAggregator_.describeAll(order, *riskState_, verdict.violations, result);
+    return result;
+}
+
+BasketResult RiskGuardian::validateBasket(const Order* orders, size_t count, RiskVerdict* verdicts,
+                                         size_t threads) {
+    static common::LatencyProbe& probe = common::latencyProbe("risk.basket");
+    common::ScopedLatency latency(probe);
+    BasketResult result;
+    if (count == 0) {
+        return result;
+    }
+    BasketScratch& scratch = basketScratch();
+    scratch.resize(count);
     
-    validationCount_++;
+    // Order columns, and what earlier orders add in the same symbol
+    for (size_t i = 0; i < count; ++i) {
+        const Order& order = orders[i];
+        SymbolId symbolId = order.resolveSymbolId();
+        double quantity = std::abs(order.quantity);
+        double notional = (order.side == OrderSide::SELL ? -quantity : quantity) * order.price;
+        scratch.symbolIds[i] = symbolId;
+        scratch.quantity[i] = quantity;
+        scratch.notional[i] = notional;
+        result.grossNotional += std::abs(notional);
+        
+        if (symbolId >= RiskState::CAPACITY) {
+            scratch.priorQuantity[i] = 0;  // Unknown symbol: no state to add up against
+            scratch.priorNotional[i] = 0;
+            continue;
+        }
+        if (symbolId >= scratch.symbolQuantity.size()) {
+            scratch.symbolQuantity.resize(symbolId + 1, 0.0);
+            scratch.symbolNotional.resize(symbolId + 1, 0.0);
+        }
+        double& symbolQuantity = scratch.symbolQuantity[symbolId];
+        double& symbolNotional = scratch.symbolNotional[symbolId];
+        if (symbolQuantity == 0 && quantity > 0) {
+            scratch.touched.push_back(symbolId);
+        }
+        scratch.priorQuantity[i] = symbolQuantity;
+        scratch.priorNotional[i] = symbolNotional;
+        symbolQuantity += quantity;
+        symbolNotional += notional;
+    }
+    scratch.touchedValue.resize(scratch.touched.size());
     
-    std::lock_guard<std::mutex> lock(validationMutex_);
+    // State columns, all from one version. A large basket may keep losing to
+    // a busy writer, so after a few tries writers are paused for the gather.
+    BasketView view;
+    double grossExposure = 0;
+    double netExposure = 0;
+    auto gather = [&] {
+        const RiskState& state = *riskState_;
+        for (size_t i = 0; i < count; ++i) {
+            scratch.adv[i] = state.adv(scratch.symbolIds[i]);
+            scratch.positionValue[i] = state.positionValue(scratch.symbolIds[i]);
+        }
+        for (size_t k = 0; k < scratch.touched.size(); ++k) {
+            scratch.touchedValue[k] = state.positionValue(scratch.touched[k]);
+        }
+        view.nav = state.nav();
+        view.startOfDayNAV = state.startOfDayNAV();
+        view.pnl = state.pnl();
+        grossExposure = state.grossExposure();
+        netExposure = state.netExposure();
+        result.stateVersion = state.version();
+    };
+    if (!riskState_->tryRead(gather, GuardianConfig::BASKET_READ_ATTEMPTS)) {
+        std::lock_guard<std::mutex> lock(stateWriteMutex_);
+        gather();
+    }
     
-    // Run all risk checks
-    auto result = checkAggregator_.validateAll(order);
+    view.orders = orders;
+    view.count = count;
+    view.quantity = scratch.quantity.data();
+    view.notional = scratch.notional.data();
+    view.adv = scratch.adv.data();
+    view.positionValue = scratch.positionValue.data();
+    view.priorQuantity = scratch.priorQuantity.data();
+    view.priorNotional = scratch.priorNotional.data();
+    ViolationMask* violations = scratch.violations.data();
     
-    if (result.approved) {
-        approvedCount_++;
+    // Orders are independent once the prior columns are known, so the
+    // basket splits into contiguous ranges with no shared writes
+    size_t workers = std::min(threads, count / GuardianConfig::MIN_BASKET_ORDERS_PER_THREAD);
+    std::unique_lock<std::mutex> helpersLock(basketHelpersMutex_, std::defer_lock);
+    if (workers <= 1 || !helpersLock.try_lock()) {
+        checkAggregator_.checkBasket(view, 0, count, violations);
     } else {
-        rejectedCount_++;
+        size_t chunk = (count + workers - 1) / workers;
+        auto checkPart = [&](size_t part) {
+            size_t begin = std::min(part * chunk, count);
+            checkAggregator_.checkBasket(view, begin, std::min(begin + chunk, count), violations);
+        };
+        if (!basketHelpers_) {
+            basketHelpers_ = std::make_unique<BasketHelpers>();
+        }
+        basketHelpers_->run(workers, checkPart);
     }
     
-    auto endTime = std::chrono::high_resolution_clock::now();
-    auto duration = std::chrono::duration_cast<std::chrono::nanoseconds>(endTime - startTime);
+    for (size_t i = 0; i < count; ++i) {
+        verdicts[i].violations = violations[i];
+        verdicts[i].approved = violations[i] == 0;
+        result.approved += verdicts[i].approved;
+    }
+    result.rejected = count - result.approved;
     
-    // Log if exceeds 50µs target
-    if (duration.count() > RiskLimits::MAX_VALIDATION_TIME_NS) {
-        // Would log warning in production
+    // Book exposure with the basket's symbols moved by its full notional
+    result.grossExposureAfter = grossExposure;
+    result.netExposureAfter = netExposure;
+    for (size_t k = 0; k < scratch.touched.size(); ++k) {
+        SymbolId symbolId = scratch.touched[k];
+        double before = scratch.touchedValue[k];
+        double added = scratch.symbolNotional[symbolId];
+        result.grossExposureAfter += std::abs(before + added) - std::abs(before);
+        result.netExposureAfter += added;
+        scratch.symbolQuantity[symbolId] = 0;
+        scratch.symbolNotional[symbolId] = 0;
     }
     
+    validationCount_.fetch_add(count, std::memory_order_relaxed);
+    approvedCount_.fetch_add(result.approved, std::memory_order_relaxed);
+    rejectedCount_.fetch_add(result.rejected, std::memory_order_relaxed);
     return result;
 }
 
+void RiskGuardian::attachOrderInput(OrderRing& ring, OrderResultCallback callback) {
+    detachOrderInput();
+    orderConsumer_ = std::make_unique<common::RingConsumer<OrderRing>>(ring,
+        [this, callback = std::move(callback)](Order* orders, size_t count) {
+            for (size_t i = 0; i < count; ++i) {
+                auto result = validateOrder(orders[i]);
+                if (callback) {
+                    callback(orders[i], result);
+                }
+            }
+        });
+    orderConsumer_->setStage(common::TopologyStage::RISK_INPUT);
+    common::topology().place("risk.input ring", &ring, sizeof(ring), common::TopologyStage::RISK_INPUT);
+    orderConsumer_->start();
+}
+
+void RiskGuardian::detachOrderInput() {
+    if (orderConsumer_) {
+        orderConsumer_->stop();  // Validates what is already queued
+        orderConsumer_.reset();
+    }
+}
+
 // Function overloading
 RiskCheckResult RiskGuardian::validateOrder(
     std::string_view symbol,
@@ -134,7 +545,7 @@ RiskCheckResult RiskGuardian::validateOrder(
     double price) {
     
     Order order;
-    order.symbol = symbol;
+    order.setSymbol(symbol);
     order.quantity = quantity;
     order.side = side;
     order.price = price;
@@ -144,12 +555,54 @@ RiskCheckResult RiskGuardian::validateOrder(
 }
 
 void RiskGuardian::updatePosition(std::string_view symbol, double executedQty, double executedPrice) {
-    positionManager_.updatePosition(symbol, executedQty, executedPrice);
+    SymbolId symbolId = common::internSymbol(symbol);
+    std::lock_guard<std::mutex> lock(stateWriteMutex_);
+    positionManager_.updatePosition(symbolId, executedQty, executedPrice);
+    publishPositionLocked(symbolId);
 }
 
 void RiskGuardian::updateMarketPrice(std::string_view symbol, double price) {
-    std::unique_lock<std::shared_mutex> lock(pricesMutex_);
-    marketPrices_[std::string(symbol)] = price;
+    SymbolId symbolId = common::internSymbol(symbol);
+    std::lock_guard<std::mutex> lock(stateWriteMutex_);
+    positionManager_.updateMarketPrice(symbolId, price);
+    publishPositionLocked(symbolId);
+}
+
+void RiskGuardian::setADV(std::string_view symbol, double adv) {
+    SymbolId symbolId = common::internSymbol(symbol);
+    std::lock_guard<std::mutex> lock(stateWriteMutex_);
+    RiskState::WriteScope write(*riskState_);
+    riskState_->setADV(symbolId, adv);
+}
+
+void RiskGuardian::checkpoint(common::CheckpointWriter& out) const {
+    out.beginSection(CHECKPOINT_SECTION);
+    positionManager_.checkpoint(out);
+    out.endSection();
+}
+
+size_t RiskGuardian::restoreCheckpoint(const common::CheckpointReader& in) {
+    std::lock_guard<std::mutex> lock(stateWriteMutex_);
+    size_t restored = 0;
+    for (auto section : in.sections(CHECKPOINT_SECTION)) {
+        restored += positionManager_.restore(section);
+    }
+    for (const auto& position : positionManager_.getAllPositions()) {
+        publishPositionLocked(position.symbolId);
+    }
+    return restored;
+}
+
+void RiskGuardian::publishPositionLocked(SymbolId symbolId) {
+    // Gather first so the write section is only the stores readers wait on
+    double value = positionManager_.getPositionValue(symbolId);
+    double pnl = positionManager_.getRealizedPnL() + positionManager_.getUnrealizedPnL();
+    
+    RiskState::WriteScope write(*riskState_);
+    riskState_->setPositionValue(symbolId, value);
+    riskState_->setPnL(pnl);
+    riskState_->setNAV(currentNAV_ + pnl);
+    riskState_->setExposure(positionManager_.getGrossExposure(), positionManager_.getNetExposure());
 }
 
 double RiskGuardian::calculateOrderValue(const Order& order) const {
@@ -0,0 +1,99 @@
+#include "risk_service.hpp"
+
+namespace wq::risk {
+
+namespace {
+
+// Per polling thread, reused across basket calls
+struct BasketBuffers {
+    std::vector<Order> orders;
+    std::vector<RiskVerdict> verdicts;
+};
+
+BasketBuffers& basketBuffers() {
+    thread_local BasketBuffers buffers;
+    return buffers;
+}
+
+} // namespace
+
+Order fromOrderRequest(const proto::OrderRequest& request) {
+    Order order;
+    order.orderId = OrderIdString(request.order_id());
+    order.setSymbol(request.symbol());
+    order.quantity = request.quantity();
+    order.side = request.side() == "SELL" ? OrderSide::SELL : OrderSide::BUY;
+    order.price = request.price();
+    order.timestampNs = request.timestamp_ns();
+    return order;
+}
+
+void toProto(const RiskVerdict& verdict, const RiskCheckResult* reasons, proto::RiskCheckResult* result) {
+    result->set_approved(verdict.approved);
+    result->set_violation_mask(verdict.violations);
+    if (!reasons) {
+        return;
+    }
+    result->set_reason(reasons->reason);
+    for (ViolationType violation : reasons->violations) {
+        std::string_view name = violationTypeToString(violation);
+        result->add_violations(name.data(), name.size());
+    }
+}
+
+RiskServiceImpl::RiskServiceImpl(common::AsyncServer& server, RiskGuardian& guardian)
+    : guardian_(guardian)
+    , validateOrder_(server, service_, &AsyncService::RequestValidateOrder,
+                     [this](const proto::OrderRequest& request, proto::RiskCheckResult& result) {
+                         return validateOrder(request, result);
+                     })
+    , validateBasket_(server, service_, &AsyncService::RequestValidateBasket,
+                      [this](const proto::BasketRequest& request, proto::BasketResult& result) {
+                          return validateBasket(request, result);
+                      }) {
+    server.addService(&service_);
+}
+
+grpc::Status RiskServiceImpl::validateOrder(const proto::OrderRequest& request, proto::RiskCheckResult& result) {
+    Order order = fromOrderRequest(request);
+    RiskVerdict verdict = guardian_.checkOrder(order);
+    if (verdict.approved) {
+        toProto(verdict, nullptr, &result);
+    } else {
+        RiskCheckResult reasons = guardian_.explainVerdict(order, verdict);
+        toProto(verdict, &reasons, &result);
+    }
+    return grpc::Status::OK;
+}
+
+grpc::Status RiskServiceImpl::validateBasket(const proto::BasketRequest& request, proto::BasketResult& result) {
+    BasketBuffers& buffers = basketBuffers();
+    size_t count = static_cast<size_t>(request.orders_size());
+    buffers.orders.resize(count);
+    buffers.verdicts.resize(count);
+    for (size_t i = 0; i < count; ++i) {
+        buffers.orders[i] = fromOrderRequest(request.orders(static_cast<int>(i)));
+    }
+    
+    BasketResult basket = guardian_.validateBasket(buffers.orders.data(), count, buffers.verdicts.data());
+    
+    result.set_basket_id(request.basket_id());
+    result.mutable_results()->Reserve(static_cast<int>(count));
+    for (size_t i = 0; i < count; ++i) {
+        const RiskVerdict& verdict = buffers.verdicts[i];
+        if (verdict.approved) {
+            toProto(verdict, nullptr, result.add_results());
+        } else {
+            RiskCheckResult reasons = guardian_.explainVerdict(buffers.orders[i], verdict);
+            toProto(verdict, &reasons, result.add_results());
+        }
+    }
+    result.set_num_approved(static_cast<uint32_t>(basket.approved));
+    result.set_gross_notional(basket.grossNotional);
+    result.set_gross_exposure_after(basket.grossExposureAfter);
+    result.set_net_exposure_after(basket.netExposureAfter);
+    result.set_state_version(basket.stateVersion);
+    return grpc::Status::OK;
+}
+
+} // namespace wq::risk
@@ -0,0 +1,38 @@
+#pragma once
+
+#include "async_server.hpp"
+#include "signal_aggregator.hpp"
+#include "portfolio.grpc.pb.h"
+
+namespace wq::aggregator {
+
+void toProto(const TargetPosition& position, proto::TargetPosition* out);
+
+// PortfolioService on the async server. StreamTargetPortfolio starts each
+// subscriber with the full portfolio, then sends the deltas handed to
+// publishDelta(), merged per symbol while the subscriber is behind.
+// GetTargetPortfolio answers from the published snapshot when there is one.
+class PortfolioServiceImpl {
+public:
+    using AsyncService = proto::PortfolioService::AsyncService;
+
+    // Registers with server, which must not have started yet
+    PortfolioServiceImpl(common::AsyncServer& server, SignalAggregator& aggregator);
+
+    // Changed positions, e.g. from generatePortfolioDelta(), from one thread
+    void publishDelta(const std::vector<TargetPosition>& delta);
+
+    size_t getSubscriberCount() const { return stream_.getSubscriberCount(); }
+    uint64_t getConflatedCount() const { return stream_.getConflatedCount(); }
+
+private:
+    SignalAggregator& aggregator_;
+    AsyncService service_;
+    common::UnaryMethod<AsyncService, proto::PortfolioRequest, proto::TargetPortfolio> getPortfolio_;
+    common::StreamPublisher<AsyncService, proto::PortfolioRequest, proto::TargetPortfolio, proto::TargetPosition> stream_;
+    common::CallArena stagingArena_;  // Converted delta of one publishDelta(), shared by all subscribers
+
+    grpc::Status getTargetPortfolio(const proto::PortfolioRequest& request, proto::TargetPortfolio& portfolio);
+};
+
+} // namespace wq::aggregator
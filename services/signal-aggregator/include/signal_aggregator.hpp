@@ -1,6 +1,16 @@
 #pragma once
 
+#include "checkpoint.hpp"
+#include "fixed_string.hpp"
+#include "ipc_transport.hpp"
+#include "ring_buffer.hpp"
+#include "ring_consumer.hpp"
+#include "symbol_table.hpp"
+#include <atomic>
+#include <cstdint>
+#include <limits>
 #include <string>
+#include <string_view>
 #include <vector>
 #include <memory>
 #include <optional>
@@ -9,21 +19,159 @@
 
 namespace wq::aggregator {
 
-// Signal from alpha engine
+using common::AlphaIdString;
+using common::AlphaIndex;
+using common::SymbolId;
+using common::SymbolString;
+
+// Constexpr configuration
+namespace AggregatorConfig {
+    constexpr double MIN_CONFIDENCE_THRESHOLD = 0.3;
+    constexpr int MAX_SIGNALS_PER_SYMBOL = 1000;
+    constexpr int64_t SIGNAL_EXPIRY_NS = 60000000000LL;  // 60 seconds
+    constexpr size_t SIGNAL_RING_CAPACITY = 65536;  // Signals buffered from the alpha engine
+    constexpr size_t TARGET_RING_CAPACITY = 4096;   // Targets buffered for risk
+    constexpr size_t MIN_LATEST_COLUMNS = 64;       // Initial alpha columns per latest-signal row
+    constexpr size_t NUM_SHARDS = 64;               // Symbol shards, each with its own lock
+    constexpr double DEFAULT_TRIM_FRACTION = 0.1;   // Share of signals cut from each tail
+    static_assert((NUM_SHARDS & (NUM_SHARDS - 1)) == 0 && NUM_SHARDS <= 64,
+                  "shards are a power of two, tracked in one 64-bit dirty mask");
+}
+
+// How signals are kept per symbol
+enum class SignalStorageMode : uint8_t {
+    HISTORY,            // Every signal, up to MAX_SIGNALS_PER_SYMBOL
+    LATEST_PER_ALPHA    // Only the newest signal of each alpha, in a dense slot
+};
+
+// Signal from alpha engine - identifiers inline, no heap allocation
 struct AlphaSignal {
-    std::string alphaId;
-    std::string symbol;
-    double signal;
-    double confidence;
-    int64_t timestampNs;
+    AlphaIdString alphaId;
+    AlphaIndex alphaIndex{common::INVALID_ALPHA_INDEX};
+    SymbolString symbol;
+    SymbolId symbolId{common::INVALID_SYMBOL_ID};
+    double signal{0};
+    double confidence{0};
+    int64_t timestampNs{0};
+    
+    // Set symbol and its interned id together
+    void setSymbol(std::string_view name) {
+        symbol = SymbolString(name);
+        symbolId = common::internSymbol(name);
+    }
+    
+    // Set alpha id and its interned index together
+    void setAlphaId(std::string_view name) {
+        alphaId = AlphaIdString(name);
+        alphaIndex = common::internAlphaId(name);
+    }
+};
+
+// Latest signal of one alpha for one symbol. An empty slot has zero signal
+// and confidence, so reductions can run over a whole row without a branch.
+struct SignalSlot {
+    static constexpr int64_t EMPTY = std::numeric_limits<int64_t>::min();
+    
+    double signal{0};
+    double confidence{0};
+    int64_t timestampNs{EMPTY};
+    
+    bool empty() const { return timestampNs == EMPTY; }
+};
+
+// Symbols x alphas matrix of latest signals: one contiguous row per symbol,
+// one column per interned alpha index, SignalSlot-sized cells. Columns grow
+// by doubling the row stride as new alphas appear.
+class LatestSignalTable {
+public:
+    uint32_t addRow();
+    
+    // Slot for an alpha, widening every row first if the index is new
+    SignalSlot& slot(uint32_t row, AlphaIndex alpha);
+    
+    SignalSlot* row(uint32_t row) { return slots_.data() + row * stride_; }
+    const SignalSlot* row(uint32_t row) const { return slots_.data() + row * stride_; }
+    
+    // Columns in use: highest alpha index seen + 1
+    size_t numColumns() const { return columns_; }
+    size_t numRows() const { return rows_; }
+    size_t memoryBytes() const { return slots_.capacity() * sizeof(SignalSlot); }
+
+private:
+    std::vector<SignalSlot> slots_;
+    size_t stride_{0};
+    size_t columns_{0};
+    size_t rows_{0};
+    
+    void widen(size_t columns);
 };
 
 // Target position for portfolio
 struct TargetPosition {
-    std::string symbol;
-    double targetQuantity;
-    double currentQuantity;
-    int64_t timestampNs;
+    SymbolString symbol;
+    SymbolId symbolId{common::INVALID_SYMBOL_ID};
+    double targetQuantity{0};
+    double currentQuantity{0};
+    int64_t timestampNs{0};
+};
+
+// Co-located IPC conversions: alpha signals in, targets out
+inline AlphaSignal fromSignalRecord(const common::SignalRecord& record) {
+    AlphaSignal signal;
+    signal.alphaId = record.alphaId;
+    signal.alphaIndex = common::alphaIdTable().internName(record.alphaId);
+    signal.symbol = record.symbol;
+    signal.symbolId = common::symbolTable().internName(record.symbol);
+    signal.signal = record.signal;
+    signal.confidence = record.confidence;
+    signal.timestampNs = record.timestampNs;
+    return signal;
+}
+
+inline common::TargetRecord toTargetRecord(const TargetPosition& position) {
+    common::TargetRecord record{};
+    record.symbol = position.symbol;
+    record.targetQuantity = position.targetQuantity;
+    record.currentQuantity = position.currentQuantity;
+    record.timestampNs = position.timestampNs;
+    return record;
+}
+
+// Running median of a multiset of values that changes one value at a time.
+// Two heaps split the values at the median: a max-heap of the lower half
+// and a min-heap of the upper half, sized to differ by at most one. Erased
+// values are queued in a deletion heap per half and dropped once they reach
+// the top, with a compaction if they pile up below it. Insert and erase are
+// O(log n) and median() is O(1); storage is reused once warmed up.
+class StreamingMedian {
+public:
+    void insert(double value);
+    
+    // value must be one that was inserted and not yet erased
+    void erase(double value);
+    
+    // 0 if empty
+    double median() const;
+    
+    size_t size() const { return lowerSize_ + upperSize_; }
+    bool empty() const { return size() == 0; }
+
+private:
+    std::vector<double> lower_;         // Max-heap
+    std::vector<double> upper_;         // Min-heap
+    std::vector<double> lowerErased_;   // Max-heap of erased values still in lower_
+    std::vector<double> upperErased_;   // Min-heap of erased values still in upper_
+    size_t lowerSize_{0};               // Live values in each half
+    size_t upperSize_{0};
+    
+    void rebalance();
+    
+    // Pop erased values off the top of each half
+    void prune();
+    
+    // Rebuild a half without its erased values
+    template<typename Compare>
+    static void compact(std::vector<double>& heap, std::vector<double>& erased, Compare compare);
 };
 
 // Abstract signal aggregation strategy
@@ -34,7 +182,23 @@ public:
     // Pure virtual function for aggregating signals
     virtual double aggregate(const std::vector<AlphaSignal>& signals) const = 0;
     
+    // Aggregate one row of latest signals, empty slots included. The default
+    // gathers the filled slots and calls aggregate().
+    virtual double aggregateLatest(const SignalSlot* slots, size_t count) const;
+    
     virtual std::string_view getStrategyName() const = 0;
+    
+    // Strategies whose result is sum(weight * signal) / sum(weight) over the
+    // stored signals can be maintained as running sums instead of re-running
+    // aggregate(). They return true here and the weight of a single signal
+    // from weight(), 0 to leave it out.
+    virtual bool isIncremental() const { return false; }
+    virtual double weight(double /*signal*/, double /*confidence*/) const { return 0.0; }
+    
+    // Strategies whose result is the median of the stored signals can be
+    // tracked by a StreamingMedian per symbol. They return true here and use
+    // weight() to pick the signals that count (any non-zero weight).
+    virtual bool isStreamingMedian() const { return false; }
 };
 
 // Weighted average aggregation
@@ -44,7 +208,13 @@ public:
     ~WeightedAverageAggregation() override = default;
     
     double aggregate(const std::vector<AlphaSignal>& signals) const override;
+    double aggregateLatest(const SignalSlot* slots, size_t count) const override;
     std::string_view getStrategyName() const override { return "WeightedAverage"; }
+    
+    bool isIncremental() const override { return true; }
+    double weight(double /*signal*/, double confidence) const override {
+        return confidence >= AggregatorConfig::MIN_CONFIDENCE_THRESHOLD ? confidence : 0.0;
+    }
 };
 
 // Median aggregation (robust to outliers)
@@ -54,13 +224,76 @@ public:
     ~MedianAggregation() override = default;
     
     double aggregate(const std::vector<AlphaSignal>& signals) const override;
+    double aggregateLatest(const SignalSlot* slots, size_t count) const override;
     std::string_view getStrategyName() const override { return "Median"; }
 };
 
-// Signal aggregator service
+// Median maintained as signals arrive and expire, instead of re-selected on
+// every refresh. Same result as MedianAggregation when used by the
+// aggregator; aggregate() alone falls back to selection.
+class StreamingMedianAggregation : public MedianAggregation {
+public:
+    StreamingMedianAggregation() = default;
+    ~StreamingMedianAggregation() override = default;
+    
+    std::string_view getStrategyName() const override { return "StreamingMedian"; }
+    
+    bool isStreamingMedian() const override { return true; }
+    double weight(double signal, double confidence) const override {
+        return confidence >= AggregatorConfig::MIN_CONFIDENCE_THRESHOLD && signal != 0.0 ? 1.0 : 0.0;
+    }
+};
+
+// Mean of the signals left after dropping trimFraction of them from each
+// tail: robust to a few broken alphas like the median, at the same O(n)
+// selection cost but using more of the data
+class TrimmedMeanAggregation : public IAggregationStrategy {
+public:
+    // trimFraction is clamped to [0, 0.5)
+    explicit TrimmedMeanAggregation(double trimFraction = AggregatorConfig::DEFAULT_TRIM_FRACTION);
+    ~TrimmedMeanAggregation() override = default;
+    
+    double aggregate(const std::vector<AlphaSignal>& signals) const override;
+    double aggregateLatest(const SignalSlot* slots, size_t count) const override;
+    std::string_view getStrategyName() const override { return "TrimmedMean"; }
+    
+    double getTrimFraction() const { return trimFraction_; }
+
+private:
+    double trimFraction_;
+    
+    // Trimmed mean of values, reordering them
+    double trimmedMean(std::vector<double>& values) const;
+};
+
+// Inter-stage transport. Signals come in over SignalRing. Targets go out
+// over TargetRing to whatever turns them into orders (the EMS). Risk sees
+// only those orders, on its own OrderRing (risk::Order records), so no ring
+// links the aggregator to risk directly.
+using SignalRing = common::MpmcRing<AlphaSignal, AggregatorConfig::SIGNAL_RING_CAPACITY>;
+using TargetRing = common::SpscRing<TargetPosition, AggregatorConfig::TARGET_RING_CAPACITY>;
+
+// Published target portfolio, immutable once built
+struct PortfolioSnapshot {
+    std::vector<TargetPosition> positions;
+    int64_t timestampNs{0};
+    uint64_t version{0};                // Increases with every published snapshot
+};
+
+// Signal aggregator service.
+//
+// Symbols are spread over NUM_SHARDS shards by interned id, each with its own
+// lock, stored signals, latest-signal table and dirty list, so writers on
+// different symbols never contend and a portfolio refresh holds one shard
+// at a time. Full portfolios are also published as immutable snapshots that
+// readers pick up without taking any shard lock. The strategy is called from
+// every shard concurrently, so it must be safe to share.
 class SignalAggregator {
 public:
-    explicit SignalAggregator(std::unique_ptr<IAggregationStrategy> strategy);
+    // LATEST_PER_ALPHA bounds memory to symbols x alphas x sizeof(SignalSlot)
+    // and counts each alpha once, however often it repeats itself
+    explicit SignalAggregator(std::unique_ptr<IAggregationStrategy> strategy,
+                              SignalStorageMode mode = SignalStorageMode::HISTORY);
     
     // Move only
     SignalAggregator(SignalAggregator&&) noexcept = default;
@@ -73,26 +306,135 @@ public:
     // Add signal
     void addSignal(AlphaSignal&& signal);
     
-    // Generate target portfolio
+    // Add a batch of signals, locking once per run of signals on one shard
+    void addSignals(AlphaSignal* signals, size_t count);
+    
+    // Drain signals from a ring on a dedicated thread until detachInput().
+    // The ring must outlive the aggregator. The thread and the ring are
+    // placed as the topology's aggregator.input stage.
+    void attachInput(SignalRing& ring);
+    void detachInput();
+    
+    // Generate target portfolio, locking one shard at a time
     std::vector<TargetPosition> generateTargetPortfolio();
     
-    // Get aggregated signal for a symbol
+    // Generate the target portfolio into a ring; returns the number of
+    // positions that fit
+    size_t publishTargetPortfolio(TargetRing& ring);
+    
+    // Build the portfolio and publish it as the snapshot readers see
+    std::shared_ptr<const PortfolioSnapshot> refreshPortfolioSnapshot();
+    
+    // Last snapshot published by refreshPortfolioSnapshot(), nullptr before
+    // the first. Takes no shard lock, so readers never wait for writers.
+    std::shared_ptr<const PortfolioSnapshot> getPortfolioSnapshot() const;
+    
+    // Positions whose target changed since the previous delta, for the
+    // delta stream after a full snapshot. Only symbols touched since then
+    // are visited, so the cost follows the update rate, not the universe.
+    std::vector<TargetPosition> generatePortfolioDelta();
+    
+    // Delta into a ring; positions that do not fit stay pending for the
+    // next call. Returns the number published.
+    size_t publishPortfolioDelta(TargetRing& ring);
+    
+    // Get aggregated signal for a symbol. The name is looked up in the
+    // intern table as a fixed string, so neither overload allocates.
     std::optional<double> getAggregatedSignal(std::string_view symbol) const;
+    std::optional<double> getAggregatedSignal(SymbolId symbolId) const;
     
     // Clear old signals
     void clearSignalsOlderThan(int64_t timestampNs);
+    
+    // Write the stored signals and the last target sent for every symbol,
+    // one section per shard, locking one shard at a time. The watermark is
+    // the newest signal timestamp, which follows the ticks behind it.
+    void checkpoint(common::CheckpointWriter& out) const;
+    
+    // Re-add the signals and published targets of a checkpoint, so the next
+    // delta carries only what changed since it was written; the shard count
+    // may differ. Returns the signals restored; rejected ones are counted
+    // as in addSignal().
+    size_t restoreCheckpoint(const common::CheckpointReader& in);
+    
+    SignalStorageMode getStorageMode() const { return mode_; }
+    
+    // Signals dropped because their symbol or alpha id found the intern
+    // table full
+    uint64_t getRejectedSignalCount() const { return rejectedSignals_.load(std::memory_order_relaxed); }
 
 private:
+    // Stored signals of one symbol with the aggregate derived from them
+    struct SymbolSignals {
+        std::vector<AlphaSignal> signals;   // HISTORY mode
+        uint32_t row{UINT32_MAX};           // LATEST_PER_ALPHA mode: row in the shard's table
+        size_t numLatest{0};                // Filled slots in that row
+        double weightedSum{0};          // Running sums, incremental strategies only
+        double totalWeight{0};
+        size_t numWeighted{0};          // Signals with a non-zero weight
+        StreamingMedian median;         // Streaming median strategies only
+        mutable double aggregated{0};   // Cached strategy result
+        mutable bool stale{false};      // aggregated needs recomputing
+        double publishedTarget{0};      // Last target sent as a delta
+        bool dirty{false};              // Queued in the shard's dirty list
+    };
+    
+    // Own cache lines, so locking one shard does not slow its neighbours
+    struct alignas(64) Shard {
+        mutable std::mutex mutex;
+        std::unordered_map<SymbolId, SymbolSignals> symbols;
+        LatestSignalTable latest;
+        std::vector<SymbolId> dirty;        // Changed since the last delta
+        std::vector<TargetPosition> deltaScratch;
+    };
+    
     std::unique_ptr<IAggregationStrategy> strategy_;
-    std::unordered_map<std::string, std::vector<AlphaSignal>> signalsBySymbol_;
-    mutable std::mutex signalsMutex_;
+    bool incremental_;
+    bool streamingMedian_;
+    SignalStorageMode mode_;
+    std::unique_ptr<Shard[]> shards_;
+    std::shared_ptr<const PortfolioSnapshot> snapshot_;  // Accessed with std::atomic_load/store
+    std::atomic<uint64_t> snapshotVersion_{0};
+    std::atomic<uint64_t> dirtyShards_{0};  // Bit per shard with a non-empty dirty list
+    std::atomic<size_t> numSymbols_{0};     // Sizes portfolio buffers up front
+    std::atomic<uint64_t> rejectedSignals_{0};
+    std::unique_ptr<common::RingConsumer<SignalRing>> inputConsumer_;  // Last: stops first
+    
+    // Dense ids spread evenly over the shards
+    static size_t shardIndex(SymbolId symbolId) { return symbolId & (AggregatorConfig::NUM_SHARDS - 1); }
+    Shard& shardFor(SymbolId symbolId) const { return shards_[shardIndex(symbolId)]; }
+    
+    // Interns the symbol if only its text was set
+    static SymbolId resolveSymbol(AlphaSignal& signal);
+    
+    // Callers of the helpers below hold the shard's mutex. False, and
+    // counted as rejected, if the symbol or alpha could not be interned.
+    bool insertSignalLocked(Shard& shard, AlphaSignal&& signal);
+    
+    // Replace the alpha's slot; false if the stored signal is newer
+    bool insertLatestLocked(Shard& shard, SymbolSignals& state, const AlphaSignal& signal);
+    
+    bool hasSignalsLocked(const SymbolSignals& state) const;
+    
+    // Add (sign 1) or remove (sign -1) a signal's share of the running sums
+    // or streaming median
+    void accumulateLocked(SymbolSignals& state, double signal, double confidence, double sign);
+    
+    // Invalidate the cached aggregate and queue the symbol for the next delta
+    void markChangedLocked(Shard& shard, SymbolId symbolId, SymbolSignals& state);
+    
+    double aggregatedLocked(const Shard& shard, const SymbolSignals& state) const;
+    
+    // Changed positions into out, without marking them published
+    void collectDeltaLocked(Shard& shard, std::vector<TargetPosition>& out, int64_t timestampNs);
+    
+    // The first count positions of a collected delta went out
+    void commitDeltaLocked(Shard& shard, const std::vector<TargetPosition>& delta, size_t count);
+    
+    void clearShardLocked(Shard& shard, int64_t timestampNs);
+    
+    // Every position, stamped with timestampNs
+    void buildPortfolio(std::vector<TargetPosition>& portfolio, int64_t timestampNs);
 };
 
-// Constexpr configuration
-namespace AggregatorConfig {
-    constexpr double MIN_CONFIDENCE_THRESHOLD = 0.3;
-    constexpr int MAX_SIGNALS_PER_SYMBOL = 1000;
-    constexpr int64_t SIGNAL_EXPIRY_NS = 60000000000LL;  // 60 seconds
-}
-
 } // namespace wq::aggregator
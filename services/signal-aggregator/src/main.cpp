@@ -1,8 +1,17 @@
+#include "checkpoint.hpp"
+#include "metrics_server.hpp"
+#include "portfolio_service.hpp"
 #include "signal_aggregator.hpp"
+#include "topology.hpp"
 #include <iostream>
 #include <csignal>
 #include <atomic>
 #include <chrono>
+#include <filesystem>
+#include <memory>
+#include <string>
+#include <string_view>
+#include <thread>
 
 std::atomic<bool> running{true};
 
@@ -20,34 +29,126 @@ int main(int argc, char** argv) {
     
     using namespace wq::aggregator;
     
-    // Create aggregator with weighted average strategy
+    // Create aggregator with weighted average strategy, counting each
+    // alpha's latest signal once
     auto strategy = std::make_unique<WeightedAverageAggregation>();
-    SignalAggregator aggregator(std::move(strategy));
+    SignalAggregator aggregator(std::move(strategy), SignalStorageMode::LATEST_PER_ALPHA);
+    
+    // Usage: signal-aggregator [--checkpoint FILE]
+    std::string checkpointPath;
+    for (int i = 1; i + 1 < argc; ++i) {
+        if (std::string_view(argv[i]) == "--checkpoint") {
+            checkpointPath = argv[++i];
+        }
+    }
+    
+    // Warm restart: stored signals and published targets from the last checkpoint
+    if (!checkpointPath.empty() && std::filesystem::exists(checkpointPath)) {
+        if (auto restored = wq::common::CheckpointReader::open(checkpointPath)) {
+            std::cout << "Restored " << aggregator.restoreCheckpoint(*restored)
+                      << " signals from " << checkpointPath << std::endl;
+        }
+    }
+    auto writeCheckpoint = [&aggregator, &checkpointPath](int64_t nowNs) {
+        wq::common::CheckpointWriter writer;
+        aggregator.checkpoint(writer);
+        if (writer.commit(checkpointPath, nowNs)) {
+            std::cout << "Checkpointed aggregator state to " << checkpointPath << std::endl;
+        }
+    };
+    
+    // Signals are drained from a ring by the aggregator's input thread
+    auto signalRing = std::make_unique<SignalRing>();
+    aggregator.attachInput(*signalRing);
+    
+    // Signals come from a co-located alpha engine when one is running;
+    // target portfolios are published for a co-located risk guardian
+    auto signalShm = wq::common::attachColocated<wq::common::SignalShmRing>(
+        wq::common::IpcConfig::SIGNAL_SEGMENT);
+    auto targetShm = wq::common::publishColocated<wq::common::TargetShmRing>(
+        wq::common::IpcConfig::TARGET_SEGMENT);
+    std::unique_ptr<wq::common::RingConsumer<wq::common::SignalShmRing>> signalBridge;
+    if (signalShm) {
+        signalBridge = std::make_unique<wq::common::RingConsumer<wq::common::SignalShmRing>>(*signalShm,
+            [&signalRing](wq::common::SignalRecord* records, size_t count) {
+                for (size_t i = 0; i < count; ++i) {
+                    signalRing->tryPush(fromSignalRecord(records[i]));
+                }
+            });
+        signalBridge->setStage(wq::common::TopologyStage::AGGREGATOR_BRIDGE);
+        signalBridge->start();
+    }
+    
+    // Remote consumers (EMS) get a full portfolio, then deltas, over gRPC
+    wq::common::AsyncServer server(wq::common::ServerConfig::PORTFOLIO_ADDRESS);
+    PortfolioServiceImpl portfolioService(server, aggregator);
+    server.setStage(wq::common::TopologyStage::AGGREGATOR_RPC);
+    if (!server.start()) {
+        return 1;
+    }
+    
+    // Aggregation latencies for scraping
+    wq::common::MetricsServer metricsServer(wq::common::MetricsConfig::SIGNAL_AGGREGATOR_PORT);
     
     std::cout << "Service started successfully" << std::endl;
-    std::cout << "Waiting for alpha signals..." << std::endl;
+    std::cout << "Serving PortfolioService on " << server.getAddress() << std::endl;
+    if (metricsServer.start()) {
+        std::cout << "Serving metrics on port " << metricsServer.getPort() << std::endl;
+    }
+    if (signalShm) {
+        std::cout << "Consuming alpha signals from shared memory " << signalShm->name() << std::endl;
+    } else {
+        std::cout << "Waiting for alpha signals..." << std::endl;
+    }
+    wq::common::topology().report(std::cout);
     
-    // Simulate receiving signals
+    // Simulate receiving signals unless a co-located engine supplies them
     int signalCount = 0;
+    int64_t lastCheckpointNs = std::chrono::high_resolution_clock::now().time_since_epoch().count();
     while (running) {
+        int64_t nowNs = std::chrono::high_resolution_clock::now().time_since_epoch().count();
+        if (!checkpointPath.empty() && nowNs - lastCheckpointNs >= wq::common::CheckpointConfig::INTERVAL_NS) {
+            writeCheckpoint(nowNs);
+            lastCheckpointNs = nowNs;
+        }
+        
+        if (signalShm) {
+            signalCount++;
+            if (signalCount % 10 == 0) {
+                // Only symbols whose target moved since the last refresh
+                auto delta = aggregator.generatePortfolioDelta();
+                if (targetShm) {
+                    for (const auto& pos : delta) {
+                        targetShm->tryPush(toTargetRecord(pos));
+                    }
+                }
+                portfolioService.publishDelta(delta);
+                std::cout << "Published " << delta.size() << " changed target positions" << std::endl;
+            }
+            std::this_thread::sleep_for(std::chrono::milliseconds(100));
+            continue;
+        }
+        
         // Simulate incoming signal
         AlphaSignal signal;
-        signal.alphaId = "Alpha_" + std::to_string(signalCount % 10);
-        signal.symbol = "AAPL";
+        signal.setAlphaId("Alpha_" + std::to_string(signalCount % 10));
+        signal.setSymbol("AAPL");
         signal.signal = -0.5 + (std::rand() % 100) / 100.0;
         signal.confidence = 0.5 + (std::rand() % 50) / 100.0;
         signal.timestampNs = std::chrono::high_resolution_clock::now()
             .time_since_epoch().count();
         
-        aggregator.addSignal(std::move(signal));
+        // Into the local ring the input thread drains, as bridged signals do
+        signalRing->tryPush(signal);
         signalCount++;
         
         // Generate portfolio every 10 signals
         if (signalCount % 10 == 0) {
-            auto portfolio = aggregator.generateTargetPortfolio();
+            auto snapshot = aggregator.refreshPortfolioSnapshot();
+            portfolioService.publishDelta(aggregator.generatePortfolioDelta());
             
             std::cout << "\n=== Target Portfolio ===" << std::endl;
-            for (const auto& pos : portfolio) {
+            for (const auto& pos : snapshot->positions) {
                 std::cout << "Symbol: " << pos.symbol 
                           << ", Target: " << pos.targetQuantity << std::endl;
             }
@@ -62,6 +163,15 @@ int main(int argc, char** argv) {
         std::this_thread::sleep_for(std::chrono::milliseconds(100));
     }
     
+    if (signalBridge) {
+        signalBridge->stop();
+    }
+    aggregator.detachInput();
+    if (!checkpointPath.empty()) {
+        writeCheckpoint(std::chrono::high_resolution_clock::now().time_since_epoch().count());
+    }
+    server.shutdown();
+    metricsServer.stop();
     std::cout << "Service stopped" << std::endl;
     return 0;
 }
@@ -0,0 +1,79 @@
+#include "portfolio_service.hpp"
+#include <chrono>
+
+namespace wq::aggregator {
+
+namespace {
+
+std::string positionKey(const proto::TargetPosition& position) {
+    return position.symbol();
+}
+
+int64_t nowNs() {
+    return std::chrono::high_resolution_clock::now().time_since_epoch().count();
+}
+
+} // namespace
+
+// Strings are copied straight into the position's arena
+void toProto(const TargetPosition& position, proto::TargetPosition* out) {
+    std::string_view symbol = position.symbol.view();
+    out->set_symbol(symbol.data(), symbol.size());
+    out->set_target_quantity(position.targetQuantity);
+    out->set_current_quantity(position.currentQuantity);
+    out->set_timestamp_ns(position.timestampNs);
+}
+
+PortfolioServiceImpl::PortfolioServiceImpl(common::AsyncServer& server, SignalAggregator& aggregator)
+    : aggregator_(aggregator)
+    , getPortfolio_(server, service_, &AsyncService::RequestGetTargetPortfolio,
+                    [this](const proto::PortfolioRequest& request, proto::TargetPortfolio& portfolio) {
+                        return getTargetPortfolio(request, portfolio);
+                    })
+    , stream_(server, service_, &AsyncService::RequestStreamTargetPortfolio,
+              &proto::TargetPortfolio::mutable_positions, positionKey) {
+    // Current targets of every symbol; deltas published meanwhile follow it
+    stream_.setSnapshot([this](const proto::PortfolioRequest& /*request*/, proto::TargetPortfolio& portfolio) {
+        for (const auto& position : aggregator_.generateTargetPortfolio()) {
+            toProto(position, portfolio.add_positions());
+        }
+    });
+    stream_.setPrepare([](proto::TargetPortfolio& portfolio, bool first) {
+        portfolio.set_timestamp_ns(nowNs());
+        portfolio.set_is_delta(!first);
+    });
+    server.addService(&service_);
+}
+
+void PortfolioServiceImpl::publishDelta(const std::vector<TargetPosition>& delta) {
+    if (delta.empty() || stream_.getSubscriberCount() == 0) {
+        return;
+    }
+    auto* staged = stagingArena_.create<proto::TargetPortfolio>();
+    for (const auto& position : delta) {
+        toProto(position, staged->add_positions());
+    }
+    stream_.publish(staged->positions());
+    stagingArena_.reset();
+}
+
+grpc::Status PortfolioServiceImpl::getTargetPortfolio(const proto::PortfolioRequest& /*request*/,
+                                                      proto::TargetPortfolio& portfolio) {
+    // The lock-free snapshot if one was published, else built now
+    auto snapshot = aggregator_.getPortfolioSnapshot();
+    if (snapshot) {
+        for (const auto& position : snapshot->positions) {
+            toProto(position, portfolio.add_positions());
+        }
+        portfolio.set_timestamp_ns(snapshot->timestampNs);
+    } else {
+        for (const auto& position : aggregator_.generateTargetPortfolio()) {
+            toProto(position, portfolio.add_positions());
+        }
+        portfolio.set_timestamp_ns(nowNs());
+    }
+    portfolio.set_is_delta(false);
+    return grpc::Status::OK;
+}
+
+} // namespace wq::aggregator
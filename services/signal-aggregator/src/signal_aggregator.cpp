@@ -1,134 +1,770 @@
 #include "signal_aggregator.hpp"
+#include "latency.hpp"
 #include <algorithm>
+#include <chrono>
+#include <functional>
 #include <numeric>
 #include <cmath>
+#include <iostream>
 
 namespace wq::aggregator {
 
+namespace {
+
+// One per shard: a count and that many SignalRecords, then a count and that
+// many SymbolRecords
+constexpr const char* CHECKPOINT_SECTION = "aggregator.shard";
+
+// The last target sent for a symbol, and its running sums as they stood:
+// re-adding the signals in another order would round them differently, and
+// targets are compared exactly, so every restored symbol would send a delta
+struct SymbolRecord {
+    SymbolString symbol;
+    double publishedTarget;
+    double weightedSum;
+    double totalWeight;
+};
+
+} // namespace
+
 // WeightedAverageAggregation implementation
 double WeightedAverageAggregation::aggregate(const std::vector<AlphaSignal>& signals) const {
     if (signals.empty()) {
         return 0.0;
     }
     
-    // Filter by confidence threshold
-    std::vector<AlphaSignal> filtered;
-    std::copy_if(signals.begin(), signals.end(), std::back_inserter(filtered),
-        [](const AlphaSignal& sig) {
-            return sig.confidence >= AggregatorConfig::MIN_CONFIDENCE_THRESHOLD;
-        });
+    // One pass: signals under the confidence threshold carry no weight
+    double weightedSum = 0.0;
+    double totalWeight = 0.0;
+    for (const auto& sig : signals) {
+        if (sig.confidence >= AggregatorConfig::MIN_CONFIDENCE_THRESHOLD) {
+            weightedSum += sig.signal * sig.confidence;
+            totalWeight += sig.confidence;
+        }
+    }
     
-    if (filtered.empty()) {
+    if (totalWeight == 0.0) {
         return 0.0;
     }
     
-    // Calculate weighted average using lambda
-    double weightedSum = std::accumulate(filtered.begin(), filtered.end(), 0.0,
-        [](double sum, const AlphaSignal& sig) {
-            return sum + (sig.signal * sig.confidence);
-        });
-    
-    double totalWeight = std::accumulate(filtered.begin(), filtered.end(), 0.0,
-        [](double sum, const AlphaSignal& sig) {
-            return sum + sig.confidence;
-        });
-    
     return weightedSum / totalWeight;
 }
 
+namespace {
+
+// Reused value buffer for the selection-based strategies. Shards aggregate
+// concurrently, so each thread has its own.
+std::vector<double>& selectionScratch() {
+    thread_local std::vector<double> values;
+    values.clear();
+    return values;
+}
+
+// Median by selection: only the middle element(s) need to be in place
+double medianOf(std::vector<double>& values) {
+    if (values.empty()) {
+        return 0.0;
+    }
+    size_t mid = values.size() / 2;
+    std::nth_element(values.begin(), values.begin() + mid, values.end());
+    double upper = values[mid];
+    if (values.size() % 2 != 0) {
+        return upper;
+    }
+    double lower = *std::max_element(values.begin(), values.begin() + mid);
+    return (lower + upper) / 2.0;
+}
+
+} // namespace
+
 // MedianAggregation implementation
 double MedianAggregation::aggregate(const std::vector<AlphaSignal>& signals) const {
-    if (signals.empty()) {
+    // Signals below the confidence threshold, and zero signals, are left out
+    std::vector<double>& values = selectionScratch();
+    for (const auto& sig : signals) {
+        if (sig.confidence >= AggregatorConfig::MIN_CONFIDENCE_THRESHOLD && sig.signal != 0.0) {
+            values.push_back(sig.signal);
+        }
+    }
+    return medianOf(values);
+}
+
+// Default: gather the filled slots and reuse the history form, through a
+// per-thread buffer that keeps its capacity
+double IAggregationStrategy::aggregateLatest(const SignalSlot* slots, size_t count) const {
+    thread_local std::vector<AlphaSignal> signals;
+    signals.clear();
+    for (size_t i = 0; i < count; ++i) {
+        if (!slots[i].empty()) {
+            AlphaSignal signal;
+            signal.signal = slots[i].signal;
+            signal.confidence = slots[i].confidence;
+            signal.timestampNs = slots[i].timestampNs;
+            signals.push_back(signal);
+        }
+    }
+    return aggregate(signals);
+}
+
+// Dense reduction over the row - empty slots have zero confidence and drop
+// out through the threshold
+double WeightedAverageAggregation::aggregateLatest(const SignalSlot* slots, size_t count) const {
+    double weightedSum = 0.0;
+    double totalWeight = 0.0;
+    for (size_t i = 0; i < count; ++i) {
+        double weight = slots[i].confidence >= AggregatorConfig::MIN_CONFIDENCE_THRESHOLD
+            ? slots[i].confidence : 0.0;
+        weightedSum += slots[i].signal * weight;
+        totalWeight += weight;
+    }
+    return totalWeight > 0.0 ? weightedSum / totalWeight : 0.0;
+}
+
+double MedianAggregation::aggregateLatest(const SignalSlot* slots, size_t count) const {
+    std::vector<double>& values = selectionScratch();
+    for (size_t i = 0; i < count; ++i) {
+        if (slots[i].confidence >= AggregatorConfig::MIN_CONFIDENCE_THRESHOLD && slots[i].signal != 0.0) {
+            values.push_back(slots[i].signal);
+        }
+    }
+    return medianOf(values);
+}
+
+// TrimmedMeanAggregation implementation
+TrimmedMeanAggregation::TrimmedMeanAggregation(double trimFraction)
+    : trimFraction_(std::min(std::max(trimFraction, 0.0), 0.5)) {}
+
+double TrimmedMeanAggregation::trimmedMean(std::vector<double>& values) const {
+    size_t n = values.size();
+    if (n == 0) {
         return 0.0;
     }
+    // Always keep at least one value; a fraction of 0.5 leaves the median
+    size_t cut = std::min(static_cast<size_t>(n * trimFraction_), (n - 1) / 2);
+    auto first = values.begin() + cut;
+    auto last = values.end() - cut;
+    if (cut > 0) {
+        // Two selections move both tails out of [first, last) without sorting
+        std::nth_element(values.begin(), first, values.end());
+        std::nth_element(first, last, values.end());
+    }
+    return std::accumulate(first, last, 0.0) / static_cast<double>(last - first);
+}
+
+double TrimmedMeanAggregation::aggregate(const std::vector<AlphaSignal>& signals) const {
+    std::vector<double>& values = selectionScratch();
+    for (const auto& sig : signals) {
+        if (sig.confidence >= AggregatorConfig::MIN_CONFIDENCE_THRESHOLD) {
+            values.push_back(sig.signal);
+        }
+    }
+    return trimmedMean(values);
+}
+
+double TrimmedMeanAggregation::aggregateLatest(const SignalSlot* slots, size_t count) const {
+    // Empty slots have zero confidence, so the threshold skips them
+    std::vector<double>& values = selectionScratch();
+    for (size_t i = 0; i < count; ++i) {
+        if (slots[i].confidence >= AggregatorConfig::MIN_CONFIDENCE_THRESHOLD) {
+            values.push_back(slots[i].signal);
+        }
+    }
+    return trimmedMean(values);
+}
+
+// StreamingMedian implementation
+void StreamingMedian::insert(double value) {
+    if (lowerSize_ == 0 || value <= lower_.front()) {
+        lower_.push_back(value);
+        std::push_heap(lower_.begin(), lower_.end(), std::less<double>());
+        ++lowerSize_;
+    } else {
+        upper_.push_back(value);
+        std::push_heap(upper_.begin(), upper_.end(), std::greater<double>());
+        ++upperSize_;
+    }
+    rebalance();
+}
+
+void StreamingMedian::erase(double value) {
+    // Tops are always live, and every lower value is <= every upper one, so
+    // the comparison finds a half holding a live copy of the value
+    if (lowerSize_ > 0 && value <= lower_.front()) {
+        lowerErased_.push_back(value);
+        std::push_heap(lowerErased_.begin(), lowerErased_.end(), std::less<double>());
+        --lowerSize_;
+    } else {
+        upperErased_.push_back(value);
+        std::push_heap(upperErased_.begin(), upperErased_.end(), std::greater<double>());
+        --upperSize_;
+    }
+    rebalance();
     
-    // Filter by confidence threshold
-    std::vector<double> values;
-    std::transform(signals.begin(), signals.end(), std::back_inserter(values),
-        [](const AlphaSignal& sig) {
-            return sig.confidence >= AggregatorConfig::MIN_CONFIDENCE_THRESHOLD ? sig.signal : 0.0;
-        });
-    
-    // Remove zeros
-    values.erase(std::remove(values.begin(), values.end(), 0.0), values.end());
-    
-    if (values.empty()) {
+    // Erased values buried below the top would otherwise accumulate; once
+    // they outnumber the live ones, rebuilding costs O(log n) per erase
+    if (lowerErased_.size() > lowerSize_) {
+        compact(lower_, lowerErased_, std::less<double>());
+    }
+    if (upperErased_.size() > upperSize_) {
+        compact(upper_, upperErased_, std::greater<double>());
+    }
+}
+
+double StreamingMedian::median() const {
+    if (lowerSize_ == 0) {
         return 0.0;
     }
-    
-    // Sort and find median using lambda comparator
-    std::sort(values.begin(), values.end(), [](double a, double b) { return a < b; });
-    
-    size_t mid = values.size() / 2;
-    if (values.size() % 2 == 0) {
-        return (values[mid - 1] + values[mid]) / 2.0;
-    } else {
-        return values[mid];
+    if (lowerSize_ > upperSize_) {
+        return lower_.front();
     }
+    return (lower_.front() + upper_.front()) / 2.0;
+}
+
+void StreamingMedian::rebalance() {
+    prune();
+    // lower_ holds the extra value when the count is odd
+    while (lowerSize_ > upperSize_ + 1) {
+        std::pop_heap(lower_.begin(), lower_.end(), std::less<double>());
+        upper_.push_back(lower_.back());
+        lower_.pop_back();
+        std::push_heap(upper_.begin(), upper_.end(), std::greater<double>());
+        --lowerSize_;
+        ++upperSize_;
+        prune();
+    }
+    while (upperSize_ > lowerSize_) {
+        std::pop_heap(upper_.begin(), upper_.end(), std::greater<double>());
+        lower_.push_back(upper_.back());
+        upper_.pop_back();
+        std::push_heap(lower_.begin(), lower_.end(), std::less<double>());
+        --upperSize_;
+        ++lowerSize_;
+        prune();
+    }
+}
+
+void StreamingMedian::prune() {
+    // Equal values are interchangeable, so any copy can stand for an erased one
+    while (!lowerErased_.empty() && lower_.front() == lowerErased_.front()) {
+        std::pop_heap(lower_.begin(), lower_.end(), std::less<double>());
+        lower_.pop_back();
+        std::pop_heap(lowerErased_.begin(), lowerErased_.end(), std::less<double>());
+        lowerErased_.pop_back();
+    }
+    while (!upperErased_.empty() && upper_.front() == upperErased_.front()) {
+        std::pop_heap(upper_.begin(), upper_.end(), std::greater<double>());
+        upper_.pop_back();
+        std::pop_heap(upperErased_.begin(), upperErased_.end(), std::greater<double>());
+        upperErased_.pop_back();
+    }
+}
+
+template<typename Compare>
+void StreamingMedian::compact(std::vector<double>& heap, std::vector<double>& erased, Compare compare) {
+    // Erased values are a sub-multiset of the heap: one merge pass drops them
+    std::sort(heap.begin(), heap.end());
+    std::sort(erased.begin(), erased.end());
+    size_t kept = 0;
+    size_t next = 0;
+    for (size_t i = 0; i < heap.size(); ++i) {
+        if (next < erased.size() && erased[next] == heap[i]) {
+            ++next;
+        } else {
+            heap[kept++] = heap[i];
+        }
+    }
+    heap.resize(kept);
+    erased.clear();
+    std::make_heap(heap.begin(), heap.end(), compare);
+}
+
+// LatestSignalTable implementation
+uint32_t LatestSignalTable::addRow() {
+    if (stride_ == 0) {
+        widen(AggregatorConfig::MIN_LATEST_COLUMNS);
+    }
+    slots_.resize((rows_ + 1) * stride_);
+    return static_cast<uint32_t>(rows_++);
+}
+
+SignalSlot& LatestSignalTable::slot(uint32_t row, AlphaIndex alpha) {
+    if (alpha >= stride_) {
+        widen(alpha + 1);
+    }
+    if (alpha >= columns_) {
+        columns_ = static_cast<size_t>(alpha) + 1;
+    }
+    return slots_[row * stride_ + alpha];
+}
+
+void LatestSignalTable::widen(size_t columns) {
+    size_t stride = std::max(stride_, AggregatorConfig::MIN_LATEST_COLUMNS);
+    while (stride < columns) {
+        stride *= 2;
+    }
+    if (stride == stride_) {
+        return;
+    }
+    // Re-lay every row at the new stride; new columns start empty
+    std::vector<SignalSlot> slots(rows_ * stride);
+    for (size_t r = 0; r < rows_; ++r) {
+        std::copy(slots_.begin() + r * stride_, slots_.begin() + r * stride_ + columns_,
+                  slots.begin() + r * stride);
+    }
+    slots_.swap(slots);
+    stride_ = stride;
 }
 
 // SignalAggregator implementation
-SignalAggregator::SignalAggregator(std::unique_ptr<IAggregationStrategy> strategy)
-    : strategy_(std::move(strategy)) {}
+SignalAggregator::SignalAggregator(std::unique_ptr<IAggregationStrategy> strategy, SignalStorageMode mode)
+    : strategy_(std::move(strategy))
+    , incremental_(strategy_->isIncremental())
+    , streamingMedian_(strategy_->isStreamingMedian())
+    , mode_(mode)
+    , shards_(std::make_unique<Shard[]>(AggregatorConfig::NUM_SHARDS)) {}
+
+SymbolId SignalAggregator::resolveSymbol(AlphaSignal& signal) {
+    // Callers that only set the symbol text get it interned here
+    if (signal.symbolId == common::INVALID_SYMBOL_ID) {
+        signal.symbolId = common::internSymbol(signal.symbol.view());
+    }
+    return signal.symbolId;
+}
 
 void SignalAggregator::addSignal(AlphaSignal&& signal) {
-    std::lock_guard<std::mutex> lock(signalsMutex_);
+    static common::LatencyProbe& probe = common::latencyProbe("aggregator.add_signal");
+    common::ScopedLatency latency(probe);
+    Shard& shard = shardFor(resolveSymbol(signal));
+    std::lock_guard<std::mutex> lock(shard.mutex);
+    insertSignalLocked(shard, std::move(signal));
+}
+
+void SignalAggregator::addSignals(AlphaSignal* signals, size_t count) {
+    static common::LatencyProbe& probe = common::latencyProbe("aggregator.add_batch");
+    common::ScopedLatency latency(probe);
+    size_t i = 0;
+    while (i < count) {
+        Shard& shard = shardFor(resolveSymbol(signals[i]));
+        std::lock_guard<std::mutex> lock(shard.mutex);
+        insertSignalLocked(shard, std::move(signals[i++]));
+        // Signals in a burst often share a symbol: stay on this shard
+        while (i < count && &shardFor(resolveSymbol(signals[i])) == &shard) {
+            insertSignalLocked(shard, std::move(signals[i++]));
+        }
+    }
+}
+
+void SignalAggregator::attachInput(SignalRing& ring) {
+    detachInput();
+    inputConsumer_ = std::make_unique<common::RingConsumer<SignalRing>>(ring,
+        [this](AlphaSignal* signals, size_t count) {
+            addSignals(signals, count);
+        });
+    inputConsumer_->setStage(common::TopologyStage::AGGREGATOR_INPUT);
+    common::topology().place("aggregator.input ring", &ring, sizeof(ring), common::TopologyStage::AGGREGATOR_INPUT);
+    inputConsumer_->start();
+}
+
+void SignalAggregator::detachInput() {
+    if (inputConsumer_) {
+        inputConsumer_->stop();  // Drains what is already queued
+        inputConsumer_.reset();
+    }
+}
+
+void SignalAggregator::accumulateLocked(SymbolSignals& state, double signal, double confidence, double sign) {
+    if (!incremental_ && !streamingMedian_) {
+        return;
+    }
+    double weight = strategy_->weight(signal, confidence);
+    if (weight == 0.0) {
+        return;
+    }
+    if (streamingMedian_) {
+        if (sign > 0) {
+            state.median.insert(signal);
+        } else {
+            state.median.erase(signal);
+        }
+        return;
+    }
+    state.weightedSum += sign * weight * signal;
+    state.totalWeight += sign * weight;
+    state.numWeighted = sign > 0 ? state.numWeighted + 1 : state.numWeighted - 1;
+    if (state.numWeighted == 0) {
+        // Drop the rounding left over from adding and removing
+        state.weightedSum = 0.0;
+        state.totalWeight = 0.0;
+    }
+}
+
+void SignalAggregator::markChangedLocked(Shard& shard, SymbolId symbolId, SymbolSignals& state) {
+    state.stale = true;
+    if (!state.dirty) {
+        state.dirty = true;
+        if (shard.dirty.empty()) {
+            dirtyShards_.fetch_or(uint64_t{1} << shardIndex(symbolId), std::memory_order_release);
+        }
+        shard.dirty.push_back(symbolId);
+    }
+}
+
+double SignalAggregator::aggregatedLocked(const Shard& shard, const SymbolSignals& state) const {
+    if (state.stale) {
+        if (incremental_) {
+            state.aggregated = state.numWeighted > 0 ? state.weightedSum / state.totalWeight : 0.0;
+        } else if (streamingMedian_) {
+            state.aggregated = state.median.median();
+        } else if (mode_ == SignalStorageMode::LATEST_PER_ALPHA) {
+            state.aggregated = state.row == UINT32_MAX ? 0.0
+                : strategy_->aggregateLatest(shard.latest.row(state.row), shard.latest.numColumns());
+        } else {
+            state.aggregated = strategy_->aggregate(state.signals);
+        }
+        state.stale = false;
+    }
+    return state.aggregated;
+}
+
+bool SignalAggregator::hasSignalsLocked(const SymbolSignals& state) const {
+    return mode_ == SignalStorageMode::LATEST_PER_ALPHA ? state.numLatest > 0 : !state.signals.empty();
+}
+
+bool SignalAggregator::insertLatestLocked(Shard& shard, SymbolSignals& state, const AlphaSignal& signal) {
+    if (state.row == UINT32_MAX) {
+        state.row = shard.latest.addRow();
+    }
+    SignalSlot& slot = shard.latest.slot(state.row, signal.alphaIndex);
+    if (slot.empty()) {
+        ++state.numLatest;
+    } else if (slot.timestampNs > signal.timestampNs) {
+        return false;  // Reordered: keep the newer signal
+    } else {
+        accumulateLocked(state, slot.signal, slot.confidence, -1.0);
+    }
+    slot.signal = signal.signal;
+    slot.confidence = signal.confidence;
+    slot.timestampNs = signal.timestampNs;
+    accumulateLocked(state, slot.signal, slot.confidence, 1.0);
+    return true;
+}
+
+bool SignalAggregator::insertSignalLocked(Shard& shard, AlphaSignal&& signal) {
+    SymbolId symbolId = signal.symbolId;
+    if (mode_ == SignalStorageMode::LATEST_PER_ALPHA && signal.alphaIndex == common::INVALID_ALPHA_INDEX) {
+        signal.alphaIndex = common::internAlphaId(signal.alphaId.view());
+    }
+    // A full intern table leaves no id to store the signal under
+    if (symbolId == common::INVALID_SYMBOL_ID ||
+        (mode_ == SignalStorageMode::LATEST_PER_ALPHA && signal.alphaIndex == common::INVALID_ALPHA_INDEX)) {
+        rejectedSignals_.fetch_add(1, std::memory_order_relaxed);
+        return false;
+    }
+    auto [it, inserted] = shard.symbols.try_emplace(symbolId);
+    if (inserted) {
+        numSymbols_.fetch_add(1, std::memory_order_relaxed);
+    }
+    auto& state = it->second;
+    if (mode_ == SignalStorageMode::LATEST_PER_ALPHA) {
+        if (insertLatestLocked(shard, state, signal)) {
+            markChangedLocked(shard, symbolId, state);
+        }
+        return true;
+    }
     
-    auto& signals = signalsBySymbol_[signal.symbol];
-    signals.push_back(std::move(signal));
+    accumulateLocked(state, signal.signal, signal.confidence, 1.0);
+    state.signals.push_back(std::move(signal));
     
     // Limit number of signals per symbol
-    if (signals.size() > static_cast<size_t>(AggregatorConfig::MAX_SIGNALS_PER_SYMBOL)) {
-        signals.erase(signals.begin());
+    if (state.signals.size() > static_cast<size_t>(AggregatorConfig::MAX_SIGNALS_PER_SYMBOL)) {
+        accumulateLocked(state, state.signals.front().signal, state.signals.front().confidence, -1.0);
+        state.signals.erase(state.signals.begin());
     }
+    markChangedLocked(shard, symbolId, state);
+    return true;
 }
 
-std::vector<TargetPosition> SignalAggregator::generateTargetPortfolio() {
-    std::lock_guard<std::mutex> lock(signalsMutex_);
+void SignalAggregator::buildPortfolio(std::vector<TargetPosition>& portfolio, int64_t timestampNs) {
+    static common::LatencyProbe& probe = common::latencyProbe("aggregator.aggregate");
+    common::ScopedLatency latency(probe);
+    portfolio.reserve(numSymbols_.load(std::memory_order_relaxed));
     
+    // One shard locked at a time: writers elsewhere keep going
+    for (size_t i = 0; i < AggregatorConfig::NUM_SHARDS; ++i) {
+        Shard& shard = shards_[i];
+        std::lock_guard<std::mutex> lock(shard.mutex);
+        
+        // Use lambda with std::transform
+        std::transform(shard.symbols.begin(), shard.symbols.end(),
+            std::back_inserter(portfolio),
+            [this, &shard, timestampNs](const auto& pair) {
+                TargetPosition pos;
+                pos.symbolId = pair.first;
+                pos.symbol = common::symbolTable().name(pair.first);
+                pos.targetQuantity = aggregatedLocked(shard, pair.second) * 1000.0;  // Scale signal
+                pos.currentQuantity = 0.0;
+                pos.timestampNs = timestampNs;
+                return pos;
+            });
+    }
+}
+
+std::vector<TargetPosition> SignalAggregator::generateTargetPortfolio() {
     std::vector<TargetPosition> portfolio;
-    portfolio.reserve(signalsBySymbol_.size());
+    buildPortfolio(portfolio, std::chrono::high_resolution_clock::now().time_since_epoch().count());
+    return portfolio;
+}
+
+size_t SignalAggregator::publishTargetPortfolio(TargetRing& ring) {
+    auto portfolio = generateTargetPortfolio();
+    return ring.pushBatch(portfolio.data(), portfolio.size());
+}
+
+std::shared_ptr<const PortfolioSnapshot> SignalAggregator::refreshPortfolioSnapshot() {
+    auto snapshot = std::make_shared<PortfolioSnapshot>();
+    snapshot->timestampNs = std::chrono::high_resolution_clock::now().time_since_epoch().count();
+    buildPortfolio(snapshot->positions, snapshot->timestampNs);
+    snapshot->version = snapshotVersion_.fetch_add(1, std::memory_order_relaxed) + 1;
     
-    // Use lambda with std::transform
-    std::transform(signalsBySymbol_.begin(), signalsBySymbol_.end(),
-        std::back_inserter(portfolio),
-        [this](const auto& pair) {
-            TargetPosition pos;
-            pos.symbol = pair.first;
-            pos.targetQuantity = strategy_->aggregate(pair.second) * 1000.0;  // Scale signal
-            pos.currentQuantity = 0.0;
-            pos.timestampNs = std::chrono::high_resolution_clock::now().time_since_epoch().count();
-            return pos;
-        });
+    std::shared_ptr<const PortfolioSnapshot> published = std::move(snapshot);
+    std::atomic_store(&snapshot_, published);
+    return published;
+}
+
+std::shared_ptr<const PortfolioSnapshot> SignalAggregator::getPortfolioSnapshot() const {
+    return std::atomic_load(&snapshot_);
+}
+
+void SignalAggregator::collectDeltaLocked(Shard& shard, std::vector<TargetPosition>& out, int64_t timestampNs) {
+    out.clear();
     
-    return portfolio;
+    // Keep only the symbols whose target moved, in the same order as out
+    size_t kept = 0;
+    for (SymbolId symbolId : shard.dirty) {
+        auto& state = shard.symbols[symbolId];
+        double target = aggregatedLocked(shard, state) * 1000.0;  // Scale signal
+        if (target == state.publishedTarget) {
+            state.dirty = false;
+            continue;
+        }
+        TargetPosition pos;
+        pos.symbolId = symbolId;
+        pos.symbol = common::symbolTable().name(symbolId);
+        pos.targetQuantity = target;
+        pos.currentQuantity = 0.0;
+        pos.timestampNs = timestampNs;
+        out.push_back(pos);
+        shard.dirty[kept++] = symbolId;
+    }
+    shard.dirty.resize(kept);
+}
+
+void SignalAggregator::commitDeltaLocked(Shard& shard, const std::vector<TargetPosition>& delta, size_t count) {
+    for (size_t i = 0; i < count; ++i) {
+        auto& state = shard.symbols[delta[i].symbolId];
+        state.publishedTarget = delta[i].targetQuantity;
+        state.dirty = false;
+    }
+    shard.dirty.erase(shard.dirty.begin(), shard.dirty.begin() + count);
+}
+
+std::vector<TargetPosition> SignalAggregator::generatePortfolioDelta() {
+    static common::LatencyProbe& probe = common::latencyProbe("aggregator.delta");
+    common::ScopedLatency latency(probe);
+    int64_t now = std::chrono::high_resolution_clock::now().time_since_epoch().count();
+    std::vector<TargetPosition> delta;
+    
+    // Visit only shards that queued a change; one marked again meanwhile is
+    // picked up by the next call
+    uint64_t pending = dirtyShards_.exchange(0, std::memory_order_acquire);
+    for (; pending != 0; pending &= pending - 1) {
+        Shard& shard = shards_[__builtin_ctzll(pending)];
+        std::lock_guard<std::mutex> lock(shard.mutex);
+        collectDeltaLocked(shard, shard.deltaScratch, now);
+        commitDeltaLocked(shard, shard.deltaScratch, shard.deltaScratch.size());
+        delta.insert(delta.end(), shard.deltaScratch.begin(), shard.deltaScratch.end());
+    }
+    return delta;
+}
+
+size_t SignalAggregator::publishPortfolioDelta(TargetRing& ring) {
+    static common::LatencyProbe& probe = common::latencyProbe("aggregator.delta");
+    common::ScopedLatency latency(probe);
+    int64_t now = std::chrono::high_resolution_clock::now().time_since_epoch().count();
+    size_t published = 0;
+    uint64_t pending = dirtyShards_.exchange(0, std::memory_order_acquire);
+    for (; pending != 0; pending &= pending - 1) {
+        size_t index = __builtin_ctzll(pending);
+        Shard& shard = shards_[index];
+        std::lock_guard<std::mutex> lock(shard.mutex);
+        collectDeltaLocked(shard, shard.deltaScratch, now);
+        size_t pushed = ring.pushBatch(shard.deltaScratch.data(), shard.deltaScratch.size());
+        commitDeltaLocked(shard, shard.deltaScratch, pushed);
+        published += pushed;
+        if (!shard.dirty.empty()) {
+            // Ring full: this shard and the unvisited ones stay pending
+            dirtyShards_.fetch_or(pending, std::memory_order_release);
+            break;
+        }
+    }
+    return published;
 }
 
 std::optional<double> SignalAggregator::getAggregatedSignal(std::string_view symbol) const {
-    std::lock_guard<std::mutex> lock(signalsMutex_);
+    SymbolId symbolId = common::findSymbol(symbol);
+    if (symbolId == common::INVALID_SYMBOL_ID) {
+        return std::nullopt;
+    }
+    return getAggregatedSignal(symbolId);
+}
+
+std::optional<double> SignalAggregator::getAggregatedSignal(SymbolId symbolId) const {
+    const Shard& shard = shardFor(symbolId);
+    std::lock_guard<std::mutex> lock(shard.mutex);
     
-    auto it = signalsBySymbol_.find(std::string(symbol));
-    if (it == signalsBySymbol_.end() || it->second.empty()) {
+    auto it = shard.symbols.find(symbolId);
+    if (it == shard.symbols.end() || !hasSignalsLocked(it->second)) {
         return std::nullopt;
     }
     
-    return strategy_->aggregate(it->second);
+    return aggregatedLocked(shard, it->second);
 }
 
 void SignalAggregator::clearSignalsOlderThan(int64_t timestampNs) {
-    std::lock_guard<std::mutex> lock(signalsMutex_);
-    
-    // Use lambda to remove old signals
-    for (auto& pair : signalsBySymbol_) {
-        auto& signals = pair.second;
-        signals.erase(
-            std::remove_if(signals.begin(), signals.end(),
-                [timestampNs](const AlphaSignal& sig) {
-                    return sig.timestampNs < timestampNs;
-                }),
-            signals.end()
-        );
+    for (size_t i = 0; i < AggregatorConfig::NUM_SHARDS; ++i) {
+        Shard& shard = shards_[i];
+        std::lock_guard<std::mutex> lock(shard.mutex);
+        clearShardLocked(shard, timestampNs);
+    }
+}
+
+void SignalAggregator::clearShardLocked(Shard& shard, int64_t timestampNs) {
+    // Compact each symbol's signals in place, taking the expired ones out of
+    // the running sums as they are dropped
+    for (auto& pair : shard.symbols) {
+        auto& state = pair.second;
+        if (mode_ == SignalStorageMode::LATEST_PER_ALPHA) {
+            if (state.numLatest == 0) {
+                continue;
+            }
+            size_t expired = 0;
+            SignalSlot* row = shard.latest.row(state.row);
+            for (size_t i = 0; i < shard.latest.numColumns(); ++i) {
+                if (!row[i].empty() && row[i].timestampNs < timestampNs) {
+                    accumulateLocked(state, row[i].signal, row[i].confidence, -1.0);
+                    row[i] = SignalSlot();
+                    ++expired;
+                }
+            }
+            if (expired > 0) {
+                state.numLatest -= expired;
+                markChangedLocked(shard, pair.first, state);
+            }
+            continue;
+        }
+        
+        auto& signals = state.signals;
+        size_t kept = 0;
+        for (size_t i = 0; i < signals.size(); ++i) {
+            if (signals[i].timestampNs < timestampNs) {
+                accumulateLocked(state, signals[i].signal, signals[i].confidence, -1.0);
+            } else if (kept++ != i) {
+                signals[kept - 1] = std::move(signals[i]);
+            }
+        }
+        if (kept == signals.size()) {
+            continue;
+        }
+        signals.resize(kept);
+        markChangedLocked(shard, pair.first, state);
+    }
+}
+
+void SignalAggregator::checkpoint(common::CheckpointWriter& out) const {
+    std::vector<common::SignalRecord> signals;
+    std::vector<SymbolRecord> targets;
+    for (size_t i = 0; i < AggregatorConfig::NUM_SHARDS; ++i) {
+        Shard& shard = shards_[i];
+        signals.clear();
+        targets.clear();
+        {
+            // Copy out under the lock, write after it
+            std::lock_guard<std::mutex> lock(shard.mutex);
+            for (const auto& [symbolId, state] : shard.symbols) {
+                const SymbolString& symbol = common::symbolTable().name(symbolId);
+                if (mode_ == SignalStorageMode::HISTORY) {
+                    for (const auto& signal : state.signals) {
+                        signals.push_back({signal.alphaId, symbol, signal.signal, signal.confidence,
+                                           signal.timestampNs});
+                    }
+                } else if (state.numLatest > 0) {
+                    const SignalSlot* row = shard.latest.row(state.row);
+                    for (size_t alpha = 0; alpha < shard.latest.numColumns(); ++alpha) {
+                        if (!row[alpha].empty()) {
+                            signals.push_back({common::alphaIdTable().name(static_cast<AlphaIndex>(alpha)), symbol,
+                                               row[alpha].signal, row[alpha].confidence, row[alpha].timestampNs});
+                        }
+                    }
+                }
+                targets.push_back({symbol, state.publishedTarget, state.weightedSum, state.totalWeight});
+            }
+        }
+        
+        out.beginSection(CHECKPOINT_SECTION);
+        out.write<uint64_t>(signals.size());
+        out.writeArray(signals.data(), signals.size());
+        out.write<uint64_t>(targets.size());
+        out.writeArray(targets.data(), targets.size());
+        out.endSection();
+        for (const auto& signal : signals) {
+            out.advanceWatermark(signal.timestampNs);
+        }
+    }
+}
+
+size_t SignalAggregator::restoreCheckpoint(const common::CheckpointReader& in) {
+    size_t restored = 0;
+    for (auto section : in.sections(CHECKPOINT_SECTION)) {
+        uint64_t count = 0;
+        bool valid = section.read(count);
+        for (uint64_t i = 0; valid && i < count; ++i) {
+            common::SignalRecord record;
+            if (!(valid = section.read(record))) {
+                break;
+            }
+            AlphaSignal signal = fromSignalRecord(record);
+            Shard& shard = shardFor(signal.symbolId);
+            std::lock_guard<std::mutex> lock(shard.mutex);
+            if (insertSignalLocked(shard, std::move(signal))) {
+                ++restored;
+            }
+        }
+        
+        // Targets already sent reach risk again only if they move
+        valid = valid && section.read(count);
+        for (uint64_t i = 0; valid && i < count; ++i) {
+            SymbolRecord record;
+            if (!(valid = section.read(record))) {
+                break;
+            }
+            SymbolId symbolId = common::symbolTable().internName(record.symbol);
+            Shard& shard = shardFor(symbolId);
+            std::lock_guard<std::mutex> lock(shard.mutex);
+            auto it = shard.symbols.find(symbolId);
+            if (it != shard.symbols.end()) {
+                it->second.publishedTarget = record.publishedTarget;
+                if (incremental_ && it->second.numWeighted > 0) {
+                    it->second.weightedSum = record.weightedSum;
+                    it->second.totalWeight = record.totalWeight;
+                    it->second.stale = true;
+                }
+            }
+        }
+        if (!valid) {
+            std::cerr << "Checkpoint aggregator section is truncated; restored what it held" << std::endl;
+        }
     }
+    return restored;
 }
 
 } // namespace wq::aggregator